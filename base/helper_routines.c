@@ -3,9 +3,376 @@
  * @brief       Implementation of helper utility functions
  * @details     This file contains implementations of various helper functions
  *              that provide common functionality used throughout the application.
+ *
+ *              On x86 with GCC or Clang, mem_set() dispatches to SSE2, AVX2, AVX-512,
+ *              rep stosb or non-temporal kernels chosen from CPUID on the first call.
+ *              Other targets use the portable kernel.
  */
 
 #include "helper_routines.h"
+#include <stdint.h>     /* For uintptr_t */
+#include <pthread.h>    /* For pthread_once() */
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#include <immintrin.h>
+#define MEM_SET_X86     (1U)
+#else
+#define MEM_SET_X86     (0U)
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define MEM_SET_NOINLINE    __attribute__((noinline))
+#else
+#define MEM_SET_NOINLINE
+#endif
+
+/**
+ * @brief Size from which rep stosb is used on CPUs with ERMS
+ */
+#ifndef MEM_SET_ERMS_THRESHOLD
+#define MEM_SET_ERMS_THRESHOLD      (2048U)
+#endif
+
+/**
+ * @brief Size from which non-temporal stores are used
+ * @note  Around the size of a last-level cache: larger blocks would only evict
+ *        useful data before being written back anyway
+ */
+#ifndef MEM_SET_STREAM_THRESHOLD
+#define MEM_SET_STREAM_THRESHOLD    (8U * 1024U * 1024U)
+#endif
+
+/**
+ * @brief Smallest block handed to a kernel (smaller ones are filled inline)
+ */
+#define MEM_SET_KERNEL_MIN          (256U)
+
+typedef void (*TMem_set_fn)(uint8* dest, uint8 value, size_t num);
+
+/**
+ * @brief Kernels used for one TMem_set_kernel choice
+ */
+typedef struct {
+    TMem_set_fn vector;         /**< Kernel below the size thresholds */
+    TMem_set_fn erms;           /**< rep stosb, or NULL if not used */
+    TMem_set_fn stream;         /**< Non-temporal kernel, or NULL if not used */
+    const char* vector_name;
+} TMem_set_dispatch;
+
+/* One table per kernel choice, filled once and never written again */
+static TMem_set_dispatch g_mem_set_tables[MEM_SET_KERNEL_STREAM + 1];
+static pthread_once_t g_mem_set_once = PTHREAD_ONCE_INIT;
+
+/* Table in use, published with release semantics (NULL until the first call) */
+static const TMem_set_dispatch* g_mem_set = NULL_PTR;
+
+/* ================================ Kernels ================================ */
+
+/**
+ * @brief Store 8 bytes at an unaligned address
+ */
+static inline void Store64(uint8* dest, uint64 pattern)
+{
+    __builtin_memcpy(dest, &pattern, sizeof(pattern));
+}
+
+/**
+ * @brief Portable kernel: 8-byte stores, num >= 8
+ */
+static void MemSetGeneric(uint8* dest, uint8 value, size_t num)
+{
+    uint64 pattern = (uint64)value * 0x0101010101010101ULL;
+    uint8* end = dest + num;
+
+    for (; (size_t)(end - dest) >= 8U; dest += 8)
+    {
+        Store64(dest, pattern);
+    }
+    /* Last, possibly overlapping store */
+    Store64(end - 8, pattern);
+}
+
+#if (MEM_SET_X86 == 1U)
+__attribute__((target("sse2")))
+static void MemSetSse2(uint8* dest, uint8 value, size_t num)
+{
+    __m128i v = _mm_set1_epi8((char)value);
+    uint8* end = dest + num;
+
+    /* Unaligned head, aligned body, overlapping unaligned tail */
+    _mm_storeu_si128((__m128i*)dest, v);
+    uint8* p = (uint8*)(((uintptr_t)dest + 16U) & ~(uintptr_t)15U);
+    for (; (p + 16) <= end; p += 16)
+    {
+        _mm_store_si128((__m128i*)p, v);
+    }
+    _mm_storeu_si128((__m128i*)(end - 16), v);
+}
+
+__attribute__((target("avx2")))
+static void MemSetAvx2(uint8* dest, uint8 value, size_t num)
+{
+    __m256i v = _mm256_set1_epi8((char)value);
+    uint8* end = dest + num;
+
+    _mm256_storeu_si256((__m256i*)dest, v);
+    uint8* p = (uint8*)(((uintptr_t)dest + 32U) & ~(uintptr_t)31U);
+    for (; (p + 128) <= end; p += 128)
+    {
+        _mm256_store_si256((__m256i*)p, v);
+        _mm256_store_si256((__m256i*)(p + 32), v);
+        _mm256_store_si256((__m256i*)(p + 64), v);
+        _mm256_store_si256((__m256i*)(p + 96), v);
+    }
+    for (; (p + 32) <= end; p += 32)
+    {
+        _mm256_store_si256((__m256i*)p, v);
+    }
+    _mm256_storeu_si256((__m256i*)(end - 32), v);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void MemSetAvx512(uint8* dest, uint8 value, size_t num)
+{
+    __m512i v = _mm512_set1_epi8((char)value);
+    uint8* end = dest + num;
+
+    _mm512_storeu_si512((void*)dest, v);
+    uint8* p = (uint8*)(((uintptr_t)dest + 64U) & ~(uintptr_t)63U);
+    for (; (p + 256) <= end; p += 256)
+    {
+        _mm512_store_si512((void*)p, v);
+        _mm512_store_si512((void*)(p + 64), v);
+        _mm512_store_si512((void*)(p + 128), v);
+        _mm512_store_si512((void*)(p + 192), v);
+    }
+    for (; (p + 64) <= end; p += 64)
+    {
+        _mm512_store_si512((void*)p, v);
+    }
+    _mm512_storeu_si512((void*)(end - 64), v);
+}
+
+static void MemSetErms(uint8* dest, uint8 value, size_t num)
+{
+    __asm__ volatile("rep stosb"
+                     : "+D"(dest), "+c"(num)
+                     : "a"(value)
+                     : "memory");
+}
+
+/**
+ * @brief Non-temporal kernel: cache-line stores that bypass the caches
+ */
+__attribute__((target("sse2")))
+static void MemSetStreamSse2(uint8* dest, uint8 value, size_t num)
+{
+    __m128i v = _mm_set1_epi8((char)value);
+    uint8* end = dest + num;
+
+    /* Regular stores up to the first cache line, streaming for whole lines */
+    MemSetSse2(dest, value, 64U);
+    uint8* p = (uint8*)(((uintptr_t)dest + 64U) & ~(uintptr_t)63U);
+    for (; (p + 64) <= end; p += 64)
+    {
+        _mm_stream_si128((__m128i*)p, v);
+        _mm_stream_si128((__m128i*)(p + 16), v);
+        _mm_stream_si128((__m128i*)(p + 32), v);
+        _mm_stream_si128((__m128i*)(p + 48), v);
+    }
+    _mm_sfence();
+    MemSetSse2(end - 64, value, 64U);
+}
+
+__attribute__((target("avx2")))
+static void MemSetStreamAvx2(uint8* dest, uint8 value, size_t num)
+{
+    __m256i v = _mm256_set1_epi8((char)value);
+    uint8* end = dest + num;
+
+    MemSetAvx2(dest, value, 64U);
+    uint8* p = (uint8*)(((uintptr_t)dest + 64U) & ~(uintptr_t)63U);
+    for (; (p + 64) <= end; p += 64)
+    {
+        _mm256_stream_si256((__m256i*)p, v);
+        _mm256_stream_si256((__m256i*)(p + 32), v);
+    }
+    _mm_sfence();
+    MemSetAvx2(end - 64, value, 64U);
+}
+
+/**
+ * @brief Check for Enhanced REP MOVSB/STOSB (CPUID.(EAX=7,ECX=0):EBX bit 9)
+ */
+static boolean CpuHasErms(void)
+{
+    unsigned int eax = 0U;
+    unsigned int ebx = 0U;
+    unsigned int ecx = 0U;
+    unsigned int edx = 0U;
+
+    if (__get_cpuid_count(7U, 0U, &eax, &ebx, &ecx, &edx) == 0)
+    {
+        return FALSE;
+    }
+
+    return ((ebx & (1U << 9)) != 0U) ? TRUE : FALSE;
+}
+#endif
+
+/* ================================ Dispatch ================================ */
+
+/**
+ * @brief Check whether the CPU (and OS) support a kernel
+ */
+static boolean KernelSupported(TMem_set_kernel kernel)
+{
+#if (MEM_SET_X86 == 1U)
+    __builtin_cpu_init();
+    switch (kernel)
+    {
+        case MEM_SET_KERNEL_AUTO:
+        case MEM_SET_KERNEL_GENERIC:
+            return TRUE;
+        case MEM_SET_KERNEL_SSE2:
+        case MEM_SET_KERNEL_STREAM:
+            return __builtin_cpu_supports("sse2") ? TRUE : FALSE;
+        case MEM_SET_KERNEL_AVX2:
+            return __builtin_cpu_supports("avx2") ? TRUE : FALSE;
+        case MEM_SET_KERNEL_AVX512:
+            return (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) ? TRUE : FALSE;
+        case MEM_SET_KERNEL_ERMS:
+            return CpuHasErms();
+        default:
+            return FALSE;
+    }
+#else
+    return ((kernel == MEM_SET_KERNEL_AUTO) || (kernel == MEM_SET_KERNEL_GENERIC)) ? TRUE : FALSE;
+#endif
+}
+
+/**
+ * @brief Fill in the dispatch table for a kernel choice
+ */
+static void Resolve(TMem_set_kernel kernel, TMem_set_dispatch* table)
+{
+    TMem_set_dispatch d = { MemSetGeneric, NULL_PTR, NULL_PTR, "generic" };
+
+#if (MEM_SET_X86 == 1U)
+    switch (kernel)
+    {
+        case MEM_SET_KERNEL_AUTO:
+            if (KernelSupported(MEM_SET_KERNEL_AVX512) == TRUE)
+            {
+                d.vector = MemSetAvx512;
+                d.vector_name = "avx512";
+            }
+            else if (KernelSupported(MEM_SET_KERNEL_AVX2) == TRUE)
+            {
+                d.vector = MemSetAvx2;
+                d.vector_name = "avx2";
+            }
+            else if (KernelSupported(MEM_SET_KERNEL_SSE2) == TRUE)
+            {
+                d.vector = MemSetSse2;
+                d.vector_name = "sse2";
+            }
+            d.erms   = (CpuHasErms() == TRUE) ? MemSetErms : NULL_PTR;
+            d.stream = (KernelSupported(MEM_SET_KERNEL_AVX2) == TRUE) ? MemSetStreamAvx2 :
+                       ((KernelSupported(MEM_SET_KERNEL_SSE2) == TRUE) ? MemSetStreamSse2 : NULL_PTR);
+            break;
+        case MEM_SET_KERNEL_SSE2:
+            d.vector = MemSetSse2;
+            d.vector_name = "sse2";
+            break;
+        case MEM_SET_KERNEL_AVX2:
+            d.vector = MemSetAvx2;
+            d.vector_name = "avx2";
+            break;
+        case MEM_SET_KERNEL_AVX512:
+            d.vector = MemSetAvx512;
+            d.vector_name = "avx512";
+            break;
+        case MEM_SET_KERNEL_ERMS:
+            d.vector = MemSetErms;
+            d.vector_name = "erms";
+            break;
+        case MEM_SET_KERNEL_STREAM:
+            d.vector = (KernelSupported(MEM_SET_KERNEL_AVX2) == TRUE) ? MemSetStreamAvx2 : MemSetStreamSse2;
+            d.vector_name = "stream";
+            break;
+        default:
+            break;
+    }
+#else
+    (void)kernel;
+#endif
+
+    *table = d;
+}
+
+/**
+ * @brief Fill in the tables of all kernel choices (run once)
+ */
+static void ResolveAll(void)
+{
+    for (uint32 kernel = 0U; kernel <= (uint32)MEM_SET_KERNEL_STREAM; kernel++)
+    {
+        Resolve((TMem_set_kernel)kernel, &g_mem_set_tables[kernel]);
+    }
+}
+
+/**
+ * @brief Get the table in use, publishing the automatic choice on the first call
+ */
+static const TMem_set_dispatch* CurrentTable(void)
+{
+    const TMem_set_dispatch* table = __atomic_load_n(&g_mem_set, __ATOMIC_ACQUIRE);
+
+    if (table == NULL_PTR)
+    {
+        (void)pthread_once(&g_mem_set_once, ResolveAll);
+
+        /* Keeps a choice made by a concurrent mem_set_select() */
+        const TMem_set_dispatch* expected = NULL_PTR;
+        table = &g_mem_set_tables[MEM_SET_KERNEL_AUTO];
+        if (__atomic_compare_exchange_n(&g_mem_set, &expected, table, FALSE,
+                                        __ATOMIC_RELEASE, __ATOMIC_ACQUIRE) == FALSE)
+        {
+            table = expected;
+        }
+    }
+
+    return table;
+}
+
+/**
+ * @brief Pick the kernel for a block of at least MEM_SET_KERNEL_MIN bytes
+ */
+static inline TMem_set_fn KernelFor(const TMem_set_dispatch* table, size_t num)
+{
+    if ((table->stream != NULL_PTR) && (num >= MEM_SET_STREAM_THRESHOLD))
+    {
+        return table->stream;
+    }
+    if ((table->erms != NULL_PTR) && (num >= MEM_SET_ERMS_THRESHOLD))
+    {
+        return table->erms;
+    }
+
+    return table->vector;
+}
+
+/**
+ * @brief Hand a block of at least MEM_SET_KERNEL_MIN bytes to its kernel
+ * @note  Kept out of line so that the inline path of mem_set() needs no stack frame
+ */
+MEM_SET_NOINLINE
+static void MemSetLarge(uint8* dest, uint8 value, size_t num)
+{
+    KernelFor(CurrentTable(), num)(dest, value, num);
+}
 
 /**
  * @brief Fill a block of memory with a specified value
@@ -15,10 +382,10 @@
  * @param num Number of bytes to be set to the value
  * @return void* A pointer to the memory area dest, or NULL if dest is NULL
  * 
- * @note This implementation is optimized for performance while maintaining
- *       portability and safety with NULL pointer checks.
+ * @note Blocks below 256 bytes are filled inline with overlapping 16-byte (SSE2)
+ *       or 8-byte stores; larger blocks go to the kernel selected for their size.
  */
-void* mem_set(void* dest, sint32 value, uint32 num) 
+void* mem_set(void* dest, sint32 value, size_t num) 
 {
     uint8* ptr = (uint8*)dest;
     uint8 byte_value = (uint8)value;
@@ -28,10 +395,129 @@ void* mem_set(void* dest, sint32 value, uint32 num)
         return NULL_PTR;
     }
     
-    while (num-- > 0) 
+    if (num >= MEM_SET_KERNEL_MIN)
+    {
+        MemSetLarge(ptr, byte_value, num);
+    }
+#if (MEM_SET_X86 == 1U) && defined(__SSE2__)
+    else if (num >= 16U)
+    {
+        /* SSE2 is part of the x86-64 baseline: 16-byte stores plus an overlapping tail */
+        __m128i v = _mm_set1_epi8((char)byte_value);
+        for (size_t i = 0U; (i + 16U) < num; i += 16U)
+        {
+            _mm_storeu_si128((__m128i*)(ptr + i), v);
+        }
+        _mm_storeu_si128((__m128i*)(ptr + num - 16U), v);
+    }
+#endif
+    else if (num >= 8U)
+    {
+        /* Overlapping 8-byte stores from both ends */
+        uint64 pattern = (uint64)byte_value * 0x0101010101010101ULL;
+        uint8* end = ptr + num;
+        for (; (size_t)(end - ptr) > 8U; ptr += 8)
+        {
+            Store64(ptr, pattern);
+        }
+        Store64(end - 8, pattern);
+    }
+    else
     {
-        *ptr++ = byte_value;
+        while (num-- > 0U) 
+        {
+            *ptr++ = byte_value;
+        }
     }
     
     return dest;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Copy a block of memory to a non-overlapping destination
+ * 
+ * @param dest Pointer to the destination block
+ * @param src Pointer to the source block
+ * @param num Number of bytes to copy
+ * @return void* A pointer to the memory area dest, or NULL if dest or src is NULL
+ * 
+ * @note Blocks of up to 16 bytes are copied inline with two overlapping loads and
+ *       stores; larger blocks go to the C library, whose memcpy() already picks a
+ *       vector or rep movsb variant for the CPU.
+ */
+void* mem_cpy(void* dest, const void* src, size_t num)
+{
+    uint8* d = (uint8*)dest;
+    const uint8* s = (const uint8*)src;
+
+    if ((dest == NULL_PTR) || (src == NULL_PTR))
+    {
+        return NULL_PTR;
+    }
+
+    if (num > 16U)
+    {
+        (void)__builtin_memcpy(d, s, num);
+    }
+    else if (num >= 8U)
+    {
+        /* Both loads happen before the stores, so the halves may overlap */
+        uint64 head;
+        uint64 tail;
+        __builtin_memcpy(&head, s, sizeof(head));
+        __builtin_memcpy(&tail, s + num - 8U, sizeof(tail));
+        Store64(d, head);
+        Store64(d + num - 8U, tail);
+    }
+    else
+    {
+        while (num-- > 0U)
+        {
+            *d++ = *s++;
+        }
+    }
+
+    return dest;
+}
+
+/**
+ * @brief Pin mem_set() to one kernel, or restore the automatic choice
+ * 
+ * @param kernel Kernel to use for every block of 256 bytes and more, or MEM_SET_KERNEL_AUTO
+ * @return boolean TRUE if the CPU supports the kernel, FALSE otherwise (nothing changes)
+ */
+boolean mem_set_select(TMem_set_kernel kernel)
+{
+    if (KernelSupported(kernel) == FALSE)
+    {
+        return FALSE;
+    }
+
+    /* Blocks already being filled finish with the table they loaded */
+    (void)pthread_once(&g_mem_set_once, ResolveAll);
+    __atomic_store_n(&g_mem_set, &g_mem_set_tables[kernel], __ATOMIC_RELEASE);
+    return TRUE;
+}
+
+/**
+ * @brief Get the name of the kernel mem_set() uses for a block size
+ * 
+ * @param num Block size in bytes
+ * @return const char* Kernel name, e.g. "avx2" or "erms"
+ */
+const char* mem_set_kernel_name(size_t num)
+{
+    if (num < MEM_SET_KERNEL_MIN)
+    {
+        return "inline";
+    }
+
+    const TMem_set_dispatch* table = CurrentTable();
+    TMem_set_fn kernel = KernelFor(table, num);
+    if (kernel == table->vector)
+    {
+        return table->vector_name;
+    }
+
+    return (kernel == table->erms) ? "erms" : "stream";
+}
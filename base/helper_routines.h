@@ -8,6 +8,7 @@
 #ifndef HELPER_ROUTINES_H
 #define HELPER_ROUTINES_H
 
+#include <stddef.h>     /* For size_t */
 #include "std_types.h"  /* For standard types */
 
 /**
@@ -20,7 +21,57 @@
  * 
  * @note This is a custom implementation of the standard memset function.
  *       It handles NULL pointer checks and returns NULL if dest is NULL.
+ *       Blocks of 256 bytes and more are filled by the fastest kernel the CPU
+ *       supports, which is selected on the first call (see mem_set_select()).
  */
-void* mem_set(void* dest, sint32 value, uint32 num);
+void* mem_set(void* dest, sint32 value, size_t num);
+
+/**
+ * @brief Copy a block of memory to a non-overlapping destination
+ * 
+ * @param dest Pointer to the destination block
+ * @param src Pointer to the source block
+ * @param num Number of bytes to copy
+ * @return void* A pointer to the memory area dest
+ * 
+ * @note This is a custom implementation of the standard memcpy function.
+ *       It returns NULL if dest or src is NULL. Small blocks are copied inline,
+ *       larger ones by the C library's memcpy().
+ */
+void* mem_cpy(void* dest, const void* src, size_t num);
+
+/**
+ * @brief Kernels used by mem_set() for blocks of 256 bytes and more
+ */
+typedef enum {
+    MEM_SET_KERNEL_AUTO = 0,    /**< Best vector kernel, rep stosb and streaming by size */
+    MEM_SET_KERNEL_GENERIC,     /**< Portable 8-byte stores */
+    MEM_SET_KERNEL_SSE2,        /**< 16-byte SSE2 stores */
+    MEM_SET_KERNEL_AVX2,        /**< 32-byte AVX2 stores */
+    MEM_SET_KERNEL_AVX512,      /**< 64-byte AVX-512 stores */
+    MEM_SET_KERNEL_ERMS,        /**< rep stosb (Enhanced REP MOVSB/STOSB) */
+    MEM_SET_KERNEL_STREAM       /**< Non-temporal stores that bypass the caches */
+} TMem_set_kernel;
+
+/**
+ * @brief Pin mem_set() to one kernel, or restore the automatic choice
+ * 
+ * @param kernel Kernel to use for every block of 256 bytes and more, or MEM_SET_KERNEL_AUTO
+ * @return boolean TRUE if the CPU supports the kernel, FALSE otherwise (nothing changes)
+ * 
+ * @note Meant for tests and benchmarks. With MEM_SET_KERNEL_AUTO, blocks from
+ *       MEM_SET_ERMS_THRESHOLD bytes use rep stosb on ERMS CPUs, and blocks from
+ *       MEM_SET_STREAM_THRESHOLD bytes use non-temporal stores. Other threads
+ *       may be in mem_set() meanwhile; calls already running keep the old kernel.
+ */
+boolean mem_set_select(TMem_set_kernel kernel);
+
+/**
+ * @brief Get the name of the kernel mem_set() uses for a block size
+ * 
+ * @param num Block size in bytes
+ * @return const char* Kernel name, e.g. "avx2" or "erms"
+ */
+const char* mem_set_kernel_name(size_t num);
 
 #endif /* HELPER_ROUTINES_H */
@@ -0,0 +1,94 @@
+/**
+ * @file        bench.h
+ * @brief       Shared helpers and declarations for the stack allocator benchmarks
+ * @details     Benchmarks are host-side only (they use POSIX timers) and are run
+ *              with `make bench` or `make bench BENCH=<name>`.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <time.h>
+#include "std_types.h"
+
+/**
+ * @brief   Prevents the compiler from optimizing away a computed value
+ */
+#define BENCH_KEEP(value) __asm__ volatile("" : : "g"(value) : "memory")
+
+/**
+ * @brief   Returns a monotonic timestamp in nanoseconds
+ */
+static inline uint64 Bench_NowNs(void)
+{
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64)ts.tv_sec * 1000000000ULL) + (uint64)ts.tv_nsec;
+}
+
+/**
+ * @brief   Prints one result line: label, nanoseconds per operation and throughput
+ * @param   label  Name of the measured variant
+ * @param   ops    Number of operations performed
+ * @param   ns     Elapsed time in nanoseconds
+ */
+static inline void Bench_Report(const char* label, uint64 ops, uint64 ns)
+{
+    float64 ns_per_op = (ops != 0U) ? ((float64)ns / (float64)ops) : 0.0;
+    float64 mops = (ns != 0U) ? (((float64)ops * 1000.0) / (float64)ns) : 0.0;
+    printf("  %-40s %10.2f ns/op %10.1f Mops/s\n", label, ns_per_op, mops);
+}
+
+/* ========================= Benchmarks ========================= */
+
+/** @brief Throughput of StackAlloc_Alloc for a mix of small sizes */
+void Bench_Alloc(void);
+
+/** @brief Inline fast path versus the out-of-line StackAlloc_Alloc */
+void Bench_Inline(void);
+
+/** @brief Random access over 4 KiB versus 2 MiB backed arenas */
+void Bench_HugePage(void);
+
+/** @brief Thread-local arenas versus malloc/free at increasing thread counts */
+void Bench_Tls(void);
+
+/** @brief Lock-free shared arena versus a mutex-wrapped arena under contention */
+void Bench_Concurrent(void);
+
+/** @brief Leased thread arenas versus per-call atomic allocation at increasing thread counts */
+void Bench_Lease(void);
+
+/** @brief Per-CPU arenas versus thread-local arenas with four threads per CPU */
+void Bench_PerCpu(void);
+
+/** @brief mem_set() kernels versus libc memset() from 8 B to 64 MiB */
+void Bench_Memset(void);
+
+/** @brief StackAlloc_Calloc with and without known-zero tracking */
+void Bench_Calloc(void);
+
+/** @brief Page release policies of a virtual arena under rare large spikes */
+void Bench_Release(void);
+
+/** @brief Allocation latency percentiles and page faults of fresh, prefaulted and locked arenas */
+void Bench_Latency(void);
+
+/** @brief Bounds-checked inline fast path versus the unchecked guard-page path */
+void Bench_Guard(void);
+
+/** @brief Downward bump versus the upward path for a mix of sizes and alignments */
+void Bench_Down(void);
+
+/** @brief Per-block Push/Pop versus marker-based rewinding */
+void Bench_Header(void);
+
+/** @brief One StackAlloc_AllocAligned() call per array versus StackAlloc_AllocBatch() */
+void Bench_Batch(void);
+
+/** @brief Offline buffer planning versus naive stack ordering on inference graphs */
+void Bench_Plan(void);
+
+#endif /* BENCH_H */
@@ -0,0 +1,47 @@
+/**
+ * @file        bench_alloc.c
+ * @brief       Throughput benchmark for StackAlloc_Alloc
+ * @details     Allocates a repeating mix of small sizes and resets the arena
+ *              whenever it fills up. Build once with the default configuration
+ *              and once with EXTRA_CFLAGS=-DSTACK_ALLOC_POINTER_WIDTH_SIZE=0U
+ *              to compare the pointer-width and 32-bit size modes.
+ */
+
+#include "bench.h"
+#include "stack_alloc.h"
+#include <stdlib.h>
+
+#define BENCH_ALLOC_ARENA_SIZE  (16U * 1024U * 1024U)
+#define BENCH_ALLOC_ITERATIONS  (50000000U)
+
+static const TStack_alloc_size g_sizes[8] = { 8U, 16U, 24U, 40U, 64U, 100U, 256U, 13U };
+
+void Bench_Alloc(void)
+{
+    uint8* buffer = (uint8*)malloc(BENCH_ALLOC_ARENA_SIZE);
+    TStack_alloc sa;
+
+    if ((buffer == NULL_PTR) || (StackAlloc_Init(&sa, buffer, BENCH_ALLOC_ARENA_SIZE) != STACK_ALLOC_OK))
+    {
+        printf("  setup failed\n");
+        free(buffer);
+        return;
+    }
+
+    printf("  size mode: %u-bit\n", (uint32)(sizeof(TStack_alloc_size) * 8U));
+
+    uint64 start = Bench_NowNs();
+    for (uint32 i = 0U; i < BENCH_ALLOC_ITERATIONS; i++)
+    {
+        void* ptr = StackAlloc_Alloc(&sa, g_sizes[i & 7U]);
+        if (ptr == NULL_PTR)
+        {
+            StackAlloc_Reset(&sa);
+            ptr = StackAlloc_Alloc(&sa, g_sizes[i & 7U]);
+        }
+        BENCH_KEEP(ptr);
+    }
+    Bench_Report("StackAlloc_Alloc", BENCH_ALLOC_ITERATIONS, Bench_NowNs() - start);
+
+    free(buffer);
+}
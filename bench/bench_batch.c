@@ -0,0 +1,81 @@
+/**
+ * @file        bench_batch.c
+ * @brief       One StackAlloc_AllocAligned() call per array versus StackAlloc_AllocBatch()
+ * @details     Models a decoder that allocates 24 small arrays of mixed sizes and
+ *              alignments per record and frees the record with one marker. Reports the
+ *              time per array and the bytes a record occupies with each layout.
+ */
+
+#include "bench.h"
+#include "stack_alloc_batch.h"
+#include <stdlib.h>
+
+#define BENCH_BATCH_ARENA_SIZE  (64U * 1024U)
+#define BENCH_BATCH_RECORDS     (4000000U)
+#define BENCH_BATCH_ARRAYS      (24U)
+
+static const TStack_alloc_request g_record[BENCH_BATCH_ARRAYS] = {
+    { 6U, 1U },  { 24U, 8U }, { 10U, 2U }, { 32U, 16U }, { 12U, 4U }, { 3U, 1U },
+    { 40U, 8U }, { 64U, 64U }, { 2U, 2U }, { 20U, 4U },  { 16U, 8U }, { 9U, 1U },
+    { 48U, 16U }, { 4U, 4U }, { 14U, 2U }, { 8U, 8U },   { 5U, 1U },  { 28U, 4U },
+    { 56U, 8U }, { 1U, 1U },  { 96U, 32U }, { 6U, 2U },  { 36U, 4U }, { 11U, 1U }
+};
+
+void Bench_Batch(void)
+{
+    uint8* buffer = (uint8*)malloc(BENCH_BATCH_ARENA_SIZE);
+    void* blocks[BENCH_BATCH_ARRAYS];
+    TStack_alloc_size bytes[3] = { 0U, 0U, 0U };
+    TStack_alloc sa;
+
+    if ((buffer == NULL_PTR) || (StackAlloc_Init(&sa, buffer, BENCH_BATCH_ARENA_SIZE) != STACK_ALLOC_OK))
+    {
+        printf("  setup failed\n");
+        free(buffer);
+        return;
+    }
+
+    const uint64 ops = (uint64)BENCH_BATCH_RECORDS * BENCH_BATCH_ARRAYS;
+    void* mark = StackAlloc_GetMarker(&sa);
+
+    /* One call per array */
+    uint64 start = Bench_NowNs();
+    for (uint32 record = 0U; record < BENCH_BATCH_RECORDS; record++)
+    {
+        for (uint32 i = 0U; i < BENCH_BATCH_ARRAYS; i++)
+        {
+            blocks[i] = StackAlloc_AllocAligned(&sa, g_record[i].size, g_record[i].alignment);
+        }
+        BENCH_KEEP(blocks[BENCH_BATCH_ARRAYS - 1U]);
+        bytes[0] = StackAlloc_GetUsed(&sa);
+        (void)StackAlloc_FreeToMarker(&sa, mark);
+    }
+    Bench_Report("AllocAligned per array", ops, Bench_NowNs() - start);
+
+    /* One batch in caller order */
+    start = Bench_NowNs();
+    for (uint32 record = 0U; record < BENCH_BATCH_RECORDS; record++)
+    {
+        (void)StackAlloc_AllocBatch(&sa, g_record, BENCH_BATCH_ARRAYS, blocks, STACK_ALLOC_BATCH_DEFAULT);
+        BENCH_KEEP(blocks[BENCH_BATCH_ARRAYS - 1U]);
+        bytes[1] = StackAlloc_GetUsed(&sa);
+        (void)StackAlloc_FreeToMarker(&sa, mark);
+    }
+    Bench_Report("AllocBatch", ops, Bench_NowNs() - start);
+
+    /* One batch, placed by alignment */
+    start = Bench_NowNs();
+    for (uint32 record = 0U; record < BENCH_BATCH_RECORDS; record++)
+    {
+        (void)StackAlloc_AllocBatch(&sa, g_record, BENCH_BATCH_ARRAYS, blocks, STACK_ALLOC_BATCH_REORDER);
+        BENCH_KEEP(blocks[BENCH_BATCH_ARRAYS - 1U]);
+        bytes[2] = StackAlloc_GetUsed(&sa);
+        (void)StackAlloc_FreeToMarker(&sa, mark);
+    }
+    Bench_Report("AllocBatch (reordered)", ops, Bench_NowNs() - start);
+
+    printf("  bytes per record: per array %lu, batch %lu, reordered %lu\n",
+           (unsigned long)bytes[0], (unsigned long)bytes[1], (unsigned long)bytes[2]);
+
+    free(buffer);
+}
@@ -0,0 +1,99 @@
+/**
+ * @file        bench_calloc.c
+ * @brief       StackAlloc_Calloc with and without known-zero tracking
+ * @details     Two patterns: a request loop that resets the arena and callocs a few
+ *              blocks per request (the steady state re-zeroes dirty memory either way),
+ *              and a first pass of large callocs over fresh anonymous memory, where
+ *              the known-zero watermark skips the zeroing and the page faults with it.
+ */
+
+#include "bench.h"
+#include "stack_alloc.h"
+#include "stack_alloc_chain.h"
+#include "stack_alloc_vm.h"
+
+#define BENCH_CALLOC_ARENA        (4U * 1024U * 1024U)
+#define BENCH_CALLOC_REQUESTS     (20000U)
+#define BENCH_CALLOC_FRESH_SIZE   (256U * 1024U * 1024U)
+#define BENCH_CALLOC_FRESH_BLOCK  (1024U * 1024U)
+
+static const TStack_alloc_size g_request_sizes[8] = { 256U, 4096U, 1024U, 65536U, 512U, 16384U, 128U, 8192U };
+
+/**
+ * @brief   Runs the reset-and-calloc request loop
+ */
+static void RunRequests(TStack_alloc* sa, const char* label)
+{
+    uint64 start = Bench_NowNs();
+    for (uint32 r = 0U; r < BENCH_CALLOC_REQUESTS; r++)
+    {
+        for (uint32 b = 0U; b < 8U; b++)
+        {
+            uint8* block = (uint8*)StackAlloc_Calloc(sa, 1U, g_request_sizes[(r + b) & 7U]);
+            block[0] = (uint8)r;
+            BENCH_KEEP(block);
+        }
+        StackAlloc_Reset(sa);
+    }
+    Bench_Report(label, BENCH_CALLOC_REQUESTS, Bench_NowNs() - start);
+}
+
+/**
+ * @brief   Callocs the whole arena in large blocks once
+ */
+static void RunFresh(TStack_alloc* sa, const char* label)
+{
+    uint32 blocks = BENCH_CALLOC_FRESH_SIZE / BENCH_CALLOC_FRESH_BLOCK;
+
+    uint64 start = Bench_NowNs();
+    for (uint32 i = 0U; i < blocks; i++)
+    {
+        void* block = StackAlloc_Calloc(sa, 1U, BENCH_CALLOC_FRESH_BLOCK - 64U);
+        BENCH_KEEP(block);
+    }
+    Bench_Report(label, blocks, Bench_NowNs() - start);
+}
+
+void Bench_Calloc(void)
+{
+    TStack_alloc_provider mmap_provider = StackAlloc_MmapProvider();
+    TStack_alloc sa;
+
+    /* Reset-and-calloc per request */
+    uint8* buffer = (uint8*)mmap_provider.acquire(mmap_provider.ctx, BENCH_CALLOC_ARENA);
+    if (buffer == NULL_PTR)
+    {
+        printf("  setup failed\n");
+        return;
+    }
+    (void)StackAlloc_Init(&sa, buffer, BENCH_CALLOC_ARENA);
+    RunRequests(&sa, "request loop, Init (always zero)");
+    mmap_provider.release(mmap_provider.ctx, buffer, BENCH_CALLOC_ARENA);
+
+    buffer = (uint8*)mmap_provider.acquire(mmap_provider.ctx, BENCH_CALLOC_ARENA);
+    if (buffer == NULL_PTR)
+    {
+        printf("  setup failed\n");
+        return;
+    }
+    (void)StackAlloc_InitZeroed(&sa, buffer, BENCH_CALLOC_ARENA);
+    RunRequests(&sa, "request loop, InitZeroed (known zero)");
+    mmap_provider.release(mmap_provider.ctx, buffer, BENCH_CALLOC_ARENA);
+
+    /* First pass over fresh memory, per 1 MiB calloc */
+    buffer = (uint8*)mmap_provider.acquire(mmap_provider.ctx, BENCH_CALLOC_FRESH_SIZE);
+    if (buffer == NULL_PTR)
+    {
+        printf("  setup failed\n");
+        return;
+    }
+    (void)StackAlloc_Init(&sa, buffer, BENCH_CALLOC_FRESH_SIZE);
+    RunFresh(&sa, "fresh 1 MiB callocs, Init");
+    mmap_provider.release(mmap_provider.ctx, buffer, BENCH_CALLOC_FRESH_SIZE);
+
+    if (StackAlloc_InitVirtual(&sa, BENCH_CALLOC_FRESH_SIZE, 0U) == STACK_ALLOC_OK)
+    {
+        RunFresh(&sa, "fresh 1 MiB callocs, virtual arena");
+        StackAlloc_Deinit(&sa);
+    }
+}
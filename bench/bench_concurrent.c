@@ -0,0 +1,117 @@
+/**
+ * @file        bench_concurrent.c
+ * @brief       Lock-free shared arena versus a mutex-wrapped arena under contention
+ * @details     All threads allocate small blocks from one arena at the same time,
+ *              either with StackAlloc_AllocConcurrent() or with StackAlloc_Alloc()
+ *              inside a pthread mutex. Runs with 1, 2, 4, ... threads up to at least
+ *              4 (or the number of online CPUs).
+ */
+
+#include "bench.h"
+#include "stack_alloc_concurrent.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define BENCH_CONC_ITERATIONS   (1000000U)
+#define BENCH_CONC_BLOCK        (16U)
+#define BENCH_CONC_MAX_THREADS  (16U)
+
+typedef struct {
+    TStack_alloc sa;
+    pthread_mutex_t lock;
+    pthread_barrier_t barrier;
+    boolean use_mutex;
+} TBench_conc_job;
+
+static void* ConcWorker(void* arg)
+{
+    TBench_conc_job* job = (TBench_conc_job*)arg;
+
+    (void)pthread_barrier_wait(&job->barrier);
+
+    if (job->use_mutex == TRUE)
+    {
+        for (uint32 i = 0U; i < BENCH_CONC_ITERATIONS; i++)
+        {
+            (void)pthread_mutex_lock(&job->lock);
+            void* ptr = StackAlloc_Alloc(&job->sa, BENCH_CONC_BLOCK);
+            (void)pthread_mutex_unlock(&job->lock);
+            BENCH_KEEP(ptr);
+        }
+    }
+    else
+    {
+        for (uint32 i = 0U; i < BENCH_CONC_ITERATIONS; i++)
+        {
+            void* ptr = StackAlloc_AllocConcurrent(&job->sa, BENCH_CONC_BLOCK);
+            BENCH_KEEP(ptr);
+        }
+    }
+
+    (void)pthread_barrier_wait(&job->barrier);
+
+    return NULL_PTR;
+}
+
+/**
+ * @brief   Runs one configuration and reports the aggregate throughput
+ */
+static void RunThreads(uint32 threads, boolean use_mutex)
+{
+    TStack_alloc_size size = (TStack_alloc_size)threads * BENCH_CONC_ITERATIONS * BENCH_CONC_BLOCK;
+    uint8* buffer = (uint8*)malloc(size);
+    pthread_t ids[BENCH_CONC_MAX_THREADS];
+    TBench_conc_job job;
+    char label[64];
+
+    if ((buffer == NULL_PTR) || (StackAlloc_Init(&job.sa, buffer, size) != STACK_ALLOC_OK))
+    {
+        printf("  setup failed\n");
+        free(buffer);
+        return;
+    }
+    job.use_mutex = use_mutex;
+    (void)pthread_mutex_init(&job.lock, NULL_PTR);
+    (void)pthread_barrier_init(&job.barrier, NULL_PTR, threads + 1U);
+
+    for (uint32 t = 0U; t < threads; t++)
+    {
+        (void)pthread_create(&ids[t], NULL_PTR, ConcWorker, &job);
+    }
+
+    (void)pthread_barrier_wait(&job.barrier);
+    uint64 start = Bench_NowNs();
+    (void)pthread_barrier_wait(&job.barrier);
+    uint64 elapsed = Bench_NowNs() - start;
+
+    for (uint32 t = 0U; t < threads; t++)
+    {
+        (void)pthread_join(ids[t], NULL_PTR);
+    }
+    (void)pthread_barrier_destroy(&job.barrier);
+    (void)pthread_mutex_destroy(&job.lock);
+
+    (void)snprintf(label, sizeof(label), "%s, %u thread(s)",
+                   (use_mutex == TRUE) ? "mutex + StackAlloc_Alloc" : "StackAlloc_AllocConcurrent", threads);
+    Bench_Report(label, (uint64)threads * BENCH_CONC_ITERATIONS, elapsed);
+
+    free(buffer);
+}
+
+void Bench_Concurrent(void)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32 max_threads = (cpus > 4) ? (uint32)cpus : 4U;
+
+    if (max_threads > BENCH_CONC_MAX_THREADS)
+    {
+        max_threads = BENCH_CONC_MAX_THREADS;
+    }
+
+    for (uint32 threads = 1U; threads <= max_threads; threads *= 2U)
+    {
+        RunThreads(threads, FALSE);
+        RunThreads(threads, TRUE);
+    }
+}
@@ -0,0 +1,112 @@
+/**
+ * @file        bench_down.c
+ * @brief       Downward bump versus the upward StackAlloc_Alloc path
+ * @details     Runs the same mix of sizes and alignments through the upward allocators
+ *              (out-of-line and inline) and through the downward inline path of
+ *              stack_alloc_down.h, resetting the arena whenever it is full.
+ */
+
+#include "bench.h"
+#include "stack_alloc_down.h"
+#include <stdlib.h>
+
+#define BENCH_DOWN_ARENA_SIZE  (16U * 1024U * 1024U)
+#define BENCH_DOWN_ITERATIONS  (100000000U)
+
+static const TStack_alloc_size g_sizes[8]      = { 8U, 16U, 24U, 40U, 64U, 100U, 256U, 13U };
+static const TStack_alloc_size g_alignments[8] = { 8U, 16U, 4U, 8U, 64U, 1U, 32U, 2U };
+
+void Bench_Down(void)
+{
+    uint8* buffer = (uint8*)malloc(BENCH_DOWN_ARENA_SIZE);
+    TStack_alloc up;
+    TStack_alloc down;
+
+    if ((buffer == NULL_PTR) || (StackAlloc_Init(&up, buffer, BENCH_DOWN_ARENA_SIZE) != STACK_ALLOC_OK) ||
+        (StackAlloc_InitDown(&down, buffer, BENCH_DOWN_ARENA_SIZE) != STACK_ALLOC_OK))
+    {
+        printf("  setup failed\n");
+        free(buffer);
+        return;
+    }
+
+    /* Default alignment, mixed sizes */
+    uint64 start = Bench_NowNs();
+    for (uint32 i = 0U; i < BENCH_DOWN_ITERATIONS; i++)
+    {
+        void* ptr = StackAlloc_Alloc(&up, g_sizes[i & 7U]);
+        if (ptr == NULL_PTR)
+        {
+            StackAlloc_Reset(&up);
+        }
+        BENCH_KEEP(ptr);
+    }
+    Bench_Report("up:   StackAlloc_Alloc", BENCH_DOWN_ITERATIONS, Bench_NowNs() - start);
+
+    StackAlloc_Reset(&up);
+    start = Bench_NowNs();
+    for (uint32 i = 0U; i < BENCH_DOWN_ITERATIONS; i++)
+    {
+        void* ptr = StackAlloc_AllocInline(&up, g_sizes[i & 7U]);
+        if (ptr == NULL_PTR)
+        {
+            StackAlloc_Reset(&up);
+        }
+        BENCH_KEEP(ptr);
+    }
+    Bench_Report("up:   StackAlloc_AllocInline", BENCH_DOWN_ITERATIONS, Bench_NowNs() - start);
+
+    start = Bench_NowNs();
+    for (uint32 i = 0U; i < BENCH_DOWN_ITERATIONS; i++)
+    {
+        void* ptr = StackAlloc_AllocDownInline(&down, g_sizes[i & 7U]);
+        if (ptr == NULL_PTR)
+        {
+            StackAlloc_Reset(&down);
+        }
+        BENCH_KEEP(ptr);
+    }
+    Bench_Report("down: StackAlloc_AllocDownInline", BENCH_DOWN_ITERATIONS, Bench_NowNs() - start);
+
+    /* Mixed sizes and alignments */
+    StackAlloc_Reset(&up);
+    start = Bench_NowNs();
+    for (uint32 i = 0U; i < BENCH_DOWN_ITERATIONS; i++)
+    {
+        void* ptr = StackAlloc_AllocAligned(&up, g_sizes[i & 7U], g_alignments[i & 7U]);
+        if (ptr == NULL_PTR)
+        {
+            StackAlloc_Reset(&up);
+        }
+        BENCH_KEEP(ptr);
+    }
+    Bench_Report("up:   StackAlloc_AllocAligned", BENCH_DOWN_ITERATIONS, Bench_NowNs() - start);
+
+    StackAlloc_Reset(&up);
+    start = Bench_NowNs();
+    for (uint32 i = 0U; i < BENCH_DOWN_ITERATIONS; i++)
+    {
+        void* ptr = StackAlloc_AllocAlignedInline(&up, g_sizes[i & 7U], g_alignments[i & 7U]);
+        if (ptr == NULL_PTR)
+        {
+            StackAlloc_Reset(&up);
+        }
+        BENCH_KEEP(ptr);
+    }
+    Bench_Report("up:   StackAlloc_AllocAlignedInline", BENCH_DOWN_ITERATIONS, Bench_NowNs() - start);
+
+    StackAlloc_Reset(&down);
+    start = Bench_NowNs();
+    for (uint32 i = 0U; i < BENCH_DOWN_ITERATIONS; i++)
+    {
+        void* ptr = StackAlloc_AllocAlignedDownInline(&down, g_sizes[i & 7U], g_alignments[i & 7U]);
+        if (ptr == NULL_PTR)
+        {
+            StackAlloc_Reset(&down);
+        }
+        BENCH_KEEP(ptr);
+    }
+    Bench_Report("down: StackAlloc_AllocAlignedDownInline", BENCH_DOWN_ITERATIONS, Bench_NowNs() - start);
+
+    free(buffer);
+}
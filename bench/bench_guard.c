@@ -0,0 +1,62 @@
+/**
+ * @file        bench_guard.c
+ * @brief       Bounds-checked inline fast path versus the unchecked guard-page path
+ * @details     Each request allocates 1024 small blocks from a guarded arena, writes
+ *              the first byte of each (as the unchecked path requires) and resets the
+ *              arena. The checked variant also has to test every result for NULL.
+ */
+
+#include "bench.h"
+#include "stack_alloc_guard.h"
+
+#define BENCH_GUARD_ARENA_SIZE   (1024U * 1024U)
+#define BENCH_GUARD_BLOCKS       (1024U)
+#define BENCH_GUARD_REQUESTS     (100000U)
+
+static const TStack_alloc_size g_sizes[8] = { 8U, 16U, 24U, 40U, 64U, 100U, 256U, 13U };
+
+void Bench_Guard(void)
+{
+    TStack_alloc sa;
+    uint32 failures = 0U;
+
+    if (StackAlloc_InitGuarded(&sa, BENCH_GUARD_ARENA_SIZE) != STACK_ALLOC_OK)
+    {
+        printf("  setup failed\n");
+        return;
+    }
+
+    uint64 start = Bench_NowNs();
+    for (uint32 r = 0U; r < BENCH_GUARD_REQUESTS; r++)
+    {
+        for (uint32 i = 0U; i < BENCH_GUARD_BLOCKS; i++)
+        {
+            uint8* ptr = (uint8*)StackAlloc_AllocInline(&sa, g_sizes[i & 7U]);
+            if (ptr == NULL_PTR)
+            {
+                failures++;
+                break;
+            }
+            ptr[0] = (uint8)i;
+        }
+        StackAlloc_Reset(&sa);
+    }
+    Bench_Report("StackAlloc_AllocInline (checked)", (uint64)BENCH_GUARD_REQUESTS * BENCH_GUARD_BLOCKS,
+                 Bench_NowNs() - start);
+
+    start = Bench_NowNs();
+    for (uint32 r = 0U; r < BENCH_GUARD_REQUESTS; r++)
+    {
+        for (uint32 i = 0U; i < BENCH_GUARD_BLOCKS; i++)
+        {
+            uint8* ptr = (uint8*)StackAlloc_AllocUnchecked(&sa, g_sizes[i & 7U]);
+            ptr[0] = (uint8)i;
+        }
+        StackAlloc_Reset(&sa);
+    }
+    Bench_Report("StackAlloc_AllocUnchecked (guard page)", (uint64)BENCH_GUARD_REQUESTS * BENCH_GUARD_BLOCKS,
+                 Bench_NowNs() - start);
+
+    BENCH_KEEP(failures);
+    StackAlloc_Deinit(&sa);
+}
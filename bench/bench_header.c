@@ -0,0 +1,88 @@
+/**
+ * @file        bench_header.c
+ * @brief       Per-block Push/Pop versus marker-based rewinding
+ * @details     Each frame allocates 64 blocks of mixed sizes and frees them again newest
+ *              first: one marker per block, one size record per block (StackAlloc_Pop),
+ *              and, as a lower bound, a single marker for the whole frame. Also prints the
+ *              bytes a frame occupies, which shows the space cost of the records.
+ */
+
+#include "bench.h"
+#include "stack_alloc_header.h"
+#include <stdlib.h>
+
+#define BENCH_HEADER_ARENA_SIZE  (1024U * 1024U)
+#define BENCH_HEADER_FRAMES      (2000000U)
+#define BENCH_HEADER_BLOCKS      (64U)
+
+static const TStack_alloc_size g_sizes[8] = { 8U, 16U, 24U, 40U, 64U, 100U, 256U, 13U };
+
+void Bench_Header(void)
+{
+    uint8* buffer = (uint8*)malloc(BENCH_HEADER_ARENA_SIZE);
+    void* markers[BENCH_HEADER_BLOCKS];
+    TStack_alloc_size peak[3] = { 0U, 0U, 0U };
+    TStack_alloc sa;
+
+    if ((buffer == NULL_PTR) || (StackAlloc_Init(&sa, buffer, BENCH_HEADER_ARENA_SIZE) != STACK_ALLOC_OK))
+    {
+        printf("  setup failed\n");
+        free(buffer);
+        return;
+    }
+
+    const uint64 ops = (uint64)BENCH_HEADER_FRAMES * BENCH_HEADER_BLOCKS;
+
+    /* A marker per block */
+    uint64 start = Bench_NowNs();
+    for (uint32 frame = 0U; frame < BENCH_HEADER_FRAMES; frame++)
+    {
+        for (uint32 i = 0U; i < BENCH_HEADER_BLOCKS; i++)
+        {
+            markers[i] = StackAlloc_GetMarker(&sa);
+            BENCH_KEEP(StackAlloc_Alloc(&sa, g_sizes[(frame + i) & 7U]));
+        }
+        peak[0] = StackAlloc_GetUsed(&sa);
+        for (uint32 i = BENCH_HEADER_BLOCKS; i-- > 0U;)
+        {
+            (void)StackAlloc_FreeToMarker(&sa, markers[i]);
+        }
+    }
+    Bench_Report("Alloc + FreeToMarker per block", ops, Bench_NowNs() - start);
+
+    /* A size record per block */
+    start = Bench_NowNs();
+    for (uint32 frame = 0U; frame < BENCH_HEADER_FRAMES; frame++)
+    {
+        for (uint32 i = 0U; i < BENCH_HEADER_BLOCKS; i++)
+        {
+            BENCH_KEEP(StackAlloc_Push(&sa, g_sizes[(frame + i) & 7U]));
+        }
+        peak[1] = StackAlloc_GetUsed(&sa);
+        for (uint32 i = 0U; i < BENCH_HEADER_BLOCKS; i++)
+        {
+            (void)StackAlloc_Pop(&sa);
+        }
+    }
+    Bench_Report("Push + Pop", ops, Bench_NowNs() - start);
+
+    /* One marker for the whole frame */
+    start = Bench_NowNs();
+    for (uint32 frame = 0U; frame < BENCH_HEADER_FRAMES; frame++)
+    {
+        void* mark = StackAlloc_GetMarker(&sa);
+        for (uint32 i = 0U; i < BENCH_HEADER_BLOCKS; i++)
+        {
+            BENCH_KEEP(StackAlloc_Alloc(&sa, g_sizes[(frame + i) & 7U]));
+        }
+        peak[2] = StackAlloc_GetUsed(&sa);
+        (void)StackAlloc_FreeToMarker(&sa, mark);
+    }
+    Bench_Report("Alloc + one FreeToMarker per frame", ops, Bench_NowNs() - start);
+
+    printf("  bytes per frame: markers %lu, records %lu (+%.1f B/block)\n",
+           (unsigned long)peak[0], (unsigned long)peak[1],
+           ((float64)peak[1] - (float64)peak[0]) / (float64)BENCH_HEADER_BLOCKS);
+
+    free(buffer);
+}
@@ -0,0 +1,79 @@
+/**
+ * @file        bench_hugepage.c
+ * @brief       Random-access latency over arenas backed by 4 KiB and 2 MiB pages
+ * @details     Fills a large arena, then performs dependent random reads across it.
+ *              With regular pages nearly every read misses the TLB; with huge pages
+ *              the working set is covered by far fewer TLB entries.
+ */
+
+#include "bench.h"
+#include "stack_alloc_vm.h"
+
+#define BENCH_HUGE_ARENA_SIZE  (512U * 1024U * 1024U)
+#define BENCH_HUGE_READS       (20000000U)
+
+static const char* PageKindName(TStack_alloc_page_kind kind)
+{
+    switch (kind)
+    {
+        case STACK_ALLOC_PAGES_HUGETLB: return "hugetlb 2 MiB";
+        case STACK_ALLOC_PAGES_THP:     return "THP 2 MiB";
+        default:                        return "4 KiB";
+    }
+}
+
+static void RunRandomAccess(TStack_alloc_vm_flags flags)
+{
+    TStack_alloc sa;
+    char label[64];
+
+    if (StackAlloc_InitVirtualEx(&sa, BENCH_HUGE_ARENA_SIZE, BENCH_HUGE_ARENA_SIZE, flags) != STACK_ALLOC_OK)
+    {
+        printf("  setup failed\n");
+        return;
+    }
+
+    /* Build a random cyclic chain of word indices so every read depends on the previous one */
+    uint64 count = BENCH_HUGE_ARENA_SIZE / sizeof(uint64);
+    uint64* words = (uint64*)StackAlloc_Alloc(&sa, BENCH_HUGE_ARENA_SIZE);
+    if (words == NULL_PTR)
+    {
+        printf("  allocation failed\n");
+        StackAlloc_Deinit(&sa);
+        return;
+    }
+
+    uint64 state = 0x9E3779B97F4A7C15ULL;
+    for (uint64 i = 0U; i < count; i++)
+    {
+        words[i] = i;
+    }
+    for (uint64 i = count - 1U; i > 0U; i--)
+    {
+        state = (state * 6364136223846793005ULL) + 1442695040888963407ULL;
+        uint64 j = (state >> 17) % i;  /* Sattolo: one single cycle */
+        uint64 tmp = words[i];
+        words[i] = words[j];
+        words[j] = tmp;
+    }
+
+    uint64 index = 0U;
+    uint64 start = Bench_NowNs();
+    for (uint32 i = 0U; i < BENCH_HUGE_READS; i++)
+    {
+        index = words[index];
+    }
+    uint64 elapsed = Bench_NowNs() - start;
+    BENCH_KEEP(index);
+
+    (void)snprintf(label, sizeof(label), "random read, %s pages", PageKindName(StackAlloc_GetPageKind(&sa)));
+    Bench_Report(label, BENCH_HUGE_READS, elapsed);
+
+    StackAlloc_Deinit(&sa);
+}
+
+void Bench_HugePage(void)
+{
+    RunRandomAccess(STACK_ALLOC_VM_DEFAULT);
+    RunRandomAccess(STACK_ALLOC_VM_HUGE_PAGES);
+}
@@ -0,0 +1,55 @@
+/**
+ * @file        bench_inline.c
+ * @brief       Inline fast path versus out-of-line StackAlloc_Alloc
+ * @details     Runs the same tight allocation loop through StackAlloc_Alloc() and
+ *              through StackAlloc_AllocInline() from stack_alloc_inline.h.
+ */
+
+#include "bench.h"
+#include "stack_alloc_inline.h"
+#include <stdlib.h>
+
+#define BENCH_INLINE_ARENA_SIZE  (16U * 1024U * 1024U)
+#define BENCH_INLINE_ITERATIONS  (100000000U)
+
+static const TStack_alloc_size g_sizes[8] = { 8U, 16U, 24U, 40U, 64U, 100U, 256U, 13U };
+
+void Bench_Inline(void)
+{
+    uint8* buffer = (uint8*)malloc(BENCH_INLINE_ARENA_SIZE);
+    TStack_alloc sa;
+
+    if ((buffer == NULL_PTR) || (StackAlloc_Init(&sa, buffer, BENCH_INLINE_ARENA_SIZE) != STACK_ALLOC_OK))
+    {
+        printf("  setup failed\n");
+        free(buffer);
+        return;
+    }
+
+    uint64 start = Bench_NowNs();
+    for (uint32 i = 0U; i < BENCH_INLINE_ITERATIONS; i++)
+    {
+        void* ptr = StackAlloc_Alloc(&sa, g_sizes[i & 7U]);
+        if (ptr == NULL_PTR)
+        {
+            StackAlloc_Reset(&sa);
+        }
+        BENCH_KEEP(ptr);
+    }
+    Bench_Report("StackAlloc_Alloc (out-of-line)", BENCH_INLINE_ITERATIONS, Bench_NowNs() - start);
+
+    StackAlloc_Reset(&sa);
+    start = Bench_NowNs();
+    for (uint32 i = 0U; i < BENCH_INLINE_ITERATIONS; i++)
+    {
+        void* ptr = StackAlloc_AllocInline(&sa, g_sizes[i & 7U]);
+        if (ptr == NULL_PTR)
+        {
+            StackAlloc_Reset(&sa);
+        }
+        BENCH_KEEP(ptr);
+    }
+    Bench_Report("StackAlloc_AllocInline", BENCH_INLINE_ITERATIONS, Bench_NowNs() - start);
+
+    free(buffer);
+}
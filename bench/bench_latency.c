@@ -0,0 +1,86 @@
+/**
+ * @file        bench_latency.c
+ * @brief       Per-allocation latency of fresh arenas with and without prefaulting
+ * @details     Times each StackAlloc_Alloc() plus the first write to the block, over
+ *              a series of fresh arenas, and reports the percentiles together with the
+ *              minor page faults taken during the timed loop (getrusage). Prefaulted
+ *              and locked arenas move the faults into initialization, whose cost is
+ *              reported separately. The arena fits the default RLIMIT_MEMLOCK of 8 MiB.
+ */
+
+#include "bench.h"
+#include "stack_alloc.h"
+#include "stack_alloc_vm.h"
+#include <stdlib.h>
+#include <sys/resource.h>
+
+#define BENCH_LATENCY_ARENA    (6U * 1024U * 1024U)
+#define BENCH_LATENCY_BLOCK    (4096U)
+#define BENCH_LATENCY_BLOCKS   (BENCH_LATENCY_ARENA / BENCH_LATENCY_BLOCK)
+#define BENCH_LATENCY_ROUNDS   (16U)
+
+static uint32 g_samples[BENCH_LATENCY_ROUNDS * BENCH_LATENCY_BLOCKS];
+
+static int CompareSamples(const void* a, const void* b)
+{
+    uint32 x = *(const uint32*)a;
+    uint32 y = *(const uint32*)b;
+    return (x > y) - (x < y);
+}
+
+static long MinorFaults(void)
+{
+    struct rusage usage;
+    (void)getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+}
+
+/**
+ * @brief   Measures one arena configuration
+ */
+static void RunLatency(TStack_alloc_vm_flags flags, const char* label)
+{
+    uint32 count = 0U;
+    uint64 init_ns = 0U;
+    long faults = 0;
+
+    for (uint32 round = 0U; round < BENCH_LATENCY_ROUNDS; round++)
+    {
+        TStack_alloc sa;
+        uint64 start = Bench_NowNs();
+        TStack_alloc_error err = StackAlloc_InitVirtualEx(&sa, BENCH_LATENCY_ARENA, 0U, flags);
+        init_ns += Bench_NowNs() - start;
+        if (err != STACK_ALLOC_OK)
+        {
+            printf("  %-40s unavailable (error %u)\n", label, (unsigned)err);
+            return;
+        }
+
+        long faults_before = MinorFaults();
+        for (uint32 i = 0U; i < BENCH_LATENCY_BLOCKS; i++)
+        {
+            uint64 t0 = Bench_NowNs();
+            uint8* block = (uint8*)StackAlloc_Alloc(&sa, BENCH_LATENCY_BLOCK);
+            block[0] = (uint8)i;
+            uint64 t1 = Bench_NowNs();
+            g_samples[count++] = (uint32)(t1 - t0);
+        }
+        faults += MinorFaults() - faults_before;
+
+        StackAlloc_Deinit(&sa);
+    }
+
+    qsort(g_samples, count, sizeof(g_samples[0]), CompareSamples);
+    printf("  %-40s p50 %5u  p99 %5u  p99.9 %6u  max %7u ns\n", label,
+           (unsigned)g_samples[count / 2U], (unsigned)g_samples[(count * 99U) / 100U],
+           (unsigned)g_samples[(count * 999U) / 1000U], (unsigned)g_samples[count - 1U]);
+    printf("    %ld minor faults in %u allocations, init %.1f us per arena\n",
+           faults, (unsigned)count, (double)init_ns / (1000.0 * (double)BENCH_LATENCY_ROUNDS));
+}
+
+void Bench_Latency(void)
+{
+    RunLatency(STACK_ALLOC_VM_DEFAULT,  "commit on demand");
+    RunLatency(STACK_ALLOC_VM_PREFAULT, "STACK_ALLOC_VM_PREFAULT");
+    RunLatency(STACK_ALLOC_VM_LOCKED,   "STACK_ALLOC_VM_LOCKED");
+}
@@ -0,0 +1,121 @@
+/**
+ * @file        bench_lease.c
+ * @brief       Scaling of leased thread arenas versus per-call atomic allocation
+ * @details     All threads allocate small blocks out of one shared arena, either with
+ *              StackAlloc_AllocConcurrent() on every call or through a thread arena that
+ *              leases 64 KiB chunks from it. Runs with 1, 2, 4, ... threads up to at
+ *              least 4 (or the number of online CPUs); leased throughput should grow
+ *              almost linearly with the number of cores.
+ */
+
+#include "bench.h"
+#include "stack_alloc_concurrent.h"
+#include "stack_alloc_inline.h"
+#include "stack_alloc_lease.h"
+#include <stdlib.h>
+#include <unistd.h>
+
+#define BENCH_LEASE_ITERATIONS   (2000000U)
+#define BENCH_LEASE_BLOCK        (16U)
+#define BENCH_LEASE_MAX_THREADS  (16U)
+
+typedef struct {
+    TStack_alloc sa;
+    TStack_alloc_lease_pool pool;
+    pthread_barrier_t barrier;
+    boolean leased;
+} TBench_lease_job;
+
+static void* LeaseWorker(void* arg)
+{
+    TBench_lease_job* job = (TBench_lease_job*)arg;
+    TStack_alloc local;
+
+    (void)StackAlloc_InitLeased(&local, &job->pool);
+    (void)pthread_barrier_wait(&job->barrier);
+
+    if (job->leased == TRUE)
+    {
+        for (uint32 i = 0U; i < BENCH_LEASE_ITERATIONS; i++)
+        {
+            void* ptr = StackAlloc_AllocInline(&local, BENCH_LEASE_BLOCK);
+            BENCH_KEEP(ptr);
+        }
+    }
+    else
+    {
+        for (uint32 i = 0U; i < BENCH_LEASE_ITERATIONS; i++)
+        {
+            void* ptr = StackAlloc_AllocConcurrent(&job->sa, BENCH_LEASE_BLOCK);
+            BENCH_KEEP(ptr);
+        }
+    }
+
+    (void)pthread_barrier_wait(&job->barrier);
+    StackAlloc_Deinit(&local);
+
+    return NULL_PTR;
+}
+
+/**
+ * @brief   Runs one configuration and reports the aggregate throughput
+ */
+static void RunThreads(uint32 threads, boolean leased)
+{
+    /* Room for every block plus chunk headers and the partly used last lease */
+    TStack_alloc_size size = (TStack_alloc_size)threads * ((BENCH_LEASE_ITERATIONS * BENCH_LEASE_BLOCK * 2U) + STACK_ALLOC_LEASE_SIZE);
+    uint8* buffer = (uint8*)malloc(size);
+    pthread_t ids[BENCH_LEASE_MAX_THREADS];
+    TBench_lease_job job;
+    char label[64];
+
+    if ((buffer == NULL_PTR) || (StackAlloc_Init(&job.sa, buffer, size) != STACK_ALLOC_OK) ||
+        (StackAlloc_LeasePoolInit(&job.pool, &job.sa, 0U) != STACK_ALLOC_OK))
+    {
+        printf("  setup failed\n");
+        free(buffer);
+        return;
+    }
+    job.leased = leased;
+    (void)pthread_barrier_init(&job.barrier, NULL_PTR, threads + 1U);
+
+    for (uint32 t = 0U; t < threads; t++)
+    {
+        (void)pthread_create(&ids[t], NULL_PTR, LeaseWorker, &job);
+    }
+
+    (void)pthread_barrier_wait(&job.barrier);
+    uint64 start = Bench_NowNs();
+    (void)pthread_barrier_wait(&job.barrier);
+    uint64 elapsed = Bench_NowNs() - start;
+
+    for (uint32 t = 0U; t < threads; t++)
+    {
+        (void)pthread_join(ids[t], NULL_PTR);
+    }
+    (void)pthread_barrier_destroy(&job.barrier);
+    StackAlloc_LeasePoolDeinit(&job.pool);
+
+    (void)snprintf(label, sizeof(label), "%s, %u thread(s)",
+                   (leased == TRUE) ? "leased 64 KiB chunks" : "StackAlloc_AllocConcurrent", threads);
+    Bench_Report(label, (uint64)threads * BENCH_LEASE_ITERATIONS, elapsed);
+
+    free(buffer);
+}
+
+void Bench_Lease(void)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32 max_threads = (cpus > 4) ? (uint32)cpus : 4U;
+
+    if (max_threads > BENCH_LEASE_MAX_THREADS)
+    {
+        max_threads = BENCH_LEASE_MAX_THREADS;
+    }
+
+    for (uint32 threads = 1U; threads <= max_threads; threads *= 2U)
+    {
+        RunThreads(threads, FALSE);
+        RunThreads(threads, TRUE);
+    }
+}
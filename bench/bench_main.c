@@ -0,0 +1,60 @@
+/**
+ * @file        bench_main.c
+ * @brief       Entry point for the stack allocator benchmarks
+ * @details     Runs every registered benchmark, or only the one named on the
+ *              command line.
+ */
+
+#include "bench.h"
+#include <string.h>
+
+typedef struct {
+    const char* name;
+    void (*run)(void);
+} TBench_entry;
+
+static const TBench_entry g_benches[] = {
+    { "alloc", Bench_Alloc },
+    { "inline", Bench_Inline },
+    { "hugepage", Bench_HugePage },
+    { "tls", Bench_Tls },
+    { "concurrent", Bench_Concurrent },
+    { "lease", Bench_Lease },
+    { "percpu", Bench_PerCpu },
+    { "memset", Bench_Memset },
+    { "calloc", Bench_Calloc },
+    { "release", Bench_Release },
+    { "latency", Bench_Latency },
+    { "guard", Bench_Guard },
+    { "down", Bench_Down },
+    { "header", Bench_Header },
+    { "batch", Bench_Batch },
+    { "plan", Bench_Plan },
+};
+
+int main(int argc, char** argv)
+{
+    const char* filter = (argc > 1) ? argv[1] : NULL_PTR;
+    boolean found = FALSE;
+
+    printf("Stack Allocator Benchmarks\n");
+    printf("--------------------------\n");
+
+    for (uint32 i = 0U; i < (uint32)(sizeof(g_benches) / sizeof(g_benches[0])); i++)
+    {
+        if ((filter == NULL_PTR) || (strcmp(filter, g_benches[i].name) == 0))
+        {
+            printf("[%s]\n", g_benches[i].name);
+            g_benches[i].run();
+            found = TRUE;
+        }
+    }
+
+    if (found == FALSE)
+    {
+        printf("Unknown benchmark: %s\n", filter);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file        bench_memset.c
+ * @brief       Bandwidth of mem_set() versus libc memset()
+ * @details     Fills the same buffer repeatedly for sizes from 8 B to 64 MiB, first
+ *              with the automatically selected kernels, then pinning each kernel the
+ *              CPU supports for a cache-resident and a memory-bound size.
+ */
+
+#include "bench.h"
+#include "helper_routines.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_MEMSET_MAX_SIZE     (64U * 1024U * 1024U)
+#define BENCH_MEMSET_BYTES        (2ULL * 1024U * 1024U * 1024U)
+#define BENCH_MEMSET_MAX_ITER     (20000000ULL)
+
+static const size_t g_sizes[] = {
+    8U, 64U, 512U, 4096U, 32768U, 262144U, 2097152U, 16777216U, 67108864U
+};
+
+/**
+ * @brief   Times repeated fills and returns the bandwidth in GB/s
+ */
+static float64 Measure(uint8* buffer, size_t size, boolean use_libc)
+{
+    uint64 iterations = BENCH_MEMSET_BYTES / size;
+
+    iterations = (iterations > BENCH_MEMSET_MAX_ITER) ? BENCH_MEMSET_MAX_ITER : iterations;
+    iterations = (iterations < 8U) ? 8U : iterations;
+
+    /* Warm-up (also faults the pages in) */
+    (void)memset(buffer, 1, size);
+
+    uint64 start = Bench_NowNs();
+    for (uint64 i = 0U; i < iterations; i++)
+    {
+        if (use_libc == TRUE)
+        {
+            (void)memset(buffer, (int)(i & 0xFFU), size);
+        }
+        else
+        {
+            (void)mem_set(buffer, (sint32)(i & 0xFFU), size);
+        }
+        BENCH_KEEP(buffer);
+    }
+    uint64 ns = Bench_NowNs() - start;
+
+    return (ns != 0U) ? (((float64)size * (float64)iterations) / (float64)ns) : 0.0;
+}
+
+static void PrintSize(char* text, size_t length, size_t size)
+{
+    if (size >= (1024U * 1024U))
+    {
+        (void)snprintf(text, length, "%zu MiB", size / (1024U * 1024U));
+    }
+    else if (size >= 1024U)
+    {
+        (void)snprintf(text, length, "%zu KiB", size / 1024U);
+    }
+    else
+    {
+        (void)snprintf(text, length, "%zu B", size);
+    }
+}
+
+void Bench_Memset(void)
+{
+    static const TMem_set_kernel kernels[] = {
+        MEM_SET_KERNEL_GENERIC, MEM_SET_KERNEL_SSE2, MEM_SET_KERNEL_AVX2,
+        MEM_SET_KERNEL_AVX512, MEM_SET_KERNEL_ERMS, MEM_SET_KERNEL_STREAM
+    };
+    uint8* buffer = (uint8*)aligned_alloc(64U, BENCH_MEMSET_MAX_SIZE);
+    char size_text[24];
+
+    if (buffer == NULL_PTR)
+    {
+        printf("  setup failed\n");
+        return;
+    }
+
+    printf("  %-10s %-8s %12s %12s\n", "size", "kernel", "mem_set", "memset");
+    (void)mem_set_select(MEM_SET_KERNEL_AUTO);
+    for (uint32 s = 0U; s < (uint32)(sizeof(g_sizes) / sizeof(g_sizes[0])); s++)
+    {
+        float64 ours = Measure(buffer, g_sizes[s], FALSE);
+        float64 libc = Measure(buffer, g_sizes[s], TRUE);
+        PrintSize(size_text, sizeof(size_text), g_sizes[s]);
+        printf("  %-10s %-8s %9.2f GB/s %7.2f GB/s\n", size_text, mem_set_kernel_name(g_sizes[s]), ours, libc);
+    }
+
+    /* Each kernel on its own, in cache and memory bound */
+    for (uint32 k = 0U; k < (uint32)(sizeof(kernels) / sizeof(kernels[0])); k++)
+    {
+        if (mem_set_select(kernels[k]) == TRUE)
+        {
+            float64 small = Measure(buffer, 32768U, FALSE);
+            float64 large = Measure(buffer, BENCH_MEMSET_MAX_SIZE, FALSE);
+            printf("  kernel %-8s %9.2f GB/s at 32 KiB %7.2f GB/s at 64 MiB\n",
+                   mem_set_kernel_name(32768U), small, large);
+        }
+    }
+
+    (void)mem_set_select(MEM_SET_KERNEL_AUTO);
+    free(buffer);
+}
@@ -0,0 +1,163 @@
+/**
+ * @file        bench_percpu.c
+ * @brief       Per-CPU arenas versus thread-local arenas at 4x oversubscription
+ * @details     Starts four threads per online CPU. Every thread allocates and touches
+ *              small blocks from a per-CPU arena (rseq and atomic paths) or from its
+ *              own thread-local arena. Reports throughput, the number of arenas and the
+ *              resident memory added while all threads are still alive.
+ */
+
+#include "bench.h"
+#include "stack_alloc_percpu.h"
+#include "stack_alloc_tls.h"
+#include "stack_alloc_vm.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define BENCH_PERCPU_ITERATIONS    (250000U)
+#define BENCH_PERCPU_BLOCK         (32U)
+#define BENCH_PERCPU_OVERSUB       (4U)
+#define BENCH_PERCPU_MAX_THREADS   (256U)
+
+typedef enum {
+    BENCH_PERCPU_RSEQ,
+    BENCH_PERCPU_ATOMIC,
+    BENCH_PERCPU_TLS
+} TBench_percpu_kind;
+
+typedef struct {
+    TStack_alloc_percpu pc;
+    pthread_barrier_t barrier;
+    TBench_percpu_kind kind;
+} TBench_percpu_job;
+
+/**
+ * @brief   Reads the resident set size of the process in bytes
+ */
+static uint64 ResidentBytes(void)
+{
+    unsigned long size = 0UL;
+    unsigned long resident = 0UL;
+    FILE* file = fopen("/proc/self/statm", "r");
+
+    if (file != NULL_PTR)
+    {
+        if (fscanf(file, "%lu %lu", &size, &resident) != 2)
+        {
+            resident = 0UL;
+        }
+        (void)fclose(file);
+    }
+
+    return (uint64)resident * (uint64)StackAlloc_GetPageSize();
+}
+
+static void* PercpuWorker(void* arg)
+{
+    TBench_percpu_job* job = (TBench_percpu_job*)arg;
+
+    if (job->kind == BENCH_PERCPU_TLS)
+    {
+        (void)StackAlloc_TlsGet();
+    }
+    (void)pthread_barrier_wait(&job->barrier);
+
+    for (uint32 i = 0U; i < BENCH_PERCPU_ITERATIONS; i++)
+    {
+        uint32* ptr = (job->kind == BENCH_PERCPU_TLS) ? (uint32*)StackAlloc_TlsAlloc(BENCH_PERCPU_BLOCK)
+                                                      : (uint32*)StackAlloc_PerCpuAlloc(&job->pc, BENCH_PERCPU_BLOCK);
+        if (ptr != NULL_PTR)
+        {
+            *ptr = i;
+        }
+    }
+
+    /* Stay alive until the footprint was measured */
+    (void)pthread_barrier_wait(&job->barrier);
+    (void)pthread_barrier_wait(&job->barrier);
+    StackAlloc_TlsRelease();
+
+    return NULL_PTR;
+}
+
+/**
+ * @brief   Runs one configuration and reports throughput and footprint
+ */
+static void RunThreads(uint32 threads, uint32 cpus, TBench_percpu_kind kind)
+{
+    static const char* const names[] = { "per-CPU (rseq)", "per-CPU (atomic)", "thread-local" };
+    pthread_t ids[BENCH_PERCPU_MAX_THREADS];
+    TBench_percpu_job job;
+    char label[64];
+
+    job.kind = kind;
+    if (kind != BENCH_PERCPU_TLS)
+    {
+        /* Room for twice the fair share of each CPU */
+        TStack_alloc_size slice = (TStack_alloc_size)BENCH_PERCPU_OVERSUB * 2U * BENCH_PERCPU_ITERATIONS * BENCH_PERCPU_BLOCK;
+        if (StackAlloc_PerCpuInit(&job.pc, slice,
+                                  (kind == BENCH_PERCPU_ATOMIC) ? STACK_ALLOC_PERCPU_NO_RSEQ : STACK_ALLOC_PERCPU_DEFAULT) != STACK_ALLOC_OK)
+        {
+            printf("  setup failed\n");
+            return;
+        }
+        if ((kind == BENCH_PERCPU_RSEQ) && (job.pc.use_rseq == FALSE))
+        {
+            printf("  %-40s (rseq not available)\n", names[kind]);
+            StackAlloc_PerCpuDeinit(&job.pc);
+            return;
+        }
+    }
+    else
+    {
+        StackAlloc_TlsConfigure(0U, 0U);
+    }
+
+    (void)pthread_barrier_init(&job.barrier, NULL_PTR, threads + 1U);
+    uint64 rss_before = ResidentBytes();
+
+    for (uint32 t = 0U; t < threads; t++)
+    {
+        (void)pthread_create(&ids[t], NULL_PTR, PercpuWorker, &job);
+    }
+
+    (void)pthread_barrier_wait(&job.barrier);
+    uint64 start = Bench_NowNs();
+    (void)pthread_barrier_wait(&job.barrier);
+    uint64 elapsed = Bench_NowNs() - start;
+    uint64 rss_after = ResidentBytes();
+    uint32 arenas = (kind == BENCH_PERCPU_TLS) ? StackAlloc_TlsGetArenaCount() : job.pc.cpu_count;
+    (void)pthread_barrier_wait(&job.barrier);
+
+    for (uint32 t = 0U; t < threads; t++)
+    {
+        (void)pthread_join(ids[t], NULL_PTR);
+    }
+    (void)pthread_barrier_destroy(&job.barrier);
+    if (kind != BENCH_PERCPU_TLS)
+    {
+        StackAlloc_PerCpuDeinit(&job.pc);
+    }
+
+    (void)snprintf(label, sizeof(label), "%s, %u threads / %u CPUs", names[kind], threads, cpus);
+    Bench_Report(label, (uint64)threads * BENCH_PERCPU_ITERATIONS, elapsed);
+    printf("  %-40s %10u arenas %10.1f MiB resident\n", "", arenas,
+           (float64)(rss_after - rss_before) / (1024.0 * 1024.0));
+}
+
+void Bench_PerCpu(void)
+{
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32 cpus = (online > 0) ? (uint32)online : 1U;
+    uint32 threads = cpus * BENCH_PERCPU_OVERSUB;
+
+    if (threads > BENCH_PERCPU_MAX_THREADS)
+    {
+        threads = BENCH_PERCPU_MAX_THREADS;
+    }
+
+    RunThreads(threads, cpus, BENCH_PERCPU_RSEQ);
+    RunThreads(threads, cpus, BENCH_PERCPU_ATOMIC);
+    RunThreads(threads, cpus, BENCH_PERCPU_TLS);
+}
@@ -0,0 +1,274 @@
+/**
+ * @file        bench_plan.c
+ * @brief       Offline buffer planning versus naive stack ordering
+ * @details     Builds the activation and workspace lifetimes of a few inference graphs
+ *              (float32, batch 1) and plans them with every StackAlloc_Plan() strategy.
+ *              Prints the block size against the sum of all buffers (no reuse) and the
+ *              lower bound (the most bytes alive in any one step), plus the planning time.
+ */
+
+#include "bench.h"
+#include "stack_alloc_plan.h"
+#include <stdlib.h>
+
+#define BENCH_PLAN_MAX_BUFFERS  (1024U)
+#define BENCH_PLAN_SCRATCH      (64U * 1024U)
+#define BENCH_PLAN_ALIGNMENT    (64U)
+#define BENCH_PLAN_REPEATS      (20U)
+
+/**
+ * @brief   Lifetime graph under construction
+ */
+typedef struct {
+    TStack_alloc_plan_buffer buffers[BENCH_PLAN_MAX_BUFFERS];
+    uint32 count;
+    uint32 step;
+} TBench_graph;
+
+/** @brief Adds a tensor produced in the current step; returns its id */
+static uint32 Produce(TBench_graph* g, uint64 elements)
+{
+    TStack_alloc_plan_buffer* b = &g->buffers[g->count];
+    b->size = (TStack_alloc_size)(elements * 4U);
+    b->alignment = BENCH_PLAN_ALIGNMENT;
+    b->first_step = g->step;
+    b->last_step = g->step;
+    return g->count++;
+}
+
+/** @brief Marks a tensor as read in the current step */
+static void Use(TBench_graph* g, uint32 id)
+{
+    g->buffers[id].last_step = g->step;
+}
+
+/** @brief Adds a scratch buffer used only in the current step */
+static void Workspace(TBench_graph* g, uint64 elements)
+{
+    (void)Produce(g, elements);
+}
+
+/** @brief One operator: reads an input, produces an output, moves to the next step */
+static uint32 Op(TBench_graph* g, uint32 input, uint64 elements)
+{
+    Use(g, input);
+    uint32 out = Produce(g, elements);
+    g->step++;
+    return out;
+}
+
+/** @brief 3x3 convolution with an im2col workspace */
+static uint32 Conv(TBench_graph* g, uint32 input, uint64 h, uint64 w, uint64 c_in, uint64 c_out)
+{
+    Workspace(g, h * w * c_in * 9U);
+    return Op(g, input, h * w * c_out);
+}
+
+/** @brief Element-wise sum of two tensors */
+static uint32 Add(TBench_graph* g, uint32 a, uint32 b, uint64 elements)
+{
+    Use(g, b);
+    return Op(g, a, elements);
+}
+
+static void BuildVgg16(TBench_graph* g)
+{
+    static const uint32 s_channels[] = { 64U, 64U, 0U, 128U, 128U, 0U, 256U, 256U, 256U, 0U,
+                                         512U, 512U, 512U, 0U, 512U, 512U, 512U, 0U };
+    uint64 hw = 224U;
+    uint64 c = 3U;
+    uint32 x = Op(g, Produce(g, hw * hw * c), hw * hw * c);
+
+    for (uint32 i = 0U; i < (uint32)(sizeof(s_channels) / sizeof(s_channels[0])); i++)
+    {
+        if (s_channels[i] == 0U)
+        {
+            hw /= 2U;
+            x = Op(g, x, hw * hw * c);
+        }
+        else
+        {
+            x = Conv(g, x, hw, hw, c, s_channels[i]);
+            c = s_channels[i];
+        }
+    }
+
+    x = Op(g, x, 4096U);
+    x = Op(g, x, 4096U);
+    (void)Op(g, x, 1000U);
+}
+
+static void BuildResNet18(TBench_graph* g)
+{
+    uint64 hw = 112U;
+    uint64 c = 64U;
+    uint32 x = Conv(g, Produce(g, 224U * 224U * 3U), hw, hw, 3U, c);
+    hw = 56U;
+    x = Op(g, x, hw * hw * c);
+
+    for (uint32 stage = 0U; stage < 4U; stage++)
+    {
+        for (uint32 block = 0U; block < 2U; block++)
+        {
+            uint32 shortcut = x;
+            if ((stage > 0U) && (block == 0U))
+            {
+                hw /= 2U;
+                c *= 2U;
+                shortcut = Op(g, x, hw * hw * c);   /* 1x1 projection */
+            }
+            uint32 y = Conv(g, x, hw, hw, (block == 0U) && (stage > 0U) ? c / 2U : c, c);
+            y = Conv(g, y, hw, hw, c, c);
+            x = Add(g, y, shortcut, hw * hw * c);
+        }
+    }
+
+    x = Op(g, x, c);
+    (void)Op(g, x, 1000U);
+}
+
+static void BuildUNet(TBench_graph* g)
+{
+    uint32 skips[4];
+    uint64 hw = 256U;
+    uint64 c = 32U;
+    uint32 x = Conv(g, Produce(g, hw * hw * 3U), hw, hw, 3U, c);
+
+    for (uint32 level = 0U; level < 4U; level++)
+    {
+        x = Conv(g, x, hw, hw, c, c);
+        skips[level] = x;
+        hw /= 2U;
+        x = Op(g, x, hw * hw * c);
+        x = Conv(g, x, hw, hw, c, c * 2U);
+        c *= 2U;
+    }
+
+    x = Conv(g, x, hw, hw, c, c);
+    for (uint32 level = 4U; level-- > 0U;)
+    {
+        hw *= 2U;
+        c /= 2U;
+        x = Op(g, x, hw * hw * c);                        /* up-convolution */
+        x = Add(g, x, skips[level], hw * hw * c * 2U);    /* concatenation */
+        x = Conv(g, x, hw, hw, c * 2U, c);
+        x = Conv(g, x, hw, hw, c, c);
+    }
+
+    (void)Op(g, x, hw * hw * 2U);
+}
+
+static void BuildTransformer(TBench_graph* g)
+{
+    const uint64 seq = 384U;
+    const uint64 d = 768U;
+    const uint64 heads = 12U;
+    uint32 x = Produce(g, seq * d);
+    g->step++;
+
+    for (uint32 layer = 0U; layer < 12U; layer++)
+    {
+        uint32 ln = Op(g, x, seq * d);
+        uint32 q = Op(g, ln, seq * d);
+        uint32 k = Op(g, ln, seq * d);
+        uint32 v = Op(g, ln, seq * d);
+        Use(g, k);
+        uint32 scores = Op(g, q, heads * seq * seq);
+        uint32 probs = Op(g, scores, heads * seq * seq);
+        Use(g, v);
+        uint32 ctx = Op(g, probs, seq * d);
+        uint32 proj = Op(g, ctx, seq * d);
+        uint32 x1 = Add(g, x, proj, seq * d);
+        uint32 ln2 = Op(g, x1, seq * d);
+        uint32 h = Op(g, ln2, seq * d * 4U);
+        uint32 act = Op(g, h, seq * d * 4U);
+        uint32 out = Op(g, act, seq * d);
+        x = Add(g, x1, out, seq * d);
+    }
+}
+
+/**
+ * @brief       Gets the most bytes alive in any one step
+ * @param[in]   g  Graph
+ * @return      Lower bound for every plan (ignoring alignment)
+ */
+static uint64 LowerBound(const TBench_graph* g)
+{
+    uint64 bound = 0U;
+
+    for (uint32 i = 0U; i < g->count; i++)
+    {
+        uint64 live = 0U;
+        for (uint32 j = 0U; j < g->count; j++)
+        {
+            if ((g->buffers[j].first_step <= g->buffers[i].first_step) &&
+                (g->buffers[i].first_step <= g->buffers[j].last_step))
+            {
+                live += g->buffers[j].size;
+            }
+        }
+        bound = (live > bound) ? live : bound;
+    }
+
+    return bound;
+}
+
+static void RunGraph(const char* name, void (*build)(TBench_graph*), TStack_alloc* scratch)
+{
+    static TBench_graph s_graph;
+    static TStack_alloc_size s_offsets[BENCH_PLAN_MAX_BUFFERS];
+    static const char* const s_names[3] = { "stack", "greedy by size", "best" };
+
+    s_graph.count = 0U;
+    s_graph.step = 0U;
+    build(&s_graph);
+
+    uint64 sum = 0U;
+    for (uint32 i = 0U; i < s_graph.count; i++)
+    {
+        sum += s_graph.buffers[i].size;
+    }
+    uint64 bound = LowerBound(&s_graph);
+
+    printf("  %s: %u buffers, no reuse %.1f MiB, lower bound %.2f MiB\n", name, s_graph.count,
+           (float64)sum / 1048576.0, (float64)bound / 1048576.0);
+
+    for (TStack_alloc_plan_strategy s = STACK_ALLOC_PLAN_STACK; s <= STACK_ALLOC_PLAN_BEST; s++)
+    {
+        TStack_alloc_size total = 0U;
+        uint64 start = Bench_NowNs();
+        for (uint32 r = 0U; r < BENCH_PLAN_REPEATS; r++)
+        {
+            if (StackAlloc_Plan(scratch, s_graph.buffers, s_graph.count, s, s_offsets, &total) != STACK_ALLOC_OK)
+            {
+                printf("    %-16s failed\n", s_names[s]);
+                break;
+            }
+        }
+        uint64 ns = Bench_NowNs() - start;
+
+        printf("    %-16s %8.2f MiB  (+%5.1f%% over bound)  %8.1f us/plan\n", s_names[s],
+               (float64)total / 1048576.0, (((float64)total / (float64)bound) - 1.0) * 100.0,
+               (float64)ns / (1000.0 * (float64)BENCH_PLAN_REPEATS));
+    }
+}
+
+void Bench_Plan(void)
+{
+    uint8* buffer = (uint8*)malloc(BENCH_PLAN_SCRATCH);
+    TStack_alloc scratch;
+
+    if ((buffer == NULL_PTR) || (StackAlloc_Init(&scratch, buffer, BENCH_PLAN_SCRATCH) != STACK_ALLOC_OK))
+    {
+        printf("  setup failed\n");
+        free(buffer);
+        return;
+    }
+
+    RunGraph("VGG-16 (224x224)", BuildVgg16, &scratch);
+    RunGraph("ResNet-18 (224x224)", BuildResNet18, &scratch);
+    RunGraph("U-Net (256x256)", BuildUNet, &scratch);
+    RunGraph("Transformer encoder (12 x 384 tokens)", BuildTransformer, &scratch);
+
+    free(buffer);
+}
@@ -0,0 +1,82 @@
+/**
+ * @file        bench_release.c
+ * @brief       Page release policies of a long-lived virtual arena
+ * @details     Requests use 1 MiB of scratch memory, and every 64th request spikes to
+ *              128 MiB. Each request ends with StackAlloc_Reset(). Reports the time
+ *              per request and the resident size after the last normal request, i.e.
+ *              what the arena keeps once the spikes are over. The synchronous
+ *              madvise() policies are compared with the background scavenger, which
+ *              lowers the arena in the background and decays over 20 ms.
+ */
+
+#include "bench.h"
+#include "stack_alloc.h"
+#include "stack_alloc_vm.h"
+#include "stack_alloc_scavenge.h"
+#include <string.h>
+#include <unistd.h>
+
+#define BENCH_RELEASE_RESERVE     (512U * 1024U * 1024U)
+#define BENCH_RELEASE_NORMAL      (1024U * 1024U)
+#define BENCH_RELEASE_SPIKE       (128U * 1024U * 1024U)
+#define BENCH_RELEASE_SPIKE_EVERY (64U)
+#define BENCH_RELEASE_REQUESTS    (1024U)
+
+/**
+ * @brief   Runs the request loop under one release policy
+ */
+static void RunPolicy(TStack_alloc_release_mode mode, boolean scavenge, const char* label)
+{
+    TStack_alloc sa;
+
+    if (StackAlloc_InitVirtual(&sa, BENCH_RELEASE_RESERVE, 0U) != STACK_ALLOC_OK)
+    {
+        printf("  setup failed\n");
+        return;
+    }
+    (void)StackAlloc_SetReleasePolicy(&sa, mode, 4U * BENCH_RELEASE_NORMAL);
+    if (scavenge == TRUE)
+    {
+        (void)StackAlloc_ScavengerStart(5U, 20U, 4U * BENCH_RELEASE_NORMAL);
+        (void)StackAlloc_ScavengeRegister(&sa);
+    }
+
+    uint64 start = Bench_NowNs();
+    for (uint32 r = 1U; r <= BENCH_RELEASE_REQUESTS; r++)
+    {
+        TStack_alloc_size size = ((r % BENCH_RELEASE_SPIKE_EVERY) == 0U) ? BENCH_RELEASE_SPIKE : BENCH_RELEASE_NORMAL;
+        uint8* block = (uint8*)StackAlloc_Alloc(&sa, size);
+        memset(block, (int)r, size);
+        BENCH_KEEP(block);
+        StackAlloc_Reset(&sa);
+    }
+    uint64 ns = Bench_NowNs() - start;
+
+    /* A few more normal requests over 100 ms, then look at what stays resident */
+    for (uint32 r = 0U; r < 10U; r++)
+    {
+        uint8* block = (uint8*)StackAlloc_Alloc(&sa, BENCH_RELEASE_NORMAL);
+        memset(block, 1, BENCH_RELEASE_NORMAL);
+        StackAlloc_Reset(&sa);
+        (void)usleep(10000U);
+    }
+
+    Bench_Report(label, BENCH_RELEASE_REQUESTS, ns);
+    printf("    resident %6.1f MiB, committed %6.1f MiB\n",
+           (double)StackAlloc_GetResident(&sa) / (1024.0 * 1024.0),
+           (double)StackAlloc_GetCommitted(&sa) / (1024.0 * 1024.0));
+
+    StackAlloc_Deinit(&sa);
+    if (scavenge == TRUE)
+    {
+        StackAlloc_ScavengerStop();
+    }
+}
+
+void Bench_Release(void)
+{
+    RunPolicy(STACK_ALLOC_RELEASE_NONE,     FALSE, "keep pages (no policy)");
+    RunPolicy(STACK_ALLOC_RELEASE_DONTNEED, FALSE, "MADV_DONTNEED above 4 MiB");
+    RunPolicy(STACK_ALLOC_RELEASE_FREE,     FALSE, "MADV_FREE above 4 MiB");
+    RunPolicy(STACK_ALLOC_RELEASE_NONE,     TRUE,  "background scavenger, 4 MiB min");
+}
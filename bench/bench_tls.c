@@ -0,0 +1,114 @@
+/**
+ * @file        bench_tls.c
+ * @brief       Multi-threaded scaling of thread-local arenas versus malloc/free
+ * @details     Every thread repeatedly allocates a frame of small blocks and then
+ *              releases the whole frame: with StackAlloc_TlsReset() for the thread
+ *              arena and with free() for malloc. Runs with 1, 2, 4, ... threads up
+ *              to at least 4 (or the number of online CPUs).
+ */
+
+#include "bench.h"
+#include "stack_alloc_tls.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define BENCH_TLS_FRAME       (256U)
+#define BENCH_TLS_FRAMES      (40000U)
+#define BENCH_TLS_MAX_THREADS (64U)
+
+static const TStack_alloc_size g_sizes[8] = { 8U, 16U, 24U, 40U, 64U, 100U, 256U, 13U };
+
+typedef struct {
+    pthread_barrier_t* barrier;
+    boolean use_malloc;
+} TBench_tls_job;
+
+static void* TlsWorker(void* arg)
+{
+    const TBench_tls_job* job = (const TBench_tls_job*)arg;
+    void* frame[BENCH_TLS_FRAME];
+
+    /* Create the arena before the clock starts */
+    (void)StackAlloc_TlsGet();
+    (void)pthread_barrier_wait(job->barrier);
+
+    for (uint32 f = 0U; f < BENCH_TLS_FRAMES; f++)
+    {
+        if (job->use_malloc == TRUE)
+        {
+            for (uint32 i = 0U; i < BENCH_TLS_FRAME; i++)
+            {
+                frame[i] = malloc(g_sizes[i & 7U]);
+                BENCH_KEEP(frame[i]);
+            }
+            for (uint32 i = 0U; i < BENCH_TLS_FRAME; i++)
+            {
+                free(frame[i]);
+            }
+        }
+        else
+        {
+            for (uint32 i = 0U; i < BENCH_TLS_FRAME; i++)
+            {
+                frame[i] = StackAlloc_TlsAlloc(g_sizes[i & 7U]);
+                BENCH_KEEP(frame[i]);
+            }
+            StackAlloc_TlsReset();
+        }
+    }
+
+    (void)pthread_barrier_wait(job->barrier);
+    StackAlloc_TlsRelease();
+
+    return NULL_PTR;
+}
+
+/**
+ * @brief   Runs one configuration and reports the aggregate throughput
+ */
+static void RunThreads(uint32 threads, boolean use_malloc)
+{
+    pthread_t ids[BENCH_TLS_MAX_THREADS];
+    pthread_barrier_t barrier;
+    TBench_tls_job job = { &barrier, use_malloc };
+    char label[64];
+
+    (void)pthread_barrier_init(&barrier, NULL_PTR, threads + 1U);
+    for (uint32 t = 0U; t < threads; t++)
+    {
+        (void)pthread_create(&ids[t], NULL_PTR, TlsWorker, &job);
+    }
+
+    (void)pthread_barrier_wait(&barrier);
+    uint64 start = Bench_NowNs();
+    (void)pthread_barrier_wait(&barrier);
+    uint64 elapsed = Bench_NowNs() - start;
+
+    for (uint32 t = 0U; t < threads; t++)
+    {
+        (void)pthread_join(ids[t], NULL_PTR);
+    }
+    (void)pthread_barrier_destroy(&barrier);
+
+    (void)snprintf(label, sizeof(label), "%s, %u thread(s)",
+                   (use_malloc == TRUE) ? "malloc/free" : "StackAlloc_TlsAlloc", threads);
+    Bench_Report(label, (uint64)threads * BENCH_TLS_FRAMES * BENCH_TLS_FRAME, elapsed);
+}
+
+void Bench_Tls(void)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32 max_threads = (cpus > 4) ? (uint32)cpus : 4U;
+
+    if (max_threads > BENCH_TLS_MAX_THREADS)
+    {
+        max_threads = BENCH_TLS_MAX_THREADS;
+    }
+
+    for (uint32 threads = 1U; threads <= max_threads; threads *= 2U)
+    {
+        RunThreads(threads, FALSE);
+        RunThreads(threads, TRUE);
+    }
+}
@@ -13,4 +13,110 @@
  */
 #define STACK_ALLOC_ALIGNMENT             (8U)
 
+/**
+ * @brief   Width of sizes and capacities in the public API
+ * @details 1U: sizes are pointer-width (size_t), arenas may exceed 4 GiB.
+ *          0U: sizes are 32-bit (uint32), arenas are limited to 4 GiB.
+ *          Address arithmetic is always pointer-width regardless of this setting.
+ */
+#ifndef STACK_ALLOC_POINTER_WIDTH_SIZE
+#define STACK_ALLOC_POINTER_WIDTH_SIZE    (1U)
+#endif
+
+/**
+ * @brief   Default chunk size of growable (chained) arenas in bytes
+ * @details Used when StackAlloc_InitChained() is given a chunk size of 0.
+ *          Requests larger than a chunk get a dedicated chunk.
+ */
+#define STACK_ALLOC_CHUNK_SIZE            (64U * 1024U)
+
+/**
+ * @brief   Default commit granularity of virtual-memory arenas in bytes
+ * @details Used when StackAlloc_InitVirtual() is given a commit step of 0.
+ *          Rounded up to the system page size.
+ */
+#define STACK_ALLOC_COMMIT_STEP           (64U * 1024U)
+
+/**
+ * @brief   Huge page size used by virtual-memory arenas in bytes
+ * @details Reservations and commit steps of huge-page arenas are rounded to this size.
+ */
+#define STACK_ALLOC_HUGE_PAGE_SIZE        (2U * 1024U * 1024U)
+
+/**
+ * @brief   Smallest span in bytes a virtual arena gives back to the OS at once
+ * @details With a release policy set, rewinding only issues madvise() when at least
+ *          this much resident memory lies above the new top, so small rewinds stay
+ *          free of system calls. The high-water mark is kept, so a later larger
+ *          rewind still releases everything.
+ */
+#define STACK_ALLOC_RELEASE_MIN_SIZE      (256U * 1024U)
+
+/**
+ * @brief   Size of the guard reserved after arenas created with STACK_ALLOC_VM_GUARD in bytes
+ * @details Also bounds the requests of StackAlloc_AllocAlignedUnchecked(): size plus
+ *          alignment - 1 may not exceed it, so a bump that skips the bounds check can
+ *          never jump over the guard.
+ *          Rounded up to the page size of the arena.
+ */
+#define STACK_ALLOC_GUARD_SIZE            (64U * 1024U)
+
+/**
+ * @brief   Maximum number of arenas registered with the guard fault handler at once
+ */
+#define STACK_ALLOC_GUARD_MAX_ARENAS      (64U)
+
+/**
+ * @brief   Default interval between two background scavenger passes in milliseconds
+ * @details Used when StackAlloc_ScavengerStart() is given a period of 0.
+ */
+#define STACK_ALLOC_SCAVENGE_PERIOD_MS    (100U)
+
+/**
+ * @brief   Default half-life of the usage estimate of scavenged arenas in milliseconds
+ * @details After a spike, the part of an arena the scavenger leaves committed halves
+ *          every half-life until it meets the recent usage again.
+ */
+#define STACK_ALLOC_SCAVENGE_HALF_LIFE_MS (1000U)
+
+/**
+ * @brief   Default number of committed bytes the scavenger never takes from an arena
+ */
+#define STACK_ALLOC_SCAVENGE_MIN_RETAINED (1024U * 1024U)
+
+/**
+ * @brief   Default reservation of each thread-local arena in bytes
+ * @details Thread-local arenas are virtual arenas, so only the part a thread
+ *          actually uses gets committed. Changeable with StackAlloc_TlsConfigure().
+ */
+#define STACK_ALLOC_TLS_RESERVE_SIZE      (64U * 1024U * 1024U)
+
+/**
+ * @brief   Default size of the chunks threads lease from a shared arena in bytes
+ * @details Used when StackAlloc_LeasePoolInit() is given a lease size of 0.
+ */
+#define STACK_ALLOC_LEASE_SIZE            (64U * 1024U)
+
+/**
+ * @brief   Default size of each CPU's slice of a per-CPU arena in bytes
+ * @details Used when StackAlloc_PerCpuInit() is given a size of 0. The slices are
+ *          mapped lazily, so only the pages a CPU actually reaches use memory.
+ */
+#define STACK_ALLOC_PERCPU_SIZE           (16U * 1024U * 1024U)
+
+/**
+ * @brief   Encoding of the size trailer written by StackAlloc_Push()
+ * @details 1U: LEB128-style varint, 1 byte up to 127 bytes per block, 2 bytes up to 16 KiB.
+ *          0U: fixed 4-byte trailer; a single block (plus padding) must stay below 4 GiB.
+ */
+#ifndef STACK_ALLOC_HEADER_VARINT
+#define STACK_ALLOC_HEADER_VARINT         (1U)
+#endif
+
+/**
+ * @brief   Cache line size in bytes
+ * @details Leases start on a cache line so that threads never share one.
+ */
+#define STACK_ALLOC_CACHE_LINE_SIZE       (64U)
+
 #endif /* STACK_ALLOC_CFG_H */
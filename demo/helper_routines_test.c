@@ -0,0 +1,160 @@
+/**
+ * @file        helper_routines_test.c
+ * @brief       Test suite for the helper routines
+ * @details     Runs mem_set() through every kernel the CPU supports, over many sizes
+ *              and misalignments, and checks both the filled range and its surroundings.
+ */
+
+ #include "stack_alloc_test.h"
+ #include "test_utils.h"
+ #include "helper_routines.h"
+ #include <stdlib.h>
+ 
+ #define MEM_SET_TEST_GUARD     64U
+ #define MEM_SET_TEST_MAX       (70000U)
+ #define MEM_SET_TEST_HUGE      (9U * 1024U * 1024U)
+ 
+ static const size_t g_mem_set_sizes[] = {
+     0U, 1U, 3U, 7U, 8U, 9U, 15U, 16U, 17U, 31U, 32U, 33U, 47U, 63U, 64U, 65U, 100U, 127U, 128U,
+     129U, 255U, 256U, 257U, 1000U, 2047U, 2048U, 2049U, 4096U, 4109U, 65536U, 65543U
+ };
+ 
+ /**
+  * @brief Fills size bytes at a misaligned offset and checks the result and the guards
+  */
+ static boolean CheckFill(uint8* buffer, size_t offset, size_t size)
+ {
+     uint8* target = buffer + MEM_SET_TEST_GUARD + offset;
+     size_t total = size + offset + (2U * MEM_SET_TEST_GUARD);
+ 
+     for (size_t i = 0U; i < total; i++)
+     {
+         buffer[i] = 0xAAU;
+     }
+     if (mem_set(target, 0x15C, size) != target)
+     {
+         return FALSE;
+     }
+     for (size_t i = 0U; i < total; i++)
+     {
+         boolean inside = ((buffer + i >= target) && (buffer + i < target + size)) ? TRUE : FALSE;
+         if (buffer[i] != ((inside == TRUE) ? 0x5CU : 0xAAU))
+         {
+             return FALSE;
+         }
+     }
+ 
+     return TRUE;
+ }
+ 
+ /* ========================= Individual Test Cases ========================= */
+ 
+ static boolean test_mem_set_null(void)
+ {
+     TEST_ASSERT(mem_set(NULL_PTR, 0, 16U) == NULL_PTR, "NULL destination should return NULL");
+     TEST_ASSERT(mem_set(NULL_PTR, 0, 1U << 20) == NULL_PTR, "NULL destination should return NULL for large sizes");
+     return TRUE;
+ }
+ 
+ static boolean test_mem_set_kernels(void)
+ {
+     static const TMem_set_kernel kernels[] = {
+         MEM_SET_KERNEL_AUTO, MEM_SET_KERNEL_GENERIC, MEM_SET_KERNEL_SSE2, MEM_SET_KERNEL_AVX2,
+         MEM_SET_KERNEL_AVX512, MEM_SET_KERNEL_ERMS, MEM_SET_KERNEL_STREAM
+     };
+     uint8* buffer = (uint8*)malloc(MEM_SET_TEST_MAX + (3U * MEM_SET_TEST_GUARD));
+     TEST_ASSERT(buffer != NULL_PTR, "Test buffer should be allocated");
+ 
+     for (uint32 k = 0U; k < (uint32)(sizeof(kernels) / sizeof(kernels[0])); k++)
+     {
+         if (mem_set_select(kernels[k]) == FALSE)
+         {
+             continue;   /* Not supported by this CPU */
+         }
+         for (uint32 s = 0U; s < (uint32)(sizeof(g_mem_set_sizes) / sizeof(g_mem_set_sizes[0])); s++)
+         {
+             for (size_t offset = 0U; offset < 64U; offset += ((offset < 8U) ? 1U : 27U))
+             {
+                 if (CheckFill(buffer, offset, g_mem_set_sizes[s]) == FALSE)
+                 {
+                     printf("  kernel %s, size %zu, offset %zu\n", mem_set_kernel_name(g_mem_set_sizes[s]),
+                            g_mem_set_sizes[s], offset);
+                     (void)mem_set_select(MEM_SET_KERNEL_AUTO);
+                     free(buffer);
+                     TEST_ASSERT(FALSE, "Every kernel should fill exactly the requested range");
+                 }
+             }
+         }
+     }
+ 
+     TEST_ASSERT(mem_set_select(MEM_SET_KERNEL_AUTO) == TRUE, "Automatic selection should always be available");
+     free(buffer);
+     return TRUE;
+ }
+ 
+ static boolean test_mem_set_huge(void)
+ {
+     uint8* buffer = (uint8*)malloc(MEM_SET_TEST_HUGE + (3U * MEM_SET_TEST_GUARD));
+     TEST_ASSERT(buffer != NULL_PTR, "Test buffer should be allocated");
+ 
+     boolean ok = CheckFill(buffer, 5U, MEM_SET_TEST_HUGE);
+     free(buffer);
+     TEST_ASSERT(ok == TRUE, "Blocks above the streaming threshold should be filled exactly");
+     TEST_ASSERT(mem_set_kernel_name(8U) != NULL_PTR, "Every size should have a kernel name");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_mem_cpy(void)
+ {
+     uint8 src[300];
+     uint8 dest[300 + (2U * MEM_SET_TEST_GUARD)];
+ 
+     for (size_t i = 0U; i < sizeof(src); i++)
+     {
+         src[i] = (uint8)(i * 7U + 1U);
+     }
+ 
+     for (size_t n = 0U; n < (sizeof(g_mem_set_sizes) / sizeof(g_mem_set_sizes[0])); n++)
+     {
+         size_t size = g_mem_set_sizes[n];
+         if (size > sizeof(src))
+         {
+             break;
+         }
+ 
+         for (size_t i = 0U; i < sizeof(dest); i++)
+         {
+             dest[i] = 0xAAU;
+         }
+         TEST_ASSERT(mem_cpy(dest + MEM_SET_TEST_GUARD, src + 1U, size) == dest + MEM_SET_TEST_GUARD,
+                     "mem_cpy should return the destination");
+         for (size_t i = 0U; i < sizeof(dest); i++)
+         {
+             boolean inside = ((i >= MEM_SET_TEST_GUARD) && (i < MEM_SET_TEST_GUARD + size)) ? TRUE : FALSE;
+             uint8 expected = (inside == TRUE) ? src[i - MEM_SET_TEST_GUARD + 1U] : 0xAAU;
+             TEST_ASSERT(dest[i] == expected, "Only the destination range should be copied");
+         }
+     }
+ 
+     TEST_ASSERT(mem_cpy(NULL_PTR, src, 8U) == NULL_PTR, "NULL destination should return NULL");
+     TEST_ASSERT(mem_cpy(dest, NULL_PTR, 8U) == NULL_PTR, "NULL source should return NULL");
+ 
+     return TRUE;
+ }
+ 
+ /* ========================= Test Runner ========================= */
+ 
+ boolean HelperRoutines_RunAllTests(void)
+ {
+     boolean all_passed = TRUE;
+ 
+     printf("=== Starting Helper Routines Test Suite ===\n");
+ 
+     TEST_CASE(mem_set_null);
+     TEST_CASE(mem_set_kernels);
+     TEST_CASE(mem_set_huge);
+     TEST_CASE(mem_cpy);
+ 
+     return all_passed;
+ }
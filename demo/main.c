@@ -14,6 +14,86 @@
  
      boolean all_passed = StackAlloc_RunAllTests();
  
+     if (StackAllocChain_RunAllTests() == FALSE)
+     {
+         all_passed = FALSE;
+     }
+ 
+     if (StackAllocVm_RunAllTests() == FALSE)
+     {
+         all_passed = FALSE;
+     }
+ 
+     if (StackAllocNuma_RunAllTests() == FALSE)
+     {
+         all_passed = FALSE;
+     }
+ 
+     if (StackAllocTls_RunAllTests() == FALSE)
+     {
+         all_passed = FALSE;
+     }
+ 
+     if (StackAllocConcurrent_RunAllTests() == FALSE)
+     {
+         all_passed = FALSE;
+     }
+ 
+     if (StackAllocLease_RunAllTests() == FALSE)
+     {
+         all_passed = FALSE;
+     }
+ 
+     if (StackAllocPerCpu_RunAllTests() == FALSE)
+     {
+         all_passed = FALSE;
+     }
+ 
+     if (StackAllocScavenge_RunAllTests() == FALSE)
+     {
+         all_passed = FALSE;
+     }
+ 
+     if (StackAllocGuard_RunAllTests() == FALSE)
+     {
+         all_passed = FALSE;
+     }
+ 
+     if (StackAllocDown_RunAllTests() == FALSE)
+     {
+         all_passed = FALSE;
+     }
+ 
+     if (StackAllocDual_RunAllTests() == FALSE)
+     {
+         all_passed = FALSE;
+     }
+ 
+     if (StackAllocHeader_RunAllTests() == FALSE)
+     {
+         all_passed = FALSE;
+     }
+ 
+     if (StackAllocBatch_RunAllTests() == FALSE)
+     {
+         all_passed = FALSE;
+     }
+ 
+     if (StackAllocMeasure_RunAllTests() == FALSE)
+     {
+         all_passed = FALSE;
+     }
+ 
+     if (StackAllocPlan_RunAllTests() == FALSE)
+     {
+         all_passed = FALSE;
+     }
+ 
+     if (HelperRoutines_RunAllTests() == FALSE)
+     {
+         all_passed = FALSE;
+     }
+ 
      if (all_passed == TRUE)
      {
          printf("\nSUCCESS: All tests passed!\n");
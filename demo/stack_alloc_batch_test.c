@@ -0,0 +1,152 @@
+/**
+ * @file        stack_alloc_batch_test.c
+ * @brief       Test suite for batch allocation (StackAlloc_AllocBatch)
+ * @details     Tests the layout in caller order and by alignment, atomic failure,
+ *              growth of chained arenas and error cases. Uses ONLY public API.
+ */
+
+ #include "stack_alloc_test.h"
+ #include "test_utils.h"
+ #include "stack_alloc_batch.h"
+ #include "stack_alloc_chain.h"
+ #include <string.h>
+ 
+ #define BATCH_BUFFER_SIZE  (4U * 1024U)
+ 
+ static uint8 g_batch_buffer[BATCH_BUFFER_SIZE] __attribute__((aligned(64)));
+ 
+ static const TStack_alloc_request g_batch[] = {
+     { 3U, 1U }, { 16U, 8U }, { 5U, 2U }, { 64U, 64U }, { 7U, 1U }, { 12U, 4U }, { 32U, 16U }, { 1U, 1U }
+ };
+ 
+ #define BATCH_COUNT  (sizeof(g_batch) / sizeof(g_batch[0]))
+ 
+ /**
+  * @brief Checks that every block is aligned and that no two blocks overlap
+  */
+ static boolean check_blocks(void* const* blocks)
+ {
+     for (uint32 i = 0U; i < BATCH_COUNT; i++) {
+         TStack_alloc_addr a = (TStack_alloc_addr)blocks[i];
+         if ((blocks[i] == NULL_PTR) || ((a % g_batch[i].alignment) != 0U)) {
+             return FALSE;
+         }
+         for (uint32 j = 0U; j < i; j++) {
+             TStack_alloc_addr b = (TStack_alloc_addr)blocks[j];
+             if ((a < b + g_batch[j].size) && (b < a + g_batch[i].size)) {
+                 return FALSE;
+             }
+         }
+     }
+     return TRUE;
+ }
+ 
+ /* ========================= Individual Test Cases ========================= */
+ 
+ static boolean test_batch_alloc(void)
+ {
+     TStack_alloc sa;
+     void* blocks[BATCH_COUNT];
+     StackAlloc_Init(&sa, g_batch_buffer, BATCH_BUFFER_SIZE);
+ 
+     void* mark = StackAlloc_GetMarker(&sa);
+     TEST_ASSERT(StackAlloc_AllocBatch(&sa, g_batch, BATCH_COUNT, blocks, STACK_ALLOC_BATCH_DEFAULT) == STACK_ALLOC_OK,
+                 "Batch should fit");
+     TEST_ASSERT(check_blocks(blocks) == TRUE, "Blocks should be aligned and disjoint");
+     for (uint32 i = 1U; i < BATCH_COUNT; i++) {
+         TEST_ASSERT((uint8*)blocks[i] > (uint8*)blocks[i - 1U], "Default layout should follow caller order");
+     }
+     for (uint32 i = 0U; i < BATCH_COUNT; i++) {
+         memset(blocks[i], 0xFF, g_batch[i].size);
+     }
+     TStack_alloc_size in_order = StackAlloc_GetUsed(&sa);
+ 
+     // Reordering keeps caller order for the pointers but removes the padding
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, mark) == STACK_ALLOC_OK, "One marker should free the batch");
+     TEST_ASSERT(StackAlloc_AllocBatch(&sa, g_batch, BATCH_COUNT, blocks, STACK_ALLOC_BATCH_REORDER) == STACK_ALLOC_OK,
+                 "Reordered batch should fit");
+     TEST_ASSERT(check_blocks(blocks) == TRUE, "Reordered blocks should be aligned and disjoint");
+     TEST_ASSERT((uint8*)blocks[3] < (uint8*)blocks[6], "Larger alignments should be placed first");
+     TEST_ASSERT((uint8*)blocks[0] < (uint8*)blocks[4], "Equal alignments should keep caller order");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == 64U + 32U + 16U + 12U + 5U + 3U + 7U + 1U, "Reordered batch should have no padding");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) < in_order, "Reordering should need less space");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_batch_errors(void)
+ {
+     TStack_alloc sa;
+     void* blocks[BATCH_COUNT];
+     StackAlloc_Init(&sa, g_batch_buffer, 128U);
+ 
+     // Nothing is allocated unless everything fits
+     (void)StackAlloc_Alloc(&sa, 8U);
+     TStack_alloc_size used = StackAlloc_GetUsed(&sa);
+     TEST_ASSERT(StackAlloc_AllocBatch(&sa, g_batch, BATCH_COUNT, blocks, STACK_ALLOC_BATCH_REORDER) == STACK_ALLOC_ERROR_OUT_OF_MEMORY,
+                 "Oversized batch should fail");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == used, "Failed batch should not allocate");
+     for (uint32 i = 0U; i < BATCH_COUNT; i++) {
+         TEST_ASSERT(blocks[i] == NULL_PTR, "Failed batch should clear every pointer");
+     }
+     TEST_ASSERT(StackAlloc_AllocBatch(&sa, g_batch, 2U, blocks, STACK_ALLOC_BATCH_DEFAULT) == STACK_ALLOC_OK,
+                 "A smaller batch should still fit");
+ 
+     TStack_alloc_request bad[2] = { { 8U, 8U }, { 0U, 8U } };
+     TEST_ASSERT(StackAlloc_AllocBatch(&sa, bad, 2U, blocks, STACK_ALLOC_BATCH_DEFAULT) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                 "Zero size should fail");
+     bad[1].size = 8U;
+     bad[1].alignment = 3U;
+     TEST_ASSERT(StackAlloc_AllocBatch(&sa, bad, 2U, blocks, STACK_ALLOC_BATCH_DEFAULT) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                 "Invalid alignment should fail");
+     bad[1].alignment = 8U;
+     bad[1].size = STACK_ALLOC_SIZE_MAX;
+     TEST_ASSERT(StackAlloc_AllocBatch(&sa, bad, 2U, blocks, STACK_ALLOC_BATCH_DEFAULT) == STACK_ALLOC_ERROR_OUT_OF_MEMORY,
+                 "Overflowing batch should fail");
+     TEST_ASSERT(StackAlloc_AllocBatch(&sa, bad, 0U, blocks, STACK_ALLOC_BATCH_DEFAULT) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                 "Empty batch should fail");
+     TEST_ASSERT(StackAlloc_AllocBatch(NULL_PTR, bad, 2U, blocks, STACK_ALLOC_BATCH_DEFAULT) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                 "NULL arena should fail");
+     TEST_ASSERT(StackAlloc_AllocBatch(&sa, bad, 2U, NULL_PTR, STACK_ALLOC_BATCH_DEFAULT) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                 "NULL output should fail");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_batch_chained(void)
+ {
+     uint8 initial[96];
+     void* blocks[BATCH_COUNT];
+     TStack_alloc_provider provider = StackAlloc_MallocProvider();
+     TStack_alloc sa;
+     StackAlloc_InitChained(&sa, initial, sizeof(initial), &provider, 1024U);
+ 
+     // The whole batch moves to a new chunk instead of being split
+     (void)StackAlloc_Alloc(&sa, 40U);
+     TEST_ASSERT(StackAlloc_AllocBatch(&sa, g_batch, BATCH_COUNT, blocks, STACK_ALLOC_BATCH_DEFAULT) == STACK_ALLOC_OK,
+                 "Batch should grow the arena");
+     TEST_ASSERT(StackAlloc_GetChunkCount(&sa) == 1U, "Batch should link one chunk");
+     TEST_ASSERT(check_blocks(blocks) == TRUE, "Blocks should be aligned and disjoint");
+     for (uint32 i = 0U; i < BATCH_COUNT; i++) {
+         TEST_ASSERT(((uint8*)blocks[i] < initial) || ((uint8*)blocks[i] >= initial + sizeof(initial)),
+                     "No block should stay in the initial buffer");
+     }
+ 
+     StackAlloc_Deinit(&sa);
+     return TRUE;
+ }
+ 
+ /* ========================= Test Runner ========================= */
+ 
+ boolean StackAllocBatch_RunAllTests(void)
+ {
+     boolean all_passed = TRUE;
+ 
+     printf("=== Starting Batch Allocation Test Suite ===\n");
+ 
+     TEST_CASE(batch_alloc);
+     TEST_CASE(batch_errors);
+     TEST_CASE(batch_chained);
+ 
+     return all_passed;
+ }
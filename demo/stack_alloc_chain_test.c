@@ -0,0 +1,335 @@
+/**
+ * @file        stack_alloc_chain_test.c
+ * @brief       Test suite for the growable (chained-chunk) stack allocator
+ * @details     Tests chunk linking, rewinding across chunk boundaries, chunk caching
+ *              and the bundled providers. Uses ONLY public API.
+ */
+
+ #include "stack_alloc_test.h"
+ #include "test_utils.h"
+ #include "stack_alloc_chain.h"
+ #include "stack_alloc_down.h"
+ #include <stdlib.h>
+ #include <string.h>
+ 
+ /* ========================= Counting Provider ========================= */
+ 
+ typedef struct {
+     uint32 acquired;
+     uint32 released;
+     TStack_alloc_size live_bytes;
+ } TCounting_ctx;
+ 
+ static void* CountingAcquire(void* ctx, TStack_alloc_size size)
+ {
+     TCounting_ctx* counts = (TCounting_ctx*)ctx;
+     counts->acquired++;
+     counts->live_bytes += size;
+     return malloc(size);
+ }
+ 
+ static void CountingRelease(void* ctx, void* block, TStack_alloc_size size)
+ {
+     TCounting_ctx* counts = (TCounting_ctx*)ctx;
+     counts->released++;
+     counts->live_bytes -= size;
+     free(block);
+ }
+ 
+ #define CHAIN_INITIAL_SIZE  256U
+ #define CHAIN_CHUNK_SIZE    1024U
+ 
+ /* ========================= Individual Test Cases ========================= */
+ 
+ static boolean test_chain_grows(void)
+ {
+     uint8 initial[CHAIN_INITIAL_SIZE];
+     TCounting_ctx counts = { 0U, 0U, 0U };
+     TStack_alloc_provider provider = { CountingAcquire, CountingRelease, &counts };
+     TStack_alloc sa;
+ 
+     TEST_ASSERT(StackAlloc_InitChained(&sa, initial, sizeof(initial), &provider, CHAIN_CHUNK_SIZE) == STACK_ALLOC_OK,
+                 "Chained init should succeed");
+ 
+     // Fill more than the initial buffer and one chunk
+     uint8* blocks[12];
+     for (int i = 0; i < 12; i++) {
+         blocks[i] = (uint8*)StackAlloc_Alloc(&sa, 200U);
+         TEST_ASSERT(blocks[i] != NULL_PTR, "Allocation should grow instead of failing");
+         memset(blocks[i], i, 200U);
+     }
+     TEST_ASSERT(StackAlloc_GetChunkCount(&sa) >= 2U, "Arena should have linked chunks");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) >= 12U * 200U, "Used should include every chunk");
+     TEST_ASSERT(StackAlloc_GetCapacity(&sa) == CHAIN_INITIAL_SIZE + counts.live_bytes, "Capacity should include chunks");
+     TEST_ASSERT(StackAlloc_Validate(&sa) == STACK_ALLOC_OK, "Chained arena should validate");
+ 
+     // Earlier blocks are untouched by growth
+     for (int i = 0; i < 12; i++) {
+         TEST_ASSERT(blocks[i][0] == (uint8)i && blocks[i][199] == (uint8)i, "Block contents should be preserved");
+     }
+ 
+     // A request larger than a chunk gets a dedicated chunk
+     uint8* big = (uint8*)StackAlloc_AllocAligned(&sa, 4U * CHAIN_CHUNK_SIZE, 64U);
+     TEST_ASSERT(big != NULL_PTR && ((TStack_alloc_addr)big % 64U) == 0U, "Oversized request should succeed aligned");
+ 
+     StackAlloc_Deinit(&sa);
+     TEST_ASSERT(counts.acquired == counts.released, "Deinit should release every chunk");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_chain_free_to_marker(void)
+ {
+     uint8 initial[CHAIN_INITIAL_SIZE];
+     TCounting_ctx counts = { 0U, 0U, 0U };
+     TStack_alloc_provider provider = { CountingAcquire, CountingRelease, &counts };
+     TStack_alloc sa;
+ 
+     StackAlloc_InitChained(&sa, initial, sizeof(initial), &provider, CHAIN_CHUNK_SIZE);
+ 
+     void* in_base = StackAlloc_Alloc(&sa, 64U);
+     void* keep = StackAlloc_Alloc(&sa, 64U);
+     TStack_alloc_size used_at_keep = StackAlloc_GetUsed(&sa);
+     (void)in_base;
+ 
+     // Cross into three chunks
+     for (int i = 0; i < 12; i++) {
+         TEST_ASSERT(StackAlloc_Alloc(&sa, 300U) != NULL_PTR, "Allocation should grow");
+     }
+     uint32 chunks = StackAlloc_GetChunkCount(&sa);
+     TEST_ASSERT(chunks >= 3U, "Should span several chunks");
+ 
+     // Rewind to the top of the initial buffer region
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, keep) == STACK_ALLOC_OK, "Rewind across chunks should succeed");
+     TEST_ASSERT(StackAlloc_GetChunkCount(&sa) == 0U, "All chunks should be unlinked");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == used_at_keep - 64U, "Used should match the marker");
+     TEST_ASSERT(StackAlloc_GetCapacity(&sa) == CHAIN_INITIAL_SIZE, "Capacity should shrink back");
+     TEST_ASSERT(counts.released == chunks - 1U, "All but one chunk should be released");
+ 
+     // Growing again reuses the cached chunk
+     uint32 acquired_before = counts.acquired;
+     StackAlloc_Alloc(&sa, 100U);
+     StackAlloc_Alloc(&sa, 200U);
+     TEST_ASSERT(StackAlloc_GetChunkCount(&sa) == 1U, "Should be in a chunk again");
+     TEST_ASSERT(counts.acquired == acquired_before, "Cached chunk should be reused");
+ 
+     // Rewind to a block inside a lower chunk
+     void* mid = StackAlloc_Alloc(&sa, 300U);
+     for (int i = 0; i < 8; i++) {
+         StackAlloc_Alloc(&sa, 300U);
+     }
+     TEST_ASSERT(StackAlloc_GetChunkCount(&sa) >= 2U, "Should span two chunks");
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, mid) == STACK_ALLOC_OK, "Rewind into a lower chunk should succeed");
+     TEST_ASSERT(StackAlloc_Alloc(&sa, 300U) == mid, "Next allocation should reuse the freed block");
+ 
+     // Foreign pointers are rejected
+     uint8 foreign[16];
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, foreign) == STACK_ALLOC_ERROR_INVALID_MARKER, "Foreign marker should fail");
+     TEST_ASSERT(StackAlloc_Validate(&sa) == STACK_ALLOC_OK, "Arena should still validate");
+ 
+     // Reset unlinks everything
+     StackAlloc_Reset(&sa);
+     TEST_ASSERT(StackAlloc_GetChunkCount(&sa) == 0U && StackAlloc_GetUsed(&sa) == 0U, "Reset should unlink all chunks");
+ 
+     StackAlloc_Deinit(&sa);
+     TEST_ASSERT(counts.live_bytes == 0U, "No chunk memory should leak");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_chain_no_initial_buffer(void)
+ {
+     TStack_alloc_provider provider = StackAlloc_MallocProvider();
+     TStack_alloc sa;
+ 
+     TEST_ASSERT(StackAlloc_InitChained(&sa, NULL_PTR, 0U, &provider, 0U) == STACK_ALLOC_OK,
+                 "Init without initial buffer should succeed");
+     TEST_ASSERT(StackAlloc_Validate(&sa) == STACK_ALLOC_OK, "Empty chained arena should validate");
+     TEST_ASSERT(StackAlloc_GetCapacity(&sa) == 0U, "Capacity should start at 0");
+ 
+     void* first = StackAlloc_Alloc(&sa, 32U);
+     TEST_ASSERT(first != NULL_PTR, "First allocation should link a chunk");
+     TEST_ASSERT(StackAlloc_GetCapacity(&sa) >= STACK_ALLOC_CHUNK_SIZE, "Default chunk size should be used");
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, first) == STACK_ALLOC_OK, "Rewind in first chunk should succeed");
+ 
+     StackAlloc_Reset(&sa);
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == 0U && StackAlloc_Validate(&sa) == STACK_ALLOC_OK, "Reset should empty the arena");
+     StackAlloc_Deinit(&sa);
+ 
+     // A marker taken while the arena has no chunk rewinds across every chunk
+     TEST_ASSERT(StackAlloc_InitChained(&sa, NULL_PTR, 0U, &provider, 256U) == STACK_ALLOC_OK, "Init should succeed");
+     void* empty = StackAlloc_GetMarker(&sa);
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, empty) == STACK_ALLOC_OK, "Empty marker on an empty arena should succeed");
+     TEST_ASSERT(StackAlloc_Alloc(&sa, 100U) != NULL_PTR && StackAlloc_Alloc(&sa, 300U) != NULL_PTR, "Allocations should link chunks");
+     TEST_ASSERT(StackAlloc_GetChunkCount(&sa) == 2U, "Two chunks should be linked");
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, empty) == STACK_ALLOC_OK, "Empty marker should rewind every chunk");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == 0U && StackAlloc_GetChunkCount(&sa) == 0U, "Nothing should stay in use");
+     TEST_ASSERT(StackAlloc_Validate(&sa) == STACK_ALLOC_OK, "Rewound arena should validate");
+     TEST_ASSERT(StackAlloc_Alloc(&sa, 100U) != NULL_PTR, "Arena should grow again");
+     StackAlloc_Deinit(&sa);
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_chain_invalid_params(void)
+ {
+     uint8 initial[CHAIN_INITIAL_SIZE];
+     TStack_alloc_provider provider = StackAlloc_MallocProvider();
+     TStack_alloc_provider broken = { NULL_PTR, NULL_PTR, NULL_PTR };
+     TStack_alloc sa;
+ 
+     TEST_ASSERT(StackAlloc_InitChained(NULL_PTR, initial, sizeof(initial), &provider, 0U) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                 "NULL sa should fail");
+     TEST_ASSERT(StackAlloc_InitChained(&sa, initial, sizeof(initial), NULL_PTR, 0U) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                 "NULL provider should fail");
+     TEST_ASSERT(StackAlloc_InitChained(&sa, initial, sizeof(initial), &broken, 0U) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                 "Incomplete provider should fail");
+     TEST_ASSERT(StackAlloc_InitChained(&sa, NULL_PTR, 64U, &provider, 0U) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                 "Size without buffer should fail");
+     TEST_ASSERT(StackAlloc_GetChunkCount(NULL_PTR) == 0U, "Chunk count should be 0 for NULL");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_chain_providers(void)
+ {
+     static uint8 parent_buffer[8U * 1024U];
+     TStack_alloc parent;
+     TStack_alloc child;
+ 
+     // Parent arena provider: chunks are carved from the parent and handed back on rewind
+     StackAlloc_Init(&parent, parent_buffer, sizeof(parent_buffer));
+     TStack_alloc_provider from_parent = StackAlloc_ParentProvider(&parent);
+     StackAlloc_InitChained(&child, NULL_PTR, 0U, &from_parent, 1024U);
+ 
+     for (int i = 0; i < 6; i++) {
+         TEST_ASSERT(StackAlloc_Alloc(&child, 500U) != NULL_PTR, "Child should grow from parent");
+     }
+     TEST_ASSERT(StackAlloc_GetUsed(&parent) >= 3U * 1024U, "Parent should hold the child's chunks");
+     StackAlloc_Deinit(&child);
+     TEST_ASSERT(StackAlloc_GetUsed(&parent) == 0U, "Parent should get its chunks back");
+ 
+     // Same with a downward parent, whose topmost block is its lowest one
+     StackAlloc_InitDown(&parent, parent_buffer, sizeof(parent_buffer));
+     StackAlloc_InitChained(&child, NULL_PTR, 0U, &from_parent, 1024U);
+     for (int i = 0; i < 6; i++) {
+         TEST_ASSERT(StackAlloc_Alloc(&child, 500U) != NULL_PTR, "Child should grow from a downward parent");
+     }
+     TEST_ASSERT(StackAlloc_GetUsed(&parent) >= 3U * 1024U, "Downward parent should hold the child's chunks");
+     StackAlloc_Deinit(&child);
+     TEST_ASSERT(StackAlloc_GetUsed(&parent) == 0U, "Downward parent should get its chunks back");
+ 
+     // Odd-sized chunks of varying size must all go back, without padding left behind
+     static const TStack_alloc_size s_odd[] = { 1001U, 2002U, 3003U, 1337U, 4097U };
+     static uint8 odd_buffer[32U * 1024U];
+     for (int down = 0; down < 2; down++) {
+         if (down == 0) {
+             StackAlloc_Init(&parent, odd_buffer, sizeof(odd_buffer));
+         } else {
+             StackAlloc_InitDown(&parent, odd_buffer, sizeof(odd_buffer));
+         }
+         (void)StackAlloc_Alloc(&parent, 3U);   // leaves the parent's top unaligned
+         TStack_alloc_size base = StackAlloc_GetUsed(&parent);
+         for (int cycle = 0; cycle < 2000; cycle++) {
+             StackAlloc_InitChained(&child, NULL_PTR, 0U, &from_parent, 64U);
+             for (uint32 i = 0U; i < 5U; i++) {
+                 TEST_ASSERT(StackAlloc_Alloc(&child, s_odd[i]) != NULL_PTR, "Child should grow from the parent");
+             }
+             StackAlloc_Deinit(&child);
+         }
+         TEST_ASSERT(StackAlloc_GetUsed(&parent) == base, "Parent should get every odd-sized chunk back");
+     }
+ 
+     // mmap provider
+     TStack_alloc_provider mapped = StackAlloc_MmapProvider();
+     StackAlloc_InitChained(&child, NULL_PTR, 0U, &mapped, 0U);
+     uint8* block = (uint8*)StackAlloc_Alloc(&child, 3U * STACK_ALLOC_CHUNK_SIZE);
+     TEST_ASSERT(block != NULL_PTR, "mmap-backed chunk should be allocated");
+     block[3U * STACK_ALLOC_CHUNK_SIZE - 1U] = 0x5AU;
+     StackAlloc_Deinit(&child);
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_chain_realloc(void)
+ {
+     uint8 initial[CHAIN_INITIAL_SIZE];
+     TCounting_ctx counts = { 0U, 0U, 0U };
+     TStack_alloc_provider provider = { CountingAcquire, CountingRelease, &counts };
+     TStack_alloc sa;
+     StackAlloc_InitChained(&sa, initial, sizeof(initial), &provider, CHAIN_CHUNK_SIZE);
+ 
+     // Grow the top block past the initial buffer: it moves into a chunk
+     void* mark = StackAlloc_GetMarker(&sa);
+     uint8* block = (uint8*)StackAlloc_Alloc(&sa, 64U);
+     memset(block, 0x3C, 64U);
+     uint8* grown = (uint8*)StackAlloc_Realloc(&sa, block, 64U, 600U);
+     TEST_ASSERT(grown != NULL_PTR && grown != block, "Block should move to a new chunk");
+     TEST_ASSERT(StackAlloc_GetChunkCount(&sa) == 1U, "One chunk should be linked");
+     TEST_ASSERT(grown[0] == 0x3CU && grown[63] == 0x3CU, "Contents should be copied");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == 600U, "The old copy should not count as used");
+ 
+     // Within the chunk it grows in place again
+     TEST_ASSERT(StackAlloc_Realloc(&sa, grown, 600U, 900U) == grown, "Block should grow in place in the chunk");
+ 
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, mark) == STACK_ALLOC_OK, "Rewind should work");
+     TEST_ASSERT(StackAlloc_GetChunkCount(&sa) == 0U, "Rewind should unlink the chunk");
+     StackAlloc_Deinit(&sa);
+     TEST_ASSERT(counts.live_bytes == 0U, "All chunks should be released");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_chain_open_block(void)
+ {
+     TCounting_ctx counts = { 0U, 0U, 0U };
+     TStack_alloc_provider provider = { CountingAcquire, CountingRelease, &counts };
+     TStack_alloc sa;
+     TStack_alloc_size window = 0U;
+     StackAlloc_InitChained(&sa, NULL_PTR, 0U, &provider, CHAIN_CHUNK_SIZE);
+ 
+     // Opening on an empty chained arena links the first chunk
+     uint8* out = (uint8*)StackAlloc_OpenBlock(&sa, 100U, &window);
+     TEST_ASSERT(out != NULL_PTR && window >= 100U, "Open should link a chunk");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == 0U, "Opening should not allocate");
+ 
+     // Append until the window is full, then grow: the block moves to a bigger chunk
+     TStack_alloc_size used = 0U;
+     for (uint32 i = 0U; i < 3000U; i++) {
+         if (used == window) {
+             out = (uint8*)StackAlloc_GrowBlock(&sa, out, used, used * 2U, &window);
+             TEST_ASSERT(out != NULL_PTR && window >= used * 2U, "Grow should provide a larger window");
+         }
+         out[used++] = (uint8)i;
+     }
+     TEST_ASSERT(StackAlloc_GetChunkCount(&sa) >= 2U, "Growing should have linked chunks");
+     TEST_ASSERT(StackAlloc_CommitBlock(&sa, out, used) == STACK_ALLOC_OK, "Commit should succeed");
+     for (uint32 i = 0U; i < 3000U; i++) {
+         TEST_ASSERT(out[i] == (uint8)i, "Data should survive the moves");
+     }
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == 3000U, "Only the committed block should be in use");
+ 
+     StackAlloc_Deinit(&sa);
+     TEST_ASSERT(counts.live_bytes == 0U, "All chunks should be released");
+ 
+     return TRUE;
+ }
+ 
+ /* ========================= Test Runner ========================= */
+ 
+ boolean StackAllocChain_RunAllTests(void)
+ {
+     boolean all_passed = TRUE;
+ 
+     printf("=== Starting Chained Stack Allocator Test Suite ===\n");
+ 
+     TEST_CASE(chain_grows);
+     TEST_CASE(chain_free_to_marker);
+     TEST_CASE(chain_no_initial_buffer);
+     TEST_CASE(chain_invalid_params);
+     TEST_CASE(chain_providers);
+     TEST_CASE(chain_realloc);
+     TEST_CASE(chain_open_block);
+ 
+     return all_passed;
+ }
@@ -0,0 +1,200 @@
+/**
+ * @file        stack_alloc_concurrent_test.c
+ * @brief       Test suite for lock-free allocation from a shared stack allocator
+ * @details     Several threads exhaust one arena together; the blocks they got must
+ *              be aligned, inside the buffer and pairwise disjoint. Uses ONLY public API.
+ */
+
+ #include "stack_alloc_test.h"
+ #include "test_utils.h"
+ #include "stack_alloc_concurrent.h"
+ #include "stack_alloc_down.h"
+ #include "stack_alloc_measure.h"
+ #include <pthread.h>
+ #include <stdlib.h>
+ 
+ #define CONC_TEST_THREADS      4
+ #define CONC_TEST_MAX_BLOCKS   8192
+ #define CONC_TEST_BUFFER_SIZE  (256U * 1024U)
+ 
+ typedef struct {
+     uint8* ptr;
+     TStack_alloc_size size;
+ } TConc_block;
+ 
+ typedef struct {
+     TStack_alloc* sa;
+     uint32 seed;
+     uint32 count;
+     boolean aligned;
+     TConc_block blocks[CONC_TEST_MAX_BLOCKS];
+ } TConc_worker;
+ 
+ static uint8 g_conc_buffer[CONC_TEST_BUFFER_SIZE];
+ static TConc_worker g_conc_workers[CONC_TEST_THREADS];
+ 
+ static void* ConcWorker(void* arg)
+ {
+     TConc_worker* worker = (TConc_worker*)arg;
+ 
+     worker->count = 0U;
+     worker->aligned = TRUE;
+     while (worker->count < CONC_TEST_MAX_BLOCKS)
+     {
+         worker->seed = (worker->seed * 1103515245U) + 12345U;
+         TStack_alloc_size size = 1U + ((worker->seed >> 16) % 96U);
+         TStack_alloc_size alignment = ((worker->seed >> 8) & 1U) ? 64U : 8U;
+ 
+         uint8* ptr = (uint8*)StackAlloc_AllocAlignedConcurrent(worker->sa, size, alignment);
+         if (ptr == NULL_PTR)
+         {
+             break;
+         }
+         if (((TStack_alloc_addr)ptr % alignment) != 0U)
+         {
+             worker->aligned = FALSE;
+         }
+         worker->blocks[worker->count].ptr = ptr;
+         worker->blocks[worker->count].size = size;
+         worker->count++;
+     }
+ 
+     return NULL_PTR;
+ }
+ 
+ static int CompareBlocks(const void* a, const void* b)
+ {
+     const TConc_block* x = (const TConc_block*)a;
+     const TConc_block* y = (const TConc_block*)b;
+     return (x->ptr < y->ptr) ? -1 : ((x->ptr > y->ptr) ? 1 : 0);
+ }
+ 
+ /**
+ * @brief Lets every worker exhaust the arena and checks the blocks are disjoint
+ */
+ static boolean RunNoOverlap(TStack_alloc* sa)
+ {
+     pthread_t threads[CONC_TEST_THREADS];
+     static TConc_block all[CONC_TEST_THREADS * CONC_TEST_MAX_BLOCKS];
+     uint32 total = 0U;
+ 
+     for (uint32 i = 0U; i < CONC_TEST_THREADS; i++)
+     {
+         g_conc_workers[i].sa = sa;
+         g_conc_workers[i].seed = i + 1U;
+         TEST_ASSERT(pthread_create(&threads[i], NULL_PTR, ConcWorker, &g_conc_workers[i]) == 0, "Thread should start");
+     }
+     for (uint32 i = 0U; i < CONC_TEST_THREADS; i++)
+     {
+         (void)pthread_join(threads[i], NULL_PTR);
+     }
+ 
+     for (uint32 i = 0U; i < CONC_TEST_THREADS; i++)
+     {
+         TEST_ASSERT(g_conc_workers[i].aligned == TRUE, "Every block should be aligned");
+         for (uint32 j = 0U; j < g_conc_workers[i].count; j++)
+         {
+             all[total++] = g_conc_workers[i].blocks[j];
+         }
+     }
+ 
+     qsort(all, total, sizeof(all[0]), CompareBlocks);
+     for (uint32 i = 0U; i < total; i++)
+     {
+         TEST_ASSERT((all[i].ptr >= g_conc_buffer) &&
+                     ((all[i].ptr + all[i].size) <= (g_conc_buffer + CONC_TEST_BUFFER_SIZE)),
+                     "Blocks should lie inside the buffer");
+         if (i > 0U)
+         {
+             TEST_ASSERT((all[i - 1U].ptr + all[i - 1U].size) <= all[i].ptr, "Blocks should not overlap");
+         }
+     }
+ 
+     return TRUE;
+ }
+ 
+ /* ========================= Individual Test Cases ========================= */
+ 
+ static boolean test_concurrent_basic(void)
+ {
+     TStack_alloc sa;
+     uint8 buffer[256];
+ 
+     TEST_ASSERT(StackAlloc_Init(&sa, buffer, sizeof(buffer)) == STACK_ALLOC_OK, "Init should succeed");
+     TEST_ASSERT(StackAlloc_AllocConcurrent(NULL_PTR, 8U) == NULL_PTR, "NULL arena should fail");
+     TEST_ASSERT(StackAlloc_AllocConcurrent(&sa, 0U) == NULL_PTR, "Zero size should fail");
+     TEST_ASSERT(StackAlloc_AllocAlignedConcurrent(&sa, 8U, 24U) == NULL_PTR, "Non power-of-two alignment should fail");
+ 
+     void* a = StackAlloc_AllocConcurrent(&sa, 10U);
+     void* mark = StackAlloc_GetMarkerConcurrent(&sa);
+     void* b = StackAlloc_AllocAlignedConcurrent(&sa, 16U, 32U);
+     TEST_ASSERT(a != NULL_PTR && b != NULL_PTR, "Allocations should succeed");
+     TEST_ASSERT(((TStack_alloc_addr)b % 32U) == 0U, "Block should be aligned");
+     TEST_ASSERT(StackAlloc_GetUsedConcurrent(&sa) == StackAlloc_GetUsed(&sa), "Used should match the regular query");
+     TEST_ASSERT(StackAlloc_AllocConcurrent(&sa, 1024U) == NULL_PTR, "Oversized request should fail without growing");
+ 
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, mark) == STACK_ALLOC_OK, "Quiescent arena should accept the marker");
+     TEST_ASSERT(StackAlloc_AllocAlignedConcurrent(&sa, 16U, 32U) == b, "Rewound space should be reused");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_concurrent_no_overlap(void)
+ {
+     TStack_alloc sa;
+ 
+     TEST_ASSERT(StackAlloc_Init(&sa, g_conc_buffer, CONC_TEST_BUFFER_SIZE) == STACK_ALLOC_OK, "Init should succeed");
+     TEST_ASSERT(RunNoOverlap(&sa) == TRUE, "Workers should share the arena");
+ 
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) <= CONC_TEST_BUFFER_SIZE, "Used should stay within the buffer");
+     TEST_ASSERT(StackAlloc_GetAvailable(&sa) < 160U, "Threads together should have exhausted the arena");
+     TEST_ASSERT(StackAlloc_Validate(&sa) == STACK_ALLOC_OK, "Arena should be valid afterwards");
+ 
+     StackAlloc_Reset(&sa);
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == 0U, "Reset after join should empty the arena");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_concurrent_down(void)
+ {
+     TStack_alloc sa;
+ 
+     TEST_ASSERT(StackAlloc_InitDown(&sa, g_conc_buffer, CONC_TEST_BUFFER_SIZE) == STACK_ALLOC_OK, "Init should succeed");
+ 
+     void* a = StackAlloc_AllocConcurrent(&sa, 10U);
+     void* mark = StackAlloc_GetMarkerConcurrent(&sa);
+     void* b = StackAlloc_AllocAlignedConcurrent(&sa, 16U, 32U);
+     TEST_ASSERT(a != NULL_PTR && b != NULL_PTR, "Allocations should succeed");
+     TEST_ASSERT((uint8*)b < (uint8*)a, "Blocks should be taken downwards");
+     TEST_ASSERT(((TStack_alloc_addr)b % 32U) == 0U, "Block should be aligned");
+     TEST_ASSERT(StackAlloc_GetUsedConcurrent(&sa) == StackAlloc_GetUsed(&sa), "Used should match the regular query");
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, mark) == STACK_ALLOC_OK, "Quiescent arena should accept the marker");
+     TEST_ASSERT(StackAlloc_AllocAlignedConcurrent(&sa, 16U, 32U) == b, "Rewound space should be reused");
+     StackAlloc_Reset(&sa);
+ 
+     TEST_ASSERT(RunNoOverlap(&sa) == TRUE, "Workers should share the arena");
+     TEST_ASSERT(StackAlloc_GetUsedConcurrent(&sa) == StackAlloc_GetUsed(&sa), "Used should match the regular query");
+     TEST_ASSERT(StackAlloc_GetAvailable(&sa) < 160U, "Threads together should have exhausted the arena");
+     TEST_ASSERT(StackAlloc_Validate(&sa) == STACK_ALLOC_OK, "Arena should be valid afterwards");
+ 
+     TEST_ASSERT(StackAlloc_InitMeasure(&sa) == STACK_ALLOC_OK, "Measure init should succeed");
+     TEST_ASSERT(StackAlloc_AllocConcurrent(&sa, 8U) == NULL_PTR, "Measuring arena should be rejected");
+ 
+     return TRUE;
+ }
+ 
+ /* ========================= Test Runner ========================= */
+ 
+ boolean StackAllocConcurrent_RunAllTests(void)
+ {
+     boolean all_passed = TRUE;
+ 
+     printf("=== Starting Concurrent Stack Allocator Test Suite ===\n");
+ 
+     TEST_CASE(concurrent_basic);
+     TEST_CASE(concurrent_no_overlap);
+     TEST_CASE(concurrent_down);
+ 
+     return all_passed;
+ }
@@ -0,0 +1,152 @@
+/**
+ * @file        stack_alloc_down_test.c
+ * @brief       Test suite for the downward-bumping stack allocator
+ * @details     Tests allocation order and alignment, marker rewinding, exhaustion and
+ *              the queries on a downward arena. Uses ONLY public API.
+ */
+
+ #include "stack_alloc_test.h"
+ #include "test_utils.h"
+ #include "stack_alloc_down.h"
+ #include <string.h>
+ 
+ #define DOWN_BUFFER_SIZE  1024U
+ 
+ static uint8 g_down_buffer[DOWN_BUFFER_SIZE] __attribute__((aligned(64)));
+ 
+ /* ========================= Individual Test Cases ========================= */
+ 
+ static boolean test_down_alloc(void)
+ {
+     TStack_alloc sa;
+     TEST_ASSERT(StackAlloc_InitDown(&sa, g_down_buffer, DOWN_BUFFER_SIZE) == STACK_ALLOC_OK,
+                 "Downward init should succeed");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == 0U, "New arena should be empty");
+ 
+     // Blocks are placed from the end towards the start
+     uint8* a = (uint8*)StackAlloc_AllocDownInline(&sa, 10U);
+     uint8* b = (uint8*)StackAlloc_AllocDownInline(&sa, 20U);
+     TEST_ASSERT(a != NULL_PTR && b != NULL_PTR, "Allocations should succeed");
+     TEST_ASSERT(a + 10U <= g_down_buffer + DOWN_BUFFER_SIZE, "First block should end inside the buffer");
+     TEST_ASSERT(b + 20U <= a, "Second block should lie below the first");
+     TEST_ASSERT(((TStack_alloc_addr)a % STACK_ALLOC_ALIGNMENT) == 0U &&
+                 ((TStack_alloc_addr)b % STACK_ALLOC_ALIGNMENT) == 0U, "Blocks should be aligned");
+     memset(a, 0xAA, 10U);
+     memset(b, 0xBB, 20U);
+ 
+     // Per-call alignment, through the inline path and the generic entry points
+     uint8* c = (uint8*)StackAlloc_AllocAlignedDownInline(&sa, 3U, 64U);
+     uint8* d = (uint8*)StackAlloc_AllocAligned(&sa, 5U, 1U);
+     uint8* e = (uint8*)StackAlloc_Alloc(&sa, 7U);
+     TEST_ASSERT(c != NULL_PTR && ((TStack_alloc_addr)c % 64U) == 0U, "64-byte aligned block expected");
+     TEST_ASSERT(d != NULL_PTR && d + 5U <= c, "Byte-aligned block should pack below");
+     TEST_ASSERT(e != NULL_PTR && e + 7U <= d && ((TStack_alloc_addr)e % STACK_ALLOC_ALIGNMENT) == 0U,
+                 "StackAlloc_Alloc() should bump downward");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) + StackAlloc_GetAvailable(&sa) <= DOWN_BUFFER_SIZE,
+                 "Used and available should add up to at most the buffer");
+     TEST_ASSERT(StackAlloc_Validate(&sa) == STACK_ALLOC_OK, "Arena should validate");
+ 
+     // Calloc zeroes the whole block
+     memset(g_down_buffer, 0xCC, (size_t)(e - g_down_buffer));
+     uint8* z = (uint8*)StackAlloc_Calloc(&sa, 4U, 8U);
+     TEST_ASSERT(z != NULL_PTR, "Calloc should succeed");
+     for (uint32 i = 0U; i < 32U; i++) {
+         TEST_ASSERT(z[i] == 0U, "Calloc block should be zero");
+     }
+     TEST_ASSERT(a[9] == 0xAAU && b[19] == 0xBBU, "Older blocks should be untouched");
+
+     // Realloc cannot grow a downward block in place, so it copies below
+     uint8* r = (uint8*)StackAlloc_Realloc(&sa, z, 32U, 64U);
+     TEST_ASSERT(r != NULL_PTR && r + 64U <= z && r[31] == 0U, "Growing should copy to a new block");
+     TEST_ASSERT(StackAlloc_Realloc(&sa, r, 64U, 16U) == r, "Shrinking should keep the block");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_down_markers(void)
+ {
+     TStack_alloc sa;
+     StackAlloc_InitDown(&sa, g_down_buffer, DOWN_BUFFER_SIZE / 2U);
+ 
+     void* empty = StackAlloc_GetMarker(&sa);
+     uint8* a = (uint8*)StackAlloc_AllocDownInline(&sa, 100U);
+     void* mark = StackAlloc_GetMarker(&sa);
+     TStack_alloc_size used = StackAlloc_GetUsed(&sa);
+ 
+     (void)StackAlloc_AllocDownInline(&sa, 50U);
+     (void)StackAlloc_AllocDownInline(&sa, 60U);
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, mark) == STACK_ALLOC_OK, "Rewind to marker should work");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == used, "Usage should be back at the marker");
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, mark) == STACK_ALLOC_OK, "Rewinding to the top frees nothing");
+ 
+     // The next block reuses the freed space right below a
+     uint8* b = (uint8*)StackAlloc_AllocDownInline(&sa, 50U);
+     TEST_ASSERT(b + 50U <= a && b + 50U + STACK_ALLOC_ALIGNMENT > a, "Freed space should be reused");
+ 
+     // Markers below the top (already freed) or outside the buffer are rejected
+     void* low = StackAlloc_GetMarker(&sa);
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, empty) == STACK_ALLOC_OK, "Rewind to empty should work");
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, low) == STACK_ALLOC_ERROR_INVALID_MARKER,
+                 "Freeing forward should fail");
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, g_down_buffer + DOWN_BUFFER_SIZE / 2U + 64U) ==
+                 STACK_ALLOC_ERROR_INVALID_MARKER, "Marker past the end should fail");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == 0U, "Arena should be empty");
+ 
+     // Reset goes back to the end as well
+     (void)StackAlloc_AllocDownInline(&sa, 200U);
+     StackAlloc_Reset(&sa);
+     TEST_ASSERT(StackAlloc_GetMarker(&sa) == empty, "Reset should restore the empty top");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_down_exhaustion(void)
+ {
+     TStack_alloc sa;
+     StackAlloc_InitDown(&sa, g_down_buffer, DOWN_BUFFER_SIZE);
+ 
+     TEST_ASSERT(StackAlloc_AllocDownInline(&sa, 0U) == NULL_PTR, "Zero-size allocation should fail");
+     TEST_ASSERT(StackAlloc_Alloc(&sa, 0U) == NULL_PTR, "Zero-size allocation should fail");
+     TEST_ASSERT(StackAlloc_AllocDownInline(&sa, STACK_ALLOC_SIZE_MAX) == NULL_PTR,
+                 "Oversized allocation should fail");
+     TEST_ASSERT(StackAlloc_AllocDownInline(&sa, DOWN_BUFFER_SIZE + 1U) == NULL_PTR,
+                 "Allocation larger than the buffer should fail");
+ 
+     // The whole buffer fits exactly once
+     void* all = StackAlloc_AllocDownInline(&sa, DOWN_BUFFER_SIZE);
+     TEST_ASSERT(all == (void*)g_down_buffer, "Whole-buffer allocation should start at the buffer");
+     TEST_ASSERT(StackAlloc_GetAvailable(&sa) == 0U, "Nothing should be left");
+     TEST_ASSERT(StackAlloc_AllocDownInline(&sa, 1U) == NULL_PTR, "Full arena should fail");
+     StackAlloc_Reset(&sa);
+ 
+     // Alignment padding can exhaust the buffer even if the size alone would fit
+     StackAlloc_InitDown(&sa, g_down_buffer + 1U, DOWN_BUFFER_SIZE - 1U);
+     (void)StackAlloc_AllocAlignedDownInline(&sa, DOWN_BUFFER_SIZE - 12U, 1U);
+     TEST_ASSERT(StackAlloc_AllocAlignedDownInline(&sa, 4U, 16U) == NULL_PTR,
+                 "Padding below the start should fail");
+     TEST_ASSERT(StackAlloc_AllocAlignedDownInline(&sa, 4U, 8U) != NULL_PTR, "Smaller alignment should fit");
+     TEST_ASSERT(StackAlloc_Validate(&sa) == STACK_ALLOC_OK, "Arena should validate");
+ 
+     // Buffers that are too small are rejected
+     TEST_ASSERT(StackAlloc_InitDown(&sa, g_down_buffer, STACK_ALLOC_ALIGNMENT - 1U) ==
+                 STACK_ALLOC_ERROR_INVALID_PARAM, "Tiny buffer should be rejected");
+     TEST_ASSERT(StackAlloc_InitDown(NULL_PTR, g_down_buffer, DOWN_BUFFER_SIZE) ==
+                 STACK_ALLOC_ERROR_INVALID_PARAM, "NULL arena should be rejected");
+ 
+     return TRUE;
+ }
+ 
+ /* ========================= Test Runner ========================= */
+ 
+ boolean StackAllocDown_RunAllTests(void)
+ {
+     boolean all_passed = TRUE;
+ 
+     printf("=== Starting Downward Stack Allocator Test Suite ===\n");
+ 
+     TEST_CASE(down_alloc);
+     TEST_CASE(down_markers);
+     TEST_CASE(down_exhaustion);
+ 
+     return all_passed;
+ }
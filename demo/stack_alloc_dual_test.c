@@ -0,0 +1,143 @@
+/**
+ * @file        stack_alloc_dual_test.c
+ * @brief       Test suite for the double-ended stack allocator
+ * @details     Tests both ends growing towards each other, per-end markers and resets,
+ *              and failure when the tops meet. Uses ONLY public API.
+ */
+
+ #include "stack_alloc_test.h"
+ #include "test_utils.h"
+ #include "stack_alloc_dual.h"
+ #include <string.h>
+ 
+ #define DUAL_BUFFER_SIZE  1024U
+ 
+ static uint8 g_dual_buffer[DUAL_BUFFER_SIZE] __attribute__((aligned(64)));
+ 
+ /* ========================= Individual Test Cases ========================= */
+ 
+ static boolean test_dual_alloc(void)
+ {
+     TStack_alloc_dual da;
+     TEST_ASSERT(StackAlloc_DualInit(&da, g_dual_buffer, DUAL_BUFFER_SIZE) == STACK_ALLOC_OK,
+                 "Dual init should succeed");
+     TEST_ASSERT(StackAlloc_DualGetAvailable(&da) == DUAL_BUFFER_SIZE, "Whole buffer should be free");
+ 
+     uint8* lo = (uint8*)StackAlloc_DualAlloc(&da, STACK_ALLOC_END_LOW, 100U);
+     uint8* hi = (uint8*)StackAlloc_DualAlloc(&da, STACK_ALLOC_END_HIGH, 100U);
+     TEST_ASSERT(lo == g_dual_buffer, "Low end should start at the buffer");
+     TEST_ASSERT(hi + 100U <= g_dual_buffer + DUAL_BUFFER_SIZE && hi > lo + 100U,
+                 "High end should be placed at the end of the buffer");
+     TEST_ASSERT(((TStack_alloc_addr)hi % STACK_ALLOC_ALIGNMENT) == 0U, "High block should be aligned");
+     memset(lo, 0x11, 100U);
+     memset(hi, 0x22, 100U);
+ 
+     uint8* hi64 = (uint8*)StackAlloc_DualAllocAligned(&da, STACK_ALLOC_END_HIGH, 10U, 64U);
+     uint8* lo64 = (uint8*)StackAlloc_DualAllocAligned(&da, STACK_ALLOC_END_LOW, 10U, 64U);
+     TEST_ASSERT(hi64 != NULL_PTR && ((TStack_alloc_addr)hi64 % 64U) == 0U && hi64 + 10U <= hi,
+                 "Aligned high block should lie below the previous one");
+     TEST_ASSERT(lo64 != NULL_PTR && ((TStack_alloc_addr)lo64 % 64U) == 0U && lo64 >= lo + 100U,
+                 "Aligned low block should lie above the previous one");
+ 
+     TEST_ASSERT(StackAlloc_DualGetUsed(&da, STACK_ALLOC_END_LOW) +
+                 StackAlloc_DualGetUsed(&da, STACK_ALLOC_END_HIGH) +
+                 StackAlloc_DualGetAvailable(&da) == DUAL_BUFFER_SIZE, "Usage should add up to the buffer");
+     TEST_ASSERT(lo[99] == 0x11U && hi[99] == 0x22U, "Blocks should be intact");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_dual_meet(void)
+ {
+     TStack_alloc_dual da;
+     StackAlloc_DualInit(&da, g_dual_buffer, DUAL_BUFFER_SIZE);
+ 
+     // One end can use far more than half as long as the other leaves it free
+     TEST_ASSERT(StackAlloc_DualAlloc(&da, STACK_ALLOC_END_HIGH, 900U) != NULL_PTR,
+                 "High end should take most of the buffer");
+     TEST_ASSERT(StackAlloc_DualAlloc(&da, STACK_ALLOC_END_LOW, 120U) != NULL_PTR, "Low end should fit the rest");
+     TEST_ASSERT(StackAlloc_DualGetAvailable(&da) == 0U, "Nothing should be left");
+     TEST_ASSERT(StackAlloc_DualAlloc(&da, STACK_ALLOC_END_LOW, 1U) == NULL_PTR, "Low end should fail when met");
+     TEST_ASSERT(StackAlloc_DualAlloc(&da, STACK_ALLOC_END_HIGH, 1U) == NULL_PTR, "High end should fail when met");
+ 
+     // Freeing one end makes room for the other
+     StackAlloc_DualReset(&da, STACK_ALLOC_END_HIGH);
+     TEST_ASSERT(StackAlloc_DualGetUsed(&da, STACK_ALLOC_END_HIGH) == 0U, "High end should be empty");
+     TEST_ASSERT(StackAlloc_DualGetUsed(&da, STACK_ALLOC_END_LOW) == 120U, "Low end should be untouched");
+     TEST_ASSERT(StackAlloc_DualAlloc(&da, STACK_ALLOC_END_LOW, 900U) != NULL_PTR, "Low end should grow into it");
+ 
+     // Invalid requests
+     TEST_ASSERT(StackAlloc_DualAlloc(&da, STACK_ALLOC_END_LOW, 0U) == NULL_PTR, "Zero size should fail");
+     TEST_ASSERT(StackAlloc_DualAlloc(&da, STACK_ALLOC_END_HIGH, 0U) == NULL_PTR, "Zero size should fail");
+     TEST_ASSERT(StackAlloc_DualAlloc(&da, STACK_ALLOC_END_HIGH, STACK_ALLOC_SIZE_MAX) == NULL_PTR,
+                 "Oversized request should fail");
+     TEST_ASSERT(StackAlloc_DualAlloc(&da, STACK_ALLOC_END_LOW, STACK_ALLOC_SIZE_MAX) == NULL_PTR,
+                 "Oversized request should fail");
+     TEST_ASSERT(StackAlloc_DualAlloc(&da, 2U, 8U) == NULL_PTR, "Invalid end should fail");
+     TEST_ASSERT(StackAlloc_DualAllocAligned(&da, STACK_ALLOC_END_LOW, 8U, 3U) == NULL_PTR,
+                 "Invalid alignment should fail");
+     TEST_ASSERT(StackAlloc_DualInit(&da, g_dual_buffer, 4U) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                 "Tiny buffer should be rejected");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_dual_markers(void)
+ {
+     TStack_alloc_dual da;
+     StackAlloc_DualInit(&da, g_dual_buffer, DUAL_BUFFER_SIZE);
+ 
+     void* low_mark  = StackAlloc_DualGetMarker(&da, STACK_ALLOC_END_LOW);
+     void* high_mark = StackAlloc_DualGetMarker(&da, STACK_ALLOC_END_HIGH);
+     uint8* result   = (uint8*)StackAlloc_DualAlloc(&da, STACK_ALLOC_END_LOW, 64U);
+     void* scratch   = StackAlloc_DualGetMarker(&da, STACK_ALLOC_END_HIGH);
+ 
+     (void)StackAlloc_DualAlloc(&da, STACK_ALLOC_END_HIGH, 200U);
+     (void)StackAlloc_DualAlloc(&da, STACK_ALLOC_END_HIGH, 300U);
+     (void)StackAlloc_DualAlloc(&da, STACK_ALLOC_END_LOW, 32U);
+ 
+     // Rewinding the scratch end leaves the results alone
+     TEST_ASSERT(StackAlloc_DualFreeToMarker(&da, STACK_ALLOC_END_HIGH, scratch) == STACK_ALLOC_OK,
+                 "High rewind should work");
+     TEST_ASSERT(StackAlloc_DualGetUsed(&da, STACK_ALLOC_END_HIGH) == 0U, "Scratch should be freed");
+     TEST_ASSERT(StackAlloc_DualGetUsed(&da, STACK_ALLOC_END_LOW) == 96U, "Results should be kept");
+ 
+     // A low block pointer is a marker, as in a regular arena
+     TEST_ASSERT(StackAlloc_DualFreeToMarker(&da, STACK_ALLOC_END_LOW, result + 64U) == STACK_ALLOC_OK,
+                 "Low rewind to a block end should work");
+     TEST_ASSERT(StackAlloc_DualGetUsed(&da, STACK_ALLOC_END_LOW) == 64U, "Only the first block should remain");
+ 
+     // Markers of the other end or beyond the top are rejected
+     (void)StackAlloc_DualAlloc(&da, STACK_ALLOC_END_HIGH, 16U);
+     TEST_ASSERT(StackAlloc_DualFreeToMarker(&da, STACK_ALLOC_END_LOW, high_mark) == STACK_ALLOC_ERROR_INVALID_MARKER,
+                 "High marker should not rewind the low end");
+     TEST_ASSERT(StackAlloc_DualFreeToMarker(&da, STACK_ALLOC_END_HIGH, low_mark) == STACK_ALLOC_ERROR_INVALID_MARKER,
+                 "Low marker should not rewind the high end");
+     TEST_ASSERT(StackAlloc_DualFreeToMarker(&da, STACK_ALLOC_END_LOW, result + 128U) ==
+                 STACK_ALLOC_ERROR_INVALID_MARKER, "Freeing forward should fail");
+     TEST_ASSERT(StackAlloc_DualFreeToMarker(&da, STACK_ALLOC_END_LOW, NULL_PTR) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                 "NULL marker should fail");
+ 
+     TEST_ASSERT(StackAlloc_DualFreeToMarker(&da, STACK_ALLOC_END_HIGH, high_mark) == STACK_ALLOC_OK,
+                 "Rewind to the empty high end should work");
+     StackAlloc_DualReset(&da, STACK_ALLOC_END_LOW);
+     TEST_ASSERT(StackAlloc_DualGetMarker(&da, STACK_ALLOC_END_LOW) == low_mark, "Reset should restore the base");
+     TEST_ASSERT(StackAlloc_DualGetAvailable(&da) == DUAL_BUFFER_SIZE, "Whole buffer should be free again");
+ 
+     return TRUE;
+ }
+ 
+ /* ========================= Test Runner ========================= */
+ 
+ boolean StackAllocDual_RunAllTests(void)
+ {
+     boolean all_passed = TRUE;
+ 
+     printf("=== Starting Double-Ended Stack Allocator Test Suite ===\n");
+ 
+     TEST_CASE(dual_alloc);
+     TEST_CASE(dual_meet);
+     TEST_CASE(dual_markers);
+ 
+     return all_passed;
+ }
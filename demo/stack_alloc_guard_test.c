@@ -0,0 +1,156 @@
+/**
+ * @file        stack_alloc_guard_test.c
+ * @brief       Test suite for guard-protected arenas and the unchecked fast path
+ * @details     Tests that unchecked allocations match checked ones, that overflows
+ *              fault (in a forked child), and growth through the fault handler.
+ *              Uses ONLY public API.
+ */
+
+ #include "stack_alloc_test.h"
+ #include "test_utils.h"
+ #include "stack_alloc_guard.h"
+ #include "stack_alloc_scavenge.h"
+ #include <signal.h>
+ #include <sys/wait.h>
+ #include <unistd.h>
+ 
+ #define KIB     (1024U)
+ 
+ /**
+  * @brief Runs a function in a child process and reports whether it died of SIGSEGV
+  */
+ static boolean DiesOfSegv(void (*body)(void))
+ {
+     fflush(stdout);
+     pid_t pid = fork();
+     if (pid == 0) {
+         body();
+         _exit(0);
+     }
+ 
+     int status = 0;
+     (void)waitpid(pid, &status, 0);
+     return (WIFSIGNALED(status) && (WTERMSIG(status) == SIGSEGV)) ? TRUE : FALSE;
+ }
+ 
+ static void OverflowFixed(void)
+ {
+     TStack_alloc sa;
+     if (StackAlloc_InitGuarded(&sa, 64U * KIB) != STACK_ALLOC_OK) {
+         _exit(1);
+     }
+     for (int i = 0; i < 100; i++) {
+         uint8* block = (uint8*)StackAlloc_AllocUnchecked(&sa, 4U * KIB);
+         block[0] = 1U;
+     }
+ }
+ 
+ static void OverflowGrowing(void)
+ {
+     TStack_alloc sa;
+     if ((StackAlloc_InitVirtualEx(&sa, 256U * KIB, 0U, STACK_ALLOC_VM_GUARD) != STACK_ALLOC_OK) ||
+         (StackAlloc_GuardInstallHandler() != STACK_ALLOC_OK) || (StackAlloc_GuardRegister(&sa) != STACK_ALLOC_OK)) {
+         _exit(1);
+     }
+     for (int i = 0; i < 100; i++) {
+         uint8* block = (uint8*)StackAlloc_AllocUnchecked(&sa, 4U * KIB);
+         block[0] = 1U;
+     }
+ }
+ 
+ /* ========================= Individual Test Cases ========================= */
+ 
+ static boolean test_guard_unchecked(void)
+ {
+     TStack_alloc guarded;
+     TStack_alloc checked;
+ 
+     TEST_ASSERT(StackAlloc_InitGuarded(&guarded, 64U * KIB) == STACK_ALLOC_OK, "Guarded arena should be created");
+     TEST_ASSERT(StackAlloc_InitVirtual(&checked, 64U * KIB, 64U * KIB) == STACK_ALLOC_OK, "Reference arena should be created");
+     TEST_ASSERT(StackAlloc_GetCommitted(&guarded) == 64U * KIB, "Guarded arena should be fully committed");
+     TEST_ASSERT(StackAlloc_GetCapacity(&guarded) == 64U * KIB, "Guard should not count as capacity");
+ 
+     // Same layout as the checked path, up to the last byte of the arena
+     uint8* first_a = (uint8*)StackAlloc_AllocUnchecked(&guarded, 16U);
+     uint8* first_b = (uint8*)StackAlloc_Alloc(&checked, 16U);
+     TStack_alloc_size used = 0U;
+     for (uint32 i = 0U; used + 1024U <= 64U * KIB; i++) {
+         TStack_alloc_size size = 1U + ((i * 37U) % 1000U);
+         uint8* a = (uint8*)StackAlloc_AllocUnchecked(&guarded, size);
+         uint8* b = (uint8*)StackAlloc_Alloc(&checked, size);
+         TEST_ASSERT((a - first_a) == (b - first_b), "Offsets should match the checked path");
+         a[0] = 1U;
+         a[size - 1U] = 2U;
+         used = StackAlloc_GetUsed(&guarded);
+     }
+     uint8* aligned = (uint8*)StackAlloc_AllocAlignedUnchecked(&guarded, 8U, 256U);
+     TEST_ASSERT(((TStack_alloc_addr)aligned % 256U) == 0U, "Unchecked aligned block should be aligned");
+ 
+     StackAlloc_Deinit(&guarded);
+     StackAlloc_Deinit(&checked);
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_guard_overflow(void)
+ {
+     TEST_ASSERT(DiesOfSegv(OverflowFixed) == TRUE, "Overflowing a guarded arena should fault");
+     TEST_ASSERT(DiesOfSegv(OverflowGrowing) == TRUE, "Overflowing the reservation should fault despite the handler");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_guard_grow(void)
+ {
+     TStack_alloc sa;
+     TStack_alloc plain;
+ 
+     TEST_ASSERT(StackAlloc_GuardInstallHandler() == STACK_ALLOC_OK, "Handler should install");
+     TEST_ASSERT(StackAlloc_GuardInstallHandler() == STACK_ALLOC_OK, "Installing twice should be harmless");
+ 
+     TEST_ASSERT(StackAlloc_InitVirtual(&plain, 64U * KIB, 0U) == STACK_ALLOC_OK, "Reservation should succeed");
+     TEST_ASSERT(StackAlloc_GuardRegister(&plain) == STACK_ALLOC_ERROR_INVALID_PARAM, "Arena without guard should be rejected");
+     StackAlloc_Deinit(&plain);
+ 
+     TEST_ASSERT(StackAlloc_InitVirtualEx(&sa, 4096U * KIB, 0U, STACK_ALLOC_VM_GUARD) == STACK_ALLOC_OK,
+                 "Guarded reservation should succeed");
+     TEST_ASSERT(StackAlloc_GuardRegister(&sa) == STACK_ALLOC_OK, "Registration should succeed");
+     TEST_ASSERT(StackAlloc_GuardRegister(&sa) == STACK_ALLOC_ERROR_INVALID_PARAM, "Double registration should fail");
+     TEST_ASSERT(StackAlloc_ScavengeRegister(&sa) == STACK_ALLOC_ERROR_INVALID_PARAM, "Scavenger should reject the arena");
+     TEST_ASSERT(StackAlloc_GetCommitted(&sa) == 0U, "Nothing should be committed yet");
+ 
+     // Every page is committed by the fault handler
+     for (int i = 0; i < 1024; i++) {
+         uint8* block = (uint8*)StackAlloc_AllocUnchecked(&sa, 4U * KIB);
+         block[0] = (uint8)i;
+         block[4U * KIB - 1U] = (uint8)i;
+     }
+     TEST_ASSERT(StackAlloc_GetCommitted(&sa) == 4096U * KIB, "Faults should have committed the whole range");
+     TEST_ASSERT(StackAlloc_GetAvailable(&sa) == 0U, "Arena should be full");
+     TEST_ASSERT(StackAlloc_Alloc(&sa, 1U) == NULL_PTR, "Checked path should report exhaustion");
+ 
+     // Checked and unchecked allocations mix after a rewind
+     StackAlloc_Reset(&sa);
+     uint8* a = (uint8*)StackAlloc_Alloc(&sa, 100U);
+     uint8* b = (uint8*)StackAlloc_AllocUnchecked(&sa, 100U);
+     TEST_ASSERT((a != NULL_PTR) && (b > a), "Paths should share the arena");
+ 
+     StackAlloc_Deinit(&sa);
+ 
+     return TRUE;
+ }
+ 
+ /* ========================= Test Runner ========================= */
+ 
+ boolean StackAllocGuard_RunAllTests(void)
+ {
+     boolean all_passed = TRUE;
+ 
+     printf("=== Starting Guarded Stack Allocator Test Suite ===\n");
+ 
+     TEST_CASE(guard_unchecked);
+     TEST_CASE(guard_overflow);
+     TEST_CASE(guard_grow);
+ 
+     return all_passed;
+ }
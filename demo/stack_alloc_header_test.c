@@ -0,0 +1,137 @@
+/**
+ * @file        stack_alloc_header_test.c
+ * @brief       Test suite for blocks with size records (StackAlloc_Push/Pop)
+ * @details     Tests popping blocks one at a time with mixed sizes and alignments,
+ *              record sizes around the varint boundaries, chunk boundaries of chained
+ *              arenas and error cases. Uses ONLY public API.
+ */
+
+ #include "stack_alloc_test.h"
+ #include "test_utils.h"
+ #include "stack_alloc_header.h"
+ #include "stack_alloc_chain.h"
+ #include "stack_alloc_down.h"
+ #include <string.h>
+ 
+ #define HEADER_BUFFER_SIZE  (64U * 1024U)
+ 
+ static uint8 g_header_buffer[HEADER_BUFFER_SIZE] __attribute__((aligned(64)));
+ 
+ static const TStack_alloc_size g_push_sizes[]      = { 1U, 13U, 16U, 100U, 127U, 128U, 200U, 16383U, 16384U, 5U };
+ static const TStack_alloc_size g_push_alignments[] = { 1U, 8U, 8U, 64U, 1U, 2U, 16U, 8U, 4096U, 32U };
+ 
+ #define PUSH_COUNT  (sizeof(g_push_sizes) / sizeof(g_push_sizes[0]))
+ 
+ /* ========================= Individual Test Cases ========================= */
+ 
+ static boolean test_push_pop(void)
+ {
+     TStack_alloc sa;
+     uint8* blocks[PUSH_COUNT];
+     TStack_alloc_size used[PUSH_COUNT];
+     StackAlloc_Init(&sa, g_header_buffer, HEADER_BUFFER_SIZE);
+ 
+     (void)StackAlloc_Alloc(&sa, 24U);
+     TStack_alloc_size base = StackAlloc_GetUsed(&sa);
+ 
+     for (uint32 i = 0U; i < PUSH_COUNT; i++) {
+         used[i] = StackAlloc_GetUsed(&sa);
+         blocks[i] = (uint8*)StackAlloc_PushAligned(&sa, g_push_sizes[i], g_push_alignments[i]);
+         TEST_ASSERT(blocks[i] != NULL_PTR, "Push should succeed");
+         TEST_ASSERT(((TStack_alloc_addr)blocks[i] % g_push_alignments[i]) == 0U, "Block should be aligned");
+         memset(blocks[i], 0xFF, g_push_sizes[i]);
+     }
+ 
+     // Blocks come off one at a time, newest first
+     for (uint32 i = PUSH_COUNT; i-- > 0U;) {
+         TEST_ASSERT(StackAlloc_Pop(&sa) == STACK_ALLOC_OK, "Pop should succeed");
+         TEST_ASSERT(StackAlloc_GetUsed(&sa) == used[i], "Pop should restore the top before the push");
+     }
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == base, "Blocks below the pushed ones should stay");
+ 
+     // A one-byte record fits in the slack an aligned stream leaves anyway
+     TStack_alloc_size before = StackAlloc_GetUsed(&sa);
+     (void)StackAlloc_Push(&sa, 13U);
+     (void)StackAlloc_Alloc(&sa, 8U);
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) - before == ((STACK_ALLOC_HEADER_VARINT == 1U) ? 24U : 32U),
+                 "A 13-byte block should only cost its record if it does not fit the padding");
+ 
+     TEST_ASSERT(StackAlloc_GetPushOverhead(100U, 8U) == ((STACK_ALLOC_HEADER_VARINT == 1U) ? 1U : 4U),
+                 "Small blocks should need a one-byte record");
+     TEST_ASSERT(StackAlloc_GetPushOverhead(16384U, 8U) == ((STACK_ALLOC_HEADER_VARINT == 1U) ? 3U : 4U),
+                 "Blocks above 16 KiB should need a three-byte record");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_push_errors(void)
+ {
+     TStack_alloc sa;
+     StackAlloc_Init(&sa, g_header_buffer, 256U);
+ 
+     TEST_ASSERT(StackAlloc_Pop(&sa) == STACK_ALLOC_ERROR_INVALID_MARKER, "Empty arena should not pop");
+     TEST_ASSERT(StackAlloc_Pop(NULL_PTR) == STACK_ALLOC_ERROR_INVALID_PARAM, "NULL arena should fail");
+     TEST_ASSERT(StackAlloc_Push(&sa, 0U) == NULL_PTR, "Zero size should fail");
+     TEST_ASSERT(StackAlloc_PushAligned(&sa, 8U, 3U) == NULL_PTR, "Invalid alignment should fail");
+     TEST_ASSERT(StackAlloc_Push(&sa, STACK_ALLOC_SIZE_MAX) == NULL_PTR, "Oversized push should fail");
+ 
+     // The record must fit too
+     TStack_alloc_size used = StackAlloc_GetUsed(&sa);
+     TEST_ASSERT(StackAlloc_Push(&sa, 256U) == NULL_PTR, "Push without room for the record should fail");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == used, "Failed push should not allocate");
+     TEST_ASSERT(StackAlloc_Push(&sa, 256U - 8U) != NULL_PTR, "Push with room for the record should fit");
+ 
+     // A corrupted record is detected rather than rewinding past the start
+     StackAlloc_Reset(&sa);
+     uint8* block = (uint8*)StackAlloc_Push(&sa, 8U);
+     memset(block, 0xFF, 9U);
+     TEST_ASSERT(StackAlloc_Pop(&sa) == STACK_ALLOC_ERROR_CORRUPTED_STATE, "Bad record should be reported");
+ 
+     TStack_alloc down;
+     StackAlloc_InitDown(&down, g_header_buffer, 256U);
+     TEST_ASSERT(StackAlloc_Push(&down, 8U) == NULL_PTR, "Downward arenas should be rejected");
+     TEST_ASSERT(StackAlloc_Pop(&down) == STACK_ALLOC_ERROR_INVALID_PARAM, "Downward arenas should be rejected");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_push_chained(void)
+ {
+     uint8 initial[256];
+     TStack_alloc_provider provider = StackAlloc_MallocProvider();
+     TStack_alloc sa;
+     StackAlloc_InitChained(&sa, initial, sizeof(initial), &provider, 1024U);
+ 
+     // Spread pushed blocks over the initial buffer and several chunks
+     for (uint32 i = 0U; i < 40U; i++) {
+         uint8* block = (uint8*)StackAlloc_Push(&sa, 100U);
+         TEST_ASSERT(block != NULL_PTR, "Push should grow the arena");
+         block[0] = (uint8)i;
+     }
+     TEST_ASSERT(StackAlloc_GetChunkCount(&sa) >= 3U, "Blocks should span several chunks");
+ 
+     for (uint32 i = 0U; i < 40U; i++) {
+         TEST_ASSERT(StackAlloc_Pop(&sa) == STACK_ALLOC_OK, "Pop should cross chunk boundaries");
+     }
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == 0U, "Every block should be popped");
+     TEST_ASSERT(StackAlloc_GetChunkCount(&sa) == 0U, "Every chunk should be unlinked");
+     TEST_ASSERT(StackAlloc_Pop(&sa) == STACK_ALLOC_ERROR_INVALID_MARKER, "Empty arena should not pop");
+ 
+     StackAlloc_Deinit(&sa);
+     return TRUE;
+ }
+ 
+ /* ========================= Test Runner ========================= */
+ 
+ boolean StackAllocHeader_RunAllTests(void)
+ {
+     boolean all_passed = TRUE;
+ 
+     printf("=== Starting Push/Pop Test Suite ===\n");
+ 
+     TEST_CASE(push_pop);
+     TEST_CASE(push_errors);
+     TEST_CASE(push_chained);
+ 
+     return all_passed;
+ }
@@ -0,0 +1,251 @@
+/**
+ * @file        stack_alloc_lease_test.c
+ * @brief       Test suite for thread arenas leasing chunks from a shared arena
+ * @details     Tests giving chunks back, recycling out-of-order returns, several
+ *              threads leasing at once and threads that exit without deinitializing
+ *              their arena. Uses ONLY public API.
+ */
+
+ #include "stack_alloc_test.h"
+ #include "test_utils.h"
+ #include "stack_alloc_lease.h"
+ #include "stack_alloc_chain.h"
+ 
+ #define LEASE_TEST_THREADS      4
+ #define LEASE_TEST_BUFFER_SIZE  (4U * 1024U * 1024U)
+ #define LEASE_TEST_CHUNK        (4096U)
+ 
+ /* Leases are cache-line aligned; an aligned buffer keeps the used sizes exact */
+ static _Alignas(STACK_ALLOC_CACHE_LINE_SIZE) uint8 g_lease_buffer[LEASE_TEST_BUFFER_SIZE];
+ 
+ typedef struct {
+     TStack_alloc_lease_pool* pool;
+     uint32 id;
+     boolean ok;
+ } TLease_worker;
+ 
+ static void* LeaseWorker(void* arg)
+ {
+     TLease_worker* worker = (TLease_worker*)arg;
+     TStack_alloc sa;
+ 
+     worker->ok = FALSE;
+     if (StackAlloc_InitLeased(&sa, worker->pool) != STACK_ALLOC_OK)
+     {
+         return NULL_PTR;
+     }
+ 
+     worker->ok = TRUE;
+     for (uint32 round = 0U; round < 20U; round++)
+     {
+         uint32* blocks[200];
+ 
+         /* The first block of the round doubles as its marker */
+         for (uint32 i = 0U; i < 200U; i++)
+         {
+             blocks[i] = (uint32*)StackAlloc_Alloc(&sa, 48U);
+             if (blocks[i] == NULL_PTR)
+             {
+                 worker->ok = FALSE;
+                 break;
+             }
+             blocks[i][0] = worker->id;
+             blocks[i][11] = i;
+         }
+         for (uint32 i = 0U; (worker->ok == TRUE) && (i < 200U); i++)
+         {
+             if ((blocks[i][0] != worker->id) || (blocks[i][11] != i))
+             {
+                 worker->ok = FALSE;
+             }
+         }
+         if ((worker->ok == TRUE) && (StackAlloc_FreeToMarker(&sa, blocks[0]) != STACK_ALLOC_OK))
+         {
+             worker->ok = FALSE;
+         }
+     }
+ 
+     StackAlloc_Deinit(&sa);
+     return NULL_PTR;
+ }
+ 
+ typedef struct {
+     TStack_alloc_lease_pool* pool;
+     pthread_barrier_t* barrier;
+     uint8* block;
+ } TLease_exit_worker;
+ 
+ /* Leases a chunk through StackAlloc_LeaseGet() and exits without deinitializing */
+ static void* LeaseExitWorker(void* arg)
+ {
+     TLease_exit_worker* worker = (TLease_exit_worker*)arg;
+     TStack_alloc* sa = StackAlloc_LeaseGet(worker->pool);
+ 
+     worker->block = (sa != NULL_PTR) ? (uint8*)StackAlloc_Alloc(sa, 64U) : NULL_PTR;
+     (void)pthread_barrier_wait(worker->barrier);   /* chunk leased */
+     (void)pthread_barrier_wait(worker->barrier);   /* main thread leased above it */
+     return NULL_PTR;
+ }
+ 
+ /* ========================= Individual Test Cases ========================= */
+ 
+ static boolean test_lease_give_back(void)
+ {
+     TStack_alloc global;
+     TStack_alloc_lease_pool pool;
+     TStack_alloc local;
+ 
+     TEST_ASSERT(StackAlloc_Init(&global, g_lease_buffer, LEASE_TEST_BUFFER_SIZE) == STACK_ALLOC_OK, "Init should succeed");
+     TEST_ASSERT(StackAlloc_LeasePoolInit(NULL_PTR, &global, 0U) == STACK_ALLOC_ERROR_INVALID_PARAM, "NULL pool should fail");
+     TEST_ASSERT(StackAlloc_LeasePoolInit(&pool, &global, LEASE_TEST_CHUNK) == STACK_ALLOC_OK, "Pool init should succeed");
+     TEST_ASSERT(StackAlloc_InitLeased(&local, &pool) == STACK_ALLOC_OK, "Leased arena init should succeed");
+ 
+     void* ptr = StackAlloc_Alloc(&local, 100U);
+     TEST_ASSERT(ptr != NULL_PTR, "First allocation should lease a chunk");
+     TEST_ASSERT(StackAlloc_GetUsed(&global) == LEASE_TEST_CHUNK, "Exactly one chunk should be leased");
+     TEST_ASSERT(((TStack_alloc_addr)ptr % STACK_ALLOC_ALIGNMENT) == 0U, "Block should be aligned");
+ 
+     for (uint32 i = 0U; i < 100U; i++)
+     {
+         TEST_ASSERT(StackAlloc_Alloc(&local, 100U) != NULL_PTR, "Allocations should keep leasing chunks");
+     }
+     TEST_ASSERT(StackAlloc_GetChunkCount(&local) > 1U, "Several chunks should be leased");
+ 
+     StackAlloc_Deinit(&local);
+     TEST_ASSERT(StackAlloc_GetUsed(&global) == 0U, "Chunks on top should be given back");
+     TEST_ASSERT(StackAlloc_LeasePoolGetRecycled(&pool) == 0U, "Nothing should need recycling");
+ 
+     StackAlloc_LeasePoolDeinit(&pool);
+     return TRUE;
+ }
+ 
+ static boolean test_lease_recycle(void)
+ {
+     TStack_alloc global;
+     TStack_alloc_lease_pool pool;
+     TStack_alloc a;
+     TStack_alloc b;
+     TStack_alloc c;
+ 
+     TEST_ASSERT(StackAlloc_Init(&global, g_lease_buffer, LEASE_TEST_BUFFER_SIZE) == STACK_ALLOC_OK, "Init should succeed");
+     TEST_ASSERT(StackAlloc_LeasePoolInit(&pool, &global, LEASE_TEST_CHUNK) == STACK_ALLOC_OK, "Pool init should succeed");
+     TEST_ASSERT(StackAlloc_InitLeased(&a, &pool) == STACK_ALLOC_OK, "Init a should succeed");
+     TEST_ASSERT(StackAlloc_InitLeased(&b, &pool) == STACK_ALLOC_OK, "Init b should succeed");
+     TEST_ASSERT(StackAlloc_InitLeased(&c, &pool) == STACK_ALLOC_OK, "Init c should succeed");
+ 
+     uint8* in_a = (uint8*)StackAlloc_Alloc(&a, 64U);
+     TEST_ASSERT(in_a != NULL_PTR && StackAlloc_Alloc(&b, 64U) != NULL_PTR, "Both arenas should lease");
+     TStack_alloc_size used = StackAlloc_GetUsed(&global);
+ 
+     /* a's chunk is below b's, so it cannot be given back */
+     StackAlloc_Deinit(&a);
+     TEST_ASSERT(StackAlloc_GetUsed(&global) == used, "Out-of-order chunk should stay leased");
+     TEST_ASSERT(StackAlloc_LeasePoolGetRecycled(&pool) == 1U, "Out-of-order chunk should be recycled");
+ 
+     uint8* in_c = (uint8*)StackAlloc_Alloc(&c, 64U);
+     TEST_ASSERT(StackAlloc_LeasePoolGetRecycled(&pool) == 0U, "Next lease should reuse the recycled chunk");
+     TEST_ASSERT(StackAlloc_GetUsed(&global) == used, "Reuse should not grow the shared arena");
+     TEST_ASSERT(in_c == in_a, "Reused chunk should be a's former chunk");
+ 
+     StackAlloc_Deinit(&c);
+     StackAlloc_Deinit(&b);
+     StackAlloc_LeasePoolReset(&pool);
+     TEST_ASSERT(StackAlloc_GetUsed(&global) == 0U, "Pool reset should empty the shared arena");
+ 
+     StackAlloc_LeasePoolDeinit(&pool);
+     return TRUE;
+ }
+ 
+ static boolean test_lease_threads(void)
+ {
+     pthread_t threads[LEASE_TEST_THREADS];
+     TLease_worker workers[LEASE_TEST_THREADS];
+     TStack_alloc global;
+     TStack_alloc_lease_pool pool;
+ 
+     TEST_ASSERT(StackAlloc_Init(&global, g_lease_buffer, LEASE_TEST_BUFFER_SIZE) == STACK_ALLOC_OK, "Init should succeed");
+     TEST_ASSERT(StackAlloc_LeasePoolInit(&pool, &global, LEASE_TEST_CHUNK) == STACK_ALLOC_OK, "Pool init should succeed");
+ 
+     for (uint32 i = 0U; i < LEASE_TEST_THREADS; i++)
+     {
+         workers[i].pool = &pool;
+         workers[i].id = i + 1U;
+         TEST_ASSERT(pthread_create(&threads[i], NULL_PTR, LeaseWorker, &workers[i]) == 0, "Thread should start");
+     }
+     for (uint32 i = 0U; i < LEASE_TEST_THREADS; i++)
+     {
+         (void)pthread_join(threads[i], NULL_PTR);
+     }
+ 
+     for (uint32 i = 0U; i < LEASE_TEST_THREADS; i++)
+     {
+         TEST_ASSERT(workers[i].ok == TRUE, "Each thread should see only its own data");
+     }
+     TEST_ASSERT(StackAlloc_GetUsed(&global) ==
+                 ((TStack_alloc_size)StackAlloc_LeasePoolGetRecycled(&pool) * LEASE_TEST_CHUNK),
+                 "Every leased chunk should be given back or recycled");
+ 
+     StackAlloc_LeasePoolDeinit(&pool);
+     return TRUE;
+ }
+ 
+ static boolean test_lease_thread_exit(void)
+ {
+     TStack_alloc global;
+     TStack_alloc_lease_pool pool;
+     pthread_barrier_t barrier;
+     pthread_t thread;
+     TLease_exit_worker worker;
+ 
+     TEST_ASSERT(StackAlloc_Init(&global, g_lease_buffer, LEASE_TEST_BUFFER_SIZE) == STACK_ALLOC_OK, "Init should succeed");
+     TEST_ASSERT(StackAlloc_LeasePoolInit(&pool, &global, LEASE_TEST_CHUNK) == STACK_ALLOC_OK, "Pool init should succeed");
+     TEST_ASSERT(StackAlloc_LeaseGet(NULL_PTR) == NULL_PTR, "NULL pool should fail");
+     TEST_ASSERT(pthread_barrier_init(&barrier, NULL_PTR, 2U) == 0, "Barrier init should succeed");
+ 
+     // The worker's chunk ends up below the main thread's, so it cannot be given back
+     worker.pool = &pool;
+     worker.barrier = &barrier;
+     worker.block = NULL_PTR;
+     TEST_ASSERT(pthread_create(&thread, NULL_PTR, LeaseExitWorker, &worker) == 0, "Thread should start");
+     (void)pthread_barrier_wait(&barrier);
+     TStack_alloc* mine = StackAlloc_LeaseGet(&pool);
+     TEST_ASSERT(mine != NULL_PTR && StackAlloc_LeaseGet(&pool) == mine, "Thread arena should be created once");
+     TEST_ASSERT(StackAlloc_Alloc(mine, 64U) != NULL_PTR, "Main thread should lease above the worker");
+     (void)pthread_barrier_wait(&barrier);
+     (void)pthread_join(thread, NULL_PTR);
+     (void)pthread_barrier_destroy(&barrier);
+ 
+     TEST_ASSERT(worker.block != NULL_PTR, "Worker should have leased a chunk");
+     TEST_ASSERT(StackAlloc_LeasePoolGetRecycled(&pool) == 1U, "Chunk of the exited thread should be recycled");
+ 
+     // The next lease reuses it
+     TStack_alloc other;
+     TEST_ASSERT(StackAlloc_InitLeased(&other, &pool) == STACK_ALLOC_OK, "Init should succeed");
+     TEST_ASSERT((uint8*)StackAlloc_Alloc(&other, 64U) == worker.block, "Recycled chunk should be leased again");
+     StackAlloc_Deinit(&other);
+ 
+     // Releasing the main thread's arena returns its chunk as well
+     StackAlloc_LeaseRelease();
+     TEST_ASSERT(StackAlloc_GetUsed(&global) ==
+                 ((TStack_alloc_size)StackAlloc_LeasePoolGetRecycled(&pool) * LEASE_TEST_CHUNK),
+                 "Every leased chunk should be given back or recycled");
+ 
+     StackAlloc_LeasePoolDeinit(&pool);
+     return TRUE;
+ }
+ 
+ /* ========================= Test Runner ========================= */
+ 
+ boolean StackAllocLease_RunAllTests(void)
+ {
+     boolean all_passed = TRUE;
+ 
+     printf("=== Starting Leased Stack Allocator Test Suite ===\n");
+ 
+     TEST_CASE(lease_give_back);
+     TEST_CASE(lease_recycle);
+     TEST_CASE(lease_threads);
+     TEST_CASE(lease_thread_exit);
+ 
+     return all_passed;
+ }
@@ -0,0 +1,175 @@
+/**
+ * @file        stack_alloc_measure_test.c
+ * @brief       Test suite for measuring (dry-run) arenas
+ * @details     Tests that a buffer of the measured size replays the same code path,
+ *              the collected statistics and the functions a measuring arena rejects.
+ *              Uses ONLY public API.
+ */
+
+ #include "stack_alloc_test.h"
+ #include "test_utils.h"
+ #include "stack_alloc_measure.h"
+ #include "stack_alloc_batch.h"
+ #include "stack_alloc_header.h"
+ #include "stack_alloc_chain.h"
+ #include <string.h>
+ 
+ #define MEASURE_BUFFER_SIZE  (16U * 1024U)
+ 
+ static uint8 g_measure_buffer[MEASURE_BUFFER_SIZE] __attribute__((aligned(4096)));
+ 
+ static const TStack_alloc_request g_measure_batch[] = { { 24U, 8U }, { 3U, 1U }, { 128U, 64U } };
+ 
+ /**
+  * @brief Code path under test: fails if any allocation fails, writes only if touch is TRUE
+  */
+ static boolean run_path(TStack_alloc* sa, boolean touch)
+ {
+     void* blocks[3];
+ 
+     for (uint32 cycle = 0U; cycle < 3U; cycle++) {
+         void* mark = StackAlloc_GetMarker(sa);
+         uint8* a = (uint8*)StackAlloc_Alloc(sa, 10U + cycle);
+         uint8* b = (uint8*)StackAlloc_AllocAligned(sa, 100U, 256U);
+         uint8* c = (uint8*)StackAlloc_Calloc(sa, 7U, 3U);
+         if ((a == NULL_PTR) || (b == NULL_PTR) || (c == NULL_PTR)) {
+             return FALSE;
+         }
+         if (touch == TRUE) {
+             memset(a, 1, 10U + cycle);
+             memset(b, 2, 100U);
+         }
+ 
+         c = (uint8*)StackAlloc_Realloc(sa, c, 21U, 400U * (cycle + 1U));
+         uint8* d = (uint8*)StackAlloc_Realloc(sa, b, 100U, 300U);
+         if ((c == NULL_PTR) || (d == NULL_PTR) ||
+             (StackAlloc_AllocBatch(sa, g_measure_batch, 3U, blocks, STACK_ALLOC_BATCH_REORDER) != STACK_ALLOC_OK)) {
+             return FALSE;
+         }
+         if ((touch == TRUE) && (d[99] != 2U)) {
+             return FALSE;
+         }
+ 
+         if (cycle == 1U) {
+             (void)StackAlloc_FreeToMarker(sa, mark);
+         }
+     }
+ 
+     StackAlloc_Reset(sa);
+     return (StackAlloc_Alloc(sa, 1000U) != NULL_PTR) ? TRUE : FALSE;
+ }
+ 
+ /* ========================= Individual Test Cases ========================= */
+ 
+ static boolean test_measure_replay(void)
+ {
+     TStack_alloc measuring;
+     TStack_alloc_measure stats;
+     TEST_ASSERT(StackAlloc_InitMeasure(&measuring) == STACK_ALLOC_OK, "Measuring init should succeed");
+     TEST_ASSERT(run_path(&measuring, FALSE) == TRUE, "Measuring run should never fail");
+     TEST_ASSERT(StackAlloc_GetMeasure(&measuring, &stats) == STACK_ALLOC_OK, "Stats should be available");
+     TEST_ASSERT(StackAlloc_Validate(&measuring) == STACK_ALLOC_OK, "Measuring arena should be valid");
+ 
+     TStack_alloc_size size = StackAlloc_GetMeasuredSize(&measuring);
+     TEST_ASSERT(size == stats.peak + 256U - STACK_ALLOC_ALIGNMENT, "Size should cover the worst start alignment");
+     TEST_ASSERT(size <= MEASURE_BUFFER_SIZE - 256U, "Test buffer should be large enough");
+ 
+     // Every start alignment replays the path in exactly the measured size
+     for (uint32 offset = 0U; offset < 256U; offset += STACK_ALLOC_ALIGNMENT) {
+         TStack_alloc sa;
+         StackAlloc_Init(&sa, g_measure_buffer + offset, size);
+         TEST_ASSERT(run_path(&sa, TRUE) == TRUE, "Real run should fit the measured size");
+     }
+ 
+     // With the largest alignment at the start, the peak alone is enough, and exact
+     TStack_alloc sa;
+     StackAlloc_Init(&sa, g_measure_buffer, stats.peak);
+     TEST_ASSERT(run_path(&sa, TRUE) == TRUE, "Aligned real run should fit the peak");
+     StackAlloc_Init(&sa, g_measure_buffer, stats.peak - 1U);
+     TEST_ASSERT(run_path(&sa, TRUE) == FALSE, "One byte less should not fit");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_measure_stats(void)
+ {
+     TStack_alloc sa;
+     TStack_alloc_measure stats;
+     StackAlloc_InitMeasure(&sa);
+ 
+     (void)StackAlloc_Alloc(&sa, 3U);                 /* 0..3 */
+     (void)StackAlloc_AllocAligned(&sa, 10U, 16U);    /* 16..26, 13 bytes of padding */
+     void* mark = StackAlloc_GetMarker(&sa);
+     (void)StackAlloc_AllocAligned(&sa, 100U, 64U);   /* 64..164, 38 bytes of padding */
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == 164U, "Used should include padding");
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, mark) == STACK_ALLOC_OK, "Markers should work");
+     (void)StackAlloc_Alloc(&sa, 8U);                 /* 32..40, 6 bytes of padding */
+ 
+     TEST_ASSERT(StackAlloc_GetMeasure(&sa, &stats) == STACK_ALLOC_OK, "Stats should be available");
+     TEST_ASSERT(stats.peak == 164U, "Peak should be the highest top");
+     TEST_ASSERT(stats.requested == 121U, "Requested bytes should be summed");
+     TEST_ASSERT(stats.padding == 57U, "Padding should be summed");
+     TEST_ASSERT(stats.max_alignment == 64U, "Largest alignment should be kept");
+     TEST_ASSERT(stats.allocations == 4U, "Allocations should be counted");
+ 
+     // Statistics outlive a reset; a smaller cycle leaves the peak alone
+     StackAlloc_Reset(&sa);
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == 0U, "Reset should empty the arena");
+     (void)StackAlloc_Alloc(&sa, 50U);
+     StackAlloc_GetMeasure(&sa, &stats);
+     TEST_ASSERT((stats.peak == 164U) && (stats.allocations == 5U), "Reset should keep the statistics");
+ 
+     // Nothing is zeroed or copied, so even huge blocks are free to measure
+     TEST_ASSERT(StackAlloc_Calloc(&sa, 1024U, 1024U * 1024U) != NULL_PTR, "Measuring calloc should not touch memory");
+     TEST_ASSERT(StackAlloc_GetAvailable(&sa) == StackAlloc_GetCapacity(&sa) - StackAlloc_GetUsed(&sa),
+                 "Available should be the rest of the capacity");
+     TEST_ASSERT(StackAlloc_Alloc(&sa, STACK_ALLOC_SIZE_MAX) == NULL_PTR, "Capacity should still be enforced");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_measure_errors(void)
+ {
+     TStack_alloc sa;
+     TStack_alloc fixed;
+     TStack_alloc_measure stats;
+     TStack_alloc_size window;
+     StackAlloc_InitMeasure(&sa);
+     StackAlloc_Init(&fixed, g_measure_buffer, 256U);
+ 
+     TEST_ASSERT(StackAlloc_InitMeasure(NULL_PTR) == STACK_ALLOC_ERROR_INVALID_PARAM, "NULL arena should fail");
+     TEST_ASSERT(StackAlloc_GetMeasure(&fixed, &stats) == STACK_ALLOC_ERROR_INVALID_PARAM, "Fixed arena has no stats");
+     TEST_ASSERT(StackAlloc_GetMeasure(&sa, NULL_PTR) == STACK_ALLOC_ERROR_INVALID_PARAM, "NULL stats should fail");
+     TEST_ASSERT(StackAlloc_GetMeasuredSize(&fixed) == 0U, "Fixed arena has no measured size");
+     TEST_ASSERT(StackAlloc_GetMeasuredSize(&sa) == STACK_ALLOC_ALIGNMENT, "Empty run should need the minimum buffer");
+ 
+     // Anything that needs the contents is refused
+     TEST_ASSERT(StackAlloc_Push(&sa, 8U) == NULL_PTR, "Push should be rejected");
+     TEST_ASSERT(StackAlloc_Pop(&sa) == STACK_ALLOC_ERROR_INVALID_PARAM, "Pop should be rejected");
+     TEST_ASSERT(StackAlloc_OpenBlock(&sa, 8U, &window) == NULL_PTR, "Open blocks should be rejected");
+     TEST_ASSERT(StackAlloc_CommitBlock(&sa, StackAlloc_GetMarker(&sa), 0U) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                 "Open blocks should be rejected");
+ 
+     TStack_alloc child;
+     TStack_alloc_provider provider = StackAlloc_ParentProvider(&sa);
+     StackAlloc_InitChained(&child, NULL_PTR, 0U, &provider, 1024U);
+     TEST_ASSERT(StackAlloc_Alloc(&child, 8U) == NULL_PTR, "A measuring parent should not back chunks");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == 0U, "Refused chunk should not be counted");
+ 
+     return TRUE;
+ }
+ 
+ /* ========================= Test Runner ========================= */
+ 
+ boolean StackAllocMeasure_RunAllTests(void)
+ {
+     boolean all_passed = TRUE;
+ 
+     printf("=== Starting Measuring Arena Test Suite ===\n");
+ 
+     TEST_CASE(measure_replay);
+     TEST_CASE(measure_stats);
+     TEST_CASE(measure_errors);
+ 
+     return all_passed;
+ }
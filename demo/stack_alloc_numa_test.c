@@ -0,0 +1,94 @@
+/**
+ * @file        stack_alloc_numa_test.c
+ * @brief       Test suite for NUMA placement of virtual-memory stack allocators
+ * @details     Binds arenas to the local node and checks where the pages landed.
+ *              Works on single-node machines as well. Uses ONLY public API.
+ */
+
+ #include "stack_alloc_test.h"
+ #include "test_utils.h"
+ #include "stack_alloc_numa.h"
+ #include <string.h>
+ 
+ #define NUMA_TEST_MAX_NODES  64U
+ 
+ /* ========================= Individual Test Cases ========================= */
+ 
+ static boolean test_numa_topology(void)
+ {
+     uint32 nodes = StackAlloc_GetNodeCount();
+ 
+     printf("  nodes: %u, current node: %u\n", nodes, StackAlloc_GetCurrentNode());
+     TEST_ASSERT(nodes >= 1U, "There should be at least one node");
+     TEST_ASSERT(StackAlloc_GetCurrentNode() < nodes, "Current node should be a valid node");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_numa_bind_local(void)
+ {
+     TStack_alloc sa;
+     TStack_alloc_size per_node[NUMA_TEST_MAX_NODES];
+     TStack_alloc_size size = 1024U * 1024U;
+ 
+     TEST_ASSERT(StackAlloc_InitVirtualOnNode(&sa, 16U * size, 0U, STACK_ALLOC_VM_DEFAULT,
+                                              STACK_ALLOC_NUMA_LOCAL_NODE) == STACK_ALLOC_OK,
+                 "Binding to the local node should succeed");
+ 
+     uint32 node = StackAlloc_GetCurrentNode();
+     uint8* block = (uint8*)StackAlloc_Alloc(&sa, size);
+     TEST_ASSERT(block != NULL_PTR, "Allocation should succeed");
+     memset(block, 0x3C, size);
+ 
+     TStack_alloc_size resident = StackAlloc_QueryNodes(&sa, per_node, NUMA_TEST_MAX_NODES);
+     TStack_alloc_size touched = size / StackAlloc_GetPageSize();
+     TEST_ASSERT(resident >= touched, "Touched pages should be resident");
+     if (node < NUMA_TEST_MAX_NODES) {
+         TEST_ASSERT(per_node[node] == resident, "All pages should be on the bound node");
+     }
+ 
+     StackAlloc_Deinit(&sa);
+     return TRUE;
+ }
+ 
+ static boolean test_numa_invalid(void)
+ {
+     uint8 buffer[256];
+     TStack_alloc sa;
+     TStack_alloc_size per_node[NUMA_TEST_MAX_NODES];
+ 
+     // Only virtual arenas own their range
+     StackAlloc_Init(&sa, buffer, sizeof(buffer));
+     TEST_ASSERT(StackAlloc_BindToNode(&sa, 0) == STACK_ALLOC_ERROR_INVALID_PARAM, "Fixed arena cannot be bound");
+     TEST_ASSERT(StackAlloc_BindToNode(NULL_PTR, 0) == STACK_ALLOC_ERROR_INVALID_PARAM, "NULL sa should fail");
+ 
+     // Out-of-range nodes are rejected and the range is released again
+     sint32 bad = (sint32)StackAlloc_GetNodeCount();
+     TEST_ASSERT(StackAlloc_InitVirtualOnNode(&sa, 1024U * 1024U, 0U, STACK_ALLOC_VM_DEFAULT, bad) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                 "Non-existent node should fail");
+     TEST_ASSERT(StackAlloc_InitVirtualOnNode(&sa, 1024U * 1024U, 0U, STACK_ALLOC_VM_DEFAULT, -5) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                 "Negative node should fail");
+ 
+     // Untouched arenas have no resident pages
+     StackAlloc_InitVirtualOnNode(&sa, 1024U * 1024U, 0U, STACK_ALLOC_VM_DEFAULT, 0);
+     TEST_ASSERT(StackAlloc_QueryNodes(&sa, per_node, NUMA_TEST_MAX_NODES) == 0U, "Nothing should be resident yet");
+     TEST_ASSERT(StackAlloc_QueryNodes(&sa, NULL_PTR, NUMA_TEST_MAX_NODES) == 0U, "NULL output should fail");
+     StackAlloc_Deinit(&sa);
+ 
+     return TRUE;
+ }
+ 
+ /* ========================= Test Runner ========================= */
+ 
+ boolean StackAllocNuma_RunAllTests(void)
+ {
+     boolean all_passed = TRUE;
+ 
+     printf("=== Starting NUMA Stack Allocator Test Suite ===\n");
+ 
+     TEST_CASE(numa_topology);
+     TEST_CASE(numa_bind_local);
+     TEST_CASE(numa_invalid);
+ 
+     return all_passed;
+ }
@@ -0,0 +1,250 @@
+/**
+ * @file        stack_alloc_percpu_test.c
+ * @brief       Test suite for per-CPU stack allocators
+ * @details     Oversubscribes the CPUs with threads that tag every block they get, so
+ *              that any overlap between allocations (e.g. a missed restart after a
+ *              preemption) shows up as corrupted data. Runs with and without rseq, and
+ *              with threads that keep migrating between two CPUs.
+ *              Uses ONLY public API.
+ */
+
+ #if defined(__linux__) && !defined(_GNU_SOURCE)
+ #define _GNU_SOURCE             /* sched_setaffinity() */
+ #endif
+ 
+ #include "stack_alloc_test.h"
+ #include "test_utils.h"
+ #include "stack_alloc_percpu.h"
+ #include <pthread.h>
+ 
+ #if defined(__linux__)
+ #include <sched.h>
+ #endif
+ 
+ #if defined(__linux__) && defined(__has_include)
+ #if __has_include(<sys/rseq.h>)
+ #include <sys/rseq.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+ #define PERCPU_TEST_HAS_RSEQ  (1U)
+ #endif
+ #endif
+ 
+ #define PERCPU_TEST_THREADS  8
+ #define PERCPU_TEST_BLOCKS   20000
+ #define PERCPU_TEST_HOP      16U     /* allocations between two forced migrations */
+ 
+ typedef struct {
+     TStack_alloc_percpu* pc;
+     uint32 id;
+     boolean ok;
+     int cpus[2];                    /* CPUs to alternate between, or -1 to stay put */
+ } TPercpu_worker;
+ 
+ static void* PercpuWorker(void* arg)
+ {
+     TPercpu_worker* worker = (TPercpu_worker*)arg;
+     static __thread uint32* blocks[PERCPU_TEST_BLOCKS];
+ 
+     worker->ok = TRUE;
+     for (uint32 i = 0U; i < PERCPU_TEST_BLOCKS; i++)
+     {
+ #if defined(__linux__)
+         if ((worker->cpus[0] >= 0) && ((i % PERCPU_TEST_HOP) == 0U))
+         {
+             cpu_set_t set;
+             CPU_ZERO(&set);
+             CPU_SET(worker->cpus[(i / PERCPU_TEST_HOP) & 1U], &set);
+             (void)sched_setaffinity(0, sizeof(set), &set);
+         }
+ #endif
+         blocks[i] = (uint32*)StackAlloc_PerCpuAlloc(worker->pc, 24U);
+         if ((blocks[i] == NULL_PTR) || (((TStack_alloc_addr)blocks[i] % STACK_ALLOC_ALIGNMENT) != 0U))
+         {
+             worker->ok = FALSE;
+             return NULL_PTR;
+         }
+         blocks[i][0] = worker->id;
+         blocks[i][5] = i;
+     }
+     for (uint32 i = 0U; i < PERCPU_TEST_BLOCKS; i++)
+     {
+         if ((blocks[i][0] != worker->id) || (blocks[i][5] != i))
+         {
+             worker->ok = FALSE;
+         }
+     }
+ 
+     return NULL_PTR;
+ }
+ 
+ static boolean RunWorkers(TStack_alloc_percpu* pc, const int cpus[2])
+ {
+     pthread_t threads[PERCPU_TEST_THREADS];
+     TPercpu_worker workers[PERCPU_TEST_THREADS];
+     boolean ok = TRUE;
+ 
+     for (uint32 i = 0U; i < PERCPU_TEST_THREADS; i++)
+     {
+         workers[i].pc = pc;
+         workers[i].id = i + 1U;
+         workers[i].ok = FALSE;
+         workers[i].cpus[0] = (cpus != NULL_PTR) ? cpus[0] : -1;
+         workers[i].cpus[1] = (cpus != NULL_PTR) ? cpus[1] : -1;
+         if (pthread_create(&threads[i], NULL_PTR, PercpuWorker, &workers[i]) != 0)
+         {
+             return FALSE;
+         }
+     }
+     for (uint32 i = 0U; i < PERCPU_TEST_THREADS; i++)
+     {
+         (void)pthread_join(threads[i], NULL_PTR);
+         ok = ((ok == TRUE) && (workers[i].ok == TRUE)) ? TRUE : FALSE;
+     }
+ 
+     return ok;
+ }
+ 
+ #if defined(PERCPU_TEST_HAS_RSEQ)
+ /* Unregisters the thread's rseq area (as glibc registered it), then allocates */
+ static void* UnregisteredWorker(void* arg)
+ {
+     TPercpu_worker* worker = (TPercpu_worker*)arg;
+     struct rseq* rs = (struct rseq*)((uint8*)__builtin_thread_pointer() + __rseq_offset);
+ 
+     worker->ok = TRUE;
+     /* The length must match the registration, which glibc versions make differently */
+     if ((syscall(SYS_rseq, rs, (uint32)sizeof(*rs), RSEQ_FLAG_UNREGISTER, 0x53053053) != 0) &&
+         (syscall(SYS_rseq, rs, __rseq_size, RSEQ_FLAG_UNREGISTER, 0x53053053) != 0))
+     {
+         return NULL_PTR;   /* cannot unregister here: nothing to test */
+     }
+ 
+     uint8* a = (uint8*)StackAlloc_PerCpuAlloc(worker->pc, 100U);
+     uint8* b = (uint8*)StackAlloc_PerCpuAllocAligned(worker->pc, 64U, 64U);
+     worker->ok = ((a != NULL_PTR) && (b != NULL_PTR) && (b >= a + 100U) && (((TStack_alloc_addr)b % 64U) == 0U) &&
+                   (StackAlloc_PerCpuAlloc(worker->pc, 8192U) == NULL_PTR)) ? TRUE : FALSE;
+ 
+     return NULL_PTR;
+ }
+ #endif
+ 
+ /* ========================= Individual Test Cases ========================= */
+ 
+ static boolean test_percpu_basic(void)
+ {
+     TStack_alloc_percpu pc;
+ 
+     TEST_ASSERT(StackAlloc_PerCpuInit(NULL_PTR, 0U, STACK_ALLOC_PERCPU_DEFAULT) == STACK_ALLOC_ERROR_INVALID_PARAM, "NULL arena should fail");
+     TEST_ASSERT(StackAlloc_PerCpuInit(&pc, 4096U, STACK_ALLOC_PERCPU_DEFAULT) == STACK_ALLOC_OK, "Init should succeed");
+     TEST_ASSERT(pc.cpu_count >= 1U, "There should be at least one slice");
+ 
+     TEST_ASSERT(StackAlloc_PerCpuAlloc(&pc, 0U) == NULL_PTR, "Zero size should fail");
+     TEST_ASSERT(StackAlloc_PerCpuAllocAligned(&pc, 8U, 3U) == NULL_PTR, "Non power-of-two alignment should fail");
+ 
+     void* a = StackAlloc_PerCpuAlloc(&pc, 100U);
+     void* b = StackAlloc_PerCpuAllocAligned(&pc, 64U, 64U);
+     TEST_ASSERT(a != NULL_PTR && b != NULL_PTR, "Allocations should succeed");
+     TEST_ASSERT(((TStack_alloc_addr)b % 64U) == 0U, "Block should be aligned");
+     TEST_ASSERT(StackAlloc_PerCpuGetUsed(&pc) >= 164U, "Used should count both blocks");
+     TEST_ASSERT(StackAlloc_PerCpuAlloc(&pc, 8192U) == NULL_PTR, "Request larger than a slice should fail");
+ 
+     StackAlloc_PerCpuReset(&pc);
+     TEST_ASSERT(StackAlloc_PerCpuGetUsed(&pc) == 0U, "Reset should empty every slice");
+ 
+     StackAlloc_PerCpuDeinit(&pc);
+     TEST_ASSERT(StackAlloc_PerCpuAlloc(&pc, 8U) == NULL_PTR, "Deinitialized arena should fail");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_percpu_threads(void)
+ {
+     TStack_alloc_percpu pc;
+ 
+     TEST_ASSERT(StackAlloc_PerCpuInit(&pc, 0U, STACK_ALLOC_PERCPU_DEFAULT) == STACK_ALLOC_OK, "Init should succeed");
+     TEST_ASSERT(RunWorkers(&pc, NULL_PTR) == TRUE, "Blocks of different threads should never overlap");
+     TEST_ASSERT(StackAlloc_PerCpuGetUsed(&pc) == (TStack_alloc_size)PERCPU_TEST_THREADS * PERCPU_TEST_BLOCKS * 24U,
+                 "Used should match the blocks handed out");
+     StackAlloc_PerCpuDeinit(&pc);
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_percpu_no_rseq_thread(void)
+ {
+ #if defined(PERCPU_TEST_HAS_RSEQ)
+     TStack_alloc_percpu pc;
+     TPercpu_worker worker = { &pc, 1U, FALSE, { -1, -1 } };
+     pthread_t thread;
+ 
+     TEST_ASSERT(StackAlloc_PerCpuInit(&pc, 4096U, STACK_ALLOC_PERCPU_DEFAULT) == STACK_ALLOC_OK, "Init should succeed");
+     TEST_ASSERT(pthread_create(&thread, NULL_PTR, UnregisteredWorker, &worker) == 0, "Thread should start");
+     (void)pthread_join(thread, NULL_PTR);
+     TEST_ASSERT(worker.ok == TRUE, "A thread without rseq should fall back to the shared slice");
+     StackAlloc_PerCpuDeinit(&pc);
+ #endif
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_percpu_threads_atomic(void)
+ {
+     TStack_alloc_percpu pc;
+ 
+     TEST_ASSERT(StackAlloc_PerCpuInit(&pc, 0U, STACK_ALLOC_PERCPU_NO_RSEQ) == STACK_ALLOC_OK, "Init should succeed");
+     TEST_ASSERT(pc.use_rseq == FALSE, "Flag should force the atomic path");
+     TEST_ASSERT(RunWorkers(&pc, NULL_PTR) == TRUE, "Blocks of different threads should never overlap");
+     StackAlloc_PerCpuDeinit(&pc);
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_percpu_migrate(void)
+ {
+ #if defined(__linux__)
+     TStack_alloc_percpu pc;
+     cpu_set_t allowed;
+     int cpus[2] = { -1, -1 };
+     uint32 found = 0U;
+ 
+     TEST_ASSERT(sched_getaffinity(0, sizeof(allowed), &allowed) == 0, "Affinity query should succeed");
+     for (int cpu = 0; (cpu < CPU_SETSIZE) && (found < 2U); cpu++)
+     {
+         if (CPU_ISSET(cpu, &allowed))
+         {
+             cpus[found++] = cpu;
+         }
+     }
+     if (found < 2U)
+     {
+         return TRUE;    /* a single CPU cannot migrate anything */
+     }
+ 
+     /* Every hop moves the thread, so sections are aborted and restarted on the new CPU */
+     TEST_ASSERT(StackAlloc_PerCpuInit(&pc, 0U, STACK_ALLOC_PERCPU_DEFAULT) == STACK_ALLOC_OK, "Init should succeed");
+     TEST_ASSERT(RunWorkers(&pc, cpus) == TRUE, "Blocks should never overlap across migrations");
+     TEST_ASSERT(StackAlloc_PerCpuGetUsed(&pc) == (TStack_alloc_size)PERCPU_TEST_THREADS * PERCPU_TEST_BLOCKS * 24U,
+                 "Used should match the blocks handed out");
+     StackAlloc_PerCpuDeinit(&pc);
+ #endif
+ 
+     return TRUE;
+ }
+ 
+ /* ========================= Test Runner ========================= */
+ 
+ boolean StackAllocPerCpu_RunAllTests(void)
+ {
+     boolean all_passed = TRUE;
+ 
+     printf("=== Starting Per-CPU Stack Allocator Test Suite ===\n");
+ 
+     TEST_CASE(percpu_basic);
+     TEST_CASE(percpu_threads);
+     TEST_CASE(percpu_no_rseq_thread);
+     TEST_CASE(percpu_threads_atomic);
+     TEST_CASE(percpu_migrate);
+ 
+     return all_passed;
+ }
@@ -0,0 +1,171 @@
+/**
+ * @file        stack_alloc_plan_test.c
+ * @brief       Test suite for the offline buffer planner (StackAlloc_Plan)
+ * @details     Tests that buffers alive at the same step never share memory, the
+ *              alignment of every offset, the ranking of the strategies on known and
+ *              random graphs, and error cases. Uses ONLY public API.
+ */
+
+ #include "stack_alloc_test.h"
+ #include "test_utils.h"
+ #include "stack_alloc_plan.h"
+ #include "stack_alloc_chain.h"
+ 
+ #define PLAN_SCRATCH_SIZE  (64U * 1024U)
+ #define PLAN_RANDOM_COUNT  (200U)
+ 
+ static uint8 g_plan_scratch[PLAN_SCRATCH_SIZE] __attribute__((aligned(64)));
+ 
+ /**
+  * @brief Checks the offsets of a plan: aligned, inside total, disjoint where lifetimes overlap
+  */
+ static boolean check_plan(const TStack_alloc_plan_buffer* buffers, uint32 count,
+                           const TStack_alloc_size* offsets, TStack_alloc_size total)
+ {
+     for (uint32 i = 0U; i < count; i++) {
+         if (((offsets[i] % buffers[i].alignment) != 0U) || (offsets[i] + buffers[i].size > total)) {
+             return FALSE;
+         }
+         for (uint32 j = 0U; j < i; j++) {
+             boolean alive = ((buffers[i].first_step <= buffers[j].last_step) &&
+                              (buffers[j].first_step <= buffers[i].last_step)) ? TRUE : FALSE;
+             boolean apart = ((offsets[i] >= offsets[j] + buffers[j].size) ||
+                              (offsets[j] >= offsets[i] + buffers[i].size)) ? TRUE : FALSE;
+             if ((alive == TRUE) && (apart == FALSE)) {
+                 return FALSE;
+             }
+         }
+     }
+     return TRUE;
+ }
+ 
+ /* ========================= Individual Test Cases ========================= */
+ 
+ static boolean test_plan_known(void)
+ {
+     // B outlives A and sits on top of it, so a stack cannot reuse A's space for C
+     static const TStack_alloc_plan_buffer graph[] = {
+         { 96U, 8U, 0U, 1U }, { 10U, 8U, 1U, 3U }, { 96U, 8U, 2U, 3U }, { 4U, 4U, 4U, 4U }
+     };
+     TStack_alloc scratch;
+     TStack_alloc_size offsets[4];
+     TStack_alloc_size total;
+     StackAlloc_Init(&scratch, g_plan_scratch, PLAN_SCRATCH_SIZE);
+ 
+     TEST_ASSERT(StackAlloc_Plan(&scratch, graph, 4U, STACK_ALLOC_PLAN_STACK, offsets, &total) == STACK_ALLOC_OK,
+                 "Stack plan should succeed");
+     TEST_ASSERT(check_plan(graph, 4U, offsets, total) == TRUE, "Stack plan should be valid");
+     TEST_ASSERT(total == 208U, "Stack plan should place C above B");
+     TEST_ASSERT(offsets[3] == 0U, "Stack should be empty again at step 4");
+ 
+     TEST_ASSERT(StackAlloc_Plan(&scratch, graph, 4U, STACK_ALLOC_PLAN_GREEDY_BY_SIZE, offsets, &total) == STACK_ALLOC_OK,
+                 "Greedy plan should succeed");
+     TEST_ASSERT(check_plan(graph, 4U, offsets, total) == TRUE, "Greedy plan should be valid");
+     TEST_ASSERT(total == 106U, "Greedy plan should reach the lower bound");
+     TEST_ASSERT(offsets[0] == offsets[2], "A and C should share memory");
+     TEST_ASSERT(StackAlloc_GetUsed(&scratch) == 0U, "Scratch should be rewound");
+ 
+     // Alignment is honoured even where a gap would fit unaligned
+     static const TStack_alloc_plan_buffer aligned[] = {
+         { 24U, 8U, 0U, 2U }, { 40U, 8U, 0U, 0U }, { 8U, 8U, 0U, 2U }, { 32U, 64U, 1U, 2U }
+     };
+     TEST_ASSERT(StackAlloc_Plan(&scratch, aligned, 4U, STACK_ALLOC_PLAN_BEST, offsets, &total) == STACK_ALLOC_OK,
+                 "Best plan should succeed");
+     TEST_ASSERT(check_plan(aligned, 4U, offsets, total) == TRUE, "Aligned plan should be valid");
+ 
+     TEST_ASSERT(StackAlloc_Plan(&scratch, aligned, 0U, STACK_ALLOC_PLAN_BEST, offsets, &total) == STACK_ALLOC_OK,
+                 "Empty plan should succeed");
+     TEST_ASSERT(total == 0U, "Empty plan should need no memory");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_plan_random(void)
+ {
+     static TStack_alloc_plan_buffer graph[PLAN_RANDOM_COUNT];
+     static TStack_alloc_size offsets[PLAN_RANDOM_COUNT];
+     static const TStack_alloc_size alignments[4] = { 1U, 8U, 16U, 64U };
+     TStack_alloc scratch;
+     uint32 seed = 12345U;
+     StackAlloc_Init(&scratch, g_plan_scratch, PLAN_SCRATCH_SIZE);
+ 
+     for (uint32 round = 0U; round < 20U; round++) {
+         for (uint32 i = 0U; i < PLAN_RANDOM_COUNT; i++) {
+             seed = (seed * 1103515245U) + 12345U;
+             graph[i].size = 1U + ((seed >> 8) % 5000U);
+             graph[i].alignment = alignments[(seed >> 4) & 3U];
+             graph[i].first_step = (seed >> 20) % 100U;
+             graph[i].last_step = graph[i].first_step + ((seed >> 12) % 15U);
+         }
+ 
+         TStack_alloc_size totals[3];
+         for (TStack_alloc_plan_strategy s = STACK_ALLOC_PLAN_STACK; s <= STACK_ALLOC_PLAN_BEST; s++) {
+             TEST_ASSERT(StackAlloc_Plan(&scratch, graph, PLAN_RANDOM_COUNT, s, offsets, &totals[s]) == STACK_ALLOC_OK,
+                         "Random plan should succeed");
+             TEST_ASSERT(check_plan(graph, PLAN_RANDOM_COUNT, offsets, totals[s]) == TRUE, "Random plan should be valid");
+         }
+         TEST_ASSERT(totals[STACK_ALLOC_PLAN_BEST] <= totals[STACK_ALLOC_PLAN_GREEDY_BY_SIZE],
+                     "Best should never lose to greedy by size");
+         TEST_ASSERT(totals[STACK_ALLOC_PLAN_GREEDY_BY_SIZE] <= totals[STACK_ALLOC_PLAN_STACK],
+                     "Greedy should beat the stack on random lifetimes");
+     }
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_plan_errors(void)
+ {
+     TStack_alloc_plan_buffer graph[2] = { { 16U, 8U, 0U, 1U }, { 16U, 8U, 1U, 2U } };
+     TStack_alloc scratch;
+     TStack_alloc_size offsets[2];
+     TStack_alloc_size total;
+     StackAlloc_Init(&scratch, g_plan_scratch, PLAN_SCRATCH_SIZE);
+ 
+     TEST_ASSERT(StackAlloc_Plan(NULL_PTR, graph, 2U, STACK_ALLOC_PLAN_BEST, offsets, &total) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                 "NULL scratch should fail");
+     TEST_ASSERT(StackAlloc_Plan(&scratch, graph, 2U, 3U, offsets, &total) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                 "Unknown strategy should fail");
+     graph[1].last_step = 0U;
+     TEST_ASSERT(StackAlloc_Plan(&scratch, graph, 2U, STACK_ALLOC_PLAN_BEST, offsets, &total) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                 "Lifetime ending before it starts should fail");
+     graph[1].last_step = 2U;
+     graph[1].alignment = 12U;
+     TEST_ASSERT(StackAlloc_Plan(&scratch, graph, 2U, STACK_ALLOC_PLAN_BEST, offsets, &total) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                 "Invalid alignment should fail");
+     graph[1].alignment = 8U;
+     graph[1].size = STACK_ALLOC_SIZE_MAX;
+     TEST_ASSERT(StackAlloc_Plan(&scratch, graph, 2U, STACK_ALLOC_PLAN_GREEDY_BY_SIZE, offsets, &total) == STACK_ALLOC_ERROR_OUT_OF_MEMORY,
+                 "Oversized plan should fail");
+     graph[1].size = 16U;
+ 
+     // Too little scratch fails cleanly
+     StackAlloc_Init(&scratch, g_plan_scratch, 16U);
+     TEST_ASSERT(StackAlloc_Plan(&scratch, graph, 2U, STACK_ALLOC_PLAN_BEST, offsets, &total) == STACK_ALLOC_ERROR_OUT_OF_MEMORY,
+                 "Small scratch should fail");
+     TEST_ASSERT(StackAlloc_GetUsed(&scratch) == 0U, "Failed plan should rewind the scratch");
+ 
+     // A growable scratch without an initial buffer is rewound across its chunks
+     TStack_alloc_provider provider = StackAlloc_MallocProvider();
+     StackAlloc_InitChained(&scratch, NULL_PTR, 0U, &provider, 0U);
+     TEST_ASSERT(StackAlloc_Plan(&scratch, graph, 2U, STACK_ALLOC_PLAN_BEST, offsets, &total) == STACK_ALLOC_OK,
+                 "Plan with a chained scratch should succeed");
+     TEST_ASSERT(StackAlloc_GetUsed(&scratch) == 0U, "Plan should rewind a chained scratch");
+     StackAlloc_Deinit(&scratch);
+ 
+     return TRUE;
+ }
+ 
+ /* ========================= Test Runner ========================= */
+ 
+ boolean StackAllocPlan_RunAllTests(void)
+ {
+     boolean all_passed = TRUE;
+ 
+     printf("=== Starting Buffer Planner Test Suite ===\n");
+ 
+     TEST_CASE(plan_known);
+     TEST_CASE(plan_random);
+     TEST_CASE(plan_errors);
+ 
+     return all_passed;
+ }
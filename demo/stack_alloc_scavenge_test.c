@@ -0,0 +1,162 @@
+/**
+ * @file        stack_alloc_scavenge_test.c
+ * @brief       Test suite for the background scavenger
+ * @details     Tests decay of the retained size, the tail handover with reclaim, and
+ *              the scavenger thread running against an arena in use. Uses ONLY public API.
+ */
+
+ #include "stack_alloc_test.h"
+ #include "test_utils.h"
+ #include "stack_alloc_scavenge.h"
+ #include "stack_alloc_vm.h"
+ #include <string.h>
+ #include <unistd.h>
+ 
+ #define MIB     (1024U * 1024U)
+ 
+ /* ========================= Individual Test Cases ========================= */
+ 
+ static boolean test_scavenge_decay(void)
+ {
+     TStack_alloc sa;
+     TStack_alloc fixed;
+     static uint8 buffer[256];
+ 
+     // A period of a minute keeps the thread out of the way; passes are run by hand
+     TEST_ASSERT(StackAlloc_ScavengerStart(60000U, 60000U, MIB) == STACK_ALLOC_OK, "Scavenger should start");
+     TEST_ASSERT(StackAlloc_ScavengerStart(0U, 0U, 0U) == STACK_ALLOC_ERROR_INVALID_PARAM, "Second start should fail");
+ 
+     StackAlloc_Init(&fixed, buffer, sizeof(buffer));
+     TEST_ASSERT(StackAlloc_ScavengeRegister(&fixed) == STACK_ALLOC_ERROR_INVALID_PARAM, "Fixed arena should be rejected");
+ 
+     TEST_ASSERT(StackAlloc_InitVirtual(&sa, 64U * MIB, 0U) == STACK_ALLOC_OK, "Reservation should succeed");
+     TEST_ASSERT(StackAlloc_ScavengeRegister(&sa) == STACK_ALLOC_OK, "Registration should succeed");
+     TEST_ASSERT(StackAlloc_ScavengeRegister(&sa) == STACK_ALLOC_ERROR_INVALID_PARAM, "Double registration should fail");
+ 
+     // One spike, then small requests
+     uint8* block = (uint8*)StackAlloc_Alloc(&sa, 16U * MIB);
+     memset(block, 0xA5, 16U * MIB);
+     StackAlloc_Reset(&sa);
+     StackAlloc_ScavengeRun();
+     TEST_ASSERT(StackAlloc_GetCommitted(&sa) == 16U * MIB, "Spike should stay committed right after it");
+ 
+     TStack_alloc_size released = StackAlloc_ScavengerGetReleased();
+     for (int i = 0; i < 8; i++) {
+         block = (uint8*)StackAlloc_Alloc(&sa, 256U * 1024U);
+         TEST_ASSERT(block != NULL_PTR, "Small request should succeed");
+         memset(block, 0x5A, 256U * 1024U);
+         StackAlloc_Reset(&sa);
+         StackAlloc_ScavengeRun();
+     }
+     StackAlloc_Reset(&sa);
+ 
+     // The estimate halves every pass until min_retained
+     TEST_ASSERT(StackAlloc_GetCommitted(&sa) == MIB, "Committed size should decay to min_retained");
+     TEST_ASSERT(StackAlloc_ScavengerGetReleased() - released == 15U * MIB, "Tail should be decommitted");
+     TEST_ASSERT(StackAlloc_GetResident(&sa) <= MIB, "Decommitted pages should not be resident");
+     TEST_ASSERT(StackAlloc_GetKnownZero(&sa) == 63U * MIB, "Decommitted tail should be known zero");
+ 
+     // Growing again commits on demand and sees zeroed memory
+     block = (uint8*)StackAlloc_Calloc(&sa, 1U, 8U * MIB);
+     TEST_ASSERT((block != NULL_PTR) && (block[8U * MIB - 1U] == 0U), "Re-growth should succeed");
+ 
+     StackAlloc_Deinit(&sa);
+     StackAlloc_ScavengerStop();
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_scavenge_reclaim(void)
+ {
+     TStack_alloc sa;
+ 
+     TEST_ASSERT(StackAlloc_ScavengerStart(60000U, 60000U, MIB) == STACK_ALLOC_OK, "Scavenger should start");
+     TEST_ASSERT(StackAlloc_InitVirtual(&sa, 64U * MIB, 0U) == STACK_ALLOC_OK, "Reservation should succeed");
+     TEST_ASSERT(StackAlloc_ScavengeRegister(&sa) == STACK_ALLOC_OK, "Registration should succeed");
+ 
+     // Let the target settle at min_retained
+     StackAlloc_Reset(&sa);
+     StackAlloc_ScavengeRun();
+ 
+     uint8* block = (uint8*)StackAlloc_Alloc(&sa, 8U * MIB);
+     block[8U * MIB - 1U] = 0x77U;
+ 
+     // Reset hands the tail over, but the arena grows into it before the next pass
+     StackAlloc_Reset(&sa);
+     TEST_ASSERT(StackAlloc_GetCommitted(&sa) == MIB, "Tail above the target should be handed over");
+     uint8* again = (uint8*)StackAlloc_Alloc(&sa, 8U * MIB);
+     TEST_ASSERT(again == block, "Same memory should be handed out");
+     TEST_ASSERT(again[8U * MIB - 1U] == 0x77U, "Reclaimed tail should not have been decommitted");
+     TEST_ASSERT(StackAlloc_GetCommitted(&sa) == 8U * MIB, "Reclaimed tail should be committed again");
+ 
+     // Nothing is left for the scavenger
+     TStack_alloc_size released = StackAlloc_ScavengerGetReleased();
+     StackAlloc_ScavengeRun();
+     TEST_ASSERT(StackAlloc_ScavengerGetReleased() == released, "Reclaimed tail should not be decommitted");
+ 
+     // A posted tail is taken back on unregistering
+     StackAlloc_Reset(&sa);
+     StackAlloc_ScavengeUnregister(&sa);
+     TEST_ASSERT(StackAlloc_GetCommitted(&sa) == 8U * MIB, "Unregistering should take the tail back");
+ 
+     StackAlloc_Deinit(&sa);
+     StackAlloc_ScavengerStop();
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_scavenge_thread(void)
+ {
+     TStack_alloc sa;
+     boolean intact = TRUE;
+ 
+     TEST_ASSERT(StackAlloc_ScavengerStart(2U, 2U, MIB) == STACK_ALLOC_OK, "Scavenger should start");
+     TEST_ASSERT(StackAlloc_InitVirtual(&sa, 64U * MIB, 0U) == STACK_ALLOC_OK, "Reservation should succeed");
+     TEST_ASSERT(StackAlloc_ScavengeRegister(&sa) == STACK_ALLOC_OK, "Registration should succeed");
+ 
+     // Spikes and small requests while the thread trims behind the owner's back
+     for (uint32 r = 0U; r < 400U; r++) {
+         TStack_alloc_size size = ((r % 50U) == 0U) ? (8U * MIB) : (64U * 1024U);
+         uint8* block = (uint8*)StackAlloc_Alloc(&sa, size);
+         if (block == NULL_PTR) {
+             intact = FALSE;
+             break;
+         }
+         memset(block, (int)r, size);
+         if ((block[0] != (uint8)r) || (block[size - 1U] != (uint8)r)) {
+             intact = FALSE;
+         }
+         StackAlloc_Reset(&sa);
+         if ((r % 8U) == 0U) {
+             (void)usleep(1000U);
+         }
+     }
+     TEST_ASSERT(intact == TRUE, "Blocks should stay intact while the scavenger runs");
+ 
+     // Quiet period: the thread trims down to min_retained
+     for (int i = 0; (i < 1000) && (StackAlloc_GetCommitted(&sa) > MIB); i++) {
+         (void)usleep(1000U);
+         StackAlloc_Reset(&sa);
+     }
+     TEST_ASSERT(StackAlloc_GetCommitted(&sa) == MIB, "Idle arena should be trimmed in the background");
+ 
+     StackAlloc_ScavengerStop();
+     StackAlloc_Deinit(&sa);
+ 
+     return TRUE;
+ }
+ 
+ /* ========================= Test Runner ========================= */
+ 
+ boolean StackAllocScavenge_RunAllTests(void)
+ {
+     boolean all_passed = TRUE;
+ 
+     printf("=== Starting Scavenger Test Suite ===\n");
+ 
+     TEST_CASE(scavenge_decay);
+     TEST_CASE(scavenge_reclaim);
+     TEST_CASE(scavenge_thread);
+ 
+     return all_passed;
+ }
@@ -7,28 +7,13 @@
  */
 
  #include "stack_alloc_test.h"
+ #include "test_utils.h"
  #include "stack_alloc.h"
+ #include "stack_alloc_inline.h"
  #include <stdio.h>
+ #include <stdlib.h>
  #include <string.h>
  
- /* ========================= Test Utility Macros ========================= */
- 
- #define TEST_ASSERT(cond, msg) do { \
-     if (!(cond)) { \
-         printf("ASSERT FAILED: %s at line %d: %s\n", __FILE__, __LINE__, msg); \
-         return FALSE; \
-     } \
- } while(0)
- 
- #define TEST_CASE(name) \
-     printf("Running test: %s...\n", #name); \
-     if (!test_##name()) { \
-         printf("FAILED: %s\n", #name); \
-         all_passed = FALSE; \
-     } else { \
-         printf("PASSED: %s\n", #name); \
-     }
- 
  /* ========================= Test Buffer ========================= */
  
  #define TEST_BUFFER_SIZE 1024U
@@ -142,6 +127,45 @@
      return TRUE;
  }
  
+ static boolean test_calloc_known_zero(void)
+ {
+     static _Alignas(STACK_ALLOC_ALIGNMENT) uint8 zeroed[1024];
+     TStack_alloc sa;
+ 
+     memset(zeroed, 0, sizeof(zeroed));
+     TEST_ASSERT(StackAlloc_InitZeroed(&sa, zeroed, sizeof(zeroed)) == STACK_ALLOC_OK, "InitZeroed should succeed");
+     TEST_ASSERT(StackAlloc_GetKnownZero(&sa) == sizeof(zeroed), "A zeroed buffer should be known zero");
+ 
+     // Dirty a block, then give it back
+     uint8* dirty = (uint8*)StackAlloc_Alloc(&sa, 100U);
+     TEST_ASSERT(dirty != NULL_PTR, "Allocation should succeed");
+     memset(dirty, 0xFF, 100U);
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, dirty) == STACK_ALLOC_OK, "Free should succeed");
+     TEST_ASSERT(StackAlloc_GetKnownZero(&sa) == sizeof(zeroed) - 100U, "Freed memory should stay dirty");
+ 
+     // A calloc spanning dirty and clean memory must come back all zero
+     uint8* block = (uint8*)StackAlloc_Calloc(&sa, 1U, 300U);
+     TEST_ASSERT(block == dirty, "Calloc should reuse the freed block");
+     for (uint32 i = 0U; i < 300U; i++) {
+         TEST_ASSERT(block[i] == 0U, "Calloc should zero the previously dirtied part");
+     }
+ 
+     // Reset keeps the high-water mark
+     StackAlloc_Reset(&sa);
+     TEST_ASSERT(StackAlloc_GetKnownZero(&sa) == sizeof(zeroed) - 300U, "Reset should not forget dirtied memory");
+ 
+     // A plain Init knows nothing about the buffer
+     memset(g_test_buffer, 0xAA, 64U);
+     StackAlloc_Init(&sa, g_test_buffer, TEST_BUFFER_SIZE);
+     TEST_ASSERT(StackAlloc_GetKnownZero(&sa) == 0U, "Init should assume dirty memory");
+     uint8* cleared = (uint8*)StackAlloc_Calloc(&sa, 1U, 64U);
+     for (uint32 i = 0U; i < 64U; i++) {
+         TEST_ASSERT(cleared[i] == 0U, "Calloc should zero unknown memory");
+     }
+ 
+     return TRUE;
+ }
+ 
  static boolean test_reset(void)
  {
      TStack_alloc sa;
@@ -229,6 +253,238 @@
      return TRUE;
  }
  
+ static boolean test_large_arena(void)
+ {
+ #if (STACK_ALLOC_POINTER_WIDTH_SIZE == 1U)
+     if (sizeof(void*) < 8U)
+     {
+         return TRUE; // Multi-GiB arenas need a 64-bit address space
+     }
+
+     // 5 GiB buffer; pages are never touched so no physical memory is used
+     TStack_alloc_size big = (TStack_alloc_size)5U << 30;
+     uint8* buffer = (uint8*)malloc(big);
+     if (buffer == NULL_PTR)
+     {
+         printf("  (skipped: could not reserve 5 GiB)\n");
+         return TRUE;
+     }
+
+     TStack_alloc sa;
+     TStack_alloc_error err = StackAlloc_Init(&sa, buffer, big);
+     TEST_ASSERT(err == STACK_ALLOC_OK, "Init with 5 GiB buffer should succeed");
+     TEST_ASSERT(StackAlloc_GetCapacity(&sa) == big, "Capacity should not be truncated");
+
+     uint8* first = (uint8*)StackAlloc_Alloc(&sa, (TStack_alloc_size)9U << 29); // 4.5 GiB
+     TEST_ASSERT(first != NULL_PTR, "4.5 GiB allocation should succeed");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) >= ((TStack_alloc_size)9U << 29), "Used should exceed 4 GiB");
+
+     uint8* second = (uint8*)StackAlloc_Alloc(&sa, 64U);
+     TEST_ASSERT(second >= first + ((TStack_alloc_size)9U << 29), "Second block should follow the first");
+     TEST_ASSERT(StackAlloc_Alloc(&sa, (TStack_alloc_size)1U << 30) == NULL_PTR, "Should fail beyond 5 GiB");
+     TEST_ASSERT(StackAlloc_Validate(&sa) == STACK_ALLOC_OK, "Large arena should validate");
+
+     free(buffer);
+ #endif
+     return TRUE;
+ }
+ 
+ static boolean test_alloc_inline(void)
+ {
+     TStack_alloc sa;
+     StackAlloc_Init(&sa, g_test_buffer, TEST_BUFFER_SIZE);
+ 
+     uint8* a = (uint8*)StackAlloc_AllocInline(&sa, 3U);
+     uint8* b = (uint8*)StackAlloc_AllocInline(&sa, 17U);
+     TEST_ASSERT(a != NULL_PTR && b != NULL_PTR, "Inline allocations should succeed");
+     TEST_ASSERT(((TStack_alloc_addr)a % STACK_ALLOC_ALIGNMENT) == 0U, "Inline block should be aligned");
+     TEST_ASSERT(((TStack_alloc_addr)b % STACK_ALLOC_ALIGNMENT) == 0U, "Inline block should be aligned");
+     TEST_ASSERT(b >= a + 3U, "Inline blocks should not overlap");
+ 
+     // Inline and out-of-line paths must agree on layout
+     uint8* c = (uint8*)StackAlloc_Alloc(&sa, 5U);
+     uint8* d = (uint8*)StackAlloc_AllocInline(&sa, 5U);
+     TEST_ASSERT(d == c + STACK_ALLOC_ALIGNMENT, "Inline path should bump like StackAlloc_Alloc");
+ 
+     // Failures go through the slow path
+     TEST_ASSERT(StackAlloc_AllocInline(&sa, 0U) == NULL_PTR, "Zero size should return NULL");
+     TEST_ASSERT(StackAlloc_AllocInline(&sa, STACK_ALLOC_SIZE_MAX) == NULL_PTR, "Wrapping size should return NULL");
+     TEST_ASSERT(StackAlloc_AllocInline(&sa, TEST_BUFFER_SIZE) == NULL_PTR, "Oversized request should return NULL");
+     TEST_ASSERT(StackAlloc_AllocSlow(NULL_PTR, 8U, 8U) == NULL_PTR, "Slow path should reject NULL sa");
+ 
+     // Exactly filling the buffer is allowed
+     TStack_alloc_size avail = StackAlloc_GetAvailable(&sa) & ~(TStack_alloc_size)(STACK_ALLOC_ALIGNMENT - 1U);
+     TEST_ASSERT(StackAlloc_AllocInline(&sa, avail) != NULL_PTR, "Should fill the remaining space");
+     TEST_ASSERT(StackAlloc_GetAvailable(&sa) < STACK_ALLOC_ALIGNMENT, "Buffer should be full");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_alloc_aligned(void)
+ {
+     static uint8 big_buffer[4U * 4096U];
+     TStack_alloc sa;
+     StackAlloc_Init(&sa, big_buffer, sizeof(big_buffer));
+ 
+     // Cache-line, AVX-512 and page alignment from the same arena
+     void* line = StackAlloc_AllocAligned(&sa, 8U, 64U);
+     void* simd = StackAlloc_AllocAligned(&sa, 100U, 32U);
+     void* page = StackAlloc_AllocAligned(&sa, 4096U, 4096U);
+     TEST_ASSERT(line != NULL_PTR && simd != NULL_PTR && page != NULL_PTR, "Aligned allocations should succeed");
+     TEST_ASSERT(((TStack_alloc_addr)line % 64U) == 0U, "Block should be 64-byte aligned");
+     TEST_ASSERT(((TStack_alloc_addr)simd % 32U) == 0U, "Block should be 32-byte aligned");
+     TEST_ASSERT(((TStack_alloc_addr)page % 4096U) == 0U, "Block should be page aligned");
+ 
+     // Small alignments pack tighter than the global alignment
+     StackAlloc_Reset(&sa);
+     uint8* c1 = (uint8*)StackAlloc_AllocAligned(&sa, 3U, 1U);
+     uint8* c2 = (uint8*)StackAlloc_AllocAligned(&sa, 1U, 1U);
+     uint16* h = (uint16*)StackAlloc_AllocAligned(&sa, sizeof(uint16), 2U);
+     TEST_ASSERT(c2 == c1 + 3U, "Byte-aligned blocks should be adjacent");
+     TEST_ASSERT((uint8*)h == c1 + 4U, "No padding should be added when already aligned");
+ 
+     // Invalid alignments
+     TEST_ASSERT(StackAlloc_AllocAligned(&sa, 8U, 0U) == NULL_PTR, "Zero alignment should fail");
+     TEST_ASSERT(StackAlloc_AllocAligned(&sa, 8U, 48U) == NULL_PTR, "Non power-of-two alignment should fail");
+     TEST_ASSERT(StackAlloc_AllocAligned(NULL_PTR, 8U, 8U) == NULL_PTR, "NULL sa should fail");
+ 
+     // Calloc variant zeroes and aligns
+     memset(big_buffer, 0xAA, sizeof(big_buffer));
+     uint32* zeros = (uint32*)StackAlloc_CallocAligned(&sa, 16U, sizeof(uint32), 64U);
+     TEST_ASSERT(zeros != NULL_PTR && ((TStack_alloc_addr)zeros % 64U) == 0U, "CallocAligned should align");
+     for (int i = 0; i < 16; i++) {
+         TEST_ASSERT(zeros[i] == 0U, "CallocAligned should zero-initialize memory");
+     }
+     TEST_ASSERT(StackAlloc_CallocAligned(&sa, STACK_ALLOC_SIZE_MAX, 2U, 8U) == NULL_PTR, "Overflow should fail");
+ 
+     // Blocks with small alignment are valid markers
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, c2) == STACK_ALLOC_OK, "Byte-aligned marker should be accepted");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == 3U, "Only the first block should remain");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_alloc_typed_macros(void)
+ {
+     typedef struct { uint8 tag; uint8 flags; } TSmall;
+     typedef struct { uint64 counter; uint8 pad[56]; } TLine;
+ 
+     TStack_alloc sa;
+     StackAlloc_Init(&sa, g_test_buffer, TEST_BUFFER_SIZE);
+ 
+     uint8* first = STACK_ALLOC_NEW(&sa, uint8);
+     TSmall* small = STACK_ALLOC_NEW(&sa, TSmall);
+     TEST_ASSERT(first != NULL_PTR && small != NULL_PTR, "Typed allocations should succeed");
+     TEST_ASSERT((uint8*)small == first + 1U, "Small types should not pay for the global alignment");
+ 
+     TLine* lines = STACK_ALLOC_NEW_ARRAY(&sa, TLine, 4U);
+     TEST_ASSERT(lines != NULL_PTR, "Typed array allocation should succeed");
+     TEST_ASSERT(((TStack_alloc_addr)lines % _Alignof(TLine)) == 0U, "Array should use the type's alignment");
+     TEST_ASSERT(lines[3].counter == 0U, "Typed array should be zeroed");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_realloc(void)
+ {
+     TStack_alloc sa;
+     StackAlloc_Init(&sa, g_test_buffer, TEST_BUFFER_SIZE);
+ 
+     // Appending to the top block grows it in place
+     uint8* list = (uint8*)StackAlloc_Realloc(&sa, NULL_PTR, 0U, 16U);
+     TEST_ASSERT(list != NULL_PTR, "Realloc of NULL should allocate");
+     for (uint32 i = 0U; i < 16U; i++) {
+         list[i] = (uint8)i;
+     }
+     TStack_alloc_size size = 16U;
+     while (size < 512U) {
+         uint8* grown = (uint8*)StackAlloc_Realloc(&sa, list, size, size * 2U);
+         TEST_ASSERT(grown == list, "Top block should grow in place");
+         size *= 2U;
+     }
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == 512U, "Used should follow the block size");
+     TEST_ASSERT(list[15] == 15U, "Contents should be kept");
+ 
+     // Shrinking the top block gives the space back
+     TEST_ASSERT(StackAlloc_Realloc(&sa, list, 512U, 40U) == list, "Top block should shrink in place");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == 40U, "Shrinking should move the top");
+ 
+     // A block below the top is copied to grow, and kept to shrink
+     uint8* other = (uint8*)StackAlloc_Alloc(&sa, 8U);
+     TEST_ASSERT(other != NULL_PTR, "Allocation should succeed");
+     TEST_ASSERT(StackAlloc_Realloc(&sa, list, 40U, 24U) == list, "Inner block should shrink in place");
+     uint8* moved = (uint8*)StackAlloc_Realloc(&sa, list, 40U, 100U);
+     TEST_ASSERT(moved != NULL_PTR && moved >= other + 8U, "Inner block should move to the top");
+     TEST_ASSERT(moved[0] == 0U && moved[15] == 15U, "Moved block should keep its contents");
+ 
+     // Failure leaves the block and the top untouched
+     TStack_alloc_size used = StackAlloc_GetUsed(&sa);
+     TEST_ASSERT(StackAlloc_Realloc(&sa, moved, 100U, TEST_BUFFER_SIZE) == NULL_PTR, "Oversized realloc should fail");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == used && moved[15] == 15U, "Failed realloc should change nothing");
+     TEST_ASSERT(StackAlloc_Realloc(&sa, moved, 100U, 0U) == NULL_PTR, "Zero size should fail");
+     TEST_ASSERT(StackAlloc_Realloc(NULL_PTR, moved, 100U, 8U) == NULL_PTR, "NULL arena should fail");
+ 
+     // A top block with a weaker alignment than requested is moved
+     StackAlloc_Reset(&sa);
+     uint8* odd = (uint8*)StackAlloc_AllocAligned(&sa, 3U, 1U);
+     uint8* byte = (uint8*)StackAlloc_AllocAligned(&sa, 1U, 1U);
+     *byte = 0x7EU;
+     uint8* wide = (uint8*)StackAlloc_ReallocAligned(&sa, byte, 1U, 64U, 64U);
+     TEST_ASSERT(odd != NULL_PTR && wide != NULL_PTR && ((TStack_alloc_addr)wide % 64U) == 0U,
+                 "Realloc should honour the alignment");
+     TEST_ASSERT(*wide == 0x7EU, "Contents should be kept");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_open_block(void)
+ {
+     TStack_alloc sa;
+     TStack_alloc_size window = 0U;
+     StackAlloc_Init(&sa, g_test_buffer, TEST_BUFFER_SIZE);
+ 
+     // The window is everything above the (aligned) top
+     uint8* first = (uint8*)StackAlloc_AllocAligned(&sa, 3U, 1U);
+     uint8* out = (uint8*)StackAlloc_OpenBlock(&sa, 16U, &window);
+     TEST_ASSERT(out != NULL_PTR && ((TStack_alloc_addr)out % STACK_ALLOC_ALIGNMENT) == 0U, "Open should succeed");
+     TEST_ASSERT(out + window == g_test_buffer + TEST_BUFFER_SIZE, "Window should reach the end of the buffer");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == (TStack_alloc_size)(first + 3U - g_test_buffer),
+                 "Opening should not allocate");
+ 
+     // Commit the length actually written
+     int written = snprintf((char*)out, window, "record %d", 42);
+     TEST_ASSERT(StackAlloc_CommitBlock(&sa, out, (TStack_alloc_size)written + 1U) == STACK_ALLOC_OK,
+                 "Commit should succeed");
+     TEST_ASSERT(strcmp((const char*)out, "record 42") == 0, "Committed data should be kept");
+     uint8* next = (uint8*)StackAlloc_Alloc(&sa, 8U);
+     TEST_ASSERT(next >= out + written + 1, "Next allocation should follow the committed block");
+ 
+     // Abort leaves the arena as it was
+     TStack_alloc_size used = StackAlloc_GetUsed(&sa);
+     out = (uint8*)StackAlloc_OpenBlock(&sa, 0U, &window);
+     TEST_ASSERT(out != NULL_PTR, "Open should succeed");
+     memset(out, 0xEE, window);
+     StackAlloc_AbortBlock(&sa, out);
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == used, "Abort should not allocate");
+     uint8* zeroed = (uint8*)StackAlloc_Calloc(&sa, 1U, 64U);
+     TEST_ASSERT(zeroed != NULL_PTR && zeroed[0] == 0U && zeroed[63] == 0U, "Calloc should clear the window");
+ 
+     // A fixed arena cannot grow the window
+     used = StackAlloc_GetUsed(&sa);
+     out = (uint8*)StackAlloc_OpenBlock(&sa, 8U, &window);
+     TEST_ASSERT(StackAlloc_GrowBlock(&sa, out, 8U, window + 1U, &window) == NULL_PTR,
+                 "Growing a fixed window should fail");
+     TEST_ASSERT(StackAlloc_GrowBlock(&sa, out, 8U, window, &window) == out, "A window that fits stays put");
+     TEST_ASSERT(StackAlloc_OpenBlock(&sa, TEST_BUFFER_SIZE, &window) == NULL_PTR, "Oversized open should fail");
+     TEST_ASSERT(StackAlloc_CommitBlock(&sa, out, window + 1U) == STACK_ALLOC_ERROR_OUT_OF_MEMORY,
+                 "Committing past the window should fail");
+     TEST_ASSERT(StackAlloc_CommitBlock(&sa, first, 1U) == STACK_ALLOC_ERROR_INVALID_MARKER,
+                 "Committing below the top should fail");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == used, "Failed calls should not allocate");
+ 
+     return TRUE;
+ }
+ 
  /* ========================= Test Runner ========================= */
  
  boolean StackAlloc_RunAllTests(void)
@@ -244,10 +500,17 @@
      TEST_CASE(alloc_null_sa);
      TEST_CASE(alloc_overflow);
      TEST_CASE(calloc_basic);
+     TEST_CASE(calloc_known_zero);
      TEST_CASE(reset);
      TEST_CASE(capacity_used_available);
      TEST_CASE(validate);
      TEST_CASE(free_to_marker_behavior);
+     TEST_CASE(large_arena);
+     TEST_CASE(alloc_inline);
+     TEST_CASE(alloc_aligned);
+     TEST_CASE(alloc_typed_macros);
+     TEST_CASE(realloc);
+     TEST_CASE(open_block);
  
      if (all_passed)
      {
@@ -14,4 +14,100 @@
   */
  boolean StackAlloc_RunAllTests(void);
  
+ /**
+  * @brief Run all test cases for the growable (chained) stack allocator
+  * @return TRUE if all tests pass, FALSE otherwise
+  */
+ boolean StackAllocChain_RunAllTests(void);
+ 
+ /**
+  * @brief Run all test cases for the virtual-memory (reserve/commit) stack allocator
+  * @return TRUE if all tests pass, FALSE otherwise
+  */
+ boolean StackAllocVm_RunAllTests(void);
+ 
+ /**
+  * @brief Run all test cases for NUMA placement of stack allocators
+  * @return TRUE if all tests pass, FALSE otherwise
+  */
+ boolean StackAllocNuma_RunAllTests(void);
+ 
+ /**
+  * @brief Run all test cases for thread-local stack allocators
+  * @return TRUE if all tests pass, FALSE otherwise
+  */
+ boolean StackAllocTls_RunAllTests(void);
+ 
+ /**
+  * @brief Run all test cases for lock-free allocation from a shared arena
+  * @return TRUE if all tests pass, FALSE otherwise
+  */
+ boolean StackAllocConcurrent_RunAllTests(void);
+ 
+ /**
+  * @brief Run all test cases for thread arenas leasing from a shared arena
+  * @return TRUE if all tests pass, FALSE otherwise
+  */
+ boolean StackAllocLease_RunAllTests(void);
+ 
+ /**
+  * @brief Run all test cases for per-CPU stack allocators
+  * @return TRUE if all tests pass, FALSE otherwise
+  */
+ boolean StackAllocPerCpu_RunAllTests(void);
+ 
+ /**
+  * @brief Run all test cases for the background scavenger
+  * @return TRUE if all tests pass, FALSE otherwise
+  */
+ boolean StackAllocScavenge_RunAllTests(void);
+ 
+ /**
+  * @brief Run all test cases for guard-protected arenas
+  * @return TRUE if all tests pass, FALSE otherwise
+  */
+ boolean StackAllocGuard_RunAllTests(void);
+ 
+ /**
+  * @brief Run all test cases for the downward-bumping stack allocator
+  * @return TRUE if all tests pass, FALSE otherwise
+  */
+ boolean StackAllocDown_RunAllTests(void);
+ 
+ /**
+  * @brief Run all test cases for the double-ended stack allocator
+  * @return TRUE if all tests pass, FALSE otherwise
+  */
+ boolean StackAllocDual_RunAllTests(void);
+ 
+ /**
+  * @brief Run all test cases for blocks with size records
+  * @return TRUE if all tests pass, FALSE otherwise
+  */
+ boolean StackAllocHeader_RunAllTests(void);
+ 
+ /**
+  * @brief Run all test cases for batch allocation
+  * @return TRUE if all tests pass, FALSE otherwise
+  */
+ boolean StackAllocBatch_RunAllTests(void);
+ 
+ /**
+  * @brief Run all test cases for measuring arenas
+  * @return TRUE if all tests pass, FALSE otherwise
+  */
+ boolean StackAllocMeasure_RunAllTests(void);
+ 
+ /**
+  * @brief Run all test cases for the offline buffer planner
+  * @return TRUE if all tests pass, FALSE otherwise
+  */
+ boolean StackAllocPlan_RunAllTests(void);
+ 
+ /**
+  * @brief Run all test cases for the helper routines
+  * @return TRUE if all tests pass, FALSE otherwise
+  */
+ boolean HelperRoutines_RunAllTests(void);
+ 
  #endif /* STACK_ALLOC_TEST_H */
\ No newline at end of file
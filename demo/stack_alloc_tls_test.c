@@ -0,0 +1,114 @@
+/**
+ * @file        stack_alloc_tls_test.c
+ * @brief       Test suite for managed thread-local stack allocators
+ * @details     Tests lazy creation, per-thread isolation and teardown on thread exit.
+ *              Uses ONLY public API.
+ */
+
+ #include "stack_alloc_test.h"
+ #include "test_utils.h"
+ #include "stack_alloc_tls.h"
+ #include <pthread.h>
+ 
+ #define TLS_TEST_THREADS   4
+ #define TLS_TEST_BLOCKS    1000
+ 
+ typedef struct {
+     uint32 id;
+     TStack_alloc* arena;
+     boolean ok;
+ } TTls_worker;
+ 
+ static void* TlsWorker(void* arg)
+ {
+     TTls_worker* worker = (TTls_worker*)arg;
+     uint32* blocks[TLS_TEST_BLOCKS];
+ 
+     worker->ok = TRUE;
+     for (int i = 0; i < TLS_TEST_BLOCKS; i++) {
+         blocks[i] = (uint32*)StackAlloc_TlsAlloc(64U);
+         if (blocks[i] == NULL_PTR) {
+             worker->ok = FALSE;
+             return NULL_PTR;
+         }
+         blocks[i][0] = worker->id;
+         blocks[i][15] = (uint32)i;
+     }
+     for (int i = 0; i < TLS_TEST_BLOCKS; i++) {
+         if ((blocks[i][0] != worker->id) || (blocks[i][15] != (uint32)i)) {
+             worker->ok = FALSE;
+         }
+     }
+     worker->arena = StackAlloc_TlsGet();
+ 
+     return NULL_PTR;
+ }
+ 
+ /* ========================= Individual Test Cases ========================= */
+ 
+ static boolean test_tls_lazy_create(void)
+ {
+     uint32 before = StackAlloc_TlsGetArenaCount();
+ 
+     void* first = StackAlloc_TlsAlloc(32U);
+     TEST_ASSERT(first != NULL_PTR, "First thread-local allocation should create the arena");
+     TEST_ASSERT(StackAlloc_TlsGetArenaCount() == before + 1U, "One arena should have been created");
+ 
+     TStack_alloc* arena = StackAlloc_TlsGet();
+     TEST_ASSERT(arena != NULL_PTR && StackAlloc_GetUsed(arena) >= 32U, "TlsGet should return the same arena");
+ 
+     void* aligned = StackAlloc_TlsAllocAligned(100U, 64U);
+     TEST_ASSERT(aligned != NULL_PTR && ((TStack_alloc_addr)aligned % 64U) == 0U, "Aligned TLS allocation should work");
+     TEST_ASSERT(StackAlloc_TlsAlloc(0U) == NULL_PTR, "Zero size should fail");
+ 
+     StackAlloc_TlsReset();
+     TEST_ASSERT(StackAlloc_GetUsed(arena) == 0U, "Reset should empty the thread arena");
+     TEST_ASSERT(StackAlloc_TlsAlloc(32U) == first, "Reset should restart at the same address");
+ 
+     StackAlloc_TlsRelease();
+     TEST_ASSERT(StackAlloc_TlsGetArenaCount() == before, "Release should destroy the arena");
+     StackAlloc_TlsRelease();
+     TEST_ASSERT(StackAlloc_TlsGetArenaCount() == before, "Double release should be harmless");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_tls_threads(void)
+ {
+     pthread_t threads[TLS_TEST_THREADS];
+     TTls_worker workers[TLS_TEST_THREADS];
+     uint32 before = StackAlloc_TlsGetArenaCount();
+ 
+     StackAlloc_TlsConfigure(1024U * 1024U, 0U);
+     for (uint32 i = 0U; i < TLS_TEST_THREADS; i++) {
+         workers[i].id = i + 1U;
+         workers[i].arena = NULL_PTR;
+         TEST_ASSERT(pthread_create(&threads[i], NULL_PTR, TlsWorker, &workers[i]) == 0, "Thread should start");
+     }
+     for (uint32 i = 0U; i < TLS_TEST_THREADS; i++) {
+         (void)pthread_join(threads[i], NULL_PTR);
+     }
+     StackAlloc_TlsConfigure(0U, 0U);
+ 
+     for (uint32 i = 0U; i < TLS_TEST_THREADS; i++) {
+         TEST_ASSERT(workers[i].ok == TRUE, "Each thread should see only its own data");
+         TEST_ASSERT(workers[i].arena != NULL_PTR, "Each thread should have had an arena");
+     }
+     TEST_ASSERT(StackAlloc_TlsGetArenaCount() == before, "Arenas should be released on thread exit");
+ 
+     return TRUE;
+ }
+ 
+ /* ========================= Test Runner ========================= */
+ 
+ boolean StackAllocTls_RunAllTests(void)
+ {
+     boolean all_passed = TRUE;
+ 
+     printf("=== Starting Thread-Local Stack Allocator Test Suite ===\n");
+ 
+     TEST_CASE(tls_lazy_create);
+     TEST_CASE(tls_threads);
+ 
+     return all_passed;
+ }
@@ -0,0 +1,308 @@
+/**
+ * @file        stack_alloc_vm_test.c
+ * @brief       Test suite for the virtual-memory (reserve/commit) stack allocator
+ * @details     Tests reservation, on-demand commit, pointer stability, the
+ *              reserved/committed queries, page release and prefaulting. Uses ONLY public API.
+ */
+
+ #include "stack_alloc_test.h"
+ #include "test_utils.h"
+ #include "stack_alloc_vm.h"
+ #include <string.h>
+ #include <sys/resource.h>
+ 
+ /* ========================= Individual Test Cases ========================= */
+ 
+ static boolean test_vm_reserve_commit(void)
+ {
+     // 8 GiB on 64-bit hosts, 256 MiB otherwise; nothing is committed up front
+     TStack_alloc_size reserve = (sizeof(TStack_alloc_size) >= 8U) ? (TStack_alloc_size)((uint64)1U << 33) : ((TStack_alloc_size)1U << 28);
+     TStack_alloc_size step = 64U * 1024U;
+     TStack_alloc sa;
+ 
+     TEST_ASSERT(StackAlloc_InitVirtual(&sa, reserve, step) == STACK_ALLOC_OK, "Reservation should succeed");
+     TEST_ASSERT(StackAlloc_GetCapacity(&sa) == reserve, "Capacity should report the reservation");
+     TEST_ASSERT(StackAlloc_GetCommitted(&sa) == 0U, "Nothing should be committed yet");
+     TEST_ASSERT(StackAlloc_GetAvailable(&sa) == reserve, "Whole reservation should be available");
+     TEST_ASSERT(StackAlloc_GetKnownZero(&sa) == reserve, "Fresh mapping should be known zero");
+     TEST_ASSERT(StackAlloc_Validate(&sa) == STACK_ALLOC_OK, "Fresh virtual arena should validate");
+ 
+     // First allocation commits one step
+     uint8* first = (uint8*)StackAlloc_Alloc(&sa, 100U);
+     TEST_ASSERT(first != NULL_PTR, "First allocation should commit memory");
+     TEST_ASSERT(StackAlloc_GetCommitted(&sa) == step, "One commit step should be committed");
+     memset(first, 0xA5, 100U);
+ 
+     // Growth is contiguous across commit boundaries
+     uint8* prev = first;
+     for (int i = 0; i < 40; i++) {
+         uint8* block = (uint8*)StackAlloc_Alloc(&sa, 10000U);
+         TEST_ASSERT(block != NULL_PTR, "Allocation should commit more pages");
+         TEST_ASSERT(block > prev, "Blocks should stay contiguous");
+         block[0] = 1U;
+         block[9999] = 2U;
+         prev = block;
+     }
+     TEST_ASSERT(first[99] == 0xA5U, "Earlier blocks should not move");
+     TStack_alloc_size committed = StackAlloc_GetCommitted(&sa);
+     TEST_ASSERT(committed >= StackAlloc_GetUsed(&sa) && committed < StackAlloc_GetUsed(&sa) + step,
+                 "Commit should track usage within one step");
+ 
+     // Reset keeps the committed pages
+     StackAlloc_Reset(&sa);
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == 0U, "Reset should empty the arena");
+     TEST_ASSERT(StackAlloc_GetCommitted(&sa) == committed, "Reset should keep pages committed");
+     TEST_ASSERT(StackAlloc_Alloc(&sa, 64U) == first, "Reset should restart at the same address");
+ 
+     StackAlloc_Deinit(&sa);
+     TEST_ASSERT(StackAlloc_GetCapacity(&sa) == 0U, "Deinit should release the reservation");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_vm_limits(void)
+ {
+     TStack_alloc sa;
+     TStack_alloc_size page = StackAlloc_GetPageSize();
+ 
+     TEST_ASSERT(StackAlloc_InitVirtual(NULL_PTR, 4096U, 0U) == STACK_ALLOC_ERROR_INVALID_PARAM, "NULL sa should fail");
+     TEST_ASSERT(StackAlloc_InitVirtual(&sa, 0U, 0U) == STACK_ALLOC_ERROR_INVALID_PARAM, "Empty reservation should fail");
+ 
+     // Sizes round up to whole pages and allocations stop at the reservation
+     TEST_ASSERT(StackAlloc_InitVirtual(&sa, page + 1U, 0U) == STACK_ALLOC_OK, "Small reservation should succeed");
+     TEST_ASSERT(StackAlloc_GetCapacity(&sa) == 2U * page, "Reservation should round up to pages");
+     TEST_ASSERT(StackAlloc_Alloc(&sa, 3U * page) == NULL_PTR, "Allocation beyond the reservation should fail");
+ 
+     uint8* all = (uint8*)StackAlloc_Alloc(&sa, 2U * page);
+     TEST_ASSERT(all != NULL_PTR, "Whole reservation should be allocatable");
+     TEST_ASSERT(StackAlloc_GetCommitted(&sa) == 2U * page, "Commit should clamp to the reservation");
+     all[2U * page - 1U] = 0x11U;
+     TEST_ASSERT(StackAlloc_Alloc(&sa, 1U) == NULL_PTR, "Exhausted reservation should fail");
+ 
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, all + page) == STACK_ALLOC_OK, "Markers should work as usual");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == page, "Used should match the marker");
+     StackAlloc_Deinit(&sa);
+ 
+     TEST_ASSERT(StackAlloc_GetCommitted(NULL_PTR) == 0U, "Committed should be 0 for NULL");
+ 
+     // A step of 3 pages commits up to 4-page boundaries
+     TStack_alloc_size step = 4U * page;
+     TEST_ASSERT(StackAlloc_InitVirtual(&sa, 64U * page, 3U * page) == STACK_ALLOC_OK, "Reservation should succeed");
+     uint8* start = (uint8*)StackAlloc_Alloc(&sa, 1U);
+     TEST_ASSERT(start != NULL_PTR, "First allocation should commit memory");
+     TEST_ASSERT(((TStack_alloc_addr)(start + StackAlloc_GetCommitted(&sa)) % step) == 0U,
+                 "Step should round up to a power of 2");
+     TEST_ASSERT(StackAlloc_Alloc(&sa, 5U * page) != NULL_PTR, "Growth should commit more steps");
+     TEST_ASSERT(((TStack_alloc_addr)(start + StackAlloc_GetCommitted(&sa)) % step) == 0U,
+                 "Commits should stay on step boundaries");
+     TEST_ASSERT(StackAlloc_GetCommitted(&sa) < StackAlloc_GetUsed(&sa) + step, "Commit should track usage within one step");
+     StackAlloc_Deinit(&sa);
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_vm_huge_pages(void)
+ {
+     TStack_alloc sa;
+     const TStack_alloc_size huge = STACK_ALLOC_HUGE_PAGE_SIZE;
+ 
+     TEST_ASSERT(StackAlloc_InitVirtualEx(&sa, 3U * huge + 1U, 0U, STACK_ALLOC_VM_HUGE_PAGES) == STACK_ALLOC_OK,
+                 "Huge-page arena should be created (with fallback if needed)");
+ 
+     TStack_alloc_page_kind kind = StackAlloc_GetPageKind(&sa);
+     printf("  page kind obtained: %s\n", (kind == STACK_ALLOC_PAGES_HUGETLB) ? "hugetlb" :
+                                          (kind == STACK_ALLOC_PAGES_THP) ? "thp" : "default");
+     TEST_ASSERT(StackAlloc_GetCapacity(&sa) == 4U * huge, "Reservation should round to huge pages");
+ 
+     uint8* block = (uint8*)StackAlloc_Alloc(&sa, 100U);
+     TEST_ASSERT(block != NULL_PTR, "Allocation should succeed");
+     TEST_ASSERT(StackAlloc_GetCommitted(&sa) == huge, "Commits should be whole huge pages");
+     if (kind != STACK_ALLOC_PAGES_DEFAULT) {
+         TEST_ASSERT(((TStack_alloc_addr)block % huge) == 0U, "Huge-page range should be 2 MiB aligned");
+     }
+ 
+     uint8* big = (uint8*)StackAlloc_Alloc(&sa, 2U * huge);
+     TEST_ASSERT(big != NULL_PTR, "Allocation across huge pages should succeed");
+     big[0] = 1U;
+     big[2U * huge - 1U] = 2U;
+     StackAlloc_Deinit(&sa);
+ 
+     // Regular arenas report default pages
+     StackAlloc_InitVirtual(&sa, huge, 0U);
+     TEST_ASSERT(StackAlloc_GetPageKind(&sa) == STACK_ALLOC_PAGES_DEFAULT, "Regular arena should use default pages");
+     StackAlloc_Deinit(&sa);
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_vm_release(void)
+ {
+     const TStack_alloc_size mib = 1024U * 1024U;
+     TStack_alloc sa;
+     TStack_alloc fixed;
+     static uint8 buffer[256];
+ 
+     // Policies only apply to ranges the allocator mapped itself
+     StackAlloc_Init(&fixed, buffer, sizeof(buffer));
+     TEST_ASSERT(StackAlloc_SetReleasePolicy(&fixed, STACK_ALLOC_RELEASE_DONTNEED, 0U) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                 "Fixed arena should reject a release policy");
+ 
+     TEST_ASSERT(StackAlloc_InitVirtual(&sa, 64U * mib, 0U) == STACK_ALLOC_OK, "Reservation should succeed");
+     TEST_ASSERT(StackAlloc_SetReleasePolicy(&sa, 3U, 0U) == STACK_ALLOC_ERROR_INVALID_PARAM, "Unknown mode should be rejected");
+     TEST_ASSERT(StackAlloc_SetReleasePolicy(&sa, STACK_ALLOC_RELEASE_DONTNEED, mib) == STACK_ALLOC_OK,
+                 "Policy should be accepted");
+ 
+     // Spike to 16 MiB of dirty memory
+     uint8* block = (uint8*)StackAlloc_Alloc(&sa, 16U * mib);
+     TEST_ASSERT(block != NULL_PTR, "Allocation should succeed");
+     memset(block, 0xA5, 16U * mib);
+     TEST_ASSERT(StackAlloc_GetResident(&sa) >= 16U * mib, "Touched pages should be resident");
+ 
+     // A small rewind releases nothing
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, block + (16U * mib) - 4096U) == STACK_ALLOC_OK, "Rewind should succeed");
+     TEST_ASSERT(StackAlloc_GetResident(&sa) >= 16U * mib, "Rewinds below the minimum span should not release");
+ 
+     // Reset keeps the first MiB resident and drops the rest
+     StackAlloc_Reset(&sa);
+     TEST_ASSERT(StackAlloc_GetResident(&sa) <= mib, "Pages above keep_size should be released");
+     TEST_ASSERT(StackAlloc_GetCommitted(&sa) >= 16U * mib, "Released pages should stay committed");
+     TEST_ASSERT(StackAlloc_GetKnownZero(&sa) == (64U * mib) - mib, "Released pages should be known zero again");
+ 
+     // Re-growth works and Calloc sees zeroed memory above the kept part
+     block = (uint8*)StackAlloc_Alloc(&sa, mib);
+     uint8* zeroed = (uint8*)StackAlloc_Calloc(&sa, 1U, 8U * mib);
+     TEST_ASSERT((block != NULL_PTR) && (zeroed != NULL_PTR), "Re-growth should succeed");
+     TEST_ASSERT((block[0] == 0xA5U) && (zeroed[0] == 0U) && (zeroed[8U * mib - 1U] == 0U),
+                 "Kept pages keep their contents, released pages read as zero");
+ 
+     // Rewinding into the kept part releases everything above keep_size
+     memset(zeroed, 0x5A, 8U * mib);
+     TEST_ASSERT(StackAlloc_FreeToMarker(&sa, block + 64U) == STACK_ALLOC_OK, "Rewind should succeed");
+     TEST_ASSERT(StackAlloc_GetResident(&sa) <= mib, "Large rewind should release");
+ 
+     // MADV_FREE leaves contents undefined, so nothing becomes known zero
+     StackAlloc_Reset(&sa);
+     TEST_ASSERT(StackAlloc_SetReleasePolicy(&sa, STACK_ALLOC_RELEASE_FREE, 0U) == STACK_ALLOC_OK, "Policy should be accepted");
+     block = (uint8*)StackAlloc_Alloc(&sa, 4U * mib);
+     memset(block, 0x11, 4U * mib);
+     StackAlloc_Reset(&sa);
+     TEST_ASSERT(StackAlloc_GetKnownZero(&sa) == (64U * mib) - (4U * mib), "Lazily freed pages are not known zero");
+     StackAlloc_Deinit(&sa);
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_vm_prefault(void)
+ {
+     const TStack_alloc_size mib = 1024U * 1024U;
+     TStack_alloc sa;
+     struct rusage before;
+     struct rusage after;
+ 
+     TEST_ASSERT(StackAlloc_InitVirtualEx(&sa, 4U * mib, 0U, STACK_ALLOC_VM_PREFAULT) == STACK_ALLOC_OK,
+                 "Prefaulted arena should be created");
+     TEST_ASSERT(StackAlloc_GetCommitted(&sa) == 4U * mib, "Whole range should be committed");
+     TEST_ASSERT(StackAlloc_GetResident(&sa) == 4U * mib, "Whole range should be resident");
+     TEST_ASSERT(StackAlloc_GetKnownZero(&sa) == 4U * mib, "Prefaulting should not dirty the range");
+ 
+     // Filling the arena must not fault (allow a few faults from the test itself)
+     (void)getrusage(RUSAGE_SELF, &before);
+     for (int i = 0; i < 1024; i++) {
+         uint8* block = (uint8*)StackAlloc_Alloc(&sa, 4096U);
+         block[0] = 1U;
+         block[4095] = 2U;
+     }
+     (void)getrusage(RUSAGE_SELF, &after);
+     TEST_ASSERT((after.ru_minflt - before.ru_minflt) < 8, "Allocations from a prefaulted arena should not fault");
+     StackAlloc_Deinit(&sa);
+ 
+     // Locking may be refused by RLIMIT_MEMLOCK
+     TStack_alloc_error err = StackAlloc_InitVirtualEx(&sa, mib, 0U, STACK_ALLOC_VM_LOCKED);
+     TEST_ASSERT((err == STACK_ALLOC_OK) || (err == STACK_ALLOC_ERROR_OUT_OF_MEMORY), "Locking should succeed or report OOM");
+     if (err == STACK_ALLOC_OK) {
+         TEST_ASSERT(StackAlloc_GetResident(&sa) == mib, "Locked range should be resident");
+         TEST_ASSERT(StackAlloc_SetReleasePolicy(&sa, STACK_ALLOC_RELEASE_DONTNEED, 0U) == STACK_ALLOC_ERROR_INVALID_PARAM,
+                     "Locked arena should reject a release policy");
+         StackAlloc_Deinit(&sa);
+     } else {
+         printf("  mlock refused, locked arena not tested\n");
+     }
+ 
+     // Caller buffers keep their contents
+     static uint8 buffer[3U * 4096U];
+     TStack_alloc fixed;
+     memset(buffer, 0x3C, sizeof(buffer));
+     StackAlloc_Init(&fixed, buffer, sizeof(buffer));
+     TEST_ASSERT(StackAlloc_Prefault(&fixed) == STACK_ALLOC_OK, "Prefaulting a fixed arena should succeed");
+     TEST_ASSERT((buffer[0] == 0x3CU) && (buffer[sizeof(buffer) - 1U] == 0x3CU), "Prefaulting should keep contents");
+     TEST_ASSERT(StackAlloc_Prefault(NULL_PTR) == STACK_ALLOC_ERROR_INVALID_PARAM, "NULL should be rejected");
+ 
+     return TRUE;
+ }
+ 
+ static boolean test_vm_realloc(void)
+ {
+     TStack_alloc_size step = 64U * 1024U;
+     TStack_alloc sa;
+     TEST_ASSERT(StackAlloc_InitVirtual(&sa, 64U * step, step) == STACK_ALLOC_OK, "Reservation should succeed");
+ 
+     // The top block grows across commit steps without moving
+     uint8* block = (uint8*)StackAlloc_Alloc(&sa, 1000U);
+     TEST_ASSERT(block != NULL_PTR, "Allocation should succeed");
+     block[999] = 0x42U;
+     uint8* grown = (uint8*)StackAlloc_Realloc(&sa, block, 1000U, 10U * step);
+     TEST_ASSERT(grown == block, "Top block should grow in place");
+     TEST_ASSERT(StackAlloc_GetCommitted(&sa) >= 10U * step, "Growth should commit pages");
+     grown[(10U * step) - 1U] = 1U;
+     TEST_ASSERT(grown[999] == 0x42U, "Contents should be kept");
+     TEST_ASSERT(StackAlloc_Realloc(&sa, grown, 10U * step, 128U * step) == NULL_PTR,
+                 "Growth past the reservation should fail");
+     TEST_ASSERT(StackAlloc_GetUsed(&sa) == 10U * step, "Failed growth should keep the block");
+ 
+     StackAlloc_Deinit(&sa);
+     return TRUE;
+ }
+ 
+ static boolean test_vm_open_block(void)
+ {
+     TStack_alloc_size step = 64U * 1024U;
+     TStack_alloc_size window = 0U;
+     TStack_alloc sa;
+     TEST_ASSERT(StackAlloc_InitVirtual(&sa, 64U * step, step) == STACK_ALLOC_OK, "Reservation should succeed");
+ 
+     (void)StackAlloc_Alloc(&sa, 100U);
+     uint8* out = (uint8*)StackAlloc_OpenBlock(&sa, 1U, &window);
+     TEST_ASSERT(out != NULL_PTR && window < step, "Window should be the committed rest");
+     out[0] = 0x5AU;
+ 
+     // Growing commits behind the block instead of moving it
+     uint8* grown = (uint8*)StackAlloc_GrowBlock(&sa, out, 1U, 5U * step, &window);
+     TEST_ASSERT(grown == out && window >= 5U * step, "Window should grow in place");
+     grown[(5U * step) - 1U] = 1U;
+     TEST_ASSERT(StackAlloc_GrowBlock(&sa, out, 1U, 128U * step, &window) == NULL_PTR,
+                 "Growing past the reservation should fail");
+     TEST_ASSERT(StackAlloc_CommitBlock(&sa, out, 5U * step) == STACK_ALLOC_OK, "Commit should succeed");
+     TEST_ASSERT(out[0] == 0x5AU && StackAlloc_GetUsed(&sa) > 5U * step, "Block should be allocated");
+ 
+     StackAlloc_Deinit(&sa);
+     return TRUE;
+ }
+ 
+ /* ========================= Test Runner ========================= */
+ 
+ boolean StackAllocVm_RunAllTests(void)
+ {
+     boolean all_passed = TRUE;
+ 
+     printf("=== Starting Virtual Stack Allocator Test Suite ===\n");
+ 
+     TEST_CASE(vm_reserve_commit);
+     TEST_CASE(vm_limits);
+     TEST_CASE(vm_huge_pages);
+     TEST_CASE(vm_release);
+     TEST_CASE(vm_prefault);
+     TEST_CASE(vm_realloc);
+     TEST_CASE(vm_open_block);
+ 
+     return all_passed;
+ }
@@ -0,0 +1,30 @@
+/**
+ * @file        test_utils.h
+ * @brief       Assertion and test-case macros shared by the test suites
+ */
+
+ #ifndef TEST_UTILS_H
+ #define TEST_UTILS_H
+ 
+ #include <stdio.h>
+ #include "std_types.h"
+ 
+ /* ========================= Test Utility Macros ========================= */
+ 
+ #define TEST_ASSERT(cond, msg) do { \
+     if (!(cond)) { \
+         printf("ASSERT FAILED: %s at line %d: %s\n", __FILE__, __LINE__, msg); \
+         return FALSE; \
+     } \
+ } while(0)
+ 
+ #define TEST_CASE(name) \
+     printf("Running test: %s...\n", #name); \
+     if (!test_##name()) { \
+         printf("FAILED: %s\n", #name); \
+         all_passed = FALSE; \
+     } else { \
+         printf("PASSED: %s\n", #name); \
+     }
+ 
+ #endif /* TEST_UTILS_H */
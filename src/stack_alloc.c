@@ -7,41 +7,31 @@
 
 /* ================================ Includes ================================ */
 #include "stack_alloc.h"
+#include "stack_alloc_internal.h"
+#include "stack_alloc_down.h"
 #include "stack_alloc_cfg.h"
 #include "helper_routines.h"
 
 /**
- * @brief       Aligns an address to the specified alignment boundary
- * @param[in]   address   The address to be aligned
- * @param[in]   alignment The alignment boundary (must be a power of 2)
- * @return      The aligned address
+ * @brief       Gets the aligned start address of the stack buffer
+ * @param[in]   sa Pointer to the stack allocator instance
+ * @return      Aligned start address of the buffer
  * @note        This is an internal helper function not meant to be called directly
  */
-static inline uint32 AlignUp(uint32 address, uint32 alignment) 
+static inline uint8* GetAlignedStart(const TStack_alloc* sa)
 {
-    /* Calculate how many bytes we need to add to reach alignment */
-    uint32 remainder = address % alignment;
-
-    /* If already aligned, return as is */
-    if (remainder == 0U)
-    {
-        return address;
-    }
-
-    /* Add required bytes to reach next alignment boundary */
-    return address + (alignment - remainder);
+    /* Ensure the buffer start is properly aligned */
+    return StackAlloc_AlignedStart(sa->buffer_start);
 }
 
 /**
- * @brief       Gets the aligned start address of the stack buffer
+ * @brief       Gets the position of the top in an empty arena
  * @param[in]   sa Pointer to the stack allocator instance
- * @return      Aligned start address of the buffer
- * @note        This is an internal helper function not meant to be called directly
+ * @return      Aligned end of the buffer for a downward arena, aligned start otherwise
  */
-static inline uint8* GetAlignedStart(const TStack_alloc* sa)
+static inline uint8* GetEmptyTop(const TStack_alloc* sa)
 {
-    /* Ensure the buffer start is properly aligned */
-    return (uint8*)AlignUp((uint32)sa->buffer_start, STACK_ALLOC_ALIGNMENT);
+    return (sa->mode == STACK_ALLOC_MODE_DOWN) ? sa->top_end : GetAlignedStart(sa);
 }
 
 /**
@@ -54,7 +44,7 @@ static inline uint8* GetAlignedStart(const TStack_alloc* sa)
  * @retval      STACK_ALLOC_ERROR_OUT_OF_MEMORY  If buffer is too small after alignment
  * @note        The buffer must be large enough to accommodate the required alignment
  */
-TStack_alloc_error StackAlloc_Init(TStack_alloc* sa, void* buffer, uint32 buffer_size)
+TStack_alloc_error StackAlloc_Init(TStack_alloc* sa, void* buffer, TStack_alloc_size buffer_size)
 {
     /* Check for NULL pointers and minimum buffer size */
     if ((sa == NULL_PTR) || (buffer == NULL_PTR) || (buffer_size < STACK_ALLOC_ALIGNMENT)) 
@@ -62,14 +52,21 @@ TStack_alloc_error StackAlloc_Init(TStack_alloc* sa, void* buffer, uint32 buffer
         return STACK_ALLOC_ERROR_INVALID_PARAM;
     }
 
+    /* Start from a fixed-mode instance with no chunks */
+    (void)mem_set(sa, 0, sizeof(*sa));
+    sa->mode = STACK_ALLOC_MODE_FIXED;
+
     /* Initialize buffer boundaries and capacity */
     sa->buffer_start = (uint8*)buffer;
     sa->buffer_end   = sa->buffer_start + buffer_size;
-    sa->capacity     = (uint32)buffer_size;
+    sa->capacity     = buffer_size;
     
     /* Align the current pointer to the required boundary */
     sa->current = GetAlignedStart(sa);
 
+    /* Nothing is known about the contents of a caller's buffer */
+    sa->zero_start = sa->buffer_end;
+
     /* Verify we have at least some space after alignment */
     if (sa->current >= sa->buffer_end)
     {
@@ -79,6 +76,25 @@ TStack_alloc_error StackAlloc_Init(TStack_alloc* sa, void* buffer, uint32 buffer
     return STACK_ALLOC_OK;
 }
 
+/**
+ * @brief       Initializes the stack allocator with a buffer that is entirely zero
+ * @param[in]   sa           Pointer to the stack allocator instance to initialize
+ * @param[in]   buffer       Pointer to a zero-filled buffer (static array, fresh mmap, ...)
+ * @param[in]   buffer_size  Size of the provided buffer in bytes
+ * @return      STACK_ALLOC_OK on success, error code otherwise (see StackAlloc_Init())
+ */
+TStack_alloc_error StackAlloc_InitZeroed(TStack_alloc* sa, void* buffer, TStack_alloc_size buffer_size)
+{
+    TStack_alloc_error err = StackAlloc_Init(sa, buffer, buffer_size);
+
+    if (err == STACK_ALLOC_OK)
+    {
+        sa->zero_start = sa->current;
+    }
+
+    return err;
+}
+
 /**
  * @brief       Allocates a block of memory from the stack
  * @param[in]   sa    Pointer to the stack allocator instance
@@ -87,27 +103,75 @@ TStack_alloc_error StackAlloc_Init(TStack_alloc* sa, void* buffer, uint32 buffer
  * @note        The returned pointer is guaranteed to be aligned to STACK_ALLOC_ALIGNMENT
  * @note        This function is not thread-safe
  */
-void* StackAlloc_Alloc(TStack_alloc* sa, uint32 size)
+void* StackAlloc_Alloc(TStack_alloc* sa, TStack_alloc_size size)
 {
     /* Check for invalid parameters */
-    if ((sa == NULL_PTR) || (size == 0U))
+    if (sa == NULL_PTR)
     {
         return NULL_PTR;
     }
 
-    /* Align the current pointer and calculate new top */
-    uint8* aligned_ptr = (uint8*)AlignUp((uint32)sa->current, STACK_ALLOC_ALIGNMENT);
-    uint8* new_top = aligned_ptr + size;
+    /* Bump within the current buffer, falling back to the slow path */
+    return StackAlloc_AllocInline(sa, size);
+}
 
-    /* Check for overflow or out of memory */
-    if ((new_top < aligned_ptr) || (new_top > sa->buffer_end))
+/**
+ * @brief       Allocates a block of memory with a per-call alignment
+ * @param[in]   sa         Pointer to the stack allocator instance
+ * @param[in]   size       Number of bytes to allocate
+ * @param[in]   alignment  Required alignment in bytes (must be a power of 2)
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ * @note        Only the padding needed to reach alignment is consumed, so alignments
+ *              below STACK_ALLOC_ALIGNMENT pack blocks tighter than StackAlloc_Alloc
+ */
+void* StackAlloc_AllocAligned(TStack_alloc* sa, TStack_alloc_size size, TStack_alloc_size alignment)
+{
+    /* Check for invalid parameters */
+    if ((sa == NULL_PTR) || (StackAlloc_IsPowerOfTwo(alignment) == FALSE))
     {
         return NULL_PTR;
     }
 
-    /* Update current pointer and return allocated block */
-    sa->current = new_top;
-    return aligned_ptr;
+    /* Bump within the current buffer, falling back to the slow path */
+    return StackAlloc_AllocAlignedInline(sa, size, alignment);
+}
+
+/**
+ * @brief       Out-of-line slow path taken when the inline bump does not fit
+ * @param[in]   sa         Pointer to the stack allocator instance
+ * @param[in]   size       Number of bytes that were requested
+ * @param[in]   alignment  Alignment that was requested (power of 2)
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ * @note        Called for zero-size requests, size overflow and buffer exhaustion
+ */
+void* StackAlloc_AllocSlow(TStack_alloc* sa, TStack_alloc_size size, TStack_alloc_size alignment)
+{
+    /* Zero-size requests never succeed */
+    if ((sa == NULL_PTR) || (size == 0U))
+    {
+        return NULL_PTR;
+    }
+
+    /* Growable arenas link a new chunk or commit more pages; a fixed buffer cannot grow */
+    switch (sa->mode)
+    {
+        case STACK_ALLOC_MODE_CHAINED:
+            return StackAlloc_ChainGrow(sa, size, alignment);
+
+        case STACK_ALLOC_MODE_VIRTUAL:
+            return StackAlloc_VmGrow(sa, size, alignment);
+
+        /* Not growth: the upward bump never fits a downward arena */
+        case STACK_ALLOC_MODE_DOWN:
+            return StackAlloc_AllocAlignedDownInline(sa, size, alignment);
+
+        /* Nor for a measuring arena, which records the allocation instead */
+        case STACK_ALLOC_MODE_MEASURE:
+            return StackAlloc_MeasureAlloc(sa, size, alignment);
+
+        default:
+            return NULL_PTR;
+    }
 }
 
 /**
@@ -118,7 +182,21 @@ void* StackAlloc_Alloc(TStack_alloc* sa, uint32 size)
  * @return      Pointer to the allocated and zeroed memory, or NULL_PTR on failure
  * @note        This is equivalent to calloc() but uses the stack allocator
  */
-void* StackAlloc_Calloc(TStack_alloc* sa, uint32 num, uint32 size)
+void* StackAlloc_Calloc(TStack_alloc* sa, TStack_alloc_size num, TStack_alloc_size size)
+{
+    return StackAlloc_CallocAligned(sa, num, size, STACK_ALLOC_ALIGNMENT);
+}
+
+/**
+ * @brief       Allocates and zero-initializes a block of memory with a per-call alignment
+ * @param[in]   sa         Pointer to the stack allocator instance
+ * @param[in]   num        Number of elements to allocate
+ * @param[in]   size       Size of each element in bytes
+ * @param[in]   alignment  Required alignment in bytes (must be a power of 2)
+ * @return      Pointer to the allocated and zeroed memory, or NULL_PTR on failure
+ */
+void* StackAlloc_CallocAligned(TStack_alloc* sa, TStack_alloc_size num, TStack_alloc_size size,
+                               TStack_alloc_size alignment)
 {
     /* Check for zero values */
     if ((num == 0U) || (size == 0U))
@@ -127,66 +205,318 @@ void* StackAlloc_Calloc(TStack_alloc* sa, uint32 num, uint32 size)
     }
 
     /* Check for multiplication overflow */
-    if (num > (SIZE_MAX / size))
+    if (num > (STACK_ALLOC_SIZE_MAX / size))
     {
         return NULL_PTR;
     }
 
     /* Calculate total size needed */
-    uint32 total = (uint32)(num * size);
+    TStack_alloc_size total = num * size;
 
     /* Allocate memory */
-    void* ptr = StackAlloc_Alloc(sa, total);
+    uint8* ptr = (uint8*)StackAlloc_AllocAligned(sa, total, alignment);
 
-    /* Zero-initialize the allocated memory */
-    if (ptr != NULL_PTR)
+    /* Zero only the part below the known-zero watermark of the (possibly new) region;
+       a measuring arena has no memory to zero */
+    if ((ptr != NULL_PTR) && (sa->zero_start > ptr) && (sa->mode != STACK_ALLOC_MODE_MEASURE))
     {
-        (void)mem_set(ptr, 0U, total);
+        TStack_alloc_size dirty = (TStack_alloc_size)(sa->zero_start - ptr);
+        (void)mem_set(ptr, 0U, (dirty < total) ? dirty : total);
     }
 
     return ptr;
 }
 
+/**
+ * @brief       Resizes a block, in place if it is the topmost one
+ * @param[in]   sa        Pointer to the stack allocator instance
+ * @param[in]   ptr       Block to resize, or NULL_PTR to allocate a new one
+ * @param[in]   old_size  Current size of the block in bytes
+ * @param[in]   new_size  Requested size in bytes
+ * @return      Pointer to the resized block, or NULL_PTR on failure
+ */
+void* StackAlloc_Realloc(TStack_alloc* sa, void* ptr, TStack_alloc_size old_size, TStack_alloc_size new_size)
+{
+    return StackAlloc_ReallocAligned(sa, ptr, old_size, new_size, STACK_ALLOC_ALIGNMENT);
+}
+
+/**
+ * @brief       Resizes a block with a per-call alignment, in place if it is the topmost one
+ * @param[in]   sa         Pointer to the stack allocator instance
+ * @param[in]   ptr        Block to resize, or NULL_PTR to allocate a new one
+ * @param[in]   old_size   Current size of the block in bytes
+ * @param[in]   new_size   Requested size in bytes
+ * @param[in]   alignment  Alignment of the block in bytes (must be a power of 2)
+ * @return      Pointer to the resized block, or NULL_PTR on failure
+ */
+void* StackAlloc_ReallocAligned(TStack_alloc* sa, void* ptr, TStack_alloc_size old_size,
+                                TStack_alloc_size new_size, TStack_alloc_size alignment)
+{
+    if ((sa == NULL_PTR) || (new_size == 0U) || (StackAlloc_IsPowerOfTwo(alignment) == FALSE))
+    {
+        return NULL_PTR;
+    }
+
+    if (ptr == NULL_PTR)
+    {
+        return StackAlloc_AllocAligned(sa, new_size, alignment);
+    }
+
+    uint8* block = (uint8*)ptr;
+    boolean aligned = (((TStack_alloc_addr)block & (alignment - 1U)) == 0U) ? TRUE : FALSE;
+
+    /* The topmost block of an upward arena is resized by moving the top */
+    if ((sa->mode != STACK_ALLOC_MODE_DOWN) && (aligned == TRUE) && (block >= sa->buffer_start) &&
+        (block <= sa->current) && ((TStack_alloc_size)(sa->current - block) == old_size))
+    {
+        uint8* old_top = sa->current;
+
+        /* Allocate again from the start of the block: it either stays where it is (a
+           virtual arena commits more pages) or a chained arena moves it to a new chunk */
+        StackAlloc_NoteDirty(sa);
+        sa->current = block;
+        void* result = StackAlloc_AllocAlignedInline(sa, new_size, alignment);
+
+        if (result == NULL_PTR)
+        {
+            sa->current = old_top;
+        }
+        else if (result != ptr)
+        {
+            /* The old block in the region below is intact until that region is rewound */
+            (void)mem_cpy(result, ptr, old_size);
+        }
+        else
+        {
+            /* Resized in place */
+        }
+
+        return result;
+    }
+
+    /* Space below the top cannot be reused, so a block only moves to grow */
+    if (new_size <= old_size)
+    {
+        return ptr;
+    }
+
+    void* result = StackAlloc_AllocAligned(sa, new_size, alignment);
+    if ((result != NULL_PTR) && (sa->mode != STACK_ALLOC_MODE_MEASURE))
+    {
+        (void)mem_cpy(result, ptr, old_size);
+    }
+
+    return result;
+}
+
+/**
+ * @brief       Opens a writable window over the free space above the top
+ * @param[in]   sa        Pointer to the stack allocator instance
+ * @param[in]   min_size  Minimum size of the window in bytes
+ * @param[out]  window    Receives the size of the window in bytes
+ * @return      Start of the window, or NULL_PTR if min_size bytes cannot be provided
+ */
+void* StackAlloc_OpenBlock(TStack_alloc* sa, TStack_alloc_size min_size, TStack_alloc_size* window)
+{
+    if (sa == NULL_PTR)
+    {
+        return NULL_PTR;
+    }
+
+    void* block = (void*)StackAlloc_AlignUp((TStack_alloc_addr)sa->current, STACK_ALLOC_ALIGNMENT);
+    return StackAlloc_GrowBlock(sa, block, 0U, min_size, window);
+}
+
+/**
+ * @brief       Makes the window of an open block at least min_size bytes large
+ * @param[in]   sa        Pointer to the stack allocator instance
+ * @param[in]   block     Start of the open block (from StackAlloc_OpenBlock() or a previous call)
+ * @param[in]   used      Bytes already written at the start of the block, kept if it moves
+ * @param[in]   min_size  Minimum size of the window in bytes
+ * @param[out]  window    Receives the size of the window in bytes
+ * @return      Start of the (possibly moved) window, or NULL_PTR on failure
+ */
+void* StackAlloc_GrowBlock(TStack_alloc* sa, void* block, TStack_alloc_size used, TStack_alloc_size min_size,
+                           TStack_alloc_size* window)
+{
+    uint8* start = (uint8*)block;
+
+    /* The block must start in the free part of the active region (which a downward or
+       measuring arena does not have) */
+    if ((sa == NULL_PTR) || (window == NULL_PTR) || (sa->mode == STACK_ALLOC_MODE_DOWN) ||
+        (sa->mode == STACK_ALLOC_MODE_MEASURE) ||
+        (start < sa->current) || (start > sa->buffer_end) || (used > (TStack_alloc_size)(sa->buffer_end - start)))
+    {
+        return NULL_PTR;
+    }
+
+    TStack_alloc_size need = (min_size > used) ? min_size : used;
+    if (need == 0U)
+    {
+        need = 1U;
+    }
+
+    if ((TStack_alloc_size)(sa->buffer_end - start) < need)
+    {
+        /* Let the slow path grow the arena as if the block were allocated, then take the
+           top back: a virtual arena commits behind the block, a chained arena links a
+           chunk and the block moves there */
+        uint8* old_top = sa->current;
+        uint8* moved = (uint8*)StackAlloc_AllocSlow(sa, need, STACK_ALLOC_ALIGNMENT);
+        if (moved == NULL_PTR)
+        {
+            return NULL_PTR;
+        }
+
+        if (moved == start)
+        {
+            sa->current = old_top;
+        }
+        else
+        {
+            sa->current = moved;
+            (void)mem_cpy(moved, start, used);
+            start = moved;
+        }
+    }
+
+    /* The caller may write anywhere in the window, even if the block is aborted */
+    if (sa->zero_start < sa->buffer_end)
+    {
+        sa->zero_start = sa->buffer_end;
+    }
+
+    *window = (TStack_alloc_size)(sa->buffer_end - start);
+    return start;
+}
+
+/**
+ * @brief       Closes an open block, keeping its first length bytes allocated
+ * @param[in]   sa      Pointer to the stack allocator instance
+ * @param[in]   block   Start of the open block
+ * @param[in]   length  Number of bytes to keep
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ * @retval      STACK_ALLOC_ERROR_INVALID_PARAM    If sa or block is NULL_PTR
+ * @retval      STACK_ALLOC_ERROR_INVALID_MARKER   If block is not in the free part of the active region
+ * @retval      STACK_ALLOC_ERROR_OUT_OF_MEMORY    If length exceeds the window
+ */
+TStack_alloc_error StackAlloc_CommitBlock(TStack_alloc* sa, void* block, TStack_alloc_size length)
+{
+    uint8* start = (uint8*)block;
+
+    if ((sa == NULL_PTR) || (start == NULL_PTR) || (sa->mode == STACK_ALLOC_MODE_DOWN) ||
+        (sa->mode == STACK_ALLOC_MODE_MEASURE))
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    if ((start < sa->current) || (start > sa->buffer_end))
+    {
+        return STACK_ALLOC_ERROR_INVALID_MARKER;
+    }
+
+    if (length > (TStack_alloc_size)(sa->buffer_end - start))
+    {
+        return STACK_ALLOC_ERROR_OUT_OF_MEMORY;
+    }
+
+    sa->current = start + length;
+    return STACK_ALLOC_OK;
+}
+
+/**
+ * @brief       Closes an open block without allocating anything
+ * @param[in]   sa     Pointer to the stack allocator instance
+ * @param[in]   block  Start of the open block
+ * @note        The top never moved while the block was open, so nothing needs undoing.
+ *              A chunk linked for the block stays active until the stack is rewound below it
+ */
+void StackAlloc_AbortBlock(TStack_alloc* sa, void* block)
+{
+    (void)sa;
+    (void)block;
+}
+
+/**
+ * @brief       Gets a marker representing the current stack position
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @return      Marker for StackAlloc_FreeToMarker(), or NULL_PTR if sa is NULL_PTR
+ * @note        A chained arena without an initial buffer returns NULL_PTR while it has
+ *              no chunk; StackAlloc_FreeToMarker() accepts that marker and unlinks every chunk
+ */
+void* StackAlloc_GetMarker(const TStack_alloc* sa)
+{
+    return (sa != NULL_PTR) ? (void*)sa->current : NULL_PTR;
+}
+
 /**
  * @brief       Frees memory back to a previously saved marker
  * @param[in]   sa      Pointer to the stack allocator instance
  * @param[in]   marker  Marker to free back to (must be obtained from StackAlloc_GetMarker)
  * @return      STACK_ALLOC_OK on success, error code otherwise
  * @retval      STACK_ALLOC_ERROR_INVALID_PARAM    If any parameter is invalid
- * @retval      STACK_ALLOC_ERROR_INVALID_MARKER   If marker is outside buffer or not aligned
+ * @retval      STACK_ALLOC_ERROR_INVALID_MARKER   If marker is outside the used part of the buffer
  * @retval      STACK_ALLOC_ERROR_NOT_LIFO         If trying to free in non-LIFO order
  * @note        This function can only free memory in LIFO order
  */
 TStack_alloc_error StackAlloc_FreeToMarker(TStack_alloc* sa, void* marker)
 {
-    /* Check for NULL pointers */
-    if ((sa == NULL_PTR) || (marker == NULL_PTR))
+    if (sa == NULL_PTR)
     {
         return STACK_ALLOC_ERROR_INVALID_PARAM;
     }
 
+    /* The empty top of a chained arena without an initial buffer is NULL_PTR */
+    if (marker == NULL_PTR)
+    {
+        return ((sa->mode == STACK_ALLOC_MODE_CHAINED) && (sa->base_start == NULL_PTR)) ?
+               StackAlloc_ChainFreeToMarker(sa, NULL_PTR) : STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
     /* Cast marker to byte pointer */
     uint8* mark = (uint8*)marker;
 
-    /* Validate marker is within buffer bounds and properly aligned */
-    if (mark < sa->buffer_start || mark >= sa->current)
+    /* A downward arena frees by moving its top back up towards the end */
+    if (sa->mode == STACK_ALLOC_MODE_DOWN)
     {
-        return STACK_ALLOC_ERROR_INVALID_MARKER;
+        if ((mark < sa->current) || (mark > sa->top_end))
+        {
+            return STACK_ALLOC_ERROR_INVALID_MARKER;
+        }
+
+        sa->current = mark;
+        return STACK_ALLOC_OK;
     }
 
-    // Check if marker is properly aligned
-    if ((mark != NULL_PTR) &&
-        (((uint32)mark & (STACK_ALLOC_ALIGNMENT - 1U)) != 0U))
+    /* Everything up to the current top may have been written */
+    StackAlloc_NoteDirty(sa);
+
+    /* Validate marker is within buffer bounds (the top itself frees nothing) */
+    if (mark < sa->buffer_start || mark > sa->current)
     {
+        /* In a chained arena the marker may lie in a chunk below the active one */
+        if (sa->mode == STACK_ALLOC_MODE_CHAINED)
+        {
+            return StackAlloc_ChainFreeToMarker(sa, mark);
+        }
+
         return STACK_ALLOC_ERROR_INVALID_MARKER;
     }
 
+    // No alignment check: blocks from StackAlloc_AllocAligned() may use any
+    // power-of-two alignment and are valid markers
+
     // Check LIFO order - This check is not needed in the free function
     // as we're using the marker directly
 
     /* Update current pointer to free memory */
     sa->current = mark;
 
+    if (sa->release_mode != STACK_ALLOC_RELEASE_NONE)
+    {
+        StackAlloc_VmReleaseUnused(sa);
+    }
+
     return STACK_ALLOC_OK;
 }
 
@@ -200,8 +530,57 @@ void StackAlloc_Reset(TStack_alloc* sa)
 {
     if (sa != NULL_PTR)
     {
-        /* Reset current pointer to the aligned start of the buffer */
-        sa->current = GetAlignedStart(sa);
+        StackAlloc_NoteDirty(sa);
+
+        /* Unlink all chunks so the initial buffer is active again */
+        if (sa->mode == STACK_ALLOC_MODE_CHAINED)
+        {
+            StackAlloc_ChainReset(sa);
+        }
+
+        /* Let the background scavenger see this cycle's peak */
+        if (sa->scavenge != NULL_PTR)
+        {
+            StackAlloc_ScavengeOnReset(sa);
+        }
+
+        /* Reset current pointer to the empty position of the buffer */
+        sa->current = GetEmptyTop(sa);
+
+        if (sa->release_mode != STACK_ALLOC_RELEASE_NONE)
+        {
+            StackAlloc_VmReleaseUnused(sa);
+        }
+    }
+}
+
+/**
+ * @brief       Releases all memory the allocator obtained on its own
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @note        This function is safe to call with a NULL pointer
+ * @note        Caller-provided buffers are not touched; for a fixed arena this is
+ *              equivalent to StackAlloc_Reset()
+ */
+void StackAlloc_Deinit(TStack_alloc* sa)
+{
+    if (sa != NULL_PTR)
+    {
+        StackAlloc_NoteDirty(sa);
+
+        if (sa->mode == STACK_ALLOC_MODE_CHAINED)
+        {
+            StackAlloc_ChainDeinit(sa);
+        }
+        else if (sa->mode == STACK_ALLOC_MODE_VIRTUAL)
+        {
+            StackAlloc_VmDeinit(sa);
+        }
+        else
+        {
+            /* Nothing to release for a fixed buffer */
+        }
+
+        sa->current = GetEmptyTop(sa);
     }
 }
 
@@ -209,8 +588,9 @@ void StackAlloc_Reset(TStack_alloc* sa)
  * @brief       Gets the total capacity of the stack allocator
  * @param[in]   sa  Pointer to the stack allocator instance
  * @return      Total capacity in bytes, or 0 if sa is NULL_PTR
+ * @note        For a virtual arena this is the reserved size (see StackAlloc_GetCommitted())
  */
-uint32 StackAlloc_GetCapacity(const TStack_alloc* sa)
+TStack_alloc_size StackAlloc_GetCapacity(const TStack_alloc* sa)
 {
     return (sa != NULL_PTR) ? sa->capacity : 0U;
 }
@@ -221,16 +601,40 @@ uint32 StackAlloc_GetCapacity(const TStack_alloc* sa)
  * @return      Number of bytes currently allocated, or 0 if sa is NULL_PTR
  * @note        The returned value includes any internal alignment padding
  */
-uint32 StackAlloc_GetUsed(const TStack_alloc* sa)
+TStack_alloc_size StackAlloc_GetUsed(const TStack_alloc* sa)
 {
     if (sa == NULL_PTR)
     {
         return 0U;
     }
     
-    /* Calculate used space as difference between current and aligned start */
+    /* A downward arena is in use from the top to its end */
+    if (sa->mode == STACK_ALLOC_MODE_DOWN)
+    {
+        return (TStack_alloc_size)(sa->top_end - sa->current);
+    }
+
+    /* Calculate used space as difference between current and aligned start,
+       plus whatever is in use in chunks below the active one */
     uint8* aligned_start = GetAlignedStart(sa);
-    return (uint32)(sa->current - aligned_start);
+    return sa->used_below + (TStack_alloc_size)(sa->current - aligned_start);
+}
+
+/**
+ * @brief       Gets the number of bytes above the top that are known to be zero
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @return      Bytes StackAlloc_Calloc() can hand out without zeroing, or 0 if sa is NULL_PTR
+ */
+TStack_alloc_size StackAlloc_GetKnownZero(const TStack_alloc* sa)
+{
+    if ((sa == NULL_PTR) || (sa->buffer_start == NULL_PTR) || (sa->mode == STACK_ALLOC_MODE_DOWN))
+    {
+        return 0U;
+    }
+
+    uint8* end = (sa->mode == STACK_ALLOC_MODE_VIRTUAL) ? sa->reserve_end : sa->buffer_end;
+    uint8* zero = (sa->zero_start > sa->current) ? sa->zero_start : sa->current;
+    return (zero < end) ? (TStack_alloc_size)(end - zero) : 0U;
 }
 
 /**
@@ -238,10 +642,31 @@ uint32 StackAlloc_GetUsed(const TStack_alloc* sa)
  * @param[in]   sa  Pointer to the stack allocator instance
  * @return      Number of bytes available for allocation, or 0 if sa is NULL_PTR
  * @note        The actual available space might be less due to alignment requirements
+ * @note        For a chained arena this is the space left in the active chunk
+ * @note        For a virtual arena this is the space left in the reservation
  */
-uint32 StackAlloc_GetAvailable(const TStack_alloc* sa)
+TStack_alloc_size StackAlloc_GetAvailable(const TStack_alloc* sa)
 {
-    return (sa != NULL_PTR) ? (uint32)(sa->buffer_end - sa->current) : 0U;
+    if (sa == NULL_PTR)
+    {
+        return 0U;
+    }
+
+    /* A downward arena can still move its top down to the start */
+    if (sa->mode == STACK_ALLOC_MODE_DOWN)
+    {
+        return (TStack_alloc_size)(sa->current - sa->buffer_start);
+    }
+
+    /* A measuring arena is only limited by its made-up capacity */
+    if (sa->mode == STACK_ALLOC_MODE_MEASURE)
+    {
+        return sa->capacity - StackAlloc_GetUsed(sa);
+    }
+
+    /* A virtual arena can still commit up to the end of its reservation */
+    uint8* end = (sa->mode == STACK_ALLOC_MODE_VIRTUAL) ? sa->reserve_end : sa->buffer_end;
+    return (TStack_alloc_size)(end - sa->current);
 }
 
 /**
@@ -253,9 +678,14 @@ uint32 StackAlloc_GetAvailable(const TStack_alloc* sa)
 TStack_alloc_error StackAlloc_Validate(const TStack_alloc* sa)
 {
     /* Check for NULL pointers in the allocator structure */
-    if ((sa == NULL_PTR) || 
-        (sa->buffer_start == NULL_PTR) || 
-        (sa->buffer_end == NULL_PTR))
+    if (sa == NULL_PTR)
+    {
+        return STACK_ALLOC_ERROR_CORRUPTED_STATE;
+    }
+
+    /* Only a chained arena without initial buffer and chunks has no region */
+    boolean empty_allowed = ((sa->mode == STACK_ALLOC_MODE_CHAINED) && (sa->chunk == NULL_PTR)) ? TRUE : FALSE;
+    if (((sa->buffer_start == NULL_PTR) || (sa->buffer_end == NULL_PTR)) && (empty_allowed == FALSE))
     {
         return STACK_ALLOC_ERROR_CORRUPTED_STATE;
     }
@@ -266,6 +696,20 @@ TStack_alloc_error StackAlloc_Validate(const TStack_alloc* sa)
         return STACK_ALLOC_ERROR_CORRUPTED_STATE;
     }
     
+    /* A downward top stays between the start and the aligned end */
+    if (sa->mode == STACK_ALLOC_MODE_DOWN)
+    {
+        return ((sa->buffer_end == sa->buffer_start) && (sa->current >= sa->buffer_start) &&
+                (sa->current <= sa->top_end)) ? STACK_ALLOC_OK : STACK_ALLOC_ERROR_CORRUPTED_STATE;
+    }
+
+    /* A measuring top stays within the made-up capacity */
+    if (sa->mode == STACK_ALLOC_MODE_MEASURE)
+    {
+        return ((sa->buffer_end == sa->buffer_start) && (sa->current >= sa->buffer_start) &&
+                (StackAlloc_GetUsed(sa) <= sa->capacity)) ? STACK_ALLOC_OK : STACK_ALLOC_ERROR_CORRUPTED_STATE;
+    }
+
     /* Verify current pointer is within valid range */
     uint8* aligned_start = GetAlignedStart(sa);
     if ((sa->current < aligned_start) || (sa->current > sa->buffer_end))
@@ -24,7 +24,18 @@
  * @retval      STACK_ALLOC_ERROR_INVALID_SIZE if buffer_size is too small
  * @note        The buffer must be aligned to STACK_ALLOC_ALIGNMENT for optimal performance
  */
-TStack_alloc_error StackAlloc_Init(TStack_alloc* sa, void* buffer, uint32 buffer_size);
+TStack_alloc_error StackAlloc_Init(TStack_alloc* sa, void* buffer, TStack_alloc_size buffer_size);
+
+/**
+ * @brief       Initializes a stack allocator with a buffer that is entirely zero
+ * @param[in]   sa           Pointer to the stack allocator instance to initialize
+ * @param[in]   buffer       Pointer to a zero-filled buffer (static array, fresh mmap, ...)
+ * @param[in]   buffer_size  Size of the provided buffer in bytes
+ * @return      Error code indicating success or failure (see StackAlloc_Init())
+ * @note        StackAlloc_Calloc() then skips zeroing memory that was never handed out.
+ *              StackAlloc_Init() assumes nothing about the contents and always zeroes.
+ */
+TStack_alloc_error StackAlloc_InitZeroed(TStack_alloc* sa, void* buffer, TStack_alloc_size buffer_size);
 
 /**
  * @brief       Allocates a block of memory from the stack
@@ -34,7 +45,30 @@ TStack_alloc_error StackAlloc_Init(TStack_alloc* sa, void* buffer, uint32 buffer
  * @note        The returned pointer is guaranteed to be aligned to STACK_ALLOC_ALIGNMENT
  * @note        This function is not thread-safe
  */
-void* StackAlloc_Alloc(TStack_alloc* sa, uint32 size);
+void* StackAlloc_Alloc(TStack_alloc* sa, TStack_alloc_size size);
+
+/**
+ * @brief       Allocates a block of memory with a per-call alignment
+ * @param[in]   sa         Pointer to the stack allocator instance
+ * @param[in]   size       Number of bytes to allocate
+ * @param[in]   alignment  Required alignment in bytes (must be a power of 2)
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ * @retval      NULL_PTR if alignment is not a power of 2
+ * @note        Padding is limited to what alignment requires; it may be smaller or
+ *              larger than STACK_ALLOC_ALIGNMENT
+ */
+void* StackAlloc_AllocAligned(TStack_alloc* sa, TStack_alloc_size size, TStack_alloc_size alignment);
+
+/**
+ * @brief       Out-of-line slow path of the inline allocation fast path
+ * @param[in]   sa         Pointer to the stack allocator instance
+ * @param[in]   size       Number of bytes to allocate
+ * @param[in]   alignment  Required alignment in bytes (power of 2)
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ * @note        Called by the inline allocators (stack_alloc_inline.h) when the
+ *              request does not fit the current buffer; not meant to be called directly
+ */
+void* StackAlloc_AllocSlow(TStack_alloc* sa, TStack_alloc_size size, TStack_alloc_size alignment);
 
 /**
  * @brief       Allocates and zero-initializes a block of memory
@@ -44,13 +78,135 @@ void* StackAlloc_Alloc(TStack_alloc* sa, uint32 size);
  * @return      Pointer to the allocated and zeroed memory, or NULL_PTR on failure
  * @note        This is equivalent to calloc() but uses the stack allocator
  */
-void* StackAlloc_Calloc(TStack_alloc* sa, uint32 num, uint32 size);
+void* StackAlloc_Calloc(TStack_alloc* sa, TStack_alloc_size num, TStack_alloc_size size);
+
+/**
+ * @brief       Allocates and zero-initializes a block of memory with a per-call alignment
+ * @param[in]   sa         Pointer to the stack allocator instance
+ * @param[in]   num        Number of elements to allocate
+ * @param[in]   size       Size of each element in bytes
+ * @param[in]   alignment  Required alignment in bytes (must be a power of 2)
+ * @return      Pointer to the allocated and zeroed memory, or NULL_PTR on failure
+ * @note        Only the part of the block that was handed out before (or whose contents
+ *              are unknown) is cleared; see StackAlloc_InitZeroed()
+ */
+void* StackAlloc_CallocAligned(TStack_alloc* sa, TStack_alloc_size num, TStack_alloc_size size,
+                               TStack_alloc_size alignment);
+
+/**
+ * @brief       Resizes a block, in place if it is the topmost one
+ * @param[in]   sa        Pointer to the stack allocator instance
+ * @param[in]   ptr       Block to resize, or NULL_PTR to allocate a new one
+ * @param[in]   old_size  Size the block was allocated or last resized with
+ * @param[in]   new_size  Requested size in bytes
+ * @return      Pointer to the resized block, or NULL_PTR on failure (ptr stays valid)
+ * @retval      NULL_PTR if sa is NULL_PTR, new_size is 0 or there is not enough memory
+ * @note        If ptr ends at the top of the stack, the top simply moves and ptr is
+ *              returned, for growing and shrinking alike. A chained arena whose active
+ *              chunk is too small moves the block into a new chunk instead.
+ * @note        Any other block keeps its place when shrinking and is copied to a new
+ *              block on top when growing. The old copy is not freed: like every block
+ *              below the top it is released when the stack is rewound past it
+ */
+void* StackAlloc_Realloc(TStack_alloc* sa, void* ptr, TStack_alloc_size old_size, TStack_alloc_size new_size);
+
+/**
+ * @brief       Resizes a block with a per-call alignment, in place if it is the topmost one
+ * @param[in]   sa         Pointer to the stack allocator instance
+ * @param[in]   ptr        Block to resize, or NULL_PTR to allocate a new one
+ * @param[in]   old_size   Size the block was allocated or last resized with
+ * @param[in]   new_size   Requested size in bytes
+ * @param[in]   alignment  Alignment the block needs (must be a power of 2)
+ * @return      Pointer to the resized block, or NULL_PTR on failure (ptr stays valid)
+ * @note        See StackAlloc_Realloc(). A top block that is not aligned to alignment
+ *              is moved like any other block
+ */
+void* StackAlloc_ReallocAligned(TStack_alloc* sa, void* ptr, TStack_alloc_size old_size,
+                                TStack_alloc_size new_size, TStack_alloc_size alignment);
+
+/**
+ * @brief       Opens a writable window over the free space above the top
+ * @param[in]   sa        Pointer to the stack allocator instance
+ * @param[in]   min_size  Minimum size of the window in bytes (0 behaves like 1)
+ * @param[out]  window    Receives the size of the window in bytes
+ * @return      Start of the window (aligned to STACK_ALLOC_ALIGNMENT), or NULL_PTR on failure
+ * @retval      NULL_PTR if sa or window is NULL_PTR, the arena is a downward or measuring
+ *              arena, or a fixed arena has fewer than min_size bytes left
+ * @note        The window is all the space left in the active region; growable arenas
+ *              first grow it to min_size. Write output of unknown length into it, then call
+ *              StackAlloc_CommitBlock() with the length actually used, or StackAlloc_AbortBlock().
+ *              Nothing else may be allocated from the arena while a block is open
+ * @note        The whole window counts as dirty for StackAlloc_Calloc() afterwards
+ */
+void* StackAlloc_OpenBlock(TStack_alloc* sa, TStack_alloc_size min_size, TStack_alloc_size* window);
+
+/**
+ * @brief       Makes the window of an open block at least min_size bytes large
+ * @param[in]   sa        Pointer to the stack allocator instance
+ * @param[in]   block     Start of the open block (from StackAlloc_OpenBlock() or a previous call)
+ * @param[in]   used      Bytes already written at the start of the block
+ * @param[in]   min_size  Minimum size of the window in bytes
+ * @param[out]  window    Receives the size of the window in bytes
+ * @return      Start of the window, or NULL_PTR on failure (the block stays open and unchanged)
+ * @note        A virtual arena commits more pages behind the block. A chained arena moves
+ *              the block into a new chunk, copying the first used bytes; continue with the
+ *              returned pointer. A fixed arena cannot grow the window
+ */
+void* StackAlloc_GrowBlock(TStack_alloc* sa, void* block, TStack_alloc_size used, TStack_alloc_size min_size,
+                           TStack_alloc_size* window);
+
+/**
+ * @brief       Closes an open block, keeping its first length bytes allocated
+ * @param[in]   sa      Pointer to the stack allocator instance
+ * @param[in]   block   Start of the open block
+ * @param[in]   length  Number of bytes to keep (at most the window size)
+ * @return      Error code indicating success or failure
+ * @retval      STACK_ALLOC_OK if the block was committed
+ * @retval      STACK_ALLOC_ERROR_INVALID_PARAM if sa or block is NULL_PTR or the arena is a downward
+ *              or measuring arena
+ * @retval      STACK_ALLOC_ERROR_INVALID_MARKER if block is not an open block
+ * @retval      STACK_ALLOC_ERROR_OUT_OF_MEMORY if length exceeds the window
+ * @note        Afterwards block behaves like a block returned by StackAlloc_Alloc()
+ */
+TStack_alloc_error StackAlloc_CommitBlock(TStack_alloc* sa, void* block, TStack_alloc_size length);
+
+/**
+ * @brief       Closes an open block without allocating anything
+ * @param[in]   sa     Pointer to the stack allocator instance
+ * @param[in]   block  Start of the open block
+ */
+void StackAlloc_AbortBlock(TStack_alloc* sa, void* block);
+
+/**
+ * @brief       Allocates one uninitialized object of the given type
+ * @details     Uses the natural alignment of the type instead of STACK_ALLOC_ALIGNMENT,
+ *              so small types are packed without extra padding.
+ * @param       sa    Pointer to the stack allocator instance
+ * @param       type  Type of the object
+ * @return      Typed pointer to the object, or NULL_PTR on failure
+ */
+#define STACK_ALLOC_NEW(sa, type) \
+    ((type*)StackAlloc_AllocAligned((sa), (TStack_alloc_size)sizeof(type), (TStack_alloc_size)_Alignof(type)))
+
+/**
+ * @brief       Allocates a zero-initialized array of the given type
+ * @param       sa     Pointer to the stack allocator instance
+ * @param       type   Element type
+ * @param       count  Number of elements
+ * @return      Typed pointer to the first element, or NULL_PTR on failure
+ */
+#define STACK_ALLOC_NEW_ARRAY(sa, type, count) \
+    ((type*)StackAlloc_CallocAligned((sa), (TStack_alloc_size)(count), (TStack_alloc_size)sizeof(type), \
+                                     (TStack_alloc_size)_Alignof(type)))
 
 /**
  * @brief       Gets a marker representing the current stack position
  * @param[in]   sa  Pointer to the stack allocator instance
  * @return      Marker representing the current stack position, or NULL_PTR if sa is NULL
- * @note        This marker can be used with StackAlloc_Rewind() to free memory back to this point
+ * @note        Passing the marker to StackAlloc_FreeToMarker() frees everything allocated
+ *              after this call. In an upward arena a block pointer is a marker as well.
+ *              A chained arena without an initial buffer and without chunks returns
+ *              NULL_PTR, which is accepted as a marker for that arena
  */
 void* StackAlloc_GetMarker(const TStack_alloc* sa);
 
@@ -71,16 +227,27 @@ TStack_alloc_error StackAlloc_FreeToMarker(TStack_alloc* sa, void* marker);
 /**
  * @brief       Resets the stack allocator, freeing all allocated memory
  * @param[in]   sa  Pointer to the stack allocator instance
- * @note        This is equivalent to StackAlloc_Rewind(sa, sa->buffer)
+ * @note        This is equivalent to freeing to a marker taken right after initialization
  */
 void StackAlloc_Reset(TStack_alloc* sa);
 
+/**
+ * @brief       Releases all memory the allocator obtained on its own
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @note        Chunks of a growable arena are returned to their provider and the range of a
+ *              virtual arena is unmapped. Caller-provided buffers are left untouched;
+ *              for a fixed arena this equals StackAlloc_Reset()
+ */
+void StackAlloc_Deinit(TStack_alloc* sa);
+
 /**
  * @brief       Gets the total capacity of the stack allocator
  * @param[in]   sa  Pointer to the stack allocator instance
  * @return      Total capacity in bytes, or 0 if sa is NULL_PTR
+ * @note        For a chained arena this includes every linked chunk
+ * @note        For a virtual arena this is the reserved size; see StackAlloc_GetCommitted()
  */
-uint32 StackAlloc_GetCapacity(const TStack_alloc* sa);
+TStack_alloc_size StackAlloc_GetCapacity(const TStack_alloc* sa);
 
 /**
  * @brief       Gets the amount of memory currently in use in bytes
@@ -88,14 +255,24 @@ uint32 StackAlloc_GetCapacity(const TStack_alloc* sa);
  * @return      Number of bytes currently allocated, or 0 if sa is NULL_PTR
  * @note        The returned value includes any internal alignment padding
  */
-uint32 StackAlloc_GetUsed(const TStack_alloc* sa);
+TStack_alloc_size StackAlloc_GetUsed(const TStack_alloc* sa);
 
 /**
  * @brief       Gets the amount of free memory available for allocation
  * @param[in]   sa  Pointer to the stack allocator instance
  * @return      Number of bytes available for allocation, or 0 if sa is NULL_PTR
+ * @note        For a chained arena this is the space left in the active chunk
+ * @note        For a virtual arena this is the space left in the reservation
+ */
+TStack_alloc_size StackAlloc_GetAvailable(const TStack_alloc* sa);
+
+/**
+ * @brief       Gets the number of bytes above the top that are known to be zero
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @return      Bytes StackAlloc_Calloc() can hand out without zeroing, or 0 if sa is NULL_PTR
+ * @note        Memory that was once allocated counts as dirty even after it is freed
  */
-uint32 StackAlloc_GetAvailable(const TStack_alloc* sa);
+TStack_alloc_size StackAlloc_GetKnownZero(const TStack_alloc* sa);
 
 /**
  * @brief       Validates the internal state of the stack allocator
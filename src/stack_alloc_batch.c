@@ -0,0 +1,249 @@
+/**
+ * @file        stack_alloc_batch.c
+ * @brief       Allocating many blocks with one call and one bounds check
+ * @details     The batch is first laid out at the arena's top, in addresses, and checked
+ *              against buffer_end once. Only if that fails is it laid out again from
+ *              offset 0 and allocated as one block through the regular path, which lets
+ *              chained and virtual arenas grow (and downward arenas allocate at all).
+ *
+ *              Reordering needs no sort: alignments are powers of two, so the blocks fall
+ *              into at most one class per bit. One pass sums the (rounded) sizes of each
+ *              class, the classes are placed largest alignment first, and a second pass
+ *              hands out the blocks of each class in caller order.
+ */
+
+/* ================================ Includes ================================ */
+#include "stack_alloc_batch.h"
+#include "stack_alloc_inline.h"
+
+/* ================================ Defines ================================= */
+#define BATCH_CLASSES   (sizeof(TStack_alloc_size) * 8U)   /**< One class per alignment bit */
+
+/**
+ * @brief   Blocks of one alignment in a reordered batch
+ */
+typedef struct {
+    TStack_alloc_addr bytes;   /**< Sizes rounded up to the alignment, summed */
+    TStack_alloc_addr slack;   /**< Rounding of the last block (not needed after it) */
+    TStack_alloc_addr next;    /**< Where the next block of the class goes */
+} TBatch_class;
+
+/**
+ * @brief       Gets the class of an alignment
+ * @param[in]   alignment  Power of 2
+ * @return      Index of its bit
+ */
+static inline uint32 ClassOf(TStack_alloc_size alignment)
+{
+    return (uint32)__builtin_ctzll((unsigned long long)alignment);
+}
+
+/**
+ * @brief       Validates the requests and lays them out in caller order
+ * @param[in]   requests    Array of requests
+ * @param[in]   count       Number of requests
+ * @param[out]  blocks      Receives the address (or offset) of each block
+ * @param[in]   start       Address (or offset) the first block may start at
+ * @param[out]  end         Receives the address just past the last block, or 0 on overflow
+ * @param[out]  alignments  Receives the alignments present (one bit each)
+ * @return      FALSE if a request has size 0 or an invalid alignment, TRUE otherwise
+ */
+static boolean LayOut(const TStack_alloc_request* requests, uint32 count, void** blocks,
+                      TStack_alloc_addr start, TStack_alloc_addr* end, TStack_alloc_size* alignments)
+{
+    TStack_alloc_addr top = start;
+    TStack_alloc_size seen = 0U;
+    boolean overflow = FALSE;
+
+    for (uint32 i = 0U; i < count; i++)
+    {
+        TStack_alloc_size alignment = requests[i].alignment;
+        if ((requests[i].size == 0U) || (StackAlloc_IsPowerOfTwo(alignment) == FALSE))
+        {
+            return FALSE;
+        }
+        seen |= alignment;
+
+        TStack_alloc_addr block = StackAlloc_AlignUp(top, alignment);
+        TStack_alloc_addr next  = block + requests[i].size;
+        if ((block < top) || (next < block))
+        {
+            overflow = TRUE;
+        }
+        blocks[i] = (void*)block;
+        top = next;
+    }
+
+    *end = (overflow == FALSE) ? top : 0U;
+    *alignments = seen;
+    return TRUE;
+}
+
+/**
+ * @brief       Gets the largest alignment of a batch
+ * @param[in]   alignments  Alignments present (one bit each, non-zero)
+ * @return      Highest set bit
+ */
+static TStack_alloc_size Largest(TStack_alloc_size alignments)
+{
+    while ((alignments & (alignments - 1U)) != 0U)
+    {
+        alignments &= alignments - 1U;
+    }
+
+    return alignments;
+}
+
+/**
+ * @brief       Places the classes of a reordered batch, largest alignment first
+ * @param[in]   classes     Per-class sums (next is set to the start of each class)
+ * @param[in]   alignments  Alignments present (one bit each)
+ * @param[in]   start       Address (or offset) the first class may start at
+ * @return      Address just past the last block, or 0 on overflow
+ */
+static TStack_alloc_addr PlaceClasses(TBatch_class* classes, TStack_alloc_size alignments, TStack_alloc_addr start)
+{
+    TStack_alloc_addr top = start;
+
+    for (uint32 k = BATCH_CLASSES; k-- > 0U;)
+    {
+        if ((alignments & ((TStack_alloc_size)1U << k)) != 0U)
+        {
+            TStack_alloc_addr block = StackAlloc_AlignUp(top, (TStack_alloc_addr)1U << k);
+            TStack_alloc_addr next  = block + (classes[k].bytes - classes[k].slack);
+            if ((block < top) || (next < block))
+            {
+                return 0U;
+            }
+            classes[k].next = block;
+            top = next;
+        }
+    }
+
+    return top;
+}
+
+/**
+ * @brief       Allocates every block of a batch, or none of them
+ * @param[in]   sa        Pointer to the stack allocator instance
+ * @param[in]   requests  Array of count requests
+ * @param[in]   count     Number of requests
+ * @param[out]  blocks    Receives the block of requests[i] in blocks[i]
+ * @param[in]   flags     STACK_ALLOC_BATCH_* options
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_AllocBatch(TStack_alloc* sa, const TStack_alloc_request* requests, uint32 count,
+                                         void** blocks, TStack_alloc_batch_flags flags)
+{
+    const boolean reorder = ((flags & STACK_ALLOC_BATCH_REORDER) != 0U) ? TRUE : FALSE;
+    TBatch_class classes[BATCH_CLASSES];
+    TStack_alloc_size alignments = 0U;
+    boolean overflow = FALSE;
+
+    if ((sa == NULL_PTR) || (requests == NULL_PTR) || (blocks == NULL_PTR) || (count == 0U))
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    TStack_alloc_addr base = 0U;
+    TStack_alloc_addr end  = 0U;
+
+    /* Lay the batch out at the top (validating it) and check it once */
+    if (reorder == FALSE)
+    {
+        if (LayOut(requests, count, blocks, (TStack_alloc_addr)sa->current, &end, &alignments) == FALSE)
+        {
+            return STACK_ALLOC_ERROR_INVALID_PARAM;
+        }
+    }
+    else
+    {
+        /* Sum the blocks of each class */
+        for (uint32 i = 0U; i < count; i++)
+        {
+            TStack_alloc_size alignment = requests[i].alignment;
+            if ((requests[i].size == 0U) || (StackAlloc_IsPowerOfTwo(alignment) == FALSE))
+            {
+                return STACK_ALLOC_ERROR_INVALID_PARAM;
+            }
+
+            TBatch_class* cls = &classes[ClassOf(alignment)];
+            if ((alignments & alignment) == 0U)
+            {
+                cls->bytes = 0U;
+            }
+            alignments |= alignment;
+
+            TStack_alloc_addr rounded = StackAlloc_AlignUp(requests[i].size, alignment);
+            if ((rounded < requests[i].size) || (rounded > (UINTPTR_MAX - cls->bytes)))
+            {
+                overflow = TRUE;
+            }
+            cls->bytes += rounded;
+            cls->slack  = rounded - requests[i].size;
+        }
+
+        if (overflow == FALSE)
+        {
+            end = PlaceClasses(classes, alignments, (TStack_alloc_addr)sa->current);
+        }
+    }
+
+    /* A downward arena never passes the check: its buffer_end lies below current */
+    if ((end != 0U) && (end <= (TStack_alloc_addr)sa->buffer_end))
+    {
+        sa->current = (uint8*)end;
+    }
+    else
+    {
+        /* Lay it out from offset 0 and let the regular path find (or make) room for it */
+        void* span = NULL_PTR;
+        if (overflow == FALSE)
+        {
+            if (reorder == FALSE)
+            {
+                (void)LayOut(requests, count, blocks, 0U, &end, &alignments);
+            }
+            else
+            {
+                end = PlaceClasses(classes, alignments, 0U);
+            }
+
+            if ((end != 0U) && (end <= STACK_ALLOC_SIZE_MAX))
+            {
+                span = StackAlloc_AllocAligned(sa, (TStack_alloc_size)end, Largest(alignments));
+            }
+        }
+
+        if (span == NULL_PTR)
+        {
+            for (uint32 i = 0U; i < count; i++)
+            {
+                blocks[i] = NULL_PTR;
+            }
+            return STACK_ALLOC_ERROR_OUT_OF_MEMORY;
+        }
+
+        base = (TStack_alloc_addr)span;
+        if (reorder == FALSE)
+        {
+            for (uint32 i = 0U; i < count; i++)
+            {
+                blocks[i] = (void*)(base + (TStack_alloc_addr)blocks[i]);
+            }
+        }
+    }
+
+    /* Hand out the blocks of each class in caller order */
+    if (reorder == TRUE)
+    {
+        for (uint32 i = 0U; i < count; i++)
+        {
+            TBatch_class* cls = &classes[ClassOf(requests[i].alignment)];
+            blocks[i] = (void*)(base + cls->next);
+            cls->next += StackAlloc_AlignUp(requests[i].size, requests[i].alignment);
+        }
+    }
+
+    return STACK_ALLOC_OK;
+}
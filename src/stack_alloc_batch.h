@@ -0,0 +1,56 @@
+/**
+ * @file        stack_alloc_batch.h
+ * @brief       Allocating many blocks with one call and one bounds check
+ * @details     StackAlloc_AllocBatch() lays out a list of (size, alignment) requests in
+ *              one pass, allocates the whole span as a single block and hands out pointers
+ *              into it. Either every request is served or none is.
+ *
+ *              With STACK_ALLOC_BATCH_REORDER the blocks are placed by decreasing alignment
+ *              (caller order within the same alignment), which removes most of the padding
+ *              between mixed alignments. The pointers are still returned in caller order.
+ *
+ * @note        This implementation is not thread-safe.
+ */
+
+#ifndef STACK_ALLOC_BATCH_H
+#define STACK_ALLOC_BATCH_H
+
+#include "stack_alloc.h"
+
+/**
+ * @brief   One block of a batch
+ */
+typedef struct {
+    TStack_alloc_size size;       /**< Number of bytes (non-zero) */
+    TStack_alloc_size alignment;  /**< Required alignment in bytes (power of 2) */
+} TStack_alloc_request;
+
+/**
+ * @brief Options of StackAlloc_AllocBatch() (can be combined with |)
+ */
+typedef uint32 TStack_alloc_batch_flags;
+
+#define STACK_ALLOC_BATCH_DEFAULT           (0x0u)  /**< Place blocks in caller order */
+#define STACK_ALLOC_BATCH_REORDER           (0x1u)  /**< Place blocks by decreasing alignment */
+
+/**
+ * @brief       Allocates every block of a batch, or none of them
+ * @param[in]   sa        Pointer to the stack allocator instance
+ * @param[in]   requests  Array of count requests
+ * @param[in]   count     Number of requests
+ * @param[out]  blocks    Array of count pointers, receives the block of requests[i] in blocks[i]
+ * @param[in]   flags     STACK_ALLOC_BATCH_* options
+ * @return      Error code indicating success or failure
+ * @retval      STACK_ALLOC_OK if every block was allocated
+ * @retval      STACK_ALLOC_ERROR_INVALID_PARAM if a pointer is NULL_PTR, count is 0, or a
+ *              request has size 0 or an alignment that is not a power of 2
+ * @retval      STACK_ALLOC_ERROR_OUT_OF_MEMORY if the batch does not fit (nothing is allocated)
+ * @note        On STACK_ALLOC_ERROR_OUT_OF_MEMORY every entry of blocks is NULL_PTR
+ * @note        The span starts at the largest alignment of the batch, so it may begin with
+ *              more padding than the first block alone would need. The blocks form one
+ *              allocation: a marker taken before the call frees all of them
+ */
+TStack_alloc_error StackAlloc_AllocBatch(TStack_alloc* sa, const TStack_alloc_request* requests, uint32 count,
+                                         void** blocks, TStack_alloc_batch_flags flags);
+
+#endif /* STACK_ALLOC_BATCH_H */
@@ -0,0 +1,369 @@
+/**
+ * @file        stack_alloc_chain.c
+ * @brief       Growable (chained-chunk) stack allocator implementation
+ * @details     Chunks are linked through a small header at their start. The allocator
+ *              instance always points at the active chunk, so the bump fast path is the
+ *              same as for a fixed buffer; only the slow path and rewinding look at the chain.
+ */
+
+/* ================================ Includes ================================ */
+#include "stack_alloc_chain.h"
+#include "stack_alloc_internal.h"
+#include "helper_routines.h"
+#include <stdlib.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define STACK_ALLOC_HAS_MMAP    (1U)
+#else
+#define STACK_ALLOC_HAS_MMAP    (0U)
+#endif
+
+/**
+ * @brief       Gets the usable start of a chunk (just after its header)
+ * @param[in]   chunk  Chunk header
+ * @return      First byte after the header
+ */
+static inline uint8* ChunkStart(TStack_alloc_chunk* chunk)
+{
+    return (uint8*)(chunk + 1);
+}
+
+/**
+ * @brief       Gets the end of a chunk (one past the last byte)
+ * @param[in]   chunk  Chunk header
+ * @return      End of the chunk
+ */
+static inline uint8* ChunkEnd(TStack_alloc_chunk* chunk)
+{
+    return (uint8*)chunk + chunk->size;
+}
+
+/**
+ * @brief       Gives a chunk back to the provider, or keeps it as the spare
+ * @param[in]   sa     Pointer to the stack allocator instance
+ * @param[in]   chunk  Chunk that was just unlinked
+ * @note        Only one chunk is cached: the one unlinked last. The previous spare was
+ *              acquired after it, so chunks go back to the provider in LIFO order (which
+ *              lets a parent-arena provider actually reclaim them)
+ */
+static void CacheChunk(TStack_alloc* sa, TStack_alloc_chunk* chunk)
+{
+    TStack_alloc_chunk* old = sa->spare;
+
+    sa->spare = chunk;
+    if (old != NULL_PTR)
+    {
+        sa->provider.release(sa->provider.ctx, old, old->size);
+    }
+}
+
+/**
+ * @brief       Unlinks the active chunk and makes the region below it active again
+ * @param[in]   sa  Pointer to a chained stack allocator with at least one chunk
+ */
+static void PopChunk(TStack_alloc* sa)
+{
+    TStack_alloc_chunk* chunk = sa->chunk;
+    TStack_alloc_chunk* prev  = chunk->prev;
+
+    /* Restore the region below */
+    if (prev != NULL_PTR)
+    {
+        sa->buffer_start = ChunkStart(prev);
+        sa->buffer_end   = ChunkEnd(prev);
+    }
+    else
+    {
+        sa->buffer_start = sa->base_start;
+        sa->buffer_end   = sa->base_end;
+    }
+    sa->current = chunk->prev_current;
+
+    /* The high-water mark of the region below was not kept */
+    sa->zero_start = sa->buffer_end;
+
+    /* The restored region is no longer "below" the active one */
+    sa->used_below -= (TStack_alloc_size)(sa->current - StackAlloc_AlignedStart(sa->buffer_start));
+    sa->capacity   -= chunk->size;
+    sa->chunk       = prev;
+
+    CacheChunk(sa, chunk);
+}
+
+void* StackAlloc_ChainGrow(TStack_alloc* sa, TStack_alloc_size size, TStack_alloc_size alignment)
+{
+    const TStack_alloc_size overhead = (TStack_alloc_size)sizeof(TStack_alloc_chunk) + STACK_ALLOC_ALIGNMENT + alignment;
+    TStack_alloc_chunk* chunk;
+
+    /* Check for overflow of the worst-case chunk size */
+    if (size > (STACK_ALLOC_SIZE_MAX - overhead))
+    {
+        return NULL_PTR;
+    }
+
+    TStack_alloc_size need = size + overhead;
+
+    /* Prefer the cached chunk, otherwise ask the provider */
+    if ((sa->spare != NULL_PTR) && (sa->spare->size >= need))
+    {
+        chunk = sa->spare;
+        sa->spare = NULL_PTR;
+    }
+    else
+    {
+        TStack_alloc_size chunk_bytes = (need > sa->chunk_size) ? need : sa->chunk_size;
+        chunk = (TStack_alloc_chunk*)sa->provider.acquire(sa->provider.ctx, chunk_bytes);
+        if (chunk == NULL_PTR)
+        {
+            return NULL_PTR;
+        }
+        chunk->size = chunk_bytes;
+    }
+
+    /* Leave the active region, remembering its top */
+    sa->used_below += (TStack_alloc_size)(sa->current - StackAlloc_AlignedStart(sa->buffer_start));
+    chunk->prev         = sa->chunk;
+    chunk->prev_current = sa->current;
+
+    /* Make the new chunk active */
+    sa->chunk        = chunk;
+    sa->capacity    += chunk->size;
+    sa->buffer_start = ChunkStart(chunk);
+    sa->buffer_end   = ChunkEnd(chunk);
+    sa->current      = StackAlloc_AlignedStart(sa->buffer_start);
+
+    /* A chunk may be a reused spare or come from malloc(): assume it is dirty */
+    sa->zero_start   = sa->buffer_end;
+
+    /* Guaranteed to fit */
+    return StackAlloc_AllocAlignedInline(sa, size, alignment);
+}
+
+TStack_alloc_error StackAlloc_ChainFreeToMarker(TStack_alloc* sa, uint8* mark)
+{
+    TStack_alloc_chunk* chunk = sa->chunk;
+
+    /* Without an initial buffer the empty top is NULL_PTR: rewind below the first chunk */
+    if ((mark == NULL_PTR) && (sa->base_start == NULL_PTR))
+    {
+        StackAlloc_ChainReset(sa);
+        return STACK_ALLOC_OK;
+    }
+
+    /* Find the region containing the marker, walking down the chain */
+    while (chunk != NULL_PTR)
+    {
+        TStack_alloc_chunk* prev = chunk->prev;
+        uint8* start = (prev != NULL_PTR) ? ChunkStart(prev) : sa->base_start;
+
+        /* The top of a lower region is itself a valid marker */
+        if ((start != NULL_PTR) && (mark >= start) && (mark <= chunk->prev_current))
+        {
+            while (sa->chunk != prev)
+            {
+                PopChunk(sa);
+            }
+            sa->current = mark;
+            return STACK_ALLOC_OK;
+        }
+
+        chunk = prev;
+    }
+
+    return STACK_ALLOC_ERROR_INVALID_MARKER;
+}
+
+void StackAlloc_ChainReset(TStack_alloc* sa)
+{
+    while (sa->chunk != NULL_PTR)
+    {
+        PopChunk(sa);
+    }
+}
+
+void StackAlloc_ChainDeinit(TStack_alloc* sa)
+{
+    StackAlloc_ChainReset(sa);
+
+    if (sa->spare != NULL_PTR)
+    {
+        sa->provider.release(sa->provider.ctx, sa->spare, sa->spare->size);
+        sa->spare = NULL_PTR;
+    }
+}
+
+/**
+ * @brief       Initializes a growable stack allocator
+ * @param[in]   sa           Pointer to the stack allocator instance to initialize
+ * @param[in]   buffer       Initial buffer, or NULL_PTR to take all memory from the provider
+ * @param[in]   buffer_size  Size of the initial buffer in bytes (0 if buffer is NULL_PTR)
+ * @param[in]   provider     Source of additional chunks (copied into the instance)
+ * @param[in]   chunk_size   Minimum chunk size in bytes, 0 for STACK_ALLOC_CHUNK_SIZE
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_InitChained(TStack_alloc* sa, void* buffer, TStack_alloc_size buffer_size,
+                                          const TStack_alloc_provider* provider, TStack_alloc_size chunk_size)
+{
+    /* Check for NULL pointers and an incomplete provider */
+    if ((sa == NULL_PTR) || (provider == NULL_PTR) ||
+        (provider->acquire == NULL_PTR) || (provider->release == NULL_PTR))
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    if (buffer != NULL_PTR)
+    {
+        /* Set up the initial buffer exactly like a fixed arena */
+        TStack_alloc_error err = StackAlloc_Init(sa, buffer, buffer_size);
+        if (err != STACK_ALLOC_OK)
+        {
+            return err;
+        }
+    }
+    else
+    {
+        /* No initial buffer: the first allocation links the first chunk */
+        if (buffer_size != 0U)
+        {
+            return STACK_ALLOC_ERROR_INVALID_PARAM;
+        }
+        (void)mem_set(sa, 0, sizeof(*sa));
+    }
+
+    sa->mode       = STACK_ALLOC_MODE_CHAINED;
+    sa->base_start = sa->buffer_start;
+    sa->base_end   = sa->buffer_end;
+    sa->chunk_size = (chunk_size != 0U) ? chunk_size : STACK_ALLOC_CHUNK_SIZE;
+    sa->provider   = *provider;
+
+    return STACK_ALLOC_OK;
+}
+
+/**
+ * @brief       Gets the number of chunks currently linked above the initial buffer
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @return      Number of linked chunks, or 0 if sa is NULL_PTR
+ */
+uint32 StackAlloc_GetChunkCount(const TStack_alloc* sa)
+{
+    uint32 count = 0U;
+
+    if (sa != NULL_PTR)
+    {
+        for (const TStack_alloc_chunk* chunk = sa->chunk; chunk != NULL_PTR; chunk = chunk->prev)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/* ================================ Providers ================================ */
+
+static void* MallocAcquire(void* ctx, TStack_alloc_size size)
+{
+    (void)ctx;
+    return malloc(size);
+}
+
+static void MallocRelease(void* ctx, void* block, TStack_alloc_size size)
+{
+    (void)ctx;
+    (void)size;
+    free(block);
+}
+
+/**
+ * @brief       Gets a provider backed by malloc()/free()
+ * @return      Provider instance
+ */
+TStack_alloc_provider StackAlloc_MallocProvider(void)
+{
+    TStack_alloc_provider provider = { MallocAcquire, MallocRelease, NULL_PTR };
+    return provider;
+}
+
+#if (STACK_ALLOC_HAS_MMAP == 1U)
+static void* MmapAcquire(void* ctx, TStack_alloc_size size)
+{
+    (void)ctx;
+    void* block = mmap(NULL_PTR, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return (block != MAP_FAILED) ? block : NULL_PTR;
+}
+
+static void MmapRelease(void* ctx, void* block, TStack_alloc_size size)
+{
+    (void)ctx;
+    (void)munmap(block, size);
+}
+#endif
+
+/**
+ * @brief       Gets a provider backed by anonymous mmap()/munmap()
+ * @return      Provider instance
+ */
+TStack_alloc_provider StackAlloc_MmapProvider(void)
+{
+#if (STACK_ALLOC_HAS_MMAP == 1U)
+    TStack_alloc_provider provider = { MmapAcquire, MmapRelease, NULL_PTR };
+    return provider;
+#else
+    return StackAlloc_MallocProvider();
+#endif
+}
+
+/**
+ * @brief       Carves a chunk out of the parent arena
+ * @param[in]   ctx   Parent stack allocator
+ * @param[in]   size  Chunk size in bytes
+ * @return      Chunk, or NULL_PTR if the parent is full
+ * @note        The parent's top before the chunk is kept right after it, so releasing
+ *              the chunk also gives back the alignment padding in front of it
+ */
+static void* ParentAcquire(void* ctx, TStack_alloc_size size)
+{
+    TStack_alloc* parent = (TStack_alloc*)ctx;
+    uint8* top = parent->current;
+
+    /* The child writes a header into each chunk, which a measuring parent cannot back */
+    if ((parent->mode == STACK_ALLOC_MODE_MEASURE) || (size > (STACK_ALLOC_SIZE_MAX - sizeof(top))))
+    {
+        return NULL_PTR;
+    }
+
+    uint8* block = (uint8*)StackAlloc_AllocAligned(parent, size + (TStack_alloc_size)sizeof(top), STACK_ALLOC_ALIGNMENT);
+    if (block != NULL_PTR)
+    {
+        (void)mem_cpy(block + size, &top, sizeof(top));
+    }
+
+    return block;
+}
+
+static void ParentRelease(void* ctx, void* block, TStack_alloc_size size)
+{
+    TStack_alloc* parent = (TStack_alloc*)ctx;
+    uint8* end = (uint8*)block + size + sizeof(uint8*);
+
+    /* Only the parent's topmost block can be given back; a downward parent's top is its lowest block */
+    if (((parent->mode == STACK_ALLOC_MODE_DOWN) && ((uint8*)block == parent->current)) ||
+        ((parent->mode != STACK_ALLOC_MODE_DOWN) && (end == parent->current)))
+    {
+        uint8* top;
+        (void)mem_cpy(&top, (uint8*)block + size, sizeof(top));
+        (void)StackAlloc_FreeToMarker(parent, top);
+    }
+}
+
+/**
+ * @brief       Gets a provider that carves chunks out of a parent arena
+ * @param[in]   parent  Parent stack allocator (must outlive the child)
+ * @return      Provider instance
+ */
+TStack_alloc_provider StackAlloc_ParentProvider(TStack_alloc* parent)
+{
+    TStack_alloc_provider provider = { ParentAcquire, ParentRelease, parent };
+    return provider;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file        stack_alloc_chain.h
+ * @brief       Growable (chained-chunk) stack allocator API
+ * @details     A chained arena starts in an optional caller-provided buffer and, instead
+ *              of failing when it runs out, links additional chunks obtained from a
+ *              backing provider. Allocation stays an O(1) bump inside the active chunk;
+ *              StackAlloc_FreeToMarker() and StackAlloc_Reset() unlink the chunks they
+ *              rewind past, caching one for reuse and releasing the others.
+ *
+ * @note        This implementation is not thread-safe.
+ */
+
+#ifndef STACK_ALLOC_CHAIN_H
+#define STACK_ALLOC_CHAIN_H
+
+#include "stack_alloc.h"
+
+/**
+ * @brief       Initializes a growable stack allocator
+ * @param[in]   sa           Pointer to the stack allocator instance to initialize
+ * @param[in]   buffer       Initial buffer, or NULL_PTR to take all memory from the provider
+ * @param[in]   buffer_size  Size of the initial buffer in bytes (0 if buffer is NULL_PTR)
+ * @param[in]   provider     Source of additional chunks (copied into the instance)
+ * @param[in]   chunk_size   Minimum chunk size in bytes, 0 for STACK_ALLOC_CHUNK_SIZE
+ * @return      Error code indicating success or failure
+ * @retval      STACK_ALLOC_OK if initialization was successful
+ * @retval      STACK_ALLOC_ERROR_INVALID_PARAM if sa or provider is invalid, or buffer
+ *              and buffer_size do not agree
+ * @note        Release the chunks with StackAlloc_Deinit() when the arena is no longer needed
+ */
+TStack_alloc_error StackAlloc_InitChained(TStack_alloc* sa, void* buffer, TStack_alloc_size buffer_size,
+                                          const TStack_alloc_provider* provider, TStack_alloc_size chunk_size);
+
+/**
+ * @brief       Gets a provider backed by malloc()/free()
+ * @return      Provider instance
+ */
+TStack_alloc_provider StackAlloc_MallocProvider(void);
+
+/**
+ * @brief       Gets a provider backed by anonymous mmap()/munmap()
+ * @return      Provider instance
+ * @note        Falls back to malloc()/free() on platforms without mmap()
+ */
+TStack_alloc_provider StackAlloc_MmapProvider(void);
+
+/**
+ * @brief       Gets a provider that carves chunks out of a parent arena
+ * @param[in]   parent  Parent stack allocator (must outlive the child)
+ * @return      Provider instance
+ * @note        A released chunk is given back to the parent only when it is the
+ *              parent's topmost block; otherwise it is reclaimed when the parent rewinds
+ */
+TStack_alloc_provider StackAlloc_ParentProvider(TStack_alloc* parent);
+
+/**
+ * @brief       Gets the number of chunks currently linked above the initial buffer
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @return      Number of linked chunks, or 0 if sa is NULL_PTR
+ */
+uint32 StackAlloc_GetChunkCount(const TStack_alloc* sa);
+
+#endif /* STACK_ALLOC_CHAIN_H */
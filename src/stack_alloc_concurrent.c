@@ -0,0 +1,138 @@
+/**
+ * @file        stack_alloc_concurrent.c
+ * @brief       Lock-free allocation from a stack allocator shared between threads
+ * @details     Only sa->current is written concurrently; the region bounds are stable
+ *              while the arena is shared, so they are read with plain loads.
+ */
+
+/* ================================ Includes ================================ */
+#include "stack_alloc_concurrent.h"
+#include "stack_alloc_inline.h"
+#include "stack_alloc_internal.h"
+
+/**
+ * @brief       Compare-and-swap bump of a downward arena
+ * @param[in]   sa         Pointer to a downward stack allocator instance
+ * @param[in]   size       Number of bytes to allocate (non-zero)
+ * @param[in]   alignment  Required alignment in bytes (power of 2)
+ * @return      Pointer to the allocated memory, or NULL_PTR if it does not fit
+ */
+static void* AllocDownConcurrent(TStack_alloc* sa, TStack_alloc_size size, TStack_alloc_size alignment)
+{
+    const TStack_alloc_addr floor = (TStack_alloc_addr)sa->buffer_start;
+    uint8* top = __atomic_load_n(&sa->current, __ATOMIC_RELAXED);
+
+    for (;;)
+    {
+        /* Same checks as StackAlloc_AllocAlignedDownInline() */
+        if (STACK_ALLOC_UNLIKELY(((TStack_alloc_addr)size - 1U) >= ((TStack_alloc_addr)top - floor)))
+        {
+            return NULL_PTR;
+        }
+
+        TStack_alloc_addr block = ((TStack_alloc_addr)top - (TStack_alloc_addr)size) & ~((TStack_alloc_addr)alignment - 1U);
+        if (STACK_ALLOC_UNLIKELY(block < floor))
+        {
+            return NULL_PTR;
+        }
+
+        if (__atomic_compare_exchange_n(&sa->current, &top, (uint8*)block, TRUE,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        {
+            return (void*)block;
+        }
+    }
+}
+
+/**
+ * @brief       Allocates memory from a shared arena with the default alignment
+ * @param[in]   sa    Pointer to the stack allocator instance
+ * @param[in]   size  Number of bytes to allocate
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ */
+void* StackAlloc_AllocConcurrent(TStack_alloc* sa, TStack_alloc_size size)
+{
+    return StackAlloc_AllocAlignedConcurrent(sa, size, STACK_ALLOC_ALIGNMENT);
+}
+
+/**
+ * @brief       Allocates memory with a specific alignment from a shared arena
+ * @param[in]   sa         Pointer to the stack allocator instance
+ * @param[in]   size       Number of bytes to allocate
+ * @param[in]   alignment  Required alignment in bytes (must be a power of 2)
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ */
+void* StackAlloc_AllocAlignedConcurrent(TStack_alloc* sa, TStack_alloc_size size, TStack_alloc_size alignment)
+{
+    /* A measuring arena records every allocation, which is not done atomically */
+    if ((sa == NULL_PTR) || (size == 0U) || (StackAlloc_IsPowerOfTwo(alignment) == FALSE) ||
+        (sa->mode == STACK_ALLOC_MODE_MEASURE))
+    {
+        return NULL_PTR;
+    }
+
+    if (sa->mode == STACK_ALLOC_MODE_DOWN)
+    {
+        return AllocDownConcurrent(sa, size, alignment);
+    }
+
+    const TStack_alloc_addr end = (TStack_alloc_addr)sa->buffer_end;
+    uint8* top = __atomic_load_n(&sa->current, __ATOMIC_RELAXED);
+
+    for (;;)
+    {
+        TStack_alloc_addr aligned = StackAlloc_AlignUp((TStack_alloc_addr)top, alignment);
+        TStack_alloc_addr new_top = aligned + size;
+
+        /* Same single range check as the inline path, but no growing */
+        if (STACK_ALLOC_UNLIKELY((new_top <= aligned) || (new_top > end)))
+        {
+            return NULL_PTR;
+        }
+
+        /* On failure top is reloaded and the padding recomputed from it */
+        if (__atomic_compare_exchange_n(&sa->current, &top, (uint8*)new_top, TRUE,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        {
+            return (void*)aligned;
+        }
+    }
+}
+
+/**
+ * @brief       Gets a marker of a shared arena
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @return      Current stack position, or NULL_PTR if sa is NULL_PTR
+ */
+void* StackAlloc_GetMarkerConcurrent(const TStack_alloc* sa)
+{
+    if (sa == NULL_PTR)
+    {
+        return NULL_PTR;
+    }
+
+    return __atomic_load_n(&sa->current, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief       Gets the amount of memory in use in a shared arena
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @return      Number of bytes currently allocated, or 0 if sa is NULL_PTR
+ */
+TStack_alloc_size StackAlloc_GetUsedConcurrent(const TStack_alloc* sa)
+{
+    if ((sa == NULL_PTR) || (sa->buffer_start == NULL_PTR))
+    {
+        return 0U;
+    }
+
+    uint8* top = __atomic_load_n(&sa->current, __ATOMIC_RELAXED);
+
+    /* A downward arena is in use from the top to its end */
+    if (sa->mode == STACK_ALLOC_MODE_DOWN)
+    {
+        return (TStack_alloc_size)(sa->top_end - top);
+    }
+
+    return sa->used_below + (TStack_alloc_size)(top - StackAlloc_AlignedStart(sa->buffer_start));
+}
@@ -0,0 +1,63 @@
+/**
+ * @file        stack_alloc_concurrent.h
+ * @brief       Lock-free allocation from a stack allocator shared between threads
+ * @details     The functions below advance the current pointer with a compare-and-swap
+ *              loop, so any number of threads can carve blocks out of one arena without
+ *              a lock and without ever receiving overlapping ranges.
+ *
+ * @note        Rules for a shared arena:
+ *              - Only the functions of this header may run concurrently with each other.
+ *              - Concurrent allocations are served from the active region only: the whole
+ *                buffer of a fixed arena, the committed part of a virtual arena, the active
+ *                chunk of a chained arena. They never grow the arena; a request that does
+ *                not fit returns NULL_PTR. A downward arena is bumped downwards as usual.
+ *                A measuring arena is not supported and always returns NULL_PTR.
+ *              - StackAlloc_Reset(), StackAlloc_FreeToMarker() and StackAlloc_Deinit() need
+ *                a quiescent arena: no concurrent allocation may be in flight, e.g. after
+ *                all worker threads were joined. The same applies to regular (non-concurrent)
+ *                allocations, which may also grow the arena.
+ *              - StackAlloc_GetMarkerConcurrent() may be called at any time. The marker
+ *                only separates blocks handed out before it from blocks handed out after it
+ *                by the same thread; rewinding to it is still subject to the rule above.
+ */
+
+#ifndef STACK_ALLOC_CONCURRENT_H
+#define STACK_ALLOC_CONCURRENT_H
+
+#include "stack_alloc.h"
+
+/**
+ * @brief       Allocates memory from a shared arena with the default alignment
+ * @param[in]   sa    Pointer to the stack allocator instance
+ * @param[in]   size  Number of bytes to allocate
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ */
+void* StackAlloc_AllocConcurrent(TStack_alloc* sa, TStack_alloc_size size);
+
+/**
+ * @brief       Allocates memory with a specific alignment from a shared arena
+ * @param[in]   sa         Pointer to the stack allocator instance
+ * @param[in]   size       Number of bytes to allocate
+ * @param[in]   alignment  Required alignment in bytes (must be a power of 2)
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ * @note        The padding is computed from the value the compare-and-swap replaces,
+ *              so a competing allocation between the load and the swap cannot break
+ *              the alignment; the loop simply retries with the new top
+ */
+void* StackAlloc_AllocAlignedConcurrent(TStack_alloc* sa, TStack_alloc_size size, TStack_alloc_size alignment);
+
+/**
+ * @brief       Gets a marker of a shared arena
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @return      Current stack position, or NULL_PTR if sa is NULL_PTR
+ */
+void* StackAlloc_GetMarkerConcurrent(const TStack_alloc* sa);
+
+/**
+ * @brief       Gets the amount of memory in use in a shared arena
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @return      Number of bytes currently allocated, or 0 if sa is NULL_PTR
+ */
+TStack_alloc_size StackAlloc_GetUsedConcurrent(const TStack_alloc* sa);
+
+#endif /* STACK_ALLOC_CONCURRENT_H */
@@ -0,0 +1,42 @@
+/**
+ * @file        stack_alloc_down.c
+ * @brief       Downward-bumping stack allocator implementation
+ * @details     A downward arena keeps buffer_end equal to buffer_start, which makes the
+ *              upward fast path fail for every request and route it to the slow path,
+ *              where the core dispatches to the downward bump. The real end of the
+ *              buffer is kept in top_end.
+ */
+
+/* ================================ Includes ================================ */
+#include "stack_alloc_down.h"
+#include "stack_alloc_internal.h"
+
+/**
+ * @brief       Initializes a stack allocator that fills a buffer from its end
+ * @param[in]   sa           Pointer to the stack allocator instance to initialize
+ * @param[in]   buffer       Pointer to the memory buffer to use
+ * @param[in]   buffer_size  Size of the provided buffer in bytes
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_InitDown(TStack_alloc* sa, void* buffer, TStack_alloc_size buffer_size)
+{
+    TStack_alloc_error err = StackAlloc_Init(sa, buffer, buffer_size);
+    if (err != STACK_ALLOC_OK)
+    {
+        return err;
+    }
+
+    /* Blocks start at the aligned end, so StackAlloc_Alloc() keeps its alignment guarantee.
+       StackAlloc_Init() made sure an aligned address lies inside the buffer, so top is above it */
+    uint8* top = (uint8*)((TStack_alloc_addr)sa->buffer_end & ~((TStack_alloc_addr)STACK_ALLOC_ALIGNMENT - 1U));
+
+    sa->mode       = STACK_ALLOC_MODE_DOWN;
+    sa->top_end    = top;
+    sa->current    = top;
+    sa->buffer_end = sa->buffer_start;
+
+    /* Known-zero tracking follows an upward top; a downward arena always zeroes */
+    sa->zero_start = top;
+
+    return STACK_ALLOC_OK;
+}
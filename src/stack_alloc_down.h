@@ -0,0 +1,80 @@
+/**
+ * @file        stack_alloc_down.h
+ * @brief       Downward-bumping stack allocator API
+ * @details     A downward arena hands out blocks from the end of a caller-provided
+ *              buffer towards its start. Allocating subtracts the size from the top and
+ *              rounds the result down to the alignment with a single mask, so there is
+ *              no separate padding computation and the bounds check is one comparison
+ *              against the start of the buffer.
+ *
+ *              The marker semantics are those of an upward arena: StackAlloc_GetMarker()
+ *              saves the top and StackAlloc_FreeToMarker() frees everything allocated
+ *              since. Every other StackAlloc_* function works on a downward arena too;
+ *              StackAlloc_Alloc() reaches it through StackAlloc_AllocSlow(), so include
+ *              this header and use the inline functions below on hot paths.
+ *
+ * @note        This implementation is not thread-safe.
+ */
+
+#ifndef STACK_ALLOC_DOWN_H
+#define STACK_ALLOC_DOWN_H
+
+#include "stack_alloc_inline.h"
+
+/**
+ * @brief       Initializes a stack allocator that fills a buffer from its end
+ * @param[in]   sa           Pointer to the stack allocator instance to initialize
+ * @param[in]   buffer       Pointer to the memory buffer to use
+ * @param[in]   buffer_size  Size of the provided buffer in bytes
+ * @return      Error code indicating success or failure
+ * @retval      STACK_ALLOC_OK if initialization was successful
+ * @retval      STACK_ALLOC_ERROR_INVALID_PARAM if sa or buffer is NULL or buffer_size is too small
+ * @retval      STACK_ALLOC_ERROR_OUT_OF_MEMORY if the buffer holds no aligned address
+ * @note        Unlike an upward arena, a block pointer is not a marker that frees the
+ *              block itself: it lies below the block's end. Take markers with
+ *              StackAlloc_GetMarker()
+ */
+TStack_alloc_error StackAlloc_InitDown(TStack_alloc* sa, void* buffer, TStack_alloc_size buffer_size);
+
+/**
+ * @brief       Inline fast path for a downward arena with a per-call alignment
+ * @param[in]   sa         Pointer to a downward stack allocator instance (must not be NULL_PTR)
+ * @param[in]   size       Number of bytes to allocate
+ * @param[in]   alignment  Required alignment in bytes (must be a power of 2, not checked)
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ * @note        Zero-size, oversized and out-of-memory requests fail without a call
+ */
+static inline void* StackAlloc_AllocAlignedDownInline(TStack_alloc* sa, TStack_alloc_size size,
+                                                      TStack_alloc_size alignment)
+{
+    TStack_alloc_addr top   = (TStack_alloc_addr)sa->current;
+    TStack_alloc_addr floor = (TStack_alloc_addr)sa->buffer_start;
+
+    /* Rejects size 0 and anything larger than the space left, so top - size cannot wrap */
+    if (STACK_ALLOC_LIKELY(((TStack_alloc_addr)size - 1U) < (top - floor)))
+    {
+        /* Rounding down consumes the padding below the block */
+        TStack_alloc_addr block = (top - (TStack_alloc_addr)size) & ~((TStack_alloc_addr)alignment - 1U);
+
+        if (STACK_ALLOC_LIKELY(block >= floor))
+        {
+            sa->current = (uint8*)block;
+            return (void*)block;
+        }
+    }
+
+    return NULL_PTR;
+}
+
+/**
+ * @brief       Inline fast path for a downward arena
+ * @param[in]   sa    Pointer to a downward stack allocator instance (must not be NULL_PTR)
+ * @param[in]   size  Number of bytes to allocate
+ * @return      Pointer to memory aligned to STACK_ALLOC_ALIGNMENT, or NULL_PTR on failure
+ */
+static inline void* StackAlloc_AllocDownInline(TStack_alloc* sa, TStack_alloc_size size)
+{
+    return StackAlloc_AllocAlignedDownInline(sa, size, STACK_ALLOC_ALIGNMENT);
+}
+
+#endif /* STACK_ALLOC_DOWN_H */
@@ -0,0 +1,219 @@
+/**
+ * @file        stack_alloc_dual.c
+ * @brief       Double-ended stack allocator implementation
+ * @details     The low end bumps like a regular arena; the high end bumps like a
+ *              downward arena (stack_alloc_down.h). The top of each end is the limit of
+ *              the other, so no space is reserved for either.
+ */
+
+/* ================================ Includes ================================ */
+#include "stack_alloc_dual.h"
+#include "stack_alloc_internal.h"
+
+/**
+ * @brief       Initializes a double-ended arena with a user-provided buffer
+ * @param[in]   da           Pointer to the arena to initialize
+ * @param[in]   buffer       Pointer to the memory buffer to use
+ * @param[in]   buffer_size  Size of the provided buffer in bytes
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_DualInit(TStack_alloc_dual* da, void* buffer, TStack_alloc_size buffer_size)
+{
+    if ((da == NULL_PTR) || (buffer == NULL_PTR) || (buffer_size < STACK_ALLOC_ALIGNMENT))
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    TStack_alloc_addr end = (TStack_alloc_addr)buffer + buffer_size;
+
+    da->low_base  = StackAlloc_AlignedStart((uint8*)buffer);
+    da->high_base = (uint8*)(end & ~((TStack_alloc_addr)STACK_ALLOC_ALIGNMENT - 1U));
+    da->low       = da->low_base;
+    da->high      = da->high_base;
+
+    if (da->low_base >= da->high_base)
+    {
+        return STACK_ALLOC_ERROR_OUT_OF_MEMORY;
+    }
+
+    return STACK_ALLOC_OK;
+}
+
+/**
+ * @brief       Allocates a block from one end of a double-ended arena
+ * @param[in]   da    Pointer to the arena
+ * @param[in]   end   STACK_ALLOC_END_LOW or STACK_ALLOC_END_HIGH
+ * @param[in]   size  Number of bytes to allocate
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ */
+void* StackAlloc_DualAlloc(TStack_alloc_dual* da, TStack_alloc_end end, TStack_alloc_size size)
+{
+    return StackAlloc_DualAllocAligned(da, end, size, STACK_ALLOC_ALIGNMENT);
+}
+
+/**
+ * @brief       Allocates a block with a per-call alignment from one end of a double-ended arena
+ * @param[in]   da         Pointer to the arena
+ * @param[in]   end        STACK_ALLOC_END_LOW or STACK_ALLOC_END_HIGH
+ * @param[in]   size       Number of bytes to allocate
+ * @param[in]   alignment  Required alignment in bytes (must be a power of 2)
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ */
+void* StackAlloc_DualAllocAligned(TStack_alloc_dual* da, TStack_alloc_end end, TStack_alloc_size size,
+                                  TStack_alloc_size alignment)
+{
+    if ((da == NULL_PTR) || (StackAlloc_IsPowerOfTwo(alignment) == FALSE))
+    {
+        return NULL_PTR;
+    }
+
+    TStack_alloc_addr low  = (TStack_alloc_addr)da->low;
+    TStack_alloc_addr high = (TStack_alloc_addr)da->high;
+
+    if (end == STACK_ALLOC_END_LOW)
+    {
+        /* Same range check as the regular fast path, with the high top as the limit */
+        TStack_alloc_addr aligned = StackAlloc_AlignUp(low, alignment);
+        TStack_alloc_addr new_top = aligned + size;
+
+        if ((new_top > aligned) && (new_top <= high))
+        {
+            da->low = (uint8*)new_top;
+            return (void*)aligned;
+        }
+    }
+    else if (end == STACK_ALLOC_END_HIGH)
+    {
+        /* Rejects size 0 and anything larger than the gap, so high - size cannot wrap */
+        if (((TStack_alloc_addr)size - 1U) < (high - low))
+        {
+            TStack_alloc_addr block = (high - (TStack_alloc_addr)size) & ~((TStack_alloc_addr)alignment - 1U);
+
+            if (block >= low)
+            {
+                da->high = (uint8*)block;
+                return (void*)block;
+            }
+        }
+    }
+    else
+    {
+        /* Invalid end */
+    }
+
+    return NULL_PTR;
+}
+
+/**
+ * @brief       Gets a marker representing the current top of one end
+ * @param[in]   da   Pointer to the arena
+ * @param[in]   end  STACK_ALLOC_END_LOW or STACK_ALLOC_END_HIGH
+ * @return      Marker for StackAlloc_DualFreeToMarker(), or NULL_PTR if da or end is invalid
+ */
+void* StackAlloc_DualGetMarker(const TStack_alloc_dual* da, TStack_alloc_end end)
+{
+    if (da == NULL_PTR)
+    {
+        return NULL_PTR;
+    }
+
+    switch (end)
+    {
+        case STACK_ALLOC_END_LOW:
+            return (void*)da->low;
+
+        case STACK_ALLOC_END_HIGH:
+            return (void*)da->high;
+
+        default:
+            return NULL_PTR;
+    }
+}
+
+/**
+ * @brief       Frees the blocks of one end back to a previously obtained marker
+ * @param[in]   da      Pointer to the arena
+ * @param[in]   end     End the marker was taken from
+ * @param[in]   marker  Marker obtained from StackAlloc_DualGetMarker()
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_DualFreeToMarker(TStack_alloc_dual* da, TStack_alloc_end end, void* marker)
+{
+    if ((da == NULL_PTR) || (marker == NULL_PTR))
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    uint8* mark = (uint8*)marker;
+
+    switch (end)
+    {
+        case STACK_ALLOC_END_LOW:
+            if ((mark < da->low_base) || (mark > da->low))
+            {
+                return STACK_ALLOC_ERROR_INVALID_MARKER;
+            }
+            da->low = mark;
+            return STACK_ALLOC_OK;
+
+        case STACK_ALLOC_END_HIGH:
+            if ((mark < da->high) || (mark > da->high_base))
+            {
+                return STACK_ALLOC_ERROR_INVALID_MARKER;
+            }
+            da->high = mark;
+            return STACK_ALLOC_OK;
+
+        default:
+            return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+}
+
+/**
+ * @brief       Frees every block of one end
+ * @param[in]   da   Pointer to the arena
+ * @param[in]   end  STACK_ALLOC_END_LOW or STACK_ALLOC_END_HIGH
+ */
+void StackAlloc_DualReset(TStack_alloc_dual* da, TStack_alloc_end end)
+{
+    if (da != NULL_PTR)
+    {
+        (void)StackAlloc_DualFreeToMarker(da, end, (end == STACK_ALLOC_END_LOW) ? da->low_base : da->high_base);
+    }
+}
+
+/**
+ * @brief       Gets the amount of memory in use by one end
+ * @param[in]   da   Pointer to the arena
+ * @param[in]   end  STACK_ALLOC_END_LOW or STACK_ALLOC_END_HIGH
+ * @return      Number of bytes allocated from that end, or 0 if da or end is invalid
+ */
+TStack_alloc_size StackAlloc_DualGetUsed(const TStack_alloc_dual* da, TStack_alloc_end end)
+{
+    if (da == NULL_PTR)
+    {
+        return 0U;
+    }
+
+    switch (end)
+    {
+        case STACK_ALLOC_END_LOW:
+            return (TStack_alloc_size)(da->low - da->low_base);
+
+        case STACK_ALLOC_END_HIGH:
+            return (TStack_alloc_size)(da->high_base - da->high);
+
+        default:
+            return 0U;
+    }
+}
+
+/**
+ * @brief       Gets the free space between the two tops
+ * @param[in]   da  Pointer to the arena
+ * @return      Number of bytes either end can still allocate, or 0 if da is NULL_PTR
+ */
+TStack_alloc_size StackAlloc_DualGetAvailable(const TStack_alloc_dual* da)
+{
+    return (da != NULL_PTR) ? (TStack_alloc_size)(da->high - da->low) : 0U;
+}
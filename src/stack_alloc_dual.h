@@ -0,0 +1,122 @@
+/**
+ * @file        stack_alloc_dual.h
+ * @brief       Double-ended stack allocator API
+ * @details     A double-ended arena runs two stacks over one caller-provided buffer:
+ *              the low stack grows up from the start, the high stack grows down from
+ *              the end. Typical use is long-lived results on one end and short-lived
+ *              scratch on the other, sharing the free space in the middle instead of
+ *              splitting it up front. An allocation fails only when the two tops meet.
+ *
+ *              Each end has its own markers, reset and usage query; the free space
+ *              (StackAlloc_DualGetAvailable()) is shared.
+ *
+ * @note        This implementation is not thread-safe.
+ */
+
+#ifndef STACK_ALLOC_DUAL_H
+#define STACK_ALLOC_DUAL_H
+
+#include "stack_alloc_types.h"
+
+/**
+ * @brief End of a double-ended arena
+ */
+typedef uint8 TStack_alloc_end;
+
+#define STACK_ALLOC_END_LOW                 (0x00u)  /**< Stack growing up from the start of the buffer */
+#define STACK_ALLOC_END_HIGH                (0x01u)  /**< Stack growing down from the end of the buffer */
+
+/**
+ * @brief   Two stacks sharing one buffer
+ */
+typedef struct {
+    uint8* low_base;   /**< Start of the buffer rounded up to STACK_ALLOC_ALIGNMENT */
+    uint8* high_base;  /**< End of the buffer rounded down to STACK_ALLOC_ALIGNMENT */
+    uint8* low;        /**< Top of the low stack (first free byte) */
+    uint8* high;       /**< Top of the high stack (first used byte, high_base if empty) */
+} TStack_alloc_dual;
+
+/**
+ * @brief       Initializes a double-ended arena with a user-provided buffer
+ * @param[in]   da           Pointer to the arena to initialize
+ * @param[in]   buffer       Pointer to the memory buffer to use
+ * @param[in]   buffer_size  Size of the provided buffer in bytes
+ * @return      Error code indicating success or failure
+ * @retval      STACK_ALLOC_OK if initialization was successful
+ * @retval      STACK_ALLOC_ERROR_INVALID_PARAM if da or buffer is NULL or buffer_size is too small
+ * @retval      STACK_ALLOC_ERROR_OUT_OF_MEMORY if no aligned space is left in the buffer
+ */
+TStack_alloc_error StackAlloc_DualInit(TStack_alloc_dual* da, void* buffer, TStack_alloc_size buffer_size);
+
+/**
+ * @brief       Allocates a block from one end of a double-ended arena
+ * @param[in]   da    Pointer to the arena
+ * @param[in]   end   STACK_ALLOC_END_LOW or STACK_ALLOC_END_HIGH
+ * @param[in]   size  Number of bytes to allocate
+ * @return      Pointer aligned to STACK_ALLOC_ALIGNMENT, or NULL_PTR on failure
+ */
+void* StackAlloc_DualAlloc(TStack_alloc_dual* da, TStack_alloc_end end, TStack_alloc_size size);
+
+/**
+ * @brief       Allocates a block with a per-call alignment from one end of a double-ended arena
+ * @param[in]   da         Pointer to the arena
+ * @param[in]   end        STACK_ALLOC_END_LOW or STACK_ALLOC_END_HIGH
+ * @param[in]   size       Number of bytes to allocate
+ * @param[in]   alignment  Required alignment in bytes (must be a power of 2)
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ * @retval      NULL_PTR if the block would cross the top of the other end, size is 0,
+ *              alignment is not a power of 2 or end is invalid
+ */
+void* StackAlloc_DualAllocAligned(TStack_alloc_dual* da, TStack_alloc_end end, TStack_alloc_size size,
+                                  TStack_alloc_size alignment);
+
+/**
+ * @brief       Gets a marker representing the current top of one end
+ * @param[in]   da   Pointer to the arena
+ * @param[in]   end  STACK_ALLOC_END_LOW or STACK_ALLOC_END_HIGH
+ * @return      Marker for StackAlloc_DualFreeToMarker(), or NULL_PTR if da or end is invalid
+ * @note        On the low end a block pointer is a marker as well, as in a regular arena.
+ *              On the high end it is not (it lies below its own block)
+ */
+void* StackAlloc_DualGetMarker(const TStack_alloc_dual* da, TStack_alloc_end end);
+
+/**
+ * @brief       Frees the blocks of one end back to a previously obtained marker
+ * @param[in]   da      Pointer to the arena
+ * @param[in]   end     End the marker was taken from
+ * @param[in]   marker  Marker obtained from StackAlloc_DualGetMarker()
+ * @return      Error code indicating success or failure
+ * @retval      STACK_ALLOC_OK if free was successful
+ * @retval      STACK_ALLOC_ERROR_INVALID_PARAM if da, marker or end is invalid
+ * @retval      STACK_ALLOC_ERROR_INVALID_MARKER if marker is not within the used part of that end
+ * @note        The other end is not affected
+ */
+TStack_alloc_error StackAlloc_DualFreeToMarker(TStack_alloc_dual* da, TStack_alloc_end end, void* marker);
+
+/**
+ * @brief       Frees every block of one end
+ * @param[in]   da   Pointer to the arena
+ * @param[in]   end  STACK_ALLOC_END_LOW or STACK_ALLOC_END_HIGH
+ * @note        This function is safe to call with a NULL pointer
+ */
+void StackAlloc_DualReset(TStack_alloc_dual* da, TStack_alloc_end end);
+
+/**
+ * @brief       Gets the amount of memory in use by one end
+ * @param[in]   da   Pointer to the arena
+ * @param[in]   end  STACK_ALLOC_END_LOW or STACK_ALLOC_END_HIGH
+ * @return      Number of bytes allocated from that end including padding, or 0 if da
+ *              or end is invalid
+ */
+TStack_alloc_size StackAlloc_DualGetUsed(const TStack_alloc_dual* da, TStack_alloc_end end);
+
+/**
+ * @brief       Gets the free space between the two tops
+ * @param[in]   da  Pointer to the arena
+ * @return      Number of bytes either end can still allocate, or 0 if da is NULL_PTR
+ * @note        The space is shared: what one end allocates is no longer available to
+ *              the other. Alignment padding may make the usable amount smaller
+ */
+TStack_alloc_size StackAlloc_DualGetAvailable(const TStack_alloc_dual* da);
+
+#endif /* STACK_ALLOC_DUAL_H */
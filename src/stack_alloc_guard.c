@@ -0,0 +1,152 @@
+/**
+ * @file        stack_alloc_guard.c
+ * @brief       Guard-protected arenas and the SIGSEGV handler that grows them
+ * @details     Registered arenas live in a fixed table of atomic slots so that the
+ *              signal handler can search it without locks. The handler only commits
+ *              pages (mprotect()) and moves buffer_end, both async-signal-safe.
+ */
+
+/* ================================ Includes ================================ */
+#include "stack_alloc_guard.h"
+#include "stack_alloc_internal.h"
+#include <pthread.h>
+#include <signal.h>
+#include <stddef.h>
+
+/* =============================== Variables ================================ */
+static TStack_alloc* g_guard_arenas[STACK_ALLOC_GUARD_MAX_ARENAS];
+
+static pthread_mutex_t g_install_lock = PTHREAD_MUTEX_INITIALIZER;
+static boolean g_installed = FALSE;
+static struct sigaction g_previous;
+
+/**
+ * @brief       SIGSEGV handler: commits the faulting page of a registered arena
+ * @param[in]   sig      Signal number
+ * @param[in]   info     Fault information (si_addr is the faulting address)
+ * @param[in]   context  Interrupted context, passed on unchanged
+ */
+static void FaultHandler(int sig, siginfo_t* info, void* context)
+{
+    const uint8* address = (const uint8*)info->si_addr;
+
+    for (uint32 i = 0U; i < STACK_ALLOC_GUARD_MAX_ARENAS; i++)
+    {
+        TStack_alloc* sa = __atomic_load_n(&g_guard_arenas[i], __ATOMIC_ACQUIRE);
+        if ((sa != NULL_PTR) && (StackAlloc_VmCommitFault(sa, address) == TRUE))
+        {
+            /* Returning retries the access, which now succeeds */
+            return;
+        }
+    }
+
+    /* Not ours: hand over to whoever was installed before */
+    if (((g_previous.sa_flags & SA_SIGINFO) != 0) && (g_previous.sa_sigaction != NULL_PTR))
+    {
+        g_previous.sa_sigaction(sig, info, context);
+    }
+    else if ((g_previous.sa_handler != SIG_DFL) && (g_previous.sa_handler != SIG_IGN))
+    {
+        g_previous.sa_handler(sig);
+    }
+    else
+    {
+        /* Restore the default action; the access faults again and ends the process */
+        struct sigaction fallback;
+        fallback.sa_handler = SIG_DFL;
+        fallback.sa_flags = 0;
+        (void)sigemptyset(&fallback.sa_mask);
+        (void)sigaction(SIGSEGV, &fallback, NULL_PTR);
+    }
+}
+
+/**
+ * @brief       Initializes a fully committed arena followed by a guard
+ * @param[in]   sa    Pointer to the stack allocator instance to initialize
+ * @param[in]   size  Size of the arena in bytes
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_InitGuarded(TStack_alloc* sa, TStack_alloc_size size)
+{
+    return StackAlloc_InitVirtualEx(sa, size, 0U, STACK_ALLOC_VM_GUARD | STACK_ALLOC_VM_PREFAULT);
+}
+
+/**
+ * @brief       Installs the SIGSEGV handler that grows registered arenas on demand
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_GuardInstallHandler(void)
+{
+    TStack_alloc_error err = STACK_ALLOC_OK;
+
+    (void)pthread_mutex_lock(&g_install_lock);
+    if (g_installed == FALSE)
+    {
+        struct sigaction action;
+        action.sa_sigaction = FaultHandler;
+        action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+        (void)sigemptyset(&action.sa_mask);
+
+        if (sigaction(SIGSEGV, &action, &g_previous) == 0)
+        {
+            g_installed = TRUE;
+        }
+        else
+        {
+            err = STACK_ALLOC_ERROR_INVALID_PARAM;
+        }
+    }
+    (void)pthread_mutex_unlock(&g_install_lock);
+
+    return err;
+}
+
+/**
+ * @brief       Lets the fault handler commit more of an arena's reservation
+ * @param[in]   sa  Pointer to a virtual stack allocator created with STACK_ALLOC_VM_GUARD
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_GuardRegister(TStack_alloc* sa)
+{
+    /* A tail handed to the scavenger would be reachable above buffer_end */
+    if ((sa == NULL_PTR) || (sa->mode != STACK_ALLOC_MODE_VIRTUAL) || (sa->buffer_start == NULL_PTR) ||
+        (sa->guard_size == 0U) || (sa->fault_grow == TRUE) || (sa->scavenge != NULL_PTR))
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    for (uint32 i = 0U; i < STACK_ALLOC_GUARD_MAX_ARENAS; i++)
+    {
+        TStack_alloc* expected = NULL_PTR;
+        if (__atomic_compare_exchange_n(&g_guard_arenas[i], &expected, sa, FALSE,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        {
+            sa->fault_grow = TRUE;
+            return STACK_ALLOC_OK;
+        }
+    }
+
+    return STACK_ALLOC_ERROR_OUT_OF_MEMORY;
+}
+
+/**
+ * @brief       Stops the fault handler from growing an arena
+ * @param[in]   sa  Pointer to a registered arena
+ */
+void StackAlloc_GuardUnregister(TStack_alloc* sa)
+{
+    if ((sa == NULL_PTR) || (sa->fault_grow == FALSE))
+    {
+        return;
+    }
+
+    for (uint32 i = 0U; i < STACK_ALLOC_GUARD_MAX_ARENAS; i++)
+    {
+        if (__atomic_load_n(&g_guard_arenas[i], __ATOMIC_RELAXED) == sa)
+        {
+            __atomic_store_n(&g_guard_arenas[i], NULL_PTR, __ATOMIC_RELEASE);
+        }
+    }
+
+    sa->fault_grow = FALSE;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file        stack_alloc_guard.h
+ * @brief       Unchecked allocation fast path for guard-protected virtual arenas
+ * @details     A virtual arena created with STACK_ALLOC_VM_GUARD is followed by an
+ *              inaccessible guard of STACK_ALLOC_GUARD_SIZE bytes, and everything between
+ *              its committed end and the guard is inaccessible as well. A bump of at most
+ *              the guard size, alignment padding included, therefore cannot jump over
+ *              inaccessible memory, so the fast path below skips the bounds check: a block
+ *              beyond the arena faults when it is written instead of corrupting whatever
+ *              lies behind. Requests must keep size + alignment - 1 within
+ *              STACK_ALLOC_GUARD_SIZE; builds without NDEBUG assert it.
+ *
+ *              Without further setup the arena must be fully committed up front
+ *              (StackAlloc_InitGuarded()). Alternatively the SIGSEGV handler installed by
+ *              StackAlloc_GuardInstallHandler() commits more of the reservation whenever
+ *              a block of a registered arena touches uncommitted memory.
+ *
+ * @note        Blocks must be written in allocation order, and every block must be
+ *              written before the next unchecked allocation; an arena that ran out
+ *              then faults at most one block late. Like the rest of the allocator,
+ *              arenas are not thread-safe: faults are handled on the faulting thread,
+ *              which must be the arena's owner.
+ */
+
+#ifndef STACK_ALLOC_GUARD_H
+#define STACK_ALLOC_GUARD_H
+
+#include "stack_alloc_inline.h"
+#include "stack_alloc_vm.h"
+#include <assert.h>
+
+/**
+ * @brief       Allocates a block without checking the arena bounds
+ * @param[in]   sa         Pointer to a guard-protected stack allocator (not checked)
+ * @param[in]   size       Number of bytes (not checked in release builds)
+ * @param[in]   alignment  Required alignment in bytes, a power of 2 (not checked)
+ * @return      Pointer to the block; it faults on first write if the arena is exhausted
+ * @note        size + alignment - 1 must not exceed STACK_ALLOC_GUARD_SIZE. The padding
+ *              counts too: a larger alignment could place the block past the guard, in
+ *              memory that does not fault
+ */
+static inline void* StackAlloc_AllocAlignedUnchecked(TStack_alloc* sa, TStack_alloc_size size,
+                                                     TStack_alloc_size alignment)
+{
+    assert((size <= STACK_ALLOC_GUARD_SIZE) && ((alignment - 1U) <= (STACK_ALLOC_GUARD_SIZE - size)));
+
+    TStack_alloc_addr aligned = StackAlloc_AlignUp((TStack_alloc_addr)sa->current, alignment);
+
+    sa->current = (uint8*)(aligned + size);
+    return (void*)aligned;
+}
+
+/**
+ * @brief       Allocates a block with the default alignment without checking the arena bounds
+ * @param[in]   sa    Pointer to a guard-protected stack allocator (not checked)
+ * @param[in]   size  Number of bytes, at most STACK_ALLOC_GUARD_SIZE - STACK_ALLOC_ALIGNMENT + 1
+ * @return      Pointer to the block; it faults on first write if the arena is exhausted
+ */
+static inline void* StackAlloc_AllocUnchecked(TStack_alloc* sa, TStack_alloc_size size)
+{
+    return StackAlloc_AllocAlignedUnchecked(sa, size, STACK_ALLOC_ALIGNMENT);
+}
+
+/**
+ * @brief       Initializes a fully committed arena followed by a guard
+ * @param[in]   sa    Pointer to the stack allocator instance to initialize
+ * @param[in]   size  Size of the arena in bytes (rounded up to the page size)
+ * @return      Error code indicating success or failure (see StackAlloc_InitVirtualEx())
+ * @note        Same as StackAlloc_InitVirtualEx() with STACK_ALLOC_VM_GUARD | STACK_ALLOC_VM_PREFAULT
+ */
+TStack_alloc_error StackAlloc_InitGuarded(TStack_alloc* sa, TStack_alloc_size size);
+
+/**
+ * @brief       Installs the SIGSEGV handler that grows registered arenas on demand
+ * @return      STACK_ALLOC_OK on success, STACK_ALLOC_ERROR_INVALID_PARAM if it could not be installed
+ * @note        Faults outside registered arenas are passed on to the handler that was
+ *              installed before, or end the process as usual. Installing twice is harmless
+ */
+TStack_alloc_error StackAlloc_GuardInstallHandler(void);
+
+/**
+ * @brief       Lets the fault handler commit more of an arena's reservation
+ * @param[in]   sa  Pointer to a virtual stack allocator created with STACK_ALLOC_VM_GUARD
+ * @return      STACK_ALLOC_OK on success, STACK_ALLOC_ERROR_INVALID_PARAM if sa is not a
+ *              guarded virtual arena, already registered or registered with the scavenger,
+ *              STACK_ALLOC_ERROR_OUT_OF_MEMORY if STACK_ALLOC_GUARD_MAX_ARENAS are registered
+ * @note        StackAlloc_Deinit() unregisters the arena automatically
+ */
+TStack_alloc_error StackAlloc_GuardRegister(TStack_alloc* sa);
+
+/**
+ * @brief       Stops the fault handler from growing an arena
+ * @param[in]   sa  Pointer to a registered arena (ignored if not registered)
+ */
+void StackAlloc_GuardUnregister(TStack_alloc* sa);
+
+#endif /* STACK_ALLOC_GUARD_H */
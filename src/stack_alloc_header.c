@@ -0,0 +1,233 @@
+/**
+ * @file        stack_alloc_header.c
+ * @brief       Blocks that record their size, freed one at a time
+ * @details     The size record is a trailer so that it can be found from the top. The
+ *              varint is stored back to front: the byte just below the top holds the low
+ *              7 bits, and bit 7 of each byte says whether another byte lies below it.
+ */
+
+/* ================================ Includes ================================ */
+#include "stack_alloc_header.h"
+#include "stack_alloc_internal.h"
+
+#if (STACK_ALLOC_HEADER_VARINT == 1U)
+#define HEADER_MAX_BYTES    ((TStack_alloc_size)((sizeof(TStack_alloc_size) * 8U + 6U) / 7U))
+#else
+#define HEADER_MAX_BYTES    ((TStack_alloc_size)4U)
+#endif
+
+/**
+ * @brief       Gets the number of record bytes needed for a distance
+ * @param[in]   distance  Distance from the previous top to the end of the block
+ * @return      Number of record bytes
+ */
+static inline TStack_alloc_size HeaderLength(TStack_alloc_addr distance)
+{
+#if (STACK_ALLOC_HEADER_VARINT == 1U)
+    TStack_alloc_size length = 1U;
+    while (STACK_ALLOC_UNLIKELY(distance >= 0x80U))
+    {
+        distance >>= 7;
+        length++;
+    }
+    return length;
+#else
+    (void)distance;
+    return HEADER_MAX_BYTES;
+#endif
+}
+
+/**
+ * @brief       Writes the record for a block
+ * @param[in]   end       End of the block (first record byte)
+ * @param[in]   distance  Distance from the previous top to end
+ * @param[in]   length    Record length from HeaderLength()
+ */
+static inline void WriteHeader(uint8* end, TStack_alloc_addr distance, TStack_alloc_size length)
+{
+#if (STACK_ALLOC_HEADER_VARINT == 1U)
+    /* Low bits first, from the top down; only the lowest byte has bit 7 clear */
+    for (uint8* p = end + length - 1U; p >= end; p--)
+    {
+        *p = (uint8)((distance & 0x7FU) | ((p != end) ? 0x80U : 0x00U));
+        distance >>= 7;
+    }
+#else
+    uint32 value = (uint32)distance;
+    (void)length;
+    __builtin_memcpy(end, &value, sizeof(value));
+#endif
+}
+
+/**
+ * @brief       Reads the record ending at the top
+ * @param[in]   top       Current top of the stack
+ * @param[in]   limit     Lowest address the record may start at
+ * @param[out]  distance  Receives the distance stored in the record
+ * @return      Record length, or 0 if the record does not fit above limit
+ */
+static inline TStack_alloc_size ReadHeader(const uint8* top, const uint8* limit, TStack_alloc_addr* distance)
+{
+#if (STACK_ALLOC_HEADER_VARINT == 1U)
+    const uint8* p = top - 1;
+    TStack_alloc_addr value = 0U;
+    uint32 shift = 0U;
+
+    for (;;)
+    {
+        if ((p < limit) || (shift >= (sizeof(TStack_alloc_addr) * 8U)))
+        {
+            return 0U;
+        }
+        value |= (TStack_alloc_addr)(*p & 0x7FU) << shift;
+        if ((*p & 0x80U) == 0U)
+        {
+            break;
+        }
+        shift += 7U;
+        p--;
+    }
+
+    *distance = value;
+    return (TStack_alloc_size)(top - p);
+#else
+    uint32 value;
+    if ((TStack_alloc_size)(top - limit) < HEADER_MAX_BYTES)
+    {
+        return 0U;
+    }
+    __builtin_memcpy(&value, top - HEADER_MAX_BYTES, sizeof(value));
+    *distance = value;
+    return HEADER_MAX_BYTES;
+#endif
+}
+
+/**
+ * @brief       Allocates a block that StackAlloc_Pop() can free
+ * @param[in]   sa    Pointer to the stack allocator instance
+ * @param[in]   size  Number of bytes to allocate
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ */
+void* StackAlloc_Push(TStack_alloc* sa, TStack_alloc_size size)
+{
+    return StackAlloc_PushAligned(sa, size, STACK_ALLOC_ALIGNMENT);
+}
+
+/**
+ * @brief       Allocates a block with a per-call alignment that StackAlloc_Pop() can free
+ * @param[in]   sa         Pointer to the stack allocator instance
+ * @param[in]   size       Number of bytes to allocate
+ * @param[in]   alignment  Required alignment in bytes (must be a power of 2)
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ */
+void* StackAlloc_PushAligned(TStack_alloc* sa, TStack_alloc_size size, TStack_alloc_size alignment)
+{
+    if ((sa == NULL_PTR) || (sa->mode == STACK_ALLOC_MODE_DOWN) || (sa->mode == STACK_ALLOC_MODE_MEASURE) ||
+        (size == 0U) || (StackAlloc_IsPowerOfTwo(alignment) == FALSE))
+    {
+        return NULL_PTR;
+    }
+
+    /* Reserve the record for the worst-case padding, then give back what is not needed */
+    TStack_alloc_size reserve = StackAlloc_GetPushOverhead(size, alignment);
+    if (size > (STACK_ALLOC_SIZE_MAX - reserve))
+    {
+        return NULL_PTR;
+    }
+
+    uint8* prev = sa->current;
+    uint8* block = (uint8*)StackAlloc_AllocAlignedInline(sa, size + reserve, alignment);
+    if (block == NULL_PTR)
+    {
+        return NULL_PTR;
+    }
+
+    /* A block that opened a new chunk starts its region: there is no padding to record */
+    if ((prev < sa->buffer_start) || (prev > block))
+    {
+        prev = StackAlloc_AlignedStart(sa->buffer_start);
+    }
+
+    TStack_alloc_addr distance = (TStack_alloc_addr)(block + size - prev);
+#if (STACK_ALLOC_HEADER_VARINT == 0U)
+    if (distance > 0xFFFFFFFFU)
+    {
+        /* Too large for the fixed record; a chained arena keeps the (empty) new chunk */
+        sa->current = prev;
+        return NULL_PTR;
+    }
+#endif
+    TStack_alloc_size length = HeaderLength(distance);
+    WriteHeader(block + size, distance, length);
+    sa->current = block + size + length;
+
+    return block;
+}
+
+/**
+ * @brief       Frees the topmost block allocated with StackAlloc_Push()
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_Pop(TStack_alloc* sa)
+{
+    if ((sa == NULL_PTR) || (sa->mode == STACK_ALLOC_MODE_DOWN) || (sa->mode == STACK_ALLOC_MODE_MEASURE))
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    /* The last block of a chunk was popped: leave the empty chunk first */
+    uint8* start = StackAlloc_AlignedStart(sa->buffer_start);
+    if ((sa->mode == STACK_ALLOC_MODE_CHAINED) && (sa->chunk != NULL_PTR) && (sa->current == start))
+    {
+        TStack_alloc_error err = StackAlloc_FreeToMarker(sa, sa->chunk->prev_current);
+        if (err != STACK_ALLOC_OK)
+        {
+            return err;
+        }
+        start = StackAlloc_AlignedStart(sa->buffer_start);
+    }
+
+    if ((sa->buffer_start == NULL_PTR) || (sa->current <= start))
+    {
+        return STACK_ALLOC_ERROR_INVALID_MARKER;
+    }
+
+    TStack_alloc_addr distance = 0U;
+    TStack_alloc_size length = ReadHeader(sa->current, start, &distance);
+    if ((length == 0U) || (distance > (TStack_alloc_addr)((sa->current - length) - start)))
+    {
+        return STACK_ALLOC_ERROR_CORRUPTED_STATE;
+    }
+
+    uint8* mark = sa->current - length - distance;
+
+    /* The marker lies in the active region, so only a release policy needs the full path */
+    if (sa->release_mode != STACK_ALLOC_RELEASE_NONE)
+    {
+        return StackAlloc_FreeToMarker(sa, mark);
+    }
+
+    StackAlloc_NoteDirty(sa);
+    sa->current = mark;
+    return STACK_ALLOC_OK;
+}
+
+/**
+ * @brief       Gets the size of the record StackAlloc_Push() stores for a block
+ * @param[in]   size       Size of the block in bytes
+ * @param[in]   alignment  Alignment of the block in bytes
+ * @return      Largest number of record bytes the block can need
+ */
+TStack_alloc_size StackAlloc_GetPushOverhead(TStack_alloc_size size, TStack_alloc_size alignment)
+{
+    TStack_alloc_addr worst = (TStack_alloc_addr)size + (TStack_alloc_addr)alignment - 1U;
+
+    /* Wrapped: the request cannot succeed anyway */
+    if (worst < (TStack_alloc_addr)size)
+    {
+        return HEADER_MAX_BYTES;
+    }
+
+    return HeaderLength(worst);
+}
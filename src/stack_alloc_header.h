@@ -0,0 +1,65 @@
+/**
+ * @file        stack_alloc_header.h
+ * @brief       Blocks that record their size, freed one at a time
+ * @details     StackAlloc_Push() allocates like StackAlloc_AllocAligned() and writes a
+ *              small size record right after the block. StackAlloc_Pop() reads the record
+ *              just below the top and frees the topmost block in O(1), without a marker.
+ *
+ *              The record holds the distance from the previous top to the end of the
+ *              block (size plus alignment padding). With STACK_ALLOC_HEADER_VARINT it is
+ *              1 byte for up to 127 bytes, 2 bytes up to 16 KiB and 3 bytes up to 2 MiB;
+ *              otherwise it is always 4 bytes. Because the record sits between two blocks,
+ *              the next block's alignment padding often absorbs it: with the default 8-byte
+ *              alignment a 13-byte block costs no extra space, a 16-byte block costs 8.
+ *
+ * @note        Only blocks from StackAlloc_Push() can be popped. Mixing them with other
+ *              allocations is fine as long as StackAlloc_Pop() is only called while the
+ *              topmost block was pushed. Downward and measuring arenas are not supported.
+ */
+
+#ifndef STACK_ALLOC_HEADER_H
+#define STACK_ALLOC_HEADER_H
+
+#include "stack_alloc.h"
+
+/**
+ * @brief       Allocates a block that StackAlloc_Pop() can free
+ * @param[in]   sa    Pointer to the stack allocator instance
+ * @param[in]   size  Number of bytes to allocate
+ * @return      Pointer aligned to STACK_ALLOC_ALIGNMENT, or NULL_PTR on failure
+ */
+void* StackAlloc_Push(TStack_alloc* sa, TStack_alloc_size size);
+
+/**
+ * @brief       Allocates a block with a per-call alignment that StackAlloc_Pop() can free
+ * @param[in]   sa         Pointer to the stack allocator instance
+ * @param[in]   size       Number of bytes to allocate
+ * @param[in]   alignment  Required alignment in bytes (must be a power of 2)
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ * @retval      NULL_PTR if sa is NULL_PTR or a downward arena, size is 0, alignment is not
+ *              a power of 2 or there is not enough memory
+ */
+void* StackAlloc_PushAligned(TStack_alloc* sa, TStack_alloc_size size, TStack_alloc_size alignment);
+
+/**
+ * @brief       Frees the topmost block allocated with StackAlloc_Push()
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @return      Error code indicating success or failure
+ * @retval      STACK_ALLOC_OK if the block was freed
+ * @retval      STACK_ALLOC_ERROR_INVALID_PARAM if sa is NULL_PTR or a downward arena
+ * @retval      STACK_ALLOC_ERROR_INVALID_MARKER if the arena is empty
+ * @retval      STACK_ALLOC_ERROR_CORRUPTED_STATE if the record below the top is not valid
+ * @note        In a chained arena, popping the last block of a chunk unlinks the chunk
+ *              first, like StackAlloc_FreeToMarker() does
+ */
+TStack_alloc_error StackAlloc_Pop(TStack_alloc* sa);
+
+/**
+ * @brief       Gets the size of the record StackAlloc_Push() stores for a block
+ * @param[in]   size       Size of the block in bytes
+ * @param[in]   alignment  Alignment of the block in bytes
+ * @return      Largest number of record bytes the block can need
+ */
+TStack_alloc_size StackAlloc_GetPushOverhead(TStack_alloc_size size, TStack_alloc_size alignment);
+
+#endif /* STACK_ALLOC_HEADER_H */
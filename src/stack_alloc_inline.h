@@ -0,0 +1,85 @@
+/**
+ * @file        stack_alloc_inline.h
+ * @brief       Header-inlined fast path for the stack allocator
+ * @details     Include this header instead of (or in addition to) stack_alloc.h to
+ *              compile the allocation fast path directly into the caller. The inline
+ *              path performs a mask-based bump of the current pointer and only calls
+ *              the out-of-line StackAlloc_AllocSlow() when the bump does not fit.
+ *
+ * @note        Like the rest of the allocator, the fast path is not thread-safe.
+ */
+
+#ifndef STACK_ALLOC_INLINE_H
+#define STACK_ALLOC_INLINE_H
+
+#include "stack_alloc.h"
+#include "stack_alloc_cfg.h"
+
+/**
+ * @brief   Branch prediction hints
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define STACK_ALLOC_LIKELY(cond)      __builtin_expect(!!(cond), 1)
+#define STACK_ALLOC_UNLIKELY(cond)    __builtin_expect(!!(cond), 0)
+#else
+#define STACK_ALLOC_LIKELY(cond)      (cond)
+#define STACK_ALLOC_UNLIKELY(cond)    (cond)
+#endif
+
+/**
+ * @brief       Aligns an address up to a power-of-two boundary
+ * @param[in]   address   The address to be aligned
+ * @param[in]   alignment The alignment boundary (must be a power of 2)
+ * @return      The aligned address
+ */
+static inline TStack_alloc_addr StackAlloc_AlignUp(TStack_alloc_addr address, TStack_alloc_addr alignment)
+{
+    return (address + (alignment - 1U)) & ~(alignment - 1U);
+}
+
+/**
+ * @brief       Checks whether a value is a non-zero power of two
+ * @param[in]   value  Value to check
+ * @return      TRUE if value is a power of two, FALSE otherwise
+ */
+static inline boolean StackAlloc_IsPowerOfTwo(TStack_alloc_size value)
+{
+    return ((value != 0U) && ((value & (value - 1U)) == 0U)) ? TRUE : FALSE;
+}
+
+/**
+ * @brief       Inline fast path of StackAlloc_AllocAligned()
+ * @param[in]   sa         Pointer to the stack allocator instance (must not be NULL_PTR)
+ * @param[in]   size       Number of bytes to allocate
+ * @param[in]   alignment  Required alignment in bytes (must be a power of 2, not checked)
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ */
+static inline void* StackAlloc_AllocAlignedInline(TStack_alloc* sa, TStack_alloc_size size,
+                                                  TStack_alloc_size alignment)
+{
+    TStack_alloc_addr aligned = StackAlloc_AlignUp((TStack_alloc_addr)sa->current, alignment);
+    TStack_alloc_addr new_top = aligned + size;
+
+    if (STACK_ALLOC_LIKELY((new_top > aligned) && (new_top <= (TStack_alloc_addr)sa->buffer_end)))
+    {
+        sa->current = (uint8*)new_top;
+        return (void*)aligned;
+    }
+
+    return StackAlloc_AllocSlow(sa, size, alignment);
+}
+
+/**
+ * @brief       Inline fast path of StackAlloc_Alloc()
+ * @param[in]   sa    Pointer to the stack allocator instance (must not be NULL_PTR)
+ * @param[in]   size  Number of bytes to allocate
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ * @note        Zero-size, wrapping and out-of-memory requests all fail the single
+ *              range check and are handed to StackAlloc_AllocSlow()
+ */
+static inline void* StackAlloc_AllocInline(TStack_alloc* sa, TStack_alloc_size size)
+{
+    return StackAlloc_AllocAlignedInline(sa, size, STACK_ALLOC_ALIGNMENT);
+}
+
+#endif /* STACK_ALLOC_INLINE_H */
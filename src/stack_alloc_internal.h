@@ -0,0 +1,142 @@
+/**
+ * @file        stack_alloc_internal.h
+ * @brief       Internal interfaces shared between the stack allocator modules
+ * @details     Not part of the public API. The core (stack_alloc.c) dispatches to
+ *              these functions depending on the arena mode.
+ */
+
+#ifndef STACK_ALLOC_INTERNAL_H
+#define STACK_ALLOC_INTERNAL_H
+
+#include "stack_alloc_inline.h"
+
+/**
+ * @brief       Gets the aligned start address of a memory region
+ * @param[in]   start  Start of the region
+ * @return      start rounded up to STACK_ALLOC_ALIGNMENT
+ */
+static inline uint8* StackAlloc_AlignedStart(const uint8* start)
+{
+    return (uint8*)StackAlloc_AlignUp((TStack_alloc_addr)start, STACK_ALLOC_ALIGNMENT);
+}
+
+/**
+ * @brief       Folds the current top into the known-zero watermark
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @note        Allocations do not maintain zero_start; everything below the highest
+ *              current ever reached may have been written. Call this before current
+ *              moves down so that the high-water mark is not lost.
+ */
+static inline void StackAlloc_NoteDirty(TStack_alloc* sa)
+{
+    if (sa->current > sa->zero_start)
+    {
+        sa->zero_start = sa->current;
+    }
+}
+
+/* ========================= Chained mode (stack_alloc_chain.c) ========================= */
+
+/**
+ * @brief       Links a new chunk and allocates the request from it
+ * @param[in]   sa         Pointer to a chained stack allocator instance
+ * @param[in]   size       Number of bytes to allocate (non-zero)
+ * @param[in]   alignment  Required alignment in bytes (power of 2)
+ * @return      Pointer to the allocated memory, or NULL_PTR if the provider fails
+ */
+void* StackAlloc_ChainGrow(TStack_alloc* sa, TStack_alloc_size size, TStack_alloc_size alignment);
+
+/**
+ * @brief       Rewinds a chained arena to a marker located below the active chunk
+ * @param[in]   sa    Pointer to a chained stack allocator instance
+ * @param[in]   mark  Marker outside the active region
+ * @return      STACK_ALLOC_OK or STACK_ALLOC_ERROR_INVALID_MARKER
+ */
+TStack_alloc_error StackAlloc_ChainFreeToMarker(TStack_alloc* sa, uint8* mark);
+
+/**
+ * @brief       Unlinks every chunk so that the initial buffer is active again
+ * @param[in]   sa  Pointer to a chained stack allocator instance
+ */
+void StackAlloc_ChainReset(TStack_alloc* sa);
+
+/**
+ * @brief       Releases every chunk, including the cached spare, to the provider
+ * @param[in]   sa  Pointer to a chained stack allocator instance
+ */
+void StackAlloc_ChainDeinit(TStack_alloc* sa);
+
+/* ========================= Virtual mode (stack_alloc_vm.c) ========================= */
+
+/**
+ * @brief       Commits more of the reserved range and allocates the request from it
+ * @param[in]   sa         Pointer to a virtual stack allocator instance
+ * @param[in]   size       Number of bytes to allocate (non-zero)
+ * @param[in]   alignment  Required alignment in bytes (power of 2)
+ * @return      Pointer to the allocated memory, or NULL_PTR if the reservation is exhausted
+ */
+void* StackAlloc_VmGrow(TStack_alloc* sa, TStack_alloc_size size, TStack_alloc_size alignment);
+
+/**
+ * @brief       Applies the page release policy after a virtual arena was rewound
+ * @param[in]   sa  Pointer to a virtual stack allocator with a release policy set
+ * @note        Call after current moved down; zero_start must already hold the
+ *              high-water mark (see StackAlloc_NoteDirty())
+ */
+void StackAlloc_VmReleaseUnused(TStack_alloc* sa);
+
+/**
+ * @brief       Takes the physical pages of a committed range away again
+ * @param[in]   start  Start of the range (page aligned)
+ * @param[in]   size   Size of the range in bytes (page multiple)
+ * @return      TRUE if the range will read as zero once committed again
+ * @note        The range becomes inaccessible until StackAlloc_VmGrow() commits it
+ */
+boolean StackAlloc_VmDecommit(void* start, TStack_alloc_size size);
+
+/**
+ * @brief       Commits the reserved pages of a virtual arena up to a faulting address
+ * @param[in]   sa       Pointer to a virtual stack allocator instance
+ * @param[in]   address  Address that faulted
+ * @return      TRUE if address lies in the uncommitted part of the reservation and is
+ *              now committed, FALSE otherwise
+ * @note        Async-signal-safe: only calls mprotect()
+ */
+boolean StackAlloc_VmCommitFault(TStack_alloc* sa, const uint8* address);
+
+/**
+ * @brief       Releases the reserved range of a virtual arena
+ * @param[in]   sa  Pointer to a virtual stack allocator instance
+ */
+void StackAlloc_VmDeinit(TStack_alloc* sa);
+
+/* ===================== Background scavenger (stack_alloc_scavenge.c) ===================== */
+
+/**
+ * @brief       Records the peak of the ending cycle and hands a trimmed tail to the scavenger
+ * @param[in]   sa  Pointer to a registered virtual arena, before current is rewound
+ * @note        Runs on the owner thread and never makes a system call
+ */
+void StackAlloc_ScavengeOnReset(TStack_alloc* sa);
+
+/**
+ * @brief       Takes back a tail handed to the scavenger before the arena grows into it
+ * @param[in]   sa  Pointer to a registered virtual arena
+ * @note        A tail that was not claimed yet comes back committed (buffer_end moves up);
+ *              the call waits only while the scavenger is decommitting that very tail
+ */
+void StackAlloc_ScavengeReclaim(TStack_alloc* sa);
+
+/* ===================== Measuring arenas (stack_alloc_measure.c) ===================== */
+
+/**
+ * @brief       Bumps the top of a measuring arena and records the allocation
+ * @param[in]   sa         Pointer to a measuring stack allocator instance
+ * @param[in]   size       Number of bytes to allocate (non-zero)
+ * @param[in]   alignment  Required alignment in bytes (power of 2)
+ * @return      Address of the block (never to be dereferenced), or NULL_PTR if it
+ *              would exceed the capacity
+ */
+void* StackAlloc_MeasureAlloc(TStack_alloc* sa, TStack_alloc_size size, TStack_alloc_size alignment);
+
+#endif /* STACK_ALLOC_INTERNAL_H */
@@ -0,0 +1,271 @@
+/**
+ * @file        stack_alloc_lease.c
+ * @brief       Per-thread arenas leasing chunks from a shared arena
+ * @details     Leasing is one compare-and-swap on the shared arena's top pointer.
+ *              The recycled list is only touched when a chunk is returned out of order,
+ *              and is checked without the lock first, so it costs nothing while empty.
+ *              Thread arenas from StackAlloc_LeaseGet() live in TLS; a pthread key whose
+ *              value points at the arena deinitializes it on thread exit, as for the
+ *              thread-local arenas of stack_alloc_tls.c.
+ */
+
+/* ================================ Includes ================================ */
+#include "stack_alloc_lease.h"
+#include "stack_alloc_chain.h"
+#include "stack_alloc_concurrent.h"
+#include "stack_alloc_inline.h"
+#include "stack_alloc_tls.h"
+#include "helper_routines.h"
+
+/* =============================== Variables ================================ */
+static STACK_ALLOC_THREAD_LOCAL TStack_alloc g_lease_arena;
+static STACK_ALLOC_THREAD_LOCAL TStack_alloc_lease_pool* g_lease_arena_pool = NULL_PTR;
+
+static pthread_once_t g_lease_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t  g_lease_key;
+
+/**
+ * @brief   Header written over a chunk while it waits in the recycled list
+ */
+typedef struct TStack_alloc_lease_node {
+    struct TStack_alloc_lease_node* next;
+    TStack_alloc_size size;
+} TStack_alloc_lease_node;
+
+/**
+ * @brief       Takes a recycled chunk of exactly the requested size
+ * @param[in]   pool  Pointer to the pool
+ * @param[in]   size  Chunk size in bytes
+ * @return      Chunk, or NULL_PTR if none matches
+ * @note        Only exact matches are reused: the chain records the requested size,
+ *              so the tail of a larger chunk would be lost
+ */
+static void* TakeRecycled(TStack_alloc_lease_pool* pool, TStack_alloc_size size)
+{
+    TStack_alloc_lease_node* found = NULL_PTR;
+
+    (void)pthread_mutex_lock(&pool->lock);
+    for (TStack_alloc_lease_node** link = (TStack_alloc_lease_node**)&pool->recycled;
+         *link != NULL_PTR; link = &(*link)->next)
+    {
+        if ((*link)->size == size)
+        {
+            found = *link;
+            __atomic_store_n(link, found->next, __ATOMIC_RELAXED);
+            pool->recycled_count--;
+            break;
+        }
+    }
+    (void)pthread_mutex_unlock(&pool->lock);
+
+    return found;
+}
+
+static void* LeaseAcquire(void* ctx, TStack_alloc_size size)
+{
+    TStack_alloc_lease_pool* pool = (TStack_alloc_lease_pool*)ctx;
+
+    if (STACK_ALLOC_UNLIKELY(__atomic_load_n(&pool->recycled, __ATOMIC_RELAXED) != NULL_PTR))
+    {
+        void* chunk = TakeRecycled(pool, size);
+        if (chunk != NULL_PTR)
+        {
+            return chunk;
+        }
+    }
+
+    return StackAlloc_AllocAlignedConcurrent(pool->arena, size, STACK_ALLOC_CACHE_LINE_SIZE);
+}
+
+static void LeaseRelease(void* ctx, void* block, TStack_alloc_size size)
+{
+    TStack_alloc_lease_pool* pool = (TStack_alloc_lease_pool*)ctx;
+    uint8* top = (uint8*)block + size;
+
+    /* Still the topmost block of the shared arena: give the space back */
+    if (__atomic_compare_exchange_n(&pool->arena->current, &top, (uint8*)block, FALSE,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+        return;
+    }
+
+    /* Otherwise keep it for the next lease of the same size */
+    TStack_alloc_lease_node* node = (TStack_alloc_lease_node*)block;
+    node->size = size;
+
+    (void)pthread_mutex_lock(&pool->lock);
+    node->next = (TStack_alloc_lease_node*)pool->recycled;
+    __atomic_store_n(&pool->recycled, (void*)node, __ATOMIC_RELAXED);
+    pool->recycled_count++;
+    (void)pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * @brief       Initializes a lease pool over a shared arena
+ * @param[in]   pool        Pointer to the pool to initialize
+ * @param[in]   arena       Shared arena (fixed, or with its leasable range committed)
+ * @param[in]   lease_size  Chunk size in bytes, 0 for STACK_ALLOC_LEASE_SIZE
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_LeasePoolInit(TStack_alloc_lease_pool* pool, TStack_alloc* arena,
+                                            TStack_alloc_size lease_size)
+{
+    if ((pool == NULL_PTR) || (arena == NULL_PTR) || (arena->buffer_start == NULL_PTR))
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    pool->arena          = arena;
+    pool->lease_size     = (lease_size != 0U) ? lease_size : STACK_ALLOC_LEASE_SIZE;
+    pool->recycled       = NULL_PTR;
+    pool->recycled_count = 0U;
+
+    if (pthread_mutex_init(&pool->lock, NULL_PTR) != 0)
+    {
+        return STACK_ALLOC_ERROR_OUT_OF_MEMORY;
+    }
+
+    return STACK_ALLOC_OK;
+}
+
+/**
+ * @brief       Forgets every recycled chunk and resets the shared arena
+ * @param[in]   pool  Pointer to the pool
+ */
+void StackAlloc_LeasePoolReset(TStack_alloc_lease_pool* pool)
+{
+    if (pool != NULL_PTR)
+    {
+        pool->recycled       = NULL_PTR;
+        pool->recycled_count = 0U;
+        StackAlloc_Reset(pool->arena);
+    }
+}
+
+/**
+ * @brief       Releases the resources of a lease pool (not the shared arena)
+ * @param[in]   pool  Pointer to the pool
+ */
+void StackAlloc_LeasePoolDeinit(TStack_alloc_lease_pool* pool)
+{
+    if (pool != NULL_PTR)
+    {
+        pool->recycled       = NULL_PTR;
+        pool->recycled_count = 0U;
+        (void)pthread_mutex_destroy(&pool->lock);
+    }
+}
+
+/**
+ * @brief       Gets the number of chunks waiting in the pool for reuse
+ * @param[in]   pool  Pointer to the pool
+ * @return      Number of recycled chunks, or 0 if pool is NULL_PTR
+ */
+uint32 StackAlloc_LeasePoolGetRecycled(TStack_alloc_lease_pool* pool)
+{
+    uint32 count = 0U;
+
+    if (pool != NULL_PTR)
+    {
+        (void)pthread_mutex_lock(&pool->lock);
+        count = pool->recycled_count;
+        (void)pthread_mutex_unlock(&pool->lock);
+    }
+
+    return count;
+}
+
+/**
+ * @brief       Gets a chunk provider that leases from a pool
+ * @param[in]   pool  Pointer to the pool (must outlive every arena using the provider)
+ * @return      Provider instance
+ */
+TStack_alloc_provider StackAlloc_LeaseProvider(TStack_alloc_lease_pool* pool)
+{
+    TStack_alloc_provider provider = { LeaseAcquire, LeaseRelease, pool };
+    return provider;
+}
+
+/**
+ * @brief       Initializes a thread's arena leasing its chunks from a pool
+ * @param[in]   sa    Pointer to the stack allocator instance to initialize
+ * @param[in]   pool  Pointer to the pool
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_InitLeased(TStack_alloc* sa, TStack_alloc_lease_pool* pool)
+{
+    if (pool == NULL_PTR)
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    TStack_alloc_provider provider = StackAlloc_LeaseProvider(pool);
+
+    return StackAlloc_InitChained(sa, NULL_PTR, 0U, &provider, pool->lease_size);
+}
+
+/**
+ * @brief       Returns the chunks of a thread's leased arena and marks it as not created
+ * @param[in]   sa  Leased arena of the thread
+ */
+static void ReleaseLeased(TStack_alloc* sa)
+{
+    StackAlloc_Deinit(sa);
+    (void)mem_set(sa, 0, sizeof(*sa));
+    g_lease_arena_pool = NULL_PTR;
+}
+
+/**
+ * @brief       pthread key destructor, runs when a thread with a leased arena exits
+ * @param[in]   arena  Leased arena of the exiting thread
+ */
+static void LeaseThreadExit(void* arena)
+{
+    ReleaseLeased((TStack_alloc*)arena);
+}
+
+static void CreateLeaseKey(void)
+{
+    (void)pthread_key_create(&g_lease_key, LeaseThreadExit);
+}
+
+/**
+ * @brief       Gets the calling thread's leased arena, creating it if needed
+ * @param[in]   pool  Pointer to the pool
+ * @return      Pointer to the thread's arena, or NULL_PTR on failure
+ */
+TStack_alloc* StackAlloc_LeaseGet(TStack_alloc_lease_pool* pool)
+{
+    if ((pool == NULL_PTR) || ((g_lease_arena_pool != NULL_PTR) && (g_lease_arena_pool != pool)))
+    {
+        return NULL_PTR;
+    }
+
+    if (g_lease_arena_pool == NULL_PTR)
+    {
+        (void)pthread_once(&g_lease_key_once, CreateLeaseKey);
+
+        if (StackAlloc_InitLeased(&g_lease_arena, pool) != STACK_ALLOC_OK)
+        {
+            return NULL_PTR;
+        }
+
+        /* A non-NULL key value makes the destructor run at thread exit */
+        (void)pthread_setspecific(g_lease_key, &g_lease_arena);
+        g_lease_arena_pool = pool;
+    }
+
+    return &g_lease_arena;
+}
+
+/**
+ * @brief       Returns the chunks of the calling thread's leased arena before the thread exits
+ */
+void StackAlloc_LeaseRelease(void)
+{
+    if (g_lease_arena_pool != NULL_PTR)
+    {
+        (void)pthread_setspecific(g_lease_key, NULL_PTR);
+        ReleaseLeased(&g_lease_arena);
+    }
+}
@@ -0,0 +1,102 @@
+/**
+ * @file        stack_alloc_lease.h
+ * @brief       Per-thread arenas leasing chunks from a shared arena
+ * @details     A lease pool wraps a shared (global) arena. Each thread owns a chained
+ *              arena whose provider takes whole chunks out of the shared arena with a
+ *              single compare-and-swap, so the per-allocation fast path is the ordinary
+ *              unsynchronised bump inside the thread's current chunk.
+ *
+ *              Chunks a thread rewinds past (or releases at StackAlloc_Deinit()) are given
+ *              back to the shared arena when they are still its topmost block, and are
+ *              otherwise kept in the pool and handed to the next lease of the same size.
+ *              StackAlloc_LeaseGet() gives each thread a leased arena of its own that is
+ *              deinitialized automatically when the thread exits, so a thread that never
+ *              calls StackAlloc_Deinit() does not take its chunks with it.
+ *
+ * @note        The pool may be used from any number of threads. A leased arena must only
+ *              be used by the thread that owns it.
+ */
+
+#ifndef STACK_ALLOC_LEASE_H
+#define STACK_ALLOC_LEASE_H
+
+#include "stack_alloc.h"
+#include <pthread.h>
+
+/**
+ * @brief   Shared arena plus the chunks returned to it out of order
+ */
+typedef struct {
+    TStack_alloc* arena;            /**< Shared arena the chunks are leased from */
+    TStack_alloc_size lease_size;   /**< Chunk size of the leased arenas */
+    void* recycled;                 /**< Returned chunks that could not be given back */
+    uint32 recycled_count;          /**< Number of chunks in the recycled list */
+    pthread_mutex_t lock;           /**< Protects the recycled list */
+} TStack_alloc_lease_pool;
+
+/**
+ * @brief       Initializes a lease pool over a shared arena
+ * @param[in]   pool        Pointer to the pool to initialize
+ * @param[in]   arena       Shared arena (fixed, or with its leasable range committed)
+ * @param[in]   lease_size  Chunk size in bytes, 0 for STACK_ALLOC_LEASE_SIZE
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ * @note        The shared arena must only be allocated from through the pool
+ *              (or with StackAlloc_AllocConcurrent()) while the pool is in use
+ */
+TStack_alloc_error StackAlloc_LeasePoolInit(TStack_alloc_lease_pool* pool, TStack_alloc* arena,
+                                            TStack_alloc_size lease_size);
+
+/**
+ * @brief       Forgets every recycled chunk and resets the shared arena
+ * @param[in]   pool  Pointer to the pool
+ * @note        All leased arenas must have been deinitialized or abandoned
+ */
+void StackAlloc_LeasePoolReset(TStack_alloc_lease_pool* pool);
+
+/**
+ * @brief       Releases the resources of a lease pool (not the shared arena)
+ * @param[in]   pool  Pointer to the pool
+ */
+void StackAlloc_LeasePoolDeinit(TStack_alloc_lease_pool* pool);
+
+/**
+ * @brief       Gets the number of chunks waiting in the pool for reuse
+ * @param[in]   pool  Pointer to the pool
+ * @return      Number of recycled chunks, or 0 if pool is NULL_PTR
+ */
+uint32 StackAlloc_LeasePoolGetRecycled(TStack_alloc_lease_pool* pool);
+
+/**
+ * @brief       Gets a chunk provider that leases from a pool
+ * @param[in]   pool  Pointer to the pool (must outlive every arena using the provider)
+ * @return      Provider instance
+ */
+TStack_alloc_provider StackAlloc_LeaseProvider(TStack_alloc_lease_pool* pool);
+
+/**
+ * @brief       Initializes a thread's arena leasing its chunks from a pool
+ * @param[in]   sa    Pointer to the stack allocator instance to initialize
+ * @param[in]   pool  Pointer to the pool
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ * @note        Call StackAlloc_Deinit() before the thread exits to return the chunks, or
+ *              use StackAlloc_LeaseGet(), which does so at thread exit
+ */
+TStack_alloc_error StackAlloc_InitLeased(TStack_alloc* sa, TStack_alloc_lease_pool* pool);
+
+/**
+ * @brief       Gets the calling thread's leased arena, creating it if needed
+ * @param[in]   pool  Pointer to the pool (must outlive every thread that uses it)
+ * @return      Pointer to the thread's arena, or NULL_PTR if pool is NULL_PTR or the
+ *              thread already has an arena from another pool
+ * @note        Its chunks go back to the pool when the thread exits, or earlier with
+ *              StackAlloc_LeaseRelease()
+ */
+TStack_alloc* StackAlloc_LeaseGet(TStack_alloc_lease_pool* pool);
+
+/**
+ * @brief       Returns the chunks of the calling thread's leased arena before the thread exits
+ * @note        The next StackAlloc_LeaseGet() creates a fresh arena, from any pool
+ */
+void StackAlloc_LeaseRelease(void);
+
+#endif /* STACK_ALLOC_LEASE_H */
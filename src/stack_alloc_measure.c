@@ -0,0 +1,129 @@
+/**
+ * @file        stack_alloc_measure.c
+ * @brief       Measuring (dry-run) stack allocator implementation
+ * @details     A measuring arena keeps buffer_end equal to buffer_start, like a downward
+ *              arena, so that every allocation fails the inline range check and reaches
+ *              StackAlloc_AllocSlow(), which bumps and records it here. The range starts at
+ *              a made-up address with only its second-highest bit set: aligned to any
+ *              realistic alignment, and with room above it for any TStack_alloc_size.
+ */
+
+/* ================================ Includes ================================ */
+#include "stack_alloc_measure.h"
+#include "stack_alloc_internal.h"
+#include "stack_alloc_inline.h"
+#include "helper_routines.h"
+
+/* ================================ Defines ================================= */
+#define MEASURE_ORIGIN  ((TStack_alloc_addr)1U << ((sizeof(TStack_alloc_addr) * 8U) - 2U))
+
+/**
+ * @brief       Adds without wrapping around
+ * @param[in]   a  First summand
+ * @param[in]   b  Second summand
+ * @return      a + b, or STACK_ALLOC_SIZE_MAX if that does not fit
+ */
+static inline TStack_alloc_size AddSaturated(TStack_alloc_size a, TStack_alloc_size b)
+{
+    return (b > (STACK_ALLOC_SIZE_MAX - a)) ? STACK_ALLOC_SIZE_MAX : (a + b);
+}
+
+void* StackAlloc_MeasureAlloc(TStack_alloc* sa, TStack_alloc_size size, TStack_alloc_size alignment)
+{
+    TStack_alloc_addr top     = (TStack_alloc_addr)sa->current;
+    TStack_alloc_addr aligned = StackAlloc_AlignUp(top, alignment);
+    TStack_alloc_addr new_top = aligned + size;
+    TStack_alloc_addr limit   = (TStack_alloc_addr)sa->buffer_start + sa->capacity;
+
+    if ((aligned < top) || (new_top <= aligned) || (new_top > limit))
+    {
+        return NULL_PTR;
+    }
+
+    TStack_alloc_measure* stats = &sa->measure;
+    TStack_alloc_size used = (TStack_alloc_size)(new_top - (TStack_alloc_addr)sa->buffer_start);
+
+    stats->requested = AddSaturated(stats->requested, size);
+    stats->padding   = AddSaturated(stats->padding, (TStack_alloc_size)(aligned - top));
+    if (stats->allocations != 0xFFFFFFFFU)
+    {
+        stats->allocations++;
+    }
+    if (alignment > stats->max_alignment)
+    {
+        stats->max_alignment = alignment;
+    }
+    if (used > stats->peak)
+    {
+        stats->peak = used;
+    }
+
+    sa->current = (uint8*)new_top;
+    return (void*)aligned;
+}
+
+/**
+ * @brief       Initializes a stack allocator that only measures
+ * @param[in]   sa  Pointer to the stack allocator instance to initialize
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_InitMeasure(TStack_alloc* sa)
+{
+    if (sa == NULL_PTR)
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    (void)mem_set(sa, 0, sizeof(*sa));
+
+    /* The range ends below the highest bit, so no address computation wraps */
+    sa->mode         = STACK_ALLOC_MODE_MEASURE;
+    sa->buffer_start = (uint8*)MEASURE_ORIGIN;
+    sa->buffer_end   = sa->buffer_start;
+    sa->current      = sa->buffer_start;
+    sa->zero_start   = sa->buffer_start;
+    sa->capacity     = ((MEASURE_ORIGIN - 1U) < STACK_ALLOC_SIZE_MAX) ? (TStack_alloc_size)(MEASURE_ORIGIN - 1U)
+                                                                      : STACK_ALLOC_SIZE_MAX;
+
+    return STACK_ALLOC_OK;
+}
+
+/**
+ * @brief       Gets what a measuring arena has seen since it was initialized
+ * @param[in]   sa     Pointer to a measuring stack allocator instance
+ * @param[out]  stats  Receives the statistics
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_GetMeasure(const TStack_alloc* sa, TStack_alloc_measure* stats)
+{
+    if ((sa == NULL_PTR) || (stats == NULL_PTR) || (sa->mode != STACK_ALLOC_MODE_MEASURE))
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    *stats = sa->measure;
+    return STACK_ALLOC_OK;
+}
+
+/**
+ * @brief       Gets the buffer size that replays the measured run without failing
+ * @param[in]   sa  Pointer to a measuring stack allocator instance
+ * @return      Buffer size in bytes, or 0 if sa is NULL_PTR or not measuring
+ */
+TStack_alloc_size StackAlloc_GetMeasuredSize(const TStack_alloc* sa)
+{
+    if ((sa == NULL_PTR) || (sa->mode != STACK_ALLOC_MODE_MEASURE))
+    {
+        return 0U;
+    }
+
+    /* A real top runs at most this far ahead of the measured one: bumping is monotonic in
+       the start address, and the start is at most this far below the next address aligned
+       like the made-up range */
+    TStack_alloc_size slack = (sa->measure.max_alignment > STACK_ALLOC_ALIGNMENT)
+                              ? (sa->measure.max_alignment - STACK_ALLOC_ALIGNMENT) : 0U;
+    TStack_alloc_size size = AddSaturated(sa->measure.peak, slack);
+
+    /* StackAlloc_Init() rejects smaller buffers */
+    return (size > STACK_ALLOC_ALIGNMENT) ? size : STACK_ALLOC_ALIGNMENT;
+}
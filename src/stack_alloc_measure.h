@@ -0,0 +1,58 @@
+/**
+ * @file        stack_alloc_measure.h
+ * @brief       Measuring (dry-run) stack allocator API
+ * @details     A measuring arena has no memory. Every allocation runs the same alignment
+ *              arithmetic as a real arena on a range of made-up addresses and is recorded;
+ *              markers, StackAlloc_Reset() and the query functions work as usual. Run a code
+ *              path once against a measuring arena, then size the real buffer with
+ *              StackAlloc_GetMeasuredSize().
+ *
+ *              The blocks handed out must never be read or written. Functions that need
+ *              the contents (StackAlloc_Push/Pop(), open blocks, chunks for a child arena)
+ *              fail on a measuring arena, and StackAlloc_Calloc()/Realloc() skip their
+ *              zeroing and copying.
+ *
+ * @note        This implementation is not thread-safe.
+ */
+
+#ifndef STACK_ALLOC_MEASURE_H
+#define STACK_ALLOC_MEASURE_H
+
+#include "stack_alloc.h"
+
+/**
+ * @brief       Initializes a stack allocator that only measures
+ * @param[in]   sa  Pointer to the stack allocator instance to initialize
+ * @return      Error code indicating success or failure
+ * @retval      STACK_ALLOC_OK if initialization was successful
+ * @retval      STACK_ALLOC_ERROR_INVALID_PARAM if sa is NULL_PTR
+ * @note        The made-up range starts at an address aligned far beyond any practical
+ *              alignment, so the measured padding is that of a buffer aligned to the
+ *              largest alignment requested
+ */
+TStack_alloc_error StackAlloc_InitMeasure(TStack_alloc* sa);
+
+/**
+ * @brief       Gets what a measuring arena has seen since it was initialized
+ * @param[in]   sa     Pointer to a measuring stack allocator instance
+ * @param[out]  stats  Receives the statistics
+ * @return      Error code indicating success or failure
+ * @retval      STACK_ALLOC_OK if stats was filled
+ * @retval      STACK_ALLOC_ERROR_INVALID_PARAM if a pointer is NULL_PTR or sa is not measuring
+ * @note        The statistics survive StackAlloc_Reset(), so several cycles of a code path
+ *              can be measured together
+ */
+TStack_alloc_error StackAlloc_GetMeasure(const TStack_alloc* sa, TStack_alloc_measure* stats);
+
+/**
+ * @brief       Gets the buffer size that replays the measured run without failing
+ * @param[in]   sa  Pointer to a measuring stack allocator instance
+ * @return      Size to pass to StackAlloc_Init() with a buffer aligned to
+ *              STACK_ALLOC_ALIGNMENT, or 0 if sa is NULL_PTR or not measuring
+ * @note        This is the measured peak plus the padding a buffer aligned only to
+ *              STACK_ALLOC_ALIGNMENT may need for larger alignments. For a buffer aligned
+ *              to the largest alignment requested, the peak alone is enough
+ */
+TStack_alloc_size StackAlloc_GetMeasuredSize(const TStack_alloc* sa);
+
+#endif /* STACK_ALLOC_MEASURE_H */
@@ -0,0 +1,226 @@
+/**
+ * @file        stack_alloc_numa.c
+ * @brief       NUMA placement of virtual-memory stack allocators
+ * @details     Uses the raw mbind/move_pages/getcpu system calls so that no libnuma
+ *              is needed at build or run time. Kernels without NUMA support report
+ *              ENOSYS, which is treated as a single node 0.
+ */
+
+/* ================================ Includes ================================ */
+#include "stack_alloc_numa.h"
+#include "stack_alloc_internal.h"
+#include "helper_routines.h"
+
+#if defined(__linux__)
+#include <errno.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#define NUMA_MPOL_BIND          (2)             /**< MPOL_BIND from <numaif.h> */
+#define NUMA_MPOL_MF_MOVE       (1U << 1)       /**< MPOL_MF_MOVE from <numaif.h> */
+#define NUMA_MASK_WORDS         (16U)           /**< Node mask size: 1024 nodes */
+#define NUMA_QUERY_BATCH        (512U)          /**< Pages inspected per move_pages call */
+#endif
+
+/**
+ * @brief       Gets the number of NUMA nodes of the machine
+ * @return      Number of possible nodes (1 if NUMA is not supported)
+ */
+uint32 StackAlloc_GetNodeCount(void)
+{
+    uint32 count = 1U;
+
+#if defined(__linux__)
+    /* "possible" holds a range list such as "0" or "0-3"; the last number is the highest node */
+    FILE* file = fopen("/sys/devices/system/node/possible", "r");
+    if (file != NULL_PTR)
+    {
+        char text[128] = { 0 };
+        if (fgets(text, (int)sizeof(text), file) != NULL_PTR)
+        {
+            uint32 value = 0U;
+            for (const char* c = text; *c != '\0'; c++)
+            {
+                if ((*c >= '0') && (*c <= '9'))
+                {
+                    value = (value * 10U) + (uint32)(*c - '0');
+                }
+                else if ((*c == '-') || (*c == ','))
+                {
+                    value = 0U;
+                }
+                else
+                {
+                    break;
+                }
+            }
+            count = value + 1U;
+        }
+        (void)fclose(file);
+    }
+#endif
+
+    return count;
+}
+
+/**
+ * @brief       Gets the NUMA node of the CPU the calling thread runs on
+ * @return      Node index (0 if NUMA is not supported)
+ */
+uint32 StackAlloc_GetCurrentNode(void)
+{
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned int cpu = 0U;
+    unsigned int node = 0U;
+
+    if (syscall(SYS_getcpu, &cpu, &node, NULL_PTR) == 0)
+    {
+        return (uint32)node;
+    }
+#endif
+
+    return 0U;
+}
+
+/**
+ * @brief       Binds the whole range of a virtual arena to a NUMA node
+ * @param[in]   sa    Pointer to a virtual stack allocator instance
+ * @param[in]   node  Node index, or STACK_ALLOC_NUMA_LOCAL_NODE for the caller's node
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_BindToNode(TStack_alloc* sa, sint32 node)
+{
+    /* Only ranges the allocator mapped itself can be bound */
+    if ((sa == NULL_PTR) || (sa->mode != STACK_ALLOC_MODE_VIRTUAL) || (sa->buffer_start == NULL_PTR))
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    uint32 target = (node == STACK_ALLOC_NUMA_LOCAL_NODE) ? StackAlloc_GetCurrentNode() : (uint32)node;
+    if ((node < STACK_ALLOC_NUMA_LOCAL_NODE) || (target >= StackAlloc_GetNodeCount()))
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+#if defined(__linux__) && defined(SYS_mbind)
+    unsigned long mask[NUMA_MASK_WORDS];
+    const uint32 word_bits = (uint32)(sizeof(unsigned long) * 8U);
+
+    if (target >= (NUMA_MASK_WORDS * word_bits))
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+    (void)mem_set(mask, 0, sizeof(mask));
+    mask[target / word_bits] = 1UL << (target % word_bits);
+
+    /* Applies to pages committed later and migrates the resident ones */
+    long rc = syscall(SYS_mbind, sa->buffer_start, (unsigned long)(sa->reserve_end - sa->buffer_start),
+                      NUMA_MPOL_BIND, mask, (unsigned long)(NUMA_MASK_WORDS * word_bits) + 1UL,
+                      NUMA_MPOL_MF_MOVE);
+    if (rc != 0)
+    {
+        switch (errno)
+        {
+            case ENOSYS:    /* Kernel without NUMA: everything is on node 0 anyway */
+                return STACK_ALLOC_OK;
+            case ENOMEM:
+                return STACK_ALLOC_ERROR_OUT_OF_MEMORY;
+            default:
+                return STACK_ALLOC_ERROR_INVALID_PARAM;
+        }
+    }
+#endif
+
+    return STACK_ALLOC_OK;
+}
+
+/**
+ * @brief       Initializes a virtual-memory stack allocator bound to a NUMA node
+ * @param[in]   sa            Pointer to the stack allocator instance to initialize
+ * @param[in]   reserve_size  Size of the address range to reserve in bytes
+ * @param[in]   commit_step   Commit granularity in bytes, 0 for STACK_ALLOC_COMMIT_STEP
+ * @param[in]   flags         Combination of STACK_ALLOC_VM_* flags
+ * @param[in]   node          Node index, or STACK_ALLOC_NUMA_LOCAL_NODE for the caller's node
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_InitVirtualOnNode(TStack_alloc* sa, TStack_alloc_size reserve_size,
+                                                TStack_alloc_size commit_step, TStack_alloc_vm_flags flags,
+                                                sint32 node)
+{
+    TStack_alloc_error err = StackAlloc_InitVirtualEx(sa, reserve_size, commit_step, flags);
+    if (err != STACK_ALLOC_OK)
+    {
+        return err;
+    }
+
+    err = StackAlloc_BindToNode(sa, node);
+    if (err != STACK_ALLOC_OK)
+    {
+        StackAlloc_Deinit(sa);
+    }
+
+    return err;
+}
+
+/**
+ * @brief       Counts the resident pages of an arena per NUMA node
+ * @param[in]   sa              Pointer to the stack allocator instance
+ * @param[out]  pages_per_node  Array receiving the page count of each node (zeroed first)
+ * @param[in]   max_nodes       Number of entries in pages_per_node
+ * @return      Total number of resident pages found, or 0 on invalid parameters
+ */
+TStack_alloc_size StackAlloc_QueryNodes(const TStack_alloc* sa, TStack_alloc_size* pages_per_node, uint32 max_nodes)
+{
+    if ((sa == NULL_PTR) || (pages_per_node == NULL_PTR) || (max_nodes == 0U) || (sa->buffer_start == NULL_PTR))
+    {
+        return 0U;
+    }
+
+    (void)mem_set(pages_per_node, 0, (size_t)max_nodes * sizeof(TStack_alloc_size));
+
+    TStack_alloc_size page = StackAlloc_GetPageSize();
+    TStack_alloc_addr first = (TStack_alloc_addr)sa->buffer_start & ~(TStack_alloc_addr)(page - 1U);
+    TStack_alloc_size page_count = (TStack_alloc_size)(((TStack_alloc_addr)sa->buffer_end - first + (page - 1U)) / page);
+    TStack_alloc_size total = 0U;
+
+#if defined(__linux__) && defined(SYS_move_pages)
+    void* pages[NUMA_QUERY_BATCH];
+    int status[NUMA_QUERY_BATCH];
+
+    for (TStack_alloc_size done = 0U; done < page_count; )
+    {
+        uint32 batch = ((page_count - done) < NUMA_QUERY_BATCH) ? (uint32)(page_count - done) : NUMA_QUERY_BATCH;
+
+        for (uint32 i = 0U; i < batch; i++)
+        {
+            pages[i] = (void*)(first + ((done + i) * page));
+        }
+
+        /* With a NULL node list move_pages only reports where each page lives */
+        if (syscall(SYS_move_pages, 0, (unsigned long)batch, pages, NULL_PTR, status, 0) != 0)
+        {
+            /* No NUMA support: count every committed page on node 0 */
+            pages_per_node[0] = page_count;
+            return page_count;
+        }
+
+        for (uint32 i = 0U; i < batch; i++)
+        {
+            /* Negative status: page not resident (never touched) */
+            if ((status[i] >= 0) && ((uint32)status[i] < max_nodes))
+            {
+                pages_per_node[status[i]]++;
+                total++;
+            }
+        }
+
+        done += batch;
+    }
+#else
+    pages_per_node[0] = page_count;
+    total = page_count;
+#endif
+
+    return total;
+}
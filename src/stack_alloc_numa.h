@@ -0,0 +1,72 @@
+/**
+ * @file        stack_alloc_numa.h
+ * @brief       NUMA placement of virtual-memory stack allocators
+ * @details     Binds the reserved range of a virtual arena to a NUMA node so that every
+ *              page it commits is allocated there, and reports where the resident pages
+ *              actually are. On machines or kernels without NUMA support every call
+ *              degrades to a single node 0.
+ *
+ * @note        This implementation is not thread-safe.
+ */
+
+#ifndef STACK_ALLOC_NUMA_H
+#define STACK_ALLOC_NUMA_H
+
+#include "stack_alloc_vm.h"
+
+/**
+ * @brief   Node argument selecting the node of the calling thread
+ */
+#define STACK_ALLOC_NUMA_LOCAL_NODE     (-1)
+
+/**
+ * @brief       Gets the number of NUMA nodes of the machine
+ * @return      Number of possible nodes (1 if NUMA is not supported)
+ */
+uint32 StackAlloc_GetNodeCount(void);
+
+/**
+ * @brief       Gets the NUMA node of the CPU the calling thread runs on
+ * @return      Node index (0 if NUMA is not supported)
+ */
+uint32 StackAlloc_GetCurrentNode(void);
+
+/**
+ * @brief       Binds the whole range of a virtual arena to a NUMA node
+ * @param[in]   sa    Pointer to a virtual stack allocator instance
+ * @param[in]   node  Node index, or STACK_ALLOC_NUMA_LOCAL_NODE for the caller's node
+ * @return      Error code indicating success or failure
+ * @retval      STACK_ALLOC_OK if the binding was applied (or NUMA is not supported)
+ * @retval      STACK_ALLOC_ERROR_INVALID_PARAM if sa is not a virtual arena or node is out of range
+ * @note        Pages committed later are allocated on the node; pages that are already
+ *              resident are migrated to it
+ */
+TStack_alloc_error StackAlloc_BindToNode(TStack_alloc* sa, sint32 node);
+
+/**
+ * @brief       Initializes a virtual-memory stack allocator bound to a NUMA node
+ * @param[in]   sa            Pointer to the stack allocator instance to initialize
+ * @param[in]   reserve_size  Size of the address range to reserve in bytes
+ * @param[in]   commit_step   Commit granularity in bytes, 0 for STACK_ALLOC_COMMIT_STEP
+ * @param[in]   flags         Combination of STACK_ALLOC_VM_* flags
+ * @param[in]   node          Node index, or STACK_ALLOC_NUMA_LOCAL_NODE for the caller's node
+ * @return      Error code indicating success or failure
+ * @note        Equivalent to StackAlloc_InitVirtualEx() followed by StackAlloc_BindToNode();
+ *              the range is released again if binding fails
+ */
+TStack_alloc_error StackAlloc_InitVirtualOnNode(TStack_alloc* sa, TStack_alloc_size reserve_size,
+                                                TStack_alloc_size commit_step, TStack_alloc_vm_flags flags,
+                                                sint32 node);
+
+/**
+ * @brief       Counts the resident pages of an arena per NUMA node
+ * @param[in]   sa              Pointer to the stack allocator instance
+ * @param[out]  pages_per_node  Array receiving the page count of each node (zeroed first)
+ * @param[in]   max_nodes       Number of entries in pages_per_node
+ * @return      Total number of resident pages found, or 0 on invalid parameters
+ * @note        Inspects the pages of the active region (the committed part of a virtual
+ *              arena); pages that were never touched are not resident and not counted
+ */
+TStack_alloc_size StackAlloc_QueryNodes(const TStack_alloc* sa, TStack_alloc_size* pages_per_node, uint32 max_nodes);
+
+#endif /* STACK_ALLOC_NUMA_H */
@@ -0,0 +1,314 @@
+/**
+ * @file        stack_alloc_percpu.c
+ * @brief       Per-CPU stack allocators
+ * @details     The rseq fast path follows the kernel's restartable-sequence ABI: a
+ *              descriptor in the __rseq_cs section names the critical section and its
+ *              abort handler, and the final store to current is the commit point. glibc
+ *              registers every thread and exports the area's offset from the thread
+ *              pointer, so no registration is done here.
+ */
+
+/* ================================ Includes ================================ */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE             /* sched_getcpu() */
+#endif
+
+#include "stack_alloc_percpu.h"
+#include "stack_alloc_chain.h"
+#include "stack_alloc_concurrent.h"
+#include "stack_alloc_inline.h"
+#include "stack_alloc_internal.h"
+#include <stddef.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(__x86_64__) && defined(__GNUC__) && (__GNUC__ >= 11) && \
+    defined(__has_include)
+#if __has_include(<sys/rseq.h>)
+#include <sys/rseq.h>
+#define STACK_ALLOC_HAS_RSEQ    (1U)
+#endif
+#endif
+
+#ifndef STACK_ALLOC_HAS_RSEQ
+#define STACK_ALLOC_HAS_RSEQ    (0U)
+#endif
+
+/**
+ * @brief       Gets the number of CPUs the kernel may ever report
+ * @return      Number of configured CPUs (at least 1)
+ */
+static uint32 PossibleCpus(void)
+{
+#if defined(__linux__)
+    long count = sysconf(_SC_NPROCESSORS_CONF);
+    return (count > 0) ? (uint32)count : 1U;
+#else
+    return 1U;
+#endif
+}
+
+/**
+ * @brief       Gets the CPU the calling thread runs on
+ * @return      CPU index (0 if unknown)
+ */
+static uint32 CurrentCpu(void)
+{
+#if defined(__linux__)
+    int cpu = sched_getcpu();
+    return (cpu >= 0) ? (uint32)cpu : 0U;
+#else
+    return 0U;
+#endif
+}
+
+#if (STACK_ALLOC_HAS_RSEQ == 1U)
+/**
+ * @brief       Gets the rseq area of the calling thread
+ * @return      rseq area, or NULL_PTR if glibc did not register one
+ */
+static inline struct rseq* RseqArea(void)
+{
+    if (__rseq_size == 0U)
+    {
+        return NULL_PTR;
+    }
+
+    return (struct rseq*)((uint8*)__builtin_thread_pointer() + __rseq_offset);
+}
+
+/**
+ * @brief       Bumps the current CPU's slice inside a restartable sequence
+ * @param[in]   pc         Pointer to the per-CPU arena
+ * @param[in]   size       Number of bytes to allocate (non-zero)
+ * @param[in]   alignment  Required alignment in bytes (power of 2)
+ * @param[out]  block      Receives the allocated memory, or NULL_PTR if the slice is full
+ * @return      TRUE if the sequence ran, FALSE if the thread cannot use rseq
+ * @note        Preemption, migration or a signal between label 1 and the store to
+ *              current makes the kernel jump to label 4, which restarts from label 5.
+ *              This is plain asm rather than asm goto: GCC 12 miscompiles the goto
+ *              exits of an asm goto that has outputs
+ */
+static boolean RseqAlloc(TStack_alloc_percpu* pc, TStack_alloc_size size, TStack_alloc_size alignment, void** block)
+{
+    struct rseq* rs = RseqArea();
+    TStack_alloc_addr mask = (TStack_alloc_addr)alignment - 1U;
+    TStack_alloc_addr result;
+    uint32 status;
+
+    __asm__ volatile(
+        ".pushsection __rseq_cs, \"aw\"\n\t"
+        ".balign 32\n\t"
+        "3:\n\t"
+        ".long 0x0, 0x0\n\t"                        /* version, flags */
+        ".quad 1f, (2f - 1f), 4f\n\t"               /* start, post-commit offset, abort */
+        ".popsection\n\t"
+        "5:\n\t"
+        "leaq 3b(%%rip), %%rax\n\t"
+        "movq %%rax, %[rseq_cs]\n\t"
+        "1:\n\t"
+        "movl %[cpu_id], %%eax\n\t"
+        "cmpl %[count], %%eax\n\t"
+        "jae 7f\n\t"
+        "imulq %[stride], %%rax, %%rax\n\t"
+        "addq %[slots], %%rax\n\t"
+        "movq %c[cur](%%rax), %%rdx\n\t"            /* aligned = AlignUp(current) */
+        "addq %[mask], %%rdx\n\t"
+        "movq %[mask], %%rcx\n\t"
+        "notq %%rcx\n\t"
+        "andq %%rcx, %%rdx\n\t"
+        "leaq (%%rdx, %[size]), %%rcx\n\t"          /* new_top = aligned + size */
+        "cmpq %%rdx, %%rcx\n\t"
+        "jbe 6f\n\t"
+        "cmpq %c[end](%%rax), %%rcx\n\t"
+        "ja 6f\n\t"
+        "movq %%rcx, %c[cur](%%rax)\n\t"            /* commit */
+        "2:\n\t"
+        "movq %%rdx, %[result]\n\t"
+        "movl $0, %[status]\n\t"
+        "jmp 8f\n\t"
+        "6:\n\t"
+        "xorl %k[result], %k[result]\n\t"           /* full */
+        "movl $0, %[status]\n\t"
+        "jmp 8f\n\t"
+        "7:\n\t"
+        "movl $1, %[status]\n\t"                    /* no usable rseq area */
+        "8:\n\t"
+        ".pushsection __rseq_failure, \"ax\"\n\t"
+        ".byte 0x0f, 0xb9, 0x3d\n\t"                /* ud1 carrying the signature */
+        ".long 0x53053053\n\t"
+        "4:\n\t"
+        "jmp 5b\n\t"
+        ".popsection\n\t"
+        : [result] "=&r" (result), [status] "=&r" (status), [rseq_cs] "+m" (rs->rseq_cs)
+        : [cpu_id] "m" (rs->cpu_id), [count] "r" (pc->cpu_count),
+          [slots] "r" (pc->slots), [mask] "r" (mask), [size] "r" ((TStack_alloc_addr)size),
+          [stride] "i" (sizeof(TStack_alloc_cpu_slot)),
+          [cur] "i" (offsetof(TStack_alloc, current)), [end] "i" (offsetof(TStack_alloc, buffer_end))
+        : "rax", "rcx", "rdx", "memory", "cc");
+
+    *block = (void*)result;
+    return (status == 0U) ? TRUE : FALSE;
+}
+#endif
+
+/**
+ * @brief       Initializes a per-CPU arena
+ * @param[in]   pc        Pointer to the per-CPU arena to initialize
+ * @param[in]   cpu_size  Size of each CPU's slice in bytes, 0 for STACK_ALLOC_PERCPU_SIZE
+ * @param[in]   flags     Combination of STACK_ALLOC_PERCPU_* flags
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_PerCpuInit(TStack_alloc_percpu* pc, TStack_alloc_size cpu_size,
+                                         TStack_alloc_percpu_flags flags)
+{
+    if (pc == NULL_PTR)
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    cpu_size = (cpu_size != 0U) ? cpu_size : STACK_ALLOC_PERCPU_SIZE;
+    cpu_size = (TStack_alloc_size)StackAlloc_AlignUp(cpu_size, STACK_ALLOC_CACHE_LINE_SIZE);
+
+    /* One slot per CPU plus the shared slot */
+    uint32 cpus = PossibleCpus();
+    uint32 slot_count = cpus + 1U;
+    TStack_alloc_size slots_size = (TStack_alloc_size)slot_count * sizeof(TStack_alloc_cpu_slot);
+    if ((cpu_size == 0U) || (cpu_size > ((STACK_ALLOC_SIZE_MAX - slots_size) / slot_count)))
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    /* Slot array first, then the slices; mmap leaves untouched pages unbacked */
+    TStack_alloc_provider provider = StackAlloc_MmapProvider();
+    TStack_alloc_size total = slots_size + ((TStack_alloc_size)slot_count * cpu_size);
+    uint8* memory = (uint8*)provider.acquire(provider.ctx, total);
+    if (memory == NULL_PTR)
+    {
+        return STACK_ALLOC_ERROR_OUT_OF_MEMORY;
+    }
+
+    pc->slots       = (TStack_alloc_cpu_slot*)memory;
+    pc->cpu_count   = cpus;
+    pc->memory      = memory;
+    pc->memory_size = total;
+
+    for (uint32 slot = 0U; slot < slot_count; slot++)
+    {
+        (void)StackAlloc_Init(&pc->slots[slot].sa, memory + slots_size + ((TStack_alloc_size)slot * cpu_size), cpu_size);
+    }
+
+    pc->use_rseq = FALSE;
+#if (STACK_ALLOC_HAS_RSEQ == 1U)
+    /* Every thread of the process must take the same path, so decide once here */
+    if (((flags & STACK_ALLOC_PERCPU_NO_RSEQ) == 0U) && (RseqArea() != NULL_PTR) &&
+        ((sint32)RseqArea()->cpu_id >= 0))
+    {
+        pc->use_rseq = TRUE;
+    }
+#else
+    (void)flags;
+#endif
+
+    return STACK_ALLOC_OK;
+}
+
+/**
+ * @brief       Allocates memory from the calling CPU's slice with the default alignment
+ * @param[in]   pc    Pointer to the per-CPU arena
+ * @param[in]   size  Number of bytes to allocate
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ */
+void* StackAlloc_PerCpuAlloc(TStack_alloc_percpu* pc, TStack_alloc_size size)
+{
+    return StackAlloc_PerCpuAllocAligned(pc, size, STACK_ALLOC_ALIGNMENT);
+}
+
+/**
+ * @brief       Allocates memory with a specific alignment from the calling CPU's slice
+ * @param[in]   pc         Pointer to the per-CPU arena
+ * @param[in]   size       Number of bytes to allocate
+ * @param[in]   alignment  Required alignment in bytes (must be a power of 2)
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ */
+void* StackAlloc_PerCpuAllocAligned(TStack_alloc_percpu* pc, TStack_alloc_size size, TStack_alloc_size alignment)
+{
+    if ((pc == NULL_PTR) || (pc->slots == NULL_PTR) || (size == 0U) ||
+        (StackAlloc_IsPowerOfTwo(alignment) == FALSE))
+    {
+        return NULL_PTR;
+    }
+
+#if (STACK_ALLOC_HAS_RSEQ == 1U)
+    if (STACK_ALLOC_LIKELY(pc->use_rseq == TRUE))
+    {
+        void* block;
+        if (STACK_ALLOC_LIKELY(RseqAlloc(pc, size, alignment, &block) == TRUE))
+        {
+            return block;
+        }
+
+        /* rseq commits with a plain store, so a thread without it must keep off the CPU slots */
+        return StackAlloc_AllocAlignedConcurrent(&pc->slots[pc->cpu_count].sa, size, alignment);
+    }
+#endif
+
+    /* The thread may migrate after reading the CPU; the CAS keeps that safe */
+    return StackAlloc_AllocAlignedConcurrent(&pc->slots[CurrentCpu() % pc->cpu_count].sa, size, alignment);
+}
+
+/**
+ * @brief       Frees everything allocated from all slices
+ * @param[in]   pc  Pointer to the per-CPU arena
+ */
+void StackAlloc_PerCpuReset(TStack_alloc_percpu* pc)
+{
+    if ((pc != NULL_PTR) && (pc->slots != NULL_PTR))
+    {
+        for (uint32 slot = 0U; slot <= pc->cpu_count; slot++)
+        {
+            StackAlloc_Reset(&pc->slots[slot].sa);
+        }
+    }
+}
+
+/**
+ * @brief       Releases the backing memory of a per-CPU arena
+ * @param[in]   pc  Pointer to the per-CPU arena
+ */
+void StackAlloc_PerCpuDeinit(TStack_alloc_percpu* pc)
+{
+    if ((pc != NULL_PTR) && (pc->memory != NULL_PTR))
+    {
+        TStack_alloc_provider provider = StackAlloc_MmapProvider();
+        provider.release(provider.ctx, pc->memory, pc->memory_size);
+
+        pc->slots       = NULL_PTR;
+        pc->cpu_count   = 0U;
+        pc->memory      = NULL_PTR;
+        pc->memory_size = 0U;
+    }
+}
+
+/**
+ * @brief       Gets the amount of memory in use over all slices
+ * @param[in]   pc  Pointer to the per-CPU arena
+ * @return      Number of bytes currently allocated, or 0 if pc is NULL_PTR
+ */
+TStack_alloc_size StackAlloc_PerCpuGetUsed(const TStack_alloc_percpu* pc)
+{
+    TStack_alloc_size used = 0U;
+
+    if ((pc != NULL_PTR) && (pc->slots != NULL_PTR))
+    {
+        for (uint32 slot = 0U; slot <= pc->cpu_count; slot++)
+        {
+            used += StackAlloc_GetUsedConcurrent(&pc->slots[slot].sa);
+        }
+    }
+
+    return used;
+}
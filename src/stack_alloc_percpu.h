@@ -0,0 +1,101 @@
+/**
+ * @file        stack_alloc_percpu.h
+ * @brief       Per-CPU stack allocators
+ * @details     A per-CPU arena holds one slice per possible CPU, and every allocation
+ *              bumps the slice of the CPU the calling thread runs on. The number of
+ *              arenas (and of partly used pages) follows the core count rather than the
+ *              thread count.
+ *
+ *              On x86-64 Linux with glibc 2.35 or newer the bump is a restartable
+ *              sequence (rseq): the kernel aborts and restarts it if the thread is
+ *              preempted or migrated, so it needs neither a lock nor an atomic
+ *              instruction. Elsewhere the slice of sched_getcpu() is bumped with a
+ *              compare-and-swap, which is just as correct but slower. A thread that
+ *              cannot run the sequence (no registered rseq area, or a CPU number beyond
+ *              the slots) bumps one extra shared slice with a compare-and-swap instead.
+ *
+ * @note        Allocation is thread-safe. StackAlloc_PerCpuReset() and
+ *              StackAlloc_PerCpuDeinit() need a quiescent arena. Blocks cannot be freed
+ *              individually and there are no markers: a thread may change CPUs between
+ *              two allocations.
+ */
+
+#ifndef STACK_ALLOC_PERCPU_H
+#define STACK_ALLOC_PERCPU_H
+
+#include "stack_alloc.h"
+
+/**
+ * @brief Option flags for StackAlloc_PerCpuInit()
+ */
+typedef uint32 TStack_alloc_percpu_flags;
+
+#define STACK_ALLOC_PERCPU_DEFAULT      (0x00000000u)  /**< Use rseq when available */
+#define STACK_ALLOC_PERCPU_NO_RSEQ      (0x00000001u)  /**< Always use the atomic path */
+
+/**
+ * @brief   Arena of one CPU, padded so that no two CPUs share a cache line
+ */
+typedef struct {
+    _Alignas(STACK_ALLOC_CACHE_LINE_SIZE) TStack_alloc sa;
+} TStack_alloc_cpu_slot;
+
+/**
+ * @brief   Per-CPU stack allocator instance
+ */
+typedef struct {
+    TStack_alloc_cpu_slot* slots;   /**< One arena per possible CPU, then the shared one */
+    uint32 cpu_count;               /**< Number of CPU slots (slots[cpu_count] is shared) */
+    boolean use_rseq;               /**< TRUE if allocations use restartable sequences */
+    void* memory;                   /**< Backing memory of all slices */
+    TStack_alloc_size memory_size;  /**< Size of the backing memory in bytes */
+} TStack_alloc_percpu;
+
+/**
+ * @brief       Initializes a per-CPU arena
+ * @param[in]   pc        Pointer to the per-CPU arena to initialize
+ * @param[in]   cpu_size  Size of each CPU's slice in bytes, 0 for STACK_ALLOC_PERCPU_SIZE
+ * @param[in]   flags     Combination of STACK_ALLOC_PERCPU_* flags
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_PerCpuInit(TStack_alloc_percpu* pc, TStack_alloc_size cpu_size,
+                                         TStack_alloc_percpu_flags flags);
+
+/**
+ * @brief       Allocates memory from the calling CPU's slice with the default alignment
+ * @param[in]   pc    Pointer to the per-CPU arena
+ * @param[in]   size  Number of bytes to allocate
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ */
+void* StackAlloc_PerCpuAlloc(TStack_alloc_percpu* pc, TStack_alloc_size size);
+
+/**
+ * @brief       Allocates memory with a specific alignment from the calling CPU's slice
+ * @param[in]   pc         Pointer to the per-CPU arena
+ * @param[in]   size       Number of bytes to allocate
+ * @param[in]   alignment  Required alignment in bytes (must be a power of 2)
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ * @note        Fails when the slice in use is full, even if other slices still have room
+ */
+void* StackAlloc_PerCpuAllocAligned(TStack_alloc_percpu* pc, TStack_alloc_size size, TStack_alloc_size alignment);
+
+/**
+ * @brief       Frees everything allocated from all slices
+ * @param[in]   pc  Pointer to the per-CPU arena
+ */
+void StackAlloc_PerCpuReset(TStack_alloc_percpu* pc);
+
+/**
+ * @brief       Releases the backing memory of a per-CPU arena
+ * @param[in]   pc  Pointer to the per-CPU arena
+ */
+void StackAlloc_PerCpuDeinit(TStack_alloc_percpu* pc);
+
+/**
+ * @brief       Gets the amount of memory in use over all slices
+ * @param[in]   pc  Pointer to the per-CPU arena
+ * @return      Number of bytes currently allocated, or 0 if pc is NULL_PTR
+ */
+TStack_alloc_size StackAlloc_PerCpuGetUsed(const TStack_alloc_percpu* pc);
+
+#endif /* STACK_ALLOC_PERCPU_H */
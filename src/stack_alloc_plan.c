@@ -0,0 +1,325 @@
+/**
+ * @file        stack_alloc_plan.c
+ * @brief       Offline placement of buffers with known lifetimes into one arena
+ * @details     The greedy placement keeps the buffers placed so far in a list sorted by
+ *              offset. For the next buffer it walks that list, skipping buffers whose
+ *              lifetimes do not overlap its own, and tracks the end of the overlapping
+ *              ones seen so far: the space between that end and the next overlapping
+ *              buffer is a gap it may use. The smallest gap that fits wins; without one
+ *              the buffer goes above every overlapping buffer.
+ */
+
+/* ================================ Includes ================================ */
+#include "stack_alloc_plan.h"
+#include "stack_alloc_inline.h"
+
+/**
+ * @brief   Ordering of buffers: TRUE if a is placed before b
+ */
+typedef boolean (*TPlan_before)(const TStack_alloc_plan_buffer* a, const TStack_alloc_plan_buffer* b);
+
+/**
+ * @brief       Gets the number of steps a buffer lives for
+ * @param[in]   b  Buffer
+ * @return      Lifetime in steps (at least 1)
+ */
+static inline uint64 Lifetime(const TStack_alloc_plan_buffer* b)
+{
+    return (uint64)b->last_step - (uint64)b->first_step + 1U;
+}
+
+/**
+ * @brief       Checks whether two buffers are used in a common step
+ * @param[in]   a  First buffer
+ * @param[in]   b  Second buffer
+ * @return      TRUE if their lifetimes overlap
+ */
+static inline boolean Overlap(const TStack_alloc_plan_buffer* a, const TStack_alloc_plan_buffer* b)
+{
+    return ((a->first_step <= b->last_step) && (b->first_step <= a->last_step)) ? TRUE : FALSE;
+}
+
+/* Orderings; ties keep the caller's order */
+
+static boolean ByFirstUse(const TStack_alloc_plan_buffer* a, const TStack_alloc_plan_buffer* b)
+{
+    return (a->first_step < b->first_step) ? TRUE : FALSE;
+}
+
+static boolean BySize(const TStack_alloc_plan_buffer* a, const TStack_alloc_plan_buffer* b)
+{
+    return ((a->size > b->size) || ((a->size == b->size) && (Lifetime(a) > Lifetime(b)))) ? TRUE : FALSE;
+}
+
+static boolean ByArea(const TStack_alloc_plan_buffer* a, const TStack_alloc_plan_buffer* b)
+{
+    return (((float64)a->size * (float64)Lifetime(a)) > ((float64)b->size * (float64)Lifetime(b))) ? TRUE : FALSE;
+}
+
+static boolean ByLifetime(const TStack_alloc_plan_buffer* a, const TStack_alloc_plan_buffer* b)
+{
+    return ((Lifetime(a) > Lifetime(b)) || ((Lifetime(a) == Lifetime(b)) && (a->size > b->size))) ? TRUE : FALSE;
+}
+
+static boolean ByFirstUseLargest(const TStack_alloc_plan_buffer* a, const TStack_alloc_plan_buffer* b)
+{
+    return ((a->first_step < b->first_step) || ((a->first_step == b->first_step) && (a->size > b->size))) ? TRUE : FALSE;
+}
+
+/**
+ * @brief       Sorts buffer indices (stable insertion sort; placement is quadratic anyway)
+ * @param[out]  order    Receives the indices 0..count-1 in placement order
+ * @param[in]   buffers  Array of buffers
+ * @param[in]   count    Number of buffers
+ * @param[in]   before   Ordering
+ */
+static void SortOrder(uint32* order, const TStack_alloc_plan_buffer* buffers, uint32 count, TPlan_before before)
+{
+    for (uint32 k = 0U; k < count; k++)
+    {
+        uint32 pos = k;
+        while ((pos > 0U) && (before(&buffers[k], &buffers[order[pos - 1U]]) == TRUE))
+        {
+            order[pos] = order[pos - 1U];
+            pos--;
+        }
+        order[pos] = k;
+    }
+}
+
+/**
+ * @brief       Places a buffer at the first aligned offset at or above a bound
+ * @param[in]   b        Buffer
+ * @param[in]   bound    Lowest offset the buffer may use
+ * @param[out]  offset   Receives the offset
+ * @param[out]  end      Receives the offset just past the buffer
+ * @return      FALSE if the end does not fit TStack_alloc_size
+ */
+static boolean PlaceAbove(const TStack_alloc_plan_buffer* b, TStack_alloc_addr bound,
+                          TStack_alloc_addr* offset, TStack_alloc_addr* end)
+{
+    TStack_alloc_addr start = StackAlloc_AlignUp(bound, b->alignment);
+    if ((start < bound) || (start > STACK_ALLOC_SIZE_MAX) || (b->size > (STACK_ALLOC_SIZE_MAX - start)))
+    {
+        return FALSE;
+    }
+
+    *offset = start;
+    *end = start + b->size;
+    return TRUE;
+}
+
+/**
+ * @brief       Places buffers on a stack that only frees from the top
+ * @param[in]   buffers  Array of buffers
+ * @param[in]   count    Number of buffers
+ * @param[in]   order    Indices in order of first use
+ * @param[in]   stack    Scratch for count indices
+ * @param[out]  offsets  Receives the offset of each buffer
+ * @param[out]  total    Receives the size of the block
+ * @return      STACK_ALLOC_OK on success, STACK_ALLOC_ERROR_OUT_OF_MEMORY on overflow
+ */
+static TStack_alloc_error PlaceStack(const TStack_alloc_plan_buffer* buffers, uint32 count, const uint32* order,
+                                     uint32* stack, TStack_alloc_size* offsets, TStack_alloc_size* total)
+{
+    uint32 depth = 0U;
+    TStack_alloc_addr peak = 0U;
+
+    for (uint32 k = 0U; k < count; k++)
+    {
+        const TStack_alloc_plan_buffer* b = &buffers[order[k]];
+
+        /* Pop what is dead, but only down to the first buffer still in use */
+        while ((depth > 0U) && (buffers[stack[depth - 1U]].last_step < b->first_step))
+        {
+            depth--;
+        }
+
+        TStack_alloc_addr top = 0U;
+        if (depth > 0U)
+        {
+            uint32 below = stack[depth - 1U];
+            top = (TStack_alloc_addr)offsets[below] + buffers[below].size;
+        }
+
+        TStack_alloc_addr offset;
+        TStack_alloc_addr end;
+        if (PlaceAbove(b, top, &offset, &end) == FALSE)
+        {
+            return STACK_ALLOC_ERROR_OUT_OF_MEMORY;
+        }
+
+        offsets[order[k]] = (TStack_alloc_size)offset;
+        stack[depth++] = order[k];
+        peak = (end > peak) ? end : peak;
+    }
+
+    *total = (TStack_alloc_size)peak;
+    return STACK_ALLOC_OK;
+}
+
+/**
+ * @brief       Places each buffer in the smallest gap left by the buffers it overlaps
+ * @param[in]   buffers  Array of buffers
+ * @param[in]   count    Number of buffers
+ * @param[in]   order    Indices in placement order
+ * @param[in]   placed   Scratch for count indices (kept sorted by offset)
+ * @param[out]  offsets  Receives the offset of each buffer
+ * @param[out]  total    Receives the size of the block
+ * @return      STACK_ALLOC_OK on success, STACK_ALLOC_ERROR_OUT_OF_MEMORY on overflow
+ */
+static TStack_alloc_error PlaceGreedy(const TStack_alloc_plan_buffer* buffers, uint32 count, const uint32* order,
+                                      uint32* placed, TStack_alloc_size* offsets, TStack_alloc_size* total)
+{
+    TStack_alloc_addr peak = 0U;
+
+    for (uint32 k = 0U; k < count; k++)
+    {
+        const uint32 i = order[k];
+        const TStack_alloc_plan_buffer* b = &buffers[i];
+        TStack_alloc_addr prev_end = 0U;
+        TStack_alloc_addr best_gap = 0U;
+        TStack_alloc_addr offset = 0U;
+        TStack_alloc_addr end = 0U;
+        boolean found = FALSE;
+
+        for (uint32 p = 0U; p < k; p++)
+        {
+            const uint32 j = placed[p];
+            if (Overlap(b, &buffers[j]) == FALSE)
+            {
+                continue;
+            }
+
+            /* Try the gap below buffer j */
+            TStack_alloc_addr start = StackAlloc_AlignUp(prev_end, b->alignment);
+            TStack_alloc_addr next  = offsets[j];
+            if ((start >= prev_end) && (start <= next) && (b->size <= (next - start)) &&
+                ((found == FALSE) || ((next - prev_end) < best_gap)))
+            {
+                found    = TRUE;
+                best_gap = next - prev_end;
+                offset   = start;
+            }
+
+            TStack_alloc_addr end_j = (TStack_alloc_addr)offsets[j] + buffers[j].size;
+            prev_end = (end_j > prev_end) ? end_j : prev_end;
+        }
+
+        if (found == TRUE)
+        {
+            end = offset + b->size;
+        }
+        else if (PlaceAbove(b, prev_end, &offset, &end) == FALSE)
+        {
+            return STACK_ALLOC_ERROR_OUT_OF_MEMORY;
+        }
+        else
+        {
+            /* Above every overlapping buffer */
+        }
+
+        offsets[i] = (TStack_alloc_size)offset;
+        peak = (end > peak) ? end : peak;
+
+        /* Keep the placed list sorted by offset */
+        uint32 pos = k;
+        while ((pos > 0U) && (offsets[placed[pos - 1U]] > offsets[i]))
+        {
+            placed[pos] = placed[pos - 1U];
+            pos--;
+        }
+        placed[pos] = i;
+    }
+
+    *total = (TStack_alloc_size)peak;
+    return STACK_ALLOC_OK;
+}
+
+/**
+ * @brief       Computes an offset for every buffer and the size of the block holding them
+ * @param[in]   scratch   Arena for temporary memory
+ * @param[in]   buffers   Array of count buffers
+ * @param[in]   count     Number of buffers
+ * @param[in]   strategy  STACK_ALLOC_PLAN_* strategy
+ * @param[out]  offsets   Receives the offset of buffers[i] in offsets[i]
+ * @param[out]  total     Receives the size of the block in bytes
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_Plan(TStack_alloc* scratch, const TStack_alloc_plan_buffer* buffers, uint32 count,
+                                   TStack_alloc_plan_strategy strategy, TStack_alloc_size* offsets,
+                                   TStack_alloc_size* total)
+{
+    static const TPlan_before s_orderings[] = { BySize, ByArea, ByLifetime, ByFirstUseLargest };
+
+    if ((scratch == NULL_PTR) || (offsets == NULL_PTR) || (total == NULL_PTR) ||
+        ((buffers == NULL_PTR) && (count != 0U)) || (strategy > STACK_ALLOC_PLAN_BEST))
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    for (uint32 i = 0U; i < count; i++)
+    {
+        if ((buffers[i].size == 0U) || (StackAlloc_IsPowerOfTwo(buffers[i].alignment) == FALSE) ||
+            (buffers[i].last_step < buffers[i].first_step))
+        {
+            return STACK_ALLOC_ERROR_INVALID_PARAM;
+        }
+    }
+
+    *total = 0U;
+    if (count == 0U)
+    {
+        return STACK_ALLOC_OK;
+    }
+
+    if (((uint64)count * sizeof(TStack_alloc_size)) > (uint64)STACK_ALLOC_SIZE_MAX)
+    {
+        return STACK_ALLOC_ERROR_OUT_OF_MEMORY;
+    }
+
+    void* mark = StackAlloc_GetMarker(scratch);
+    uint32* order = (uint32*)StackAlloc_AllocAligned(scratch, (TStack_alloc_size)count * sizeof(uint32), sizeof(uint32));
+    uint32* work  = (uint32*)StackAlloc_AllocAligned(scratch, (TStack_alloc_size)count * sizeof(uint32), sizeof(uint32));
+    TStack_alloc_size* candidate = NULL_PTR;
+    if (strategy == STACK_ALLOC_PLAN_BEST)
+    {
+        candidate = (TStack_alloc_size*)StackAlloc_AllocAligned(scratch, (TStack_alloc_size)count * sizeof(TStack_alloc_size),
+                                                                sizeof(TStack_alloc_size));
+    }
+
+    TStack_alloc_error err = STACK_ALLOC_ERROR_OUT_OF_MEMORY;
+    if ((order == NULL_PTR) || (work == NULL_PTR) || ((strategy == STACK_ALLOC_PLAN_BEST) && (candidate == NULL_PTR)))
+    {
+        /* Scratch too small */
+    }
+    else if (strategy == STACK_ALLOC_PLAN_STACK)
+    {
+        SortOrder(order, buffers, count, ByFirstUse);
+        err = PlaceStack(buffers, count, order, work, offsets, total);
+    }
+    else
+    {
+        /* Greedy by size first; other orderings only replace it when they are smaller */
+        SortOrder(order, buffers, count, BySize);
+        err = PlaceGreedy(buffers, count, order, work, offsets, total);
+
+        for (uint32 o = 1U; (err == STACK_ALLOC_OK) && (strategy == STACK_ALLOC_PLAN_BEST) &&
+                            (o < (uint32)(sizeof(s_orderings) / sizeof(s_orderings[0]))); o++)
+        {
+            TStack_alloc_size size;
+            SortOrder(order, buffers, count, s_orderings[o]);
+            if ((PlaceGreedy(buffers, count, order, work, candidate, &size) == STACK_ALLOC_OK) && (size < *total))
+            {
+                for (uint32 i = 0U; i < count; i++)
+                {
+                    offsets[i] = candidate[i];
+                }
+                *total = size;
+            }
+        }
+    }
+
+    (void)StackAlloc_FreeToMarker(scratch, mark);
+    return err;
+}
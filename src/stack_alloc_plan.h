@@ -0,0 +1,73 @@
+/**
+ * @file        stack_alloc_plan.h
+ * @brief       Offline placement of buffers with known lifetimes into one arena
+ * @details     Given every buffer's size, alignment and the first and last step it is
+ *              used in, StackAlloc_Plan() computes a static offset for each buffer so that
+ *              buffers whose lifetimes overlap never overlap in memory, and returns the
+ *              size of the single block that holds them all. Place the block at an address
+ *              aligned to the largest alignment (StackAlloc_AllocAligned() does) and add
+ *              the offsets to it.
+ *
+ *              Strategies:
+ *              - STACK_ALLOC_PLAN_STACK places buffers in order of their first step on a
+ *                stack that only frees from the top, like a StackAlloc_* arena with one
+ *                marker per buffer. Included as the baseline.
+ *              - STACK_ALLOC_PLAN_GREEDY_BY_SIZE places the largest buffers first, each in
+ *                the smallest gap left by the buffers it overlaps in time.
+ *              - STACK_ALLOC_PLAN_BEST runs the greedy placement with several orderings
+ *                (size, size x lifetime, lifetime, first step) and keeps the smallest
+ *                result, so it is never worse than greedy by size.
+ *
+ *              Temporary memory comes from a caller-provided scratch arena and is freed
+ *              again before returning.
+ *
+ * @note        This implementation is not thread-safe.
+ */
+
+#ifndef STACK_ALLOC_PLAN_H
+#define STACK_ALLOC_PLAN_H
+
+#include "stack_alloc.h"
+
+/**
+ * @brief   One buffer to place
+ */
+typedef struct {
+    TStack_alloc_size size;       /**< Number of bytes (non-zero) */
+    TStack_alloc_size alignment;  /**< Required alignment in bytes (power of 2) */
+    uint32 first_step;            /**< First step the buffer is used in */
+    uint32 last_step;             /**< Last step the buffer is used in (inclusive) */
+} TStack_alloc_plan_buffer;
+
+/**
+ * @brief How StackAlloc_Plan() orders and places buffers
+ */
+typedef uint8 TStack_alloc_plan_strategy;
+
+#define STACK_ALLOC_PLAN_STACK              (0x00u)  /**< LIFO stack in order of first use */
+#define STACK_ALLOC_PLAN_GREEDY_BY_SIZE     (0x01u)  /**< Largest first, into the smallest fitting gap */
+#define STACK_ALLOC_PLAN_BEST               (0x02u)  /**< Best greedy placement over several orderings */
+
+/**
+ * @brief       Computes an offset for every buffer and the size of the block holding them
+ * @param[in]   scratch   Arena for temporary memory (rewound before returning)
+ * @param[in]   buffers   Array of count buffers
+ * @param[in]   count     Number of buffers
+ * @param[in]   strategy  STACK_ALLOC_PLAN_* strategy
+ * @param[out]  offsets   Array of count offsets, receives the offset of buffers[i] in offsets[i]
+ * @param[out]  total     Receives the size of the block in bytes (0 if count is 0)
+ * @return      Error code indicating success or failure
+ * @retval      STACK_ALLOC_OK if every buffer was placed
+ * @retval      STACK_ALLOC_ERROR_INVALID_PARAM if a pointer is NULL_PTR, the strategy is
+ *              unknown, or a buffer has size 0, an alignment that is not a power of 2 or
+ *              a last step before its first step
+ * @retval      STACK_ALLOC_ERROR_OUT_OF_MEMORY if scratch is too small or the block size
+ *              does not fit TStack_alloc_size
+ * @note        Scratch needs about count * (2 * sizeof(uint32) + sizeof(TStack_alloc_size))
+ *              bytes. The placement takes O(count^2) time
+ */
+TStack_alloc_error StackAlloc_Plan(TStack_alloc* scratch, const TStack_alloc_plan_buffer* buffers, uint32 count,
+                                   TStack_alloc_plan_strategy strategy, TStack_alloc_size* offsets,
+                                   TStack_alloc_size* total);
+
+#endif /* STACK_ALLOC_PLAN_H */
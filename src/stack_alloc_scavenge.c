@@ -0,0 +1,341 @@
+/**
+ * @file        stack_alloc_scavenge.c
+ * @brief       Background scavenger for virtual-memory stack allocators
+ * @details     Each registered arena has a record holding the handover state of its
+ *              trimmed tail. The owner posts a tail (IDLE -> POSTED) at reset; the
+ *              scavenger claims it (POSTED -> BUSY), decommits it and marks it DONE; the
+ *              owner folds a DONE tail back into its known-zero watermark, or cancels a
+ *              POSTED one (POSTED -> IDLE) when it has to grow into it.
+ */
+
+/* ================================ Includes ================================ */
+#include "stack_alloc_scavenge.h"
+#include "stack_alloc_internal.h"
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SCAVENGE_IDLE       (0U)    /**< No tail handed over */
+#define SCAVENGE_POSTED     (1U)    /**< Tail handed over, not yet claimed */
+#define SCAVENGE_BUSY       (2U)    /**< Scavenger is decommitting the tail */
+#define SCAVENGE_DONE       (3U)    /**< Tail decommitted, owner has not looked yet */
+
+/**
+ * @brief Scavenger record of a registered arena
+ */
+typedef struct TStack_alloc_scavenge_tag {
+    struct TStack_alloc_scavenge_tag* next;  /**< Next registered arena */
+    uint8* trim_start;               /**< Start of the handed-over tail (owner writes before POSTED) */
+    uint8* trim_end;                 /**< End of the handed-over tail */
+    uint32 state;                    /**< SCAVENGE_* handover state (atomic) */
+    boolean trim_zeroed;             /**< Tail reads as zero once committed again (scavenger writes before DONE) */
+    TStack_alloc_size commit_step;   /**< Commit granularity of the arena */
+    TStack_alloc_size recent_peak;   /**< Highest usage at a reset since the last pass (atomic) */
+    TStack_alloc_size target;        /**< Committed bytes the owner should keep, 0: none yet (atomic) */
+    double estimate;                 /**< Decaying usage estimate (scavenger only) */
+} TStack_alloc_scavenge;
+
+/* =============================== Variables ================================ */
+static pthread_mutex_t g_list_lock = PTHREAD_MUTEX_INITIALIZER;
+static TStack_alloc_scavenge* g_list = NULL_PTR;
+
+static pthread_mutex_t g_thread_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  g_thread_wake = PTHREAD_COND_INITIALIZER;
+static pthread_t g_thread;
+static boolean g_running = FALSE;
+static boolean g_stop = FALSE;
+
+static uint32 g_period_ms = STACK_ALLOC_SCAVENGE_PERIOD_MS;
+static double g_decay = 0.5;    /* Estimate factor per pass: 2^(-period / half-life) */
+static TStack_alloc_size g_min_retained = STACK_ALLOC_SCAVENGE_MIN_RETAINED;
+static TStack_alloc_size g_released = 0U;
+
+/* ============================== Owner side =============================== */
+
+/**
+ * @brief       Folds a decommitted tail into the arena and makes the record idle again
+ * @param[in]   sa     Pointer to the arena
+ * @param[in]   entry  Its record, in state SCAVENGE_DONE
+ */
+static void FoldDone(TStack_alloc* sa, TStack_alloc_scavenge* entry)
+{
+    /* The owner never reached past trim_start since, so the tail is all that was dirty above it */
+    if ((entry->trim_zeroed == TRUE) && (sa->zero_start > entry->trim_start))
+    {
+        sa->zero_start = entry->trim_start;
+    }
+
+    __atomic_store_n(&entry->state, SCAVENGE_IDLE, __ATOMIC_RELAXED);
+}
+
+void StackAlloc_ScavengeOnReset(TStack_alloc* sa)
+{
+    TStack_alloc_scavenge* entry = sa->scavenge;
+    TStack_alloc_size used = (TStack_alloc_size)(sa->current - sa->buffer_start);
+
+    if (used > __atomic_load_n(&entry->recent_peak, __ATOMIC_RELAXED))
+    {
+        __atomic_store_n(&entry->recent_peak, used, __ATOMIC_RELAXED);
+    }
+
+    uint32 state = __atomic_load_n(&entry->state, __ATOMIC_ACQUIRE);
+    if (state == SCAVENGE_DONE)
+    {
+        FoldDone(sa, entry);
+        state = SCAVENGE_IDLE;
+    }
+
+    /* Hand the tail above the target over; the fast path cannot reach it any more */
+    TStack_alloc_size target = __atomic_load_n(&entry->target, __ATOMIC_RELAXED);
+    if ((state == SCAVENGE_IDLE) && (target != 0U) &&
+        (target < (TStack_alloc_size)(sa->buffer_end - sa->buffer_start)))
+    {
+        entry->trim_start = sa->buffer_start + target;
+        entry->trim_end   = sa->buffer_end;
+        sa->buffer_end    = entry->trim_start;
+        __atomic_store_n(&entry->state, SCAVENGE_POSTED, __ATOMIC_RELEASE);
+    }
+}
+
+void StackAlloc_ScavengeReclaim(TStack_alloc* sa)
+{
+    TStack_alloc_scavenge* entry = sa->scavenge;
+    uint32 state = SCAVENGE_POSTED;
+
+    /* Not claimed yet: cancel and take the still committed tail back */
+    if (__atomic_compare_exchange_n(&entry->state, &state, SCAVENGE_IDLE, FALSE,
+                                    __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+    {
+        sa->buffer_end = entry->trim_end;
+        return;
+    }
+
+    /* Being decommitted right now: wait for it, the slow path will commit it again */
+    while (state == SCAVENGE_BUSY)
+    {
+        (void)sched_yield();
+        state = __atomic_load_n(&entry->state, __ATOMIC_ACQUIRE);
+    }
+
+    if (state == SCAVENGE_DONE)
+    {
+        FoldDone(sa, entry);
+    }
+}
+
+/**
+ * @brief       Registers a virtual arena with the scavenger
+ * @param[in]   sa  Pointer to a virtual stack allocator instance
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_ScavengeRegister(TStack_alloc* sa)
+{
+    if ((sa == NULL_PTR) || (sa->mode != STACK_ALLOC_MODE_VIRTUAL) || (sa->buffer_start == NULL_PTR) ||
+        (sa->locked == TRUE) || (sa->fault_grow == TRUE) || (sa->scavenge != NULL_PTR))
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    TStack_alloc_scavenge* entry = (TStack_alloc_scavenge*)calloc(1U, sizeof(*entry));
+    if (entry == NULL_PTR)
+    {
+        return STACK_ALLOC_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* Start from what is committed now so that nothing is trimmed before a first pass */
+    entry->commit_step = sa->commit_step;
+    entry->estimate    = (double)(sa->buffer_end - sa->buffer_start);
+    sa->scavenge       = entry;
+
+    (void)pthread_mutex_lock(&g_list_lock);
+    entry->next = g_list;
+    g_list = entry;
+    (void)pthread_mutex_unlock(&g_list_lock);
+
+    return STACK_ALLOC_OK;
+}
+
+/**
+ * @brief       Removes an arena from the scavenger
+ * @param[in]   sa  Pointer to a registered virtual arena
+ */
+void StackAlloc_ScavengeUnregister(TStack_alloc* sa)
+{
+    if ((sa == NULL_PTR) || (sa->scavenge == NULL_PTR))
+    {
+        return;
+    }
+
+    TStack_alloc_scavenge* entry = sa->scavenge;
+
+    /* Passes run under the list lock, so once unlinked the scavenger is done with the entry */
+    (void)pthread_mutex_lock(&g_list_lock);
+    for (TStack_alloc_scavenge** link = &g_list; *link != NULL_PTR; link = &(*link)->next)
+    {
+        if (*link == entry)
+        {
+            *link = entry->next;
+            break;
+        }
+    }
+    (void)pthread_mutex_unlock(&g_list_lock);
+
+    /* The state cannot change any more: take a posted tail back, fold a decommitted one */
+    uint32 state = __atomic_load_n(&entry->state, __ATOMIC_ACQUIRE);
+    if (state == SCAVENGE_POSTED)
+    {
+        sa->buffer_end = entry->trim_end;
+    }
+    else if (state == SCAVENGE_DONE)
+    {
+        FoldDone(sa, entry);
+    }
+
+    sa->scavenge = NULL_PTR;
+    free(entry);
+}
+
+/* ============================ Scavenger side ============================= */
+
+/**
+ * @brief       Runs one scavenger pass over all registered arenas on the calling thread
+ */
+void StackAlloc_ScavengeRun(void)
+{
+    (void)pthread_mutex_lock(&g_list_lock);
+
+    for (TStack_alloc_scavenge* entry = g_list; entry != NULL_PTR; entry = entry->next)
+    {
+        /* Decay the estimate, but never below what was used since the last pass */
+        double peak = (double)__atomic_exchange_n(&entry->recent_peak, 0U, __ATOMIC_RELAXED);
+        entry->estimate *= g_decay;
+        if (peak > entry->estimate)
+        {
+            entry->estimate = peak;
+        }
+
+        double keep = (entry->estimate > (double)g_min_retained) ? entry->estimate : (double)g_min_retained;
+        TStack_alloc_size step = entry->commit_step;
+        TStack_alloc_size target = (TStack_alloc_size)((((TStack_alloc_size)keep) + (step - 1U)) / step) * step;
+        __atomic_store_n(&entry->target, target, __ATOMIC_RELAXED);
+
+        /* Decommit a tail the owner handed over */
+        uint32 state = SCAVENGE_POSTED;
+        if (__atomic_compare_exchange_n(&entry->state, &state, SCAVENGE_BUSY, FALSE,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            TStack_alloc_size size = (TStack_alloc_size)(entry->trim_end - entry->trim_start);
+            entry->trim_zeroed = StackAlloc_VmDecommit(entry->trim_start, size);
+            g_released += size;
+            __atomic_store_n(&entry->state, SCAVENGE_DONE, __ATOMIC_RELEASE);
+        }
+    }
+
+    (void)pthread_mutex_unlock(&g_list_lock);
+}
+
+/**
+ * @brief       Body of the scavenger thread
+ * @param[in]   arg  Unused
+ * @return      NULL_PTR
+ */
+static void* ScavengerMain(void* arg)
+{
+    (void)arg;
+
+    (void)pthread_mutex_lock(&g_thread_lock);
+    while (g_stop == FALSE)
+    {
+        struct timespec deadline;
+        (void)clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec  += (time_t)(g_period_ms / 1000U);
+        deadline.tv_nsec += (long)(g_period_ms % 1000U) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec  += 1;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        (void)pthread_cond_timedwait(&g_thread_wake, &g_thread_lock, &deadline);
+        if (g_stop == FALSE)
+        {
+            (void)pthread_mutex_unlock(&g_thread_lock);
+            StackAlloc_ScavengeRun();
+            (void)pthread_mutex_lock(&g_thread_lock);
+        }
+    }
+    (void)pthread_mutex_unlock(&g_thread_lock);
+
+    return NULL_PTR;
+}
+
+/**
+ * @brief       Starts the background scavenger thread
+ * @param[in]   period_ms     Interval between passes, 0 for STACK_ALLOC_SCAVENGE_PERIOD_MS
+ * @param[in]   half_life_ms  Half-life of the usage estimate, 0 for STACK_ALLOC_SCAVENGE_HALF_LIFE_MS
+ * @param[in]   min_retained  Committed bytes never taken from an arena, 0 for STACK_ALLOC_SCAVENGE_MIN_RETAINED
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_ScavengerStart(uint32 period_ms, uint32 half_life_ms, TStack_alloc_size min_retained)
+{
+    TStack_alloc_error err = STACK_ALLOC_OK;
+
+    (void)pthread_mutex_lock(&g_thread_lock);
+    if (g_running == TRUE)
+    {
+        err = STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        g_period_ms    = (period_ms != 0U) ? period_ms : STACK_ALLOC_SCAVENGE_PERIOD_MS;
+        half_life_ms   = (half_life_ms != 0U) ? half_life_ms : STACK_ALLOC_SCAVENGE_HALF_LIFE_MS;
+        g_min_retained = (min_retained != 0U) ? min_retained : STACK_ALLOC_SCAVENGE_MIN_RETAINED;
+        g_decay        = exp2(-(double)g_period_ms / (double)half_life_ms);
+        g_stop         = FALSE;
+
+        if (pthread_create(&g_thread, NULL_PTR, ScavengerMain, NULL_PTR) == 0)
+        {
+            g_running = TRUE;
+        }
+        else
+        {
+            err = STACK_ALLOC_ERROR_OUT_OF_MEMORY;
+        }
+    }
+    (void)pthread_mutex_unlock(&g_thread_lock);
+
+    return err;
+}
+
+/**
+ * @brief       Stops the background scavenger thread and waits for it to exit
+ */
+void StackAlloc_ScavengerStop(void)
+{
+    (void)pthread_mutex_lock(&g_thread_lock);
+    boolean running = g_running;
+    g_stop    = TRUE;
+    g_running = FALSE;
+    (void)pthread_cond_signal(&g_thread_wake);
+    (void)pthread_mutex_unlock(&g_thread_lock);
+
+    if (running == TRUE)
+    {
+        (void)pthread_join(g_thread, NULL_PTR);
+    }
+}
+
+/**
+ * @brief       Gets the total number of bytes the scavenger has decommitted
+ * @return      Decommitted bytes since program start
+ */
+TStack_alloc_size StackAlloc_ScavengerGetReleased(void)
+{
+    (void)pthread_mutex_lock(&g_list_lock);
+    TStack_alloc_size released = g_released;
+    (void)pthread_mutex_unlock(&g_list_lock);
+
+    return released;
+}
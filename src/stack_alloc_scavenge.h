@@ -0,0 +1,70 @@
+/**
+ * @file        stack_alloc_scavenge.h
+ * @brief       Background scavenger for virtual-memory stack allocators
+ * @details     A scavenger thread keeps a decaying estimate of how much of each registered
+ *              arena recent requests actually used, and decommits the committed tail above
+ *              it. The owner thread only hands the tail over: StackAlloc_Reset() lowers
+ *              buffer_end to the estimate, which takes no system call and makes the tail
+ *              unreachable for the fast path. The scavenger then decommits it off the
+ *              request path. If the arena grows again first, its slow path takes the tail
+ *              back (or waits for the decommit in progress) before committing.
+ *
+ * @note        Registering, unregistering and the arena itself stay single-owner; only
+ *              the handover of the tail is synchronised with the scavenger thread.
+ */
+
+#ifndef STACK_ALLOC_SCAVENGE_H
+#define STACK_ALLOC_SCAVENGE_H
+
+#include "stack_alloc.h"
+
+/**
+ * @brief       Starts the background scavenger thread
+ * @param[in]   period_ms     Interval between passes, 0 for STACK_ALLOC_SCAVENGE_PERIOD_MS
+ * @param[in]   half_life_ms  Half-life of the usage estimate, 0 for STACK_ALLOC_SCAVENGE_HALF_LIFE_MS
+ * @param[in]   min_retained  Committed bytes never taken from an arena, 0 for
+ *                            STACK_ALLOC_SCAVENGE_MIN_RETAINED
+ * @return      Error code indicating success or failure
+ * @retval      STACK_ALLOC_OK if the thread was started
+ * @retval      STACK_ALLOC_ERROR_INVALID_PARAM if the scavenger is already running
+ * @retval      STACK_ALLOC_ERROR_OUT_OF_MEMORY if the thread could not be created
+ */
+TStack_alloc_error StackAlloc_ScavengerStart(uint32 period_ms, uint32 half_life_ms, TStack_alloc_size min_retained);
+
+/**
+ * @brief       Stops the background scavenger thread and waits for it to exit
+ * @note        Registered arenas stay registered; StackAlloc_ScavengeRun() still works
+ */
+void StackAlloc_ScavengerStop(void);
+
+/**
+ * @brief       Registers a virtual arena with the scavenger
+ * @param[in]   sa  Pointer to a virtual stack allocator instance
+ * @return      STACK_ALLOC_OK on success, STACK_ALLOC_ERROR_INVALID_PARAM if sa is not
+ *              an unlocked virtual arena, is already registered or is grown by the guard
+ *              fault handler, STACK_ALLOC_ERROR_OUT_OF_MEMORY
+ * @note        StackAlloc_Deinit() unregisters the arena automatically
+ */
+TStack_alloc_error StackAlloc_ScavengeRegister(TStack_alloc* sa);
+
+/**
+ * @brief       Removes an arena from the scavenger
+ * @param[in]   sa  Pointer to a registered virtual arena (ignored if not registered)
+ * @note        A tail already decommitted stays decommitted and is committed again on demand
+ */
+void StackAlloc_ScavengeUnregister(TStack_alloc* sa);
+
+/**
+ * @brief       Runs one scavenger pass over all registered arenas on the calling thread
+ * @note        This is what the background thread does every period; it can also be
+ *              called directly, e.g. from an existing housekeeping thread
+ */
+void StackAlloc_ScavengeRun(void);
+
+/**
+ * @brief       Gets the total number of bytes the scavenger has decommitted
+ * @return      Decommitted bytes since program start
+ */
+TStack_alloc_size StackAlloc_ScavengerGetReleased(void);
+
+#endif /* STACK_ALLOC_SCAVENGE_H */
@@ -0,0 +1,138 @@
+/**
+ * @file        stack_alloc_tls.c
+ * @brief       Managed thread-local stack allocators
+ * @details     Thread arenas are virtual arenas stored directly in TLS. A pthread key
+ *              whose value points at the arena makes sure it is released on thread exit.
+ */
+
+/* ================================ Includes ================================ */
+#include "stack_alloc_tls.h"
+#include "stack_alloc_vm.h"
+#include "helper_routines.h"
+#include <pthread.h>
+
+/* =============================== Variables ================================ */
+STACK_ALLOC_THREAD_LOCAL TStack_alloc g_StackAlloc_tls_arena;
+
+static TStack_alloc_size g_tls_reserve_size = STACK_ALLOC_TLS_RESERVE_SIZE;
+static TStack_alloc_size g_tls_commit_step  = 0U;
+static uint32 g_tls_arena_count = 0U;
+
+static pthread_once_t g_tls_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t  g_tls_key;
+
+/**
+ * @brief       Releases a thread arena and marks it as not created
+ * @param[in]   sa  Arena of the thread
+ */
+static void ReleaseArena(TStack_alloc* sa)
+{
+    if (sa->buffer_start != NULL_PTR)
+    {
+        StackAlloc_Deinit(sa);
+        (void)__atomic_fetch_sub(&g_tls_arena_count, 1U, __ATOMIC_RELAXED);
+    }
+
+    (void)mem_set(sa, 0, sizeof(*sa));
+}
+
+/**
+ * @brief       pthread key destructor, runs when a thread with an arena exits
+ * @param[in]   arena  Arena of the exiting thread
+ */
+static void ThreadExit(void* arena)
+{
+    ReleaseArena((TStack_alloc*)arena);
+}
+
+static void CreateKey(void)
+{
+    (void)pthread_key_create(&g_tls_key, ThreadExit);
+}
+
+/**
+ * @brief       Sets the reservation and commit step of thread arenas created from now on
+ * @param[in]   reserve_size  Reservation of each arena in bytes, 0 for STACK_ALLOC_TLS_RESERVE_SIZE
+ * @param[in]   commit_step   Commit granularity in bytes, 0 for STACK_ALLOC_COMMIT_STEP
+ */
+void StackAlloc_TlsConfigure(TStack_alloc_size reserve_size, TStack_alloc_size commit_step)
+{
+    g_tls_reserve_size = (reserve_size != 0U) ? reserve_size : STACK_ALLOC_TLS_RESERVE_SIZE;
+    g_tls_commit_step  = commit_step;
+}
+
+/**
+ * @brief       Gets the arena of the calling thread, creating it if needed
+ * @return      Pointer to the thread's arena, or NULL_PTR if it could not be created
+ */
+TStack_alloc* StackAlloc_TlsGet(void)
+{
+    TStack_alloc* sa = &g_StackAlloc_tls_arena;
+
+    if (sa->buffer_start == NULL_PTR)
+    {
+        (void)pthread_once(&g_tls_key_once, CreateKey);
+
+        if (StackAlloc_InitVirtual(sa, g_tls_reserve_size, g_tls_commit_step) != STACK_ALLOC_OK)
+        {
+            (void)mem_set(sa, 0, sizeof(*sa));
+            return NULL_PTR;
+        }
+
+        /* A non-NULL key value makes the destructor run at thread exit */
+        (void)pthread_setspecific(g_tls_key, sa);
+        (void)__atomic_fetch_add(&g_tls_arena_count, 1U, __ATOMIC_RELAXED);
+    }
+
+    return sa;
+}
+
+/**
+ * @brief       Slow path of the thread-local fast path
+ * @param[in]   size       Number of bytes to allocate
+ * @param[in]   alignment  Required alignment in bytes (power of 2)
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ */
+void* StackAlloc_TlsAllocSlow(TStack_alloc_size size, TStack_alloc_size alignment)
+{
+    TStack_alloc* sa = StackAlloc_TlsGet();
+
+    if (sa == NULL_PTR)
+    {
+        return NULL_PTR;
+    }
+
+    return StackAlloc_AllocAligned(sa, size, alignment);
+}
+
+/**
+ * @brief       Frees everything allocated from the calling thread's arena
+ */
+void StackAlloc_TlsReset(void)
+{
+    if (g_StackAlloc_tls_arena.buffer_start != NULL_PTR)
+    {
+        StackAlloc_Reset(&g_StackAlloc_tls_arena);
+    }
+}
+
+/**
+ * @brief       Releases the calling thread's arena before the thread exits
+ */
+void StackAlloc_TlsRelease(void)
+{
+    if (g_StackAlloc_tls_arena.buffer_start != NULL_PTR)
+    {
+        (void)pthread_setspecific(g_tls_key, NULL_PTR);
+        ReleaseArena(&g_StackAlloc_tls_arena);
+    }
+}
+
+/**
+ * @brief       Gets the number of thread arenas that currently exist
+ * @return      Number of live thread arenas
+ */
+uint32 StackAlloc_TlsGetArenaCount(void)
+{
+    return __atomic_load_n(&g_tls_arena_count, __ATOMIC_RELAXED);
+}
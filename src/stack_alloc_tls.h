@@ -0,0 +1,109 @@
+/**
+ * @file        stack_alloc_tls.h
+ * @brief       Managed thread-local stack allocators
+ * @details     Every thread gets its own virtual arena, created lazily on its first
+ *              allocation and released when the thread exits. The arena lives in
+ *              initial-exec TLS, so the fast path below is a TLS-relative load plus a
+ *              bump, without any synchronisation.
+ *
+ * @note        An arena must only be used by the thread that owns it.
+ */
+
+#ifndef STACK_ALLOC_TLS_H
+#define STACK_ALLOC_TLS_H
+
+#include "stack_alloc_inline.h"
+
+/**
+ * @brief   Storage class for the per-thread arena (initial-exec TLS model)
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define STACK_ALLOC_THREAD_LOCAL    __thread __attribute__((tls_model("initial-exec")))
+#elif defined(_MSC_VER)
+#define STACK_ALLOC_THREAD_LOCAL    __declspec(thread)
+#else
+#define STACK_ALLOC_THREAD_LOCAL    _Thread_local
+#endif
+
+/**
+ * @brief   Arena of the calling thread (zero until the thread's first allocation)
+ * @note    Use StackAlloc_TlsGet() instead of accessing it directly
+ */
+extern STACK_ALLOC_THREAD_LOCAL TStack_alloc g_StackAlloc_tls_arena;
+
+/**
+ * @brief       Sets the reservation and commit step of thread arenas created from now on
+ * @param[in]   reserve_size  Reservation of each arena in bytes, 0 for STACK_ALLOC_TLS_RESERVE_SIZE
+ * @param[in]   commit_step   Commit granularity in bytes, 0 for STACK_ALLOC_COMMIT_STEP
+ * @note        Call before other threads start allocating; existing arenas keep their size
+ */
+void StackAlloc_TlsConfigure(TStack_alloc_size reserve_size, TStack_alloc_size commit_step);
+
+/**
+ * @brief       Slow path of the thread-local fast path
+ * @param[in]   size       Number of bytes to allocate
+ * @param[in]   alignment  Required alignment in bytes (power of 2)
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ * @note        Creates the calling thread's arena on first use; not meant to be called directly
+ */
+void* StackAlloc_TlsAllocSlow(TStack_alloc_size size, TStack_alloc_size alignment);
+
+/**
+ * @brief       Gets the arena of the calling thread, creating it if needed
+ * @return      Pointer to the thread's arena, or NULL_PTR if it could not be created
+ * @note        Use it with the regular API, e.g. for markers or StackAlloc_GetUsed()
+ */
+TStack_alloc* StackAlloc_TlsGet(void);
+
+/**
+ * @brief       Frees everything allocated from the calling thread's arena
+ * @note        Keeps the arena (and its committed pages) for further use
+ */
+void StackAlloc_TlsReset(void);
+
+/**
+ * @brief       Releases the calling thread's arena before the thread exits
+ * @note        The next thread-local allocation creates a fresh arena
+ */
+void StackAlloc_TlsRelease(void);
+
+/**
+ * @brief       Gets the number of thread arenas that currently exist
+ * @return      Number of live thread arenas
+ */
+uint32 StackAlloc_TlsGetArenaCount(void);
+
+/**
+ * @brief       Allocates from the calling thread's arena with a per-call alignment
+ * @param[in]   size       Number of bytes to allocate
+ * @param[in]   alignment  Required alignment in bytes (must be a power of 2, not checked)
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ */
+static inline void* StackAlloc_TlsAllocAligned(TStack_alloc_size size, TStack_alloc_size alignment)
+{
+    TStack_alloc* sa = &g_StackAlloc_tls_arena;
+    TStack_alloc_addr aligned = StackAlloc_AlignUp((TStack_alloc_addr)sa->current, alignment);
+    TStack_alloc_addr new_top = aligned + size;
+
+    /* An arena that does not exist yet has buffer_end == NULL_PTR and always fails here */
+    if (STACK_ALLOC_LIKELY((new_top > aligned) && (new_top <= (TStack_alloc_addr)sa->buffer_end)))
+    {
+        sa->current = (uint8*)new_top;
+        return (void*)aligned;
+    }
+
+    return StackAlloc_TlsAllocSlow(size, alignment);
+}
+
+/**
+ * @brief       Allocates from the calling thread's arena
+ * @param[in]   size  Number of bytes to allocate
+ * @return      Pointer to the allocated memory, or NULL_PTR on failure
+ * @note        The returned pointer is aligned to STACK_ALLOC_ALIGNMENT
+ */
+static inline void* StackAlloc_TlsAlloc(TStack_alloc_size size)
+{
+    return StackAlloc_TlsAllocAligned(size, STACK_ALLOC_ALIGNMENT);
+}
+
+#endif /* STACK_ALLOC_TLS_H */
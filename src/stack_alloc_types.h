@@ -7,13 +7,28 @@
 #ifndef STACK_ALLOC_TYPES_H
 #define STACK_ALLOC_TYPES_H
 
+#include <stddef.h>     /* For size_t */
+#include <stdint.h>     /* For uintptr_t, SIZE_MAX */
 #include "std_types.h"  /* For standard types */
+#include "stack_alloc_cfg.h"
 
-/* Define SIZE_MAX if not already defined */
-#ifndef SIZE_MAX
-    #define SIZE_MAX ((uint32)-1)  /* Maximum value for uint32 */
+/**
+ * @brief Size type used for buffer sizes, capacities and allocation requests
+ * @note  Selected by STACK_ALLOC_POINTER_WIDTH_SIZE in stack_alloc_cfg.h
+ */
+#if (STACK_ALLOC_POINTER_WIDTH_SIZE == 1U)
+typedef size_t TStack_alloc_size;
+#define STACK_ALLOC_SIZE_MAX                SIZE_MAX
+#else
+typedef uint32 TStack_alloc_size;
+#define STACK_ALLOC_SIZE_MAX                ((uint32)0xFFFFFFFFu)
 #endif
 
+/**
+ * @brief Integer type wide enough to hold any address (used for alignment arithmetic)
+ */
+typedef uintptr_t TStack_alloc_addr;
+
 /**
  * @brief Stack Allocator error codes
  */
@@ -29,14 +44,110 @@ typedef uint8 TStack_alloc_error;
 #define STACK_ALLOC_ERROR_INVALID_MARKER    (0x04u)  /**< Invalid marker or stack position */
 #define STACK_ALLOC_ERROR_NOT_LIFO          (0x05u)  /**< Free operation violates LIFO order */
 
+/**
+ * @brief Stack Allocator modes (how the arena obtains memory)
+ */
+typedef uint8 TStack_alloc_mode;
+
+#define STACK_ALLOC_MODE_FIXED              (0x00u)  /**< Single caller-provided buffer */
+#define STACK_ALLOC_MODE_CHAINED            (0x01u)  /**< Buffer extended with chunks from a provider */
+#define STACK_ALLOC_MODE_VIRTUAL            (0x02u)  /**< Reserved address range committed on demand */
+#define STACK_ALLOC_MODE_DOWN               (0x03u)  /**< Single caller-provided buffer, filled from the end */
+#define STACK_ALLOC_MODE_MEASURE            (0x04u)  /**< No memory: allocations are only measured */
+
+/**
+ * @brief Kind of pages backing a virtual-memory arena
+ */
+typedef uint8 TStack_alloc_page_kind;
+
+#define STACK_ALLOC_PAGES_DEFAULT           (0x00u)  /**< Regular (base size) pages */
+#define STACK_ALLOC_PAGES_HUGETLB           (0x01u)  /**< Explicit huge pages (MAP_HUGETLB) */
+#define STACK_ALLOC_PAGES_THP               (0x02u)  /**< Transparent huge pages (MADV_HUGEPAGE) */
+
+/**
+ * @brief How a virtual-memory arena gives unused pages back when it is rewound
+ */
+typedef uint8 TStack_alloc_release_mode;
+
+#define STACK_ALLOC_RELEASE_NONE            (0x00u)  /**< Keep every page resident */
+#define STACK_ALLOC_RELEASE_DONTNEED        (0x01u)  /**< Drop pages now (MADV_DONTNEED), they refault as zero */
+#define STACK_ALLOC_RELEASE_FREE            (0x02u)  /**< Let the kernel reclaim pages lazily (MADV_FREE) */
+
+/**
+ * @brief Backing memory provider for growable arenas
+ * @details acquire() returns a block of at least size bytes aligned to
+ *          STACK_ALLOC_ALIGNMENT (or NULL_PTR); release() gives it back.
+ */
+typedef struct {
+    void* (*acquire)(void* ctx, TStack_alloc_size size);          /**< Obtain a block of memory */
+    void  (*release)(void* ctx, void* block, TStack_alloc_size size); /**< Return a block of memory */
+    void* ctx;                                                     /**< Opaque provider context */
+} TStack_alloc_provider;
+
+/**
+ * @brief Header placed at the start of every chunk of a chained arena
+ */
+typedef struct TStack_alloc_chunk_tag {
+    struct TStack_alloc_chunk_tag* prev;  /**< Chunk below this one (NULL_PTR: initial buffer) */
+    uint8* prev_current;                  /**< Top of the region below when this chunk was entered */
+    TStack_alloc_size size;               /**< Size of the chunk in bytes, header included */
+} TStack_alloc_chunk;
+
+/**
+ * @brief What a measuring arena has seen since it was initialized
+ */
+typedef struct {
+    TStack_alloc_size peak;           /**< Largest StackAlloc_GetUsed() reached, padding included */
+    TStack_alloc_size requested;      /**< Bytes asked for, summed over all allocations */
+    TStack_alloc_size padding;        /**< Alignment padding, summed over all allocations */
+    TStack_alloc_size max_alignment;  /**< Largest alignment requested */
+    uint32 allocations;               /**< Number of successful allocations */
+} TStack_alloc_measure;
+
+struct TStack_alloc_scavenge_tag;
+
 /**
  * @brief Internal structure for the stack allocator
+ * @note  buffer_start/buffer_end/current always describe the region being bumped
+ *        (the initial buffer or the active chunk), so the fast path never needs
+ *        to know the mode.
  */
 typedef struct {
-    uint8* buffer_start;  /**< Start of the entire memory region */
-    uint8* buffer_end;    /**< End of the entire memory region (one past the last byte) */
+    uint8* buffer_start;  /**< Start of the active memory region */
+    uint8* buffer_end;    /**< End of the active memory region (one past the last byte) */
     uint8* current;       /**< Pointer to the current top of the stack */
-    uint32 capacity;      /**< Total size of the buffer in bytes */
+    TStack_alloc_size capacity;  /**< Total size of all memory backing the arena in bytes */
+    TStack_alloc_mode mode;      /**< How the arena obtains memory (STACK_ALLOC_MODE_*) */
+    uint8* zero_start;    /**< Memory from here to the end of the region was never handed out
+                               and is known to be zero (updated lazily, see StackAlloc_NoteDirty()) */
+
+    /* Chained mode only */
+    uint8* base_start;               /**< Start of the initial buffer */
+    uint8* base_end;                 /**< End of the initial buffer */
+    TStack_alloc_chunk* chunk;       /**< Active chunk, NULL_PTR while in the initial buffer */
+    TStack_alloc_chunk* spare;       /**< Cached chunk kept for reuse after rewinding */
+    TStack_alloc_size used_below;    /**< Bytes in use in the regions below the active one */
+    TStack_alloc_size chunk_size;    /**< Minimum size of a newly acquired chunk */
+    TStack_alloc_provider provider;  /**< Source of additional chunks */
+
+    /* Virtual mode only (buffer_end is the end of the committed part) */
+    uint8* reserve_end;              /**< End of the reserved address range */
+    TStack_alloc_size commit_step;   /**< Granularity of commits in bytes (power-of-2 page multiple) */
+    TStack_alloc_page_kind page_kind; /**< Pages actually backing the range */
+    boolean locked;                  /**< Whole range is committed and locked in RAM */
+    TStack_alloc_size guard_size;    /**< Inaccessible guard reserved after reserve_end */
+    boolean fault_grow;              /**< Registered with the fault handler (StackAlloc_GuardRegister()) */
+    TStack_alloc_release_mode release_mode; /**< Page release policy applied when rewinding */
+    TStack_alloc_size release_keep;  /**< Bytes at the start of the range that stay resident */
+    struct TStack_alloc_scavenge_tag* scavenge; /**< Background scavenger record, NULL_PTR if not registered */
+
+    /* Downward mode only (buffer_end equals buffer_start so that the upward fast path
+       always defers to StackAlloc_AllocSlow()) */
+    uint8* top_end;                  /**< End of the buffer rounded down to STACK_ALLOC_ALIGNMENT */
+
+    /* Measuring mode only (buffer_end equals buffer_start for the same reason; the
+       addresses are never dereferenced) */
+    TStack_alloc_measure measure;    /**< Statistics collected by StackAlloc_AllocSlow() */
 } TStack_alloc;
 
 #endif /* STACK_ALLOC_TYPES_H */
\ No newline at end of file
@@ -0,0 +1,620 @@
+/**
+ * @file        stack_alloc_vm.c
+ * @brief       Virtual-memory (reserve/commit) stack allocator implementation
+ * @details     The whole range is reserved inaccessible at init. buffer_end marks the
+ *              end of the committed part, so the inline fast path bumps through
+ *              committed memory unchanged and only the slow path commits more.
+ */
+
+/* ================================ Includes ================================ */
+#include "stack_alloc_vm.h"
+#include "stack_alloc_scavenge.h"
+#include "stack_alloc_guard.h"
+#include "stack_alloc_internal.h"
+#include "helper_routines.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#endif
+
+/* ============================ OS abstraction ============================= */
+
+/**
+ * @brief       Reserves an inaccessible address range
+ * @param[in]   size  Size in bytes (page multiple)
+ * @return      Start of the range, or NULL_PTR on failure
+ */
+static void* OsReserve(TStack_alloc_size size)
+{
+#if defined(_WIN32)
+    return VirtualAlloc(NULL_PTR, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    void* range = mmap(NULL_PTR, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return (range != MAP_FAILED) ? range : NULL_PTR;
+#endif
+}
+
+/**
+ * @brief       Checks whether transparent huge pages can be requested with madvise()
+ * @return      TRUE unless THP is missing or set to "never"
+ */
+static boolean OsThpAvailable(void)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    char mode[64] = { 0 };
+    FILE* file = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+
+    if (file == NULL_PTR)
+    {
+        return FALSE;
+    }
+    boolean read_ok = (fgets(mode, (int)sizeof(mode), file) != NULL_PTR) ? TRUE : FALSE;
+    (void)fclose(file);
+
+    return ((read_ok == TRUE) && (strstr(mode, "[never]") == NULL_PTR)) ? TRUE : FALSE;
+#else
+    return FALSE;
+#endif
+}
+
+/**
+ * @brief       Reserves an inaccessible address range backed by huge pages if possible
+ * @param[in]   size  Size in bytes (multiple of STACK_ALLOC_HUGE_PAGE_SIZE)
+ * @param[out]  kind  Kind of pages actually obtained
+ * @return      Start of the range, or NULL_PTR on failure
+ */
+static void* OsReserveHuge(TStack_alloc_size size, TStack_alloc_page_kind* kind)
+{
+#if defined(__linux__)
+#if defined(MAP_HUGETLB)
+    /* Explicit huge pages: the pool reserves them at mmap time, so later commits cannot fail */
+    void* range = mmap(NULL_PTR, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (range != MAP_FAILED)
+    {
+        *kind = STACK_ALLOC_PAGES_HUGETLB;
+        return range;
+    }
+#endif
+#if defined(MADV_HUGEPAGE)
+    /* Transparent huge pages: over-reserve, trim to a huge page boundary and advise */
+    if ((OsThpAvailable() == TRUE) && (size <= (STACK_ALLOC_SIZE_MAX - STACK_ALLOC_HUGE_PAGE_SIZE)))
+    {
+        TStack_alloc_size over = size + STACK_ALLOC_HUGE_PAGE_SIZE;
+        uint8* raw = (uint8*)mmap(NULL_PTR, over, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if ((void*)raw != MAP_FAILED)
+        {
+            uint8* aligned = (uint8*)StackAlloc_AlignUp((TStack_alloc_addr)raw, STACK_ALLOC_HUGE_PAGE_SIZE);
+            TStack_alloc_size head = (TStack_alloc_size)(aligned - raw);
+
+            if (head != 0U)
+            {
+                (void)munmap(raw, head);
+            }
+            if ((over - head - size) != 0U)
+            {
+                (void)munmap(aligned + size, over - head - size);
+            }
+
+            *kind = (madvise(aligned, size, MADV_HUGEPAGE) == 0) ? STACK_ALLOC_PAGES_THP : STACK_ALLOC_PAGES_DEFAULT;
+            return aligned;
+        }
+    }
+#endif
+#endif
+
+    /* Huge pages are not available: fall back to regular pages */
+    *kind = STACK_ALLOC_PAGES_DEFAULT;
+    return OsReserve(size);
+}
+
+/**
+ * @brief       Makes part of a reserved range readable and writable
+ * @param[in]   start  Start of the part (page aligned)
+ * @param[in]   size   Size in bytes (page multiple)
+ * @return      TRUE on success, FALSE otherwise
+ */
+static boolean OsCommit(void* start, TStack_alloc_size size)
+{
+#if defined(_WIN32)
+    return (VirtualAlloc(start, size, MEM_COMMIT, PAGE_READWRITE) != NULL_PTR) ? TRUE : FALSE;
+#else
+    return (mprotect(start, size, PROT_READ | PROT_WRITE) == 0) ? TRUE : FALSE;
+#endif
+}
+
+/**
+ * @brief       Faults in the pages of a committed range without changing their contents
+ * @param[in]   start  Start of the range
+ * @param[in]   size   Size in bytes
+ * @return      TRUE on success, FALSE if the pages could not be populated
+ */
+static boolean OsPopulate(uint8* start, TStack_alloc_size size)
+{
+    TStack_alloc_addr page = StackAlloc_GetPageSize();
+
+#if defined(__linux__) && defined(MADV_POPULATE_WRITE)
+    TStack_alloc_addr first = (TStack_alloc_addr)start & ~(page - 1U);
+    if (madvise((void*)first, (size_t)(((TStack_alloc_addr)start + size) - first), MADV_POPULATE_WRITE) == 0)
+    {
+        return TRUE;
+    }
+    if (errno != EINVAL)
+    {
+        /* ENOMEM/EFAULT: the memory is really not there (EINVAL: kernel before 5.14) */
+        return FALSE;
+    }
+#endif
+
+    /* Write every page back to itself */
+    volatile uint8* cursor = start;
+    while (cursor < (start + size))
+    {
+        *cursor = *cursor;
+        cursor = (volatile uint8*)(((TStack_alloc_addr)cursor + page) & ~(page - 1U));
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief       Locks a committed range in RAM
+ * @param[in]   start  Start of the range (page aligned)
+ * @param[in]   size   Size in bytes (page multiple)
+ * @return      TRUE on success, FALSE if the lock limit would be exceeded
+ */
+static boolean OsLock(void* start, TStack_alloc_size size)
+{
+#if defined(_WIN32)
+    return (VirtualLock(start, size) != 0) ? TRUE : FALSE;
+#else
+    return (mlock(start, size) == 0) ? TRUE : FALSE;
+#endif
+}
+
+/**
+ * @brief       Releases a whole reserved range
+ * @param[in]   start  Start of the range
+ * @param[in]   size   Size of the range in bytes
+ */
+static void OsRelease(void* start, TStack_alloc_size size)
+{
+#if defined(_WIN32)
+    (void)size;
+    (void)VirtualFree(start, 0, MEM_RELEASE);
+#else
+    (void)munmap(start, size);
+#endif
+}
+
+/**
+ * @brief       Gives the physical pages of a committed range back to the OS
+ * @param[in]   start  Start of the range (page aligned)
+ * @param[in]   size   Size of the range in bytes (page multiple)
+ * @param[in]   mode   STACK_ALLOC_RELEASE_DONTNEED or STACK_ALLOC_RELEASE_FREE
+ * @return      TRUE if the range now reads as zero, FALSE if its contents are undefined
+ * @note        The range stays committed and accessible in every case
+ */
+static boolean OsDiscard(void* start, TStack_alloc_size size, TStack_alloc_release_mode mode)
+{
+#if defined(_WIN32)
+    (void)mode;
+    (void)VirtualAlloc(start, size, MEM_RESET, PAGE_READWRITE);
+    return FALSE;
+#else
+#if defined(MADV_FREE)
+    if ((mode == STACK_ALLOC_RELEASE_FREE) && (madvise(start, size, MADV_FREE) == 0))
+    {
+        return FALSE;
+    }
+#else
+    (void)mode;
+#endif
+    /* Falls back here on kernels without MADV_FREE (EINVAL) */
+    if (madvise(start, size, MADV_DONTNEED) != 0)
+    {
+        return FALSE;
+    }
+#if defined(__linux__)
+    /* Only Linux guarantees zero-filled pages on the next touch */
+    return TRUE;
+#else
+    return FALSE;
+#endif
+#endif
+}
+
+boolean StackAlloc_VmDecommit(void* start, TStack_alloc_size size)
+{
+#if defined(_WIN32)
+    return (VirtualFree(start, size, MEM_DECOMMIT) != 0) ? TRUE : FALSE;
+#else
+    boolean zeroed = OsDiscard(start, size, STACK_ALLOC_RELEASE_DONTNEED);
+    (void)mprotect(start, size, PROT_NONE);
+    return zeroed;
+#endif
+}
+
+/**
+ * @brief       Gets the system page size
+ * @return      Page size in bytes
+ */
+TStack_alloc_size StackAlloc_GetPageSize(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (TStack_alloc_size)info.dwPageSize;
+#else
+    return (TStack_alloc_size)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+/* ============================== Allocator =============================== */
+
+/**
+ * @brief       Rounds a size up to a multiple of a power-of-two granule
+ * @param[in]   size     Size in bytes
+ * @param[in]   granule  Granule in bytes (power of 2)
+ * @return      Rounded size, or 0 on overflow
+ */
+static TStack_alloc_size RoundUp(TStack_alloc_size size, TStack_alloc_size granule)
+{
+    if (size > (STACK_ALLOC_SIZE_MAX - (granule - 1U)))
+    {
+        return 0U;
+    }
+    return (size + (granule - 1U)) & ~(granule - 1U);
+}
+
+/**
+ * @brief       Rounds a size up to a power of two
+ * @param[in]   size  Size in bytes
+ * @return      Smallest power of 2 not below size, or 0 if size is 0 or on overflow
+ */
+static TStack_alloc_size RoundUpPowerOfTwo(TStack_alloc_size size)
+{
+    TStack_alloc_size pow = 1U;
+
+    if (size == 0U)
+    {
+        return 0U;
+    }
+    while (pow < size)
+    {
+        if (pow > (STACK_ALLOC_SIZE_MAX / 2U))
+        {
+            return 0U;
+        }
+        pow <<= 1U;
+    }
+    return pow;
+}
+
+void* StackAlloc_VmGrow(TStack_alloc* sa, TStack_alloc_size size, TStack_alloc_size alignment)
+{
+    TStack_alloc_addr aligned = StackAlloc_AlignUp((TStack_alloc_addr)sa->current, alignment);
+    TStack_alloc_addr reserve_end = (TStack_alloc_addr)sa->reserve_end;
+
+    /* A tail above buffer_end may still be with the scavenger; if it comes back
+       committed the request may fit already */
+    if (sa->scavenge != NULL_PTR)
+    {
+        StackAlloc_ScavengeReclaim(sa);
+        if ((aligned <= (TStack_alloc_addr)sa->buffer_end) && (size <= ((TStack_alloc_addr)sa->buffer_end - aligned)))
+        {
+            return StackAlloc_AllocAlignedInline(sa, size, alignment);
+        }
+    }
+
+    /* The request must fit in the reserved range */
+    if ((aligned > reserve_end) || (size > (reserve_end - aligned)))
+    {
+        return NULL_PTR;
+    }
+
+    /* Commit whole steps up to the new top, but never past the reservation */
+    TStack_alloc_addr commit_end = StackAlloc_AlignUp(aligned + size, sa->commit_step);
+    if ((commit_end > reserve_end) || (commit_end < aligned))
+    {
+        commit_end = reserve_end;
+    }
+
+    uint8* commit_start = sa->buffer_end;
+    if (OsCommit(commit_start, (TStack_alloc_size)((uint8*)commit_end - commit_start)) == FALSE)
+    {
+        return NULL_PTR;
+    }
+    sa->buffer_end = (uint8*)commit_end;
+
+    /* Guaranteed to fit */
+    return StackAlloc_AllocAlignedInline(sa, size, alignment);
+}
+
+void StackAlloc_VmReleaseUnused(TStack_alloc* sa)
+{
+    /* Huge pages can only be dropped whole (hugetlb) or without splitting them (THP) */
+    TStack_alloc_addr page = (sa->page_kind != STACK_ALLOC_PAGES_DEFAULT) ?
+                             STACK_ALLOC_HUGE_PAGE_SIZE : StackAlloc_GetPageSize();
+    TStack_alloc_addr start = (TStack_alloc_addr)sa->buffer_start;
+    TStack_alloc_addr keep  = (sa->release_keep < (TStack_alloc_size)(sa->reserve_end - sa->buffer_start)) ?
+                              start + sa->release_keep : (TStack_alloc_addr)sa->reserve_end;
+    TStack_alloc_addr low   = ((TStack_alloc_addr)sa->current > keep) ? (TStack_alloc_addr)sa->current : keep;
+
+    /* Only pages below the high-water mark were ever touched. buffer_end is a commit
+       step (page multiple) from the start; a tail above it belongs to the scavenger. */
+    low = StackAlloc_AlignUp(low, page);
+    TStack_alloc_addr high = StackAlloc_AlignUp((TStack_alloc_addr)sa->zero_start, page);
+    boolean whole = TRUE;
+    if (high > (TStack_alloc_addr)sa->buffer_end)
+    {
+        high  = (TStack_alloc_addr)sa->buffer_end;
+        whole = FALSE;
+    }
+
+    if ((high <= low) || ((high - low) < STACK_ALLOC_RELEASE_MIN_SIZE))
+    {
+        return;
+    }
+
+    if ((OsDiscard((void*)low, (TStack_alloc_size)(high - low), sa->release_mode) == TRUE) && (whole == TRUE))
+    {
+        /* Everything from low up is zero again, so Calloc can skip it */
+        sa->zero_start = (uint8*)low;
+    }
+}
+
+/**
+ * @brief       Sets the policy for returning unused pages to the OS when rewinding
+ * @param[in]   sa         Pointer to a virtual stack allocator instance
+ * @param[in]   mode       STACK_ALLOC_RELEASE_NONE, _DONTNEED or _FREE
+ * @param[in]   keep_size  Bytes at the start of the range that always stay resident
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_SetReleasePolicy(TStack_alloc* sa, TStack_alloc_release_mode mode,
+                                               TStack_alloc_size keep_size)
+{
+    /* Only ranges the allocator mapped itself are known to be anonymous memory */
+    if ((sa == NULL_PTR) || (sa->mode != STACK_ALLOC_MODE_VIRTUAL) || (sa->buffer_start == NULL_PTR) ||
+        (sa->locked == TRUE) || (mode > STACK_ALLOC_RELEASE_FREE))
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    sa->release_mode = mode;
+    sa->release_keep = keep_size;
+
+    return STACK_ALLOC_OK;
+}
+
+/**
+ * @brief       Gets the number of bytes of an arena that are resident in RAM
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @return      Resident bytes of the active region, or 0 if sa is NULL_PTR
+ */
+TStack_alloc_size StackAlloc_GetResident(const TStack_alloc* sa)
+{
+    if ((sa == NULL_PTR) || (sa->buffer_start == NULL_PTR))
+    {
+        return 0U;
+    }
+
+#if defined(__linux__)
+    TStack_alloc_size page = StackAlloc_GetPageSize();
+    TStack_alloc_addr first = (TStack_alloc_addr)sa->buffer_start & ~(TStack_alloc_addr)(page - 1U);
+    TStack_alloc_size page_count = (TStack_alloc_size)(((TStack_alloc_addr)sa->buffer_end - first + (page - 1U)) / page);
+    TStack_alloc_size resident = 0U;
+
+    unsigned char* vec = (page_count != 0U) ? (unsigned char*)malloc(page_count) : NULL_PTR;
+    if ((vec != NULL_PTR) && (mincore((void*)first, page_count * page, vec) == 0))
+    {
+        for (TStack_alloc_size i = 0U; i < page_count; i++)
+        {
+            resident += (TStack_alloc_size)(vec[i] & 1U);
+        }
+        free(vec);
+        return resident * page;
+    }
+    free(vec);
+#endif
+
+    return StackAlloc_GetCommitted(sa);
+}
+
+boolean StackAlloc_VmCommitFault(TStack_alloc* sa, const uint8* address)
+{
+    if ((address < sa->buffer_end) || (address >= sa->reserve_end))
+    {
+        return FALSE;
+    }
+
+    TStack_alloc_addr commit_end = StackAlloc_AlignUp((TStack_alloc_addr)address + 1U, sa->commit_step);
+    if ((commit_end > (TStack_alloc_addr)sa->reserve_end) || (commit_end <= (TStack_alloc_addr)address))
+    {
+        commit_end = (TStack_alloc_addr)sa->reserve_end;
+    }
+
+    if (OsCommit(sa->buffer_end, (TStack_alloc_size)((uint8*)commit_end - sa->buffer_end)) == FALSE)
+    {
+        return FALSE;
+    }
+    sa->buffer_end = (uint8*)commit_end;
+
+    return TRUE;
+}
+
+void StackAlloc_VmDeinit(TStack_alloc* sa)
+{
+    if (sa->scavenge != NULL_PTR)
+    {
+        StackAlloc_ScavengeUnregister(sa);
+    }
+
+    if (sa->fault_grow == TRUE)
+    {
+        StackAlloc_GuardUnregister(sa);
+    }
+
+    if (sa->buffer_start != NULL_PTR)
+    {
+        OsRelease(sa->buffer_start, (TStack_alloc_size)(sa->reserve_end - sa->buffer_start) + sa->guard_size);
+    }
+
+    /* Leave an empty, unusable arena behind */
+    sa->buffer_start = NULL_PTR;
+    sa->buffer_end   = NULL_PTR;
+    sa->reserve_end  = NULL_PTR;
+    sa->current      = NULL_PTR;
+    sa->zero_start   = NULL_PTR;
+    sa->capacity     = 0U;
+}
+
+/**
+ * @brief       Initializes a stack allocator over a reserved virtual address range
+ * @param[in]   sa            Pointer to the stack allocator instance to initialize
+ * @param[in]   reserve_size  Size of the address range to reserve in bytes
+ * @param[in]   commit_step   Commit granularity in bytes, 0 for STACK_ALLOC_COMMIT_STEP
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_InitVirtual(TStack_alloc* sa, TStack_alloc_size reserve_size,
+                                          TStack_alloc_size commit_step)
+{
+    return StackAlloc_InitVirtualEx(sa, reserve_size, commit_step, STACK_ALLOC_VM_DEFAULT);
+}
+
+/**
+ * @brief       Initializes a virtual-memory stack allocator with options
+ * @param[in]   sa            Pointer to the stack allocator instance to initialize
+ * @param[in]   reserve_size  Size of the address range to reserve in bytes
+ * @param[in]   commit_step   Commit granularity in bytes, 0 for STACK_ALLOC_COMMIT_STEP
+ * @param[in]   flags         Combination of STACK_ALLOC_VM_* flags
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_InitVirtualEx(TStack_alloc* sa, TStack_alloc_size reserve_size,
+                                            TStack_alloc_size commit_step, TStack_alloc_vm_flags flags)
+{
+    boolean huge = ((flags & STACK_ALLOC_VM_HUGE_PAGES) != 0U) ? TRUE : FALSE;
+    TStack_alloc_size page = (huge == TRUE) ? STACK_ALLOC_HUGE_PAGE_SIZE : StackAlloc_GetPageSize();
+    TStack_alloc_page_kind kind = STACK_ALLOC_PAGES_DEFAULT;
+
+    /* Check for NULL pointers and an empty reservation */
+    if ((sa == NULL_PTR) || (reserve_size == 0U))
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    reserve_size = RoundUp(reserve_size, page);
+    /* Commits round their end up with a mask, so the step must be a power of 2 */
+    commit_step  = RoundUpPowerOfTwo(RoundUp((commit_step != 0U) ? commit_step : STACK_ALLOC_COMMIT_STEP, page));
+    TStack_alloc_size guard = ((flags & STACK_ALLOC_VM_GUARD) != 0U) ? RoundUp(STACK_ALLOC_GUARD_SIZE, page) : 0U;
+    if ((reserve_size == 0U) || (commit_step == 0U) || (reserve_size > (STACK_ALLOC_SIZE_MAX - guard)))
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    /* The guard is reserved with the range but never committed */
+    uint8* range = (huge == TRUE) ? (uint8*)OsReserveHuge(reserve_size + guard, &kind) :
+                                    (uint8*)OsReserve(reserve_size + guard);
+    if (range == NULL_PTR)
+    {
+        return STACK_ALLOC_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* Nothing is committed yet: the first allocation takes the slow path */
+    (void)mem_set(sa, 0, sizeof(*sa));
+    sa->mode         = STACK_ALLOC_MODE_VIRTUAL;
+    sa->buffer_start = range;
+    sa->buffer_end   = range;
+    sa->current      = range;
+    sa->zero_start   = range;    /* Fresh anonymous memory reads as zero */
+    sa->reserve_end  = range + reserve_size;
+    sa->capacity     = reserve_size;
+    sa->commit_step  = commit_step;
+    sa->page_kind    = kind;
+    sa->guard_size   = guard;
+
+    if ((flags & (STACK_ALLOC_VM_PREFAULT | STACK_ALLOC_VM_LOCKED)) != 0U)
+    {
+        /* Back the whole range now so that no allocation ever faults */
+        TStack_alloc_error err = STACK_ALLOC_ERROR_OUT_OF_MEMORY;
+        if (OsCommit(range, reserve_size) == TRUE)
+        {
+            sa->buffer_end = sa->reserve_end;
+            if ((flags & STACK_ALLOC_VM_LOCKED) != 0U)
+            {
+                /* mlock() faults the pages in as well */
+                sa->locked = OsLock(range, reserve_size);
+                err = (sa->locked == TRUE) ? STACK_ALLOC_OK : STACK_ALLOC_ERROR_OUT_OF_MEMORY;
+            }
+            else
+            {
+                err = StackAlloc_Prefault(sa);
+            }
+        }
+
+        if (err != STACK_ALLOC_OK)
+        {
+            StackAlloc_VmDeinit(sa);
+            return err;
+        }
+    }
+
+    return STACK_ALLOC_OK;
+}
+
+/**
+ * @brief       Faults in every page of the active region of an arena
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @return      STACK_ALLOC_OK on success, error code otherwise
+ */
+TStack_alloc_error StackAlloc_Prefault(TStack_alloc* sa)
+{
+    if ((sa == NULL_PTR) || (sa->buffer_start == NULL_PTR))
+    {
+        return STACK_ALLOC_ERROR_INVALID_PARAM;
+    }
+
+    TStack_alloc_size size = (TStack_alloc_size)(sa->buffer_end - sa->buffer_start);
+    if ((size != 0U) && (OsPopulate(sa->buffer_start, size) == FALSE))
+    {
+        return STACK_ALLOC_ERROR_OUT_OF_MEMORY;
+    }
+
+    return STACK_ALLOC_OK;
+}
+
+/**
+ * @brief       Gets the number of bytes currently backed by memory
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @return      Committed bytes, or 0 if sa is NULL_PTR
+ */
+TStack_alloc_size StackAlloc_GetCommitted(const TStack_alloc* sa)
+{
+    if (sa == NULL_PTR)
+    {
+        return 0U;
+    }
+
+    if (sa->mode == STACK_ALLOC_MODE_VIRTUAL)
+    {
+        return (TStack_alloc_size)(sa->buffer_end - sa->buffer_start);
+    }
+
+    return sa->capacity;
+}
+
+/**
+ * @brief       Gets the kind of pages backing a virtual-memory arena
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @return      Kind of pages, STACK_ALLOC_PAGES_DEFAULT if sa is NULL_PTR
+ */
+TStack_alloc_page_kind StackAlloc_GetPageKind(const TStack_alloc* sa)
+{
+    return (sa != NULL_PTR) ? sa->page_kind : STACK_ALLOC_PAGES_DEFAULT;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file        stack_alloc_vm.h
+ * @brief       Virtual-memory (reserve/commit) stack allocator API
+ * @details     A virtual arena reserves a large contiguous address range up front
+ *              without backing it, and commits pages in steps as the stack grows.
+ *              Pointers never move, and memory that is never reached is never touched.
+ *
+ * @note        This implementation is not thread-safe.
+ */
+
+#ifndef STACK_ALLOC_VM_H
+#define STACK_ALLOC_VM_H
+
+#include "stack_alloc.h"
+
+/**
+ * @brief Option flags for StackAlloc_InitVirtualEx()
+ */
+typedef uint32 TStack_alloc_vm_flags;
+
+#define STACK_ALLOC_VM_DEFAULT          (0x00000000u)  /**< Regular pages, commit on demand */
+#define STACK_ALLOC_VM_HUGE_PAGES       (0x00000001u)  /**< Back the range with 2 MiB pages if possible */
+#define STACK_ALLOC_VM_PREFAULT         (0x00000002u)  /**< Commit and fault in the whole range at init */
+#define STACK_ALLOC_VM_LOCKED           (0x00000004u)  /**< Like PREFAULT, and lock the range in RAM (mlock) */
+#define STACK_ALLOC_VM_GUARD            (0x00000008u)  /**< Keep STACK_ALLOC_GUARD_SIZE inaccessible after the range */
+
+/**
+ * @brief       Initializes a stack allocator over a reserved virtual address range
+ * @param[in]   sa            Pointer to the stack allocator instance to initialize
+ * @param[in]   reserve_size  Size of the address range to reserve in bytes
+ * @param[in]   commit_step   Commit granularity in bytes, 0 for STACK_ALLOC_COMMIT_STEP
+ * @return      Error code indicating success or failure
+ * @retval      STACK_ALLOC_OK if initialization was successful
+ * @retval      STACK_ALLOC_ERROR_INVALID_PARAM if sa is NULL or reserve_size is 0
+ * @retval      STACK_ALLOC_ERROR_OUT_OF_MEMORY if the range could not be reserved
+ * @note        Both sizes are rounded up to the system page size, and commit_step further
+ *              up to a power of 2. Release the range with StackAlloc_Deinit()
+ */
+TStack_alloc_error StackAlloc_InitVirtual(TStack_alloc* sa, TStack_alloc_size reserve_size,
+                                          TStack_alloc_size commit_step);
+
+/**
+ * @brief       Initializes a virtual-memory stack allocator with options
+ * @param[in]   sa            Pointer to the stack allocator instance to initialize
+ * @param[in]   reserve_size  Size of the address range to reserve in bytes
+ * @param[in]   commit_step   Commit granularity in bytes, 0 for STACK_ALLOC_COMMIT_STEP
+ * @param[in]   flags         Combination of STACK_ALLOC_VM_* flags
+ * @return      Error code indicating success or failure (see StackAlloc_InitVirtual())
+ * @note        With STACK_ALLOC_VM_HUGE_PAGES the range is first requested from the
+ *              hugetlb pool (MAP_HUGETLB). If the pool cannot hold it, a 2 MiB aligned
+ *              range is advised for transparent huge pages (MADV_HUGEPAGE), and if THP
+ *              is disabled regular pages are used. Sizes are rounded to
+ *              STACK_ALLOC_HUGE_PAGE_SIZE; StackAlloc_GetPageKind() tells what was obtained
+ * @note        STACK_ALLOC_VM_PREFAULT and STACK_ALLOC_VM_LOCKED trade lazy commit for
+ *              fault-free allocation: the whole reservation is committed and populated
+ *              up front, so size it to the real bound. Locking fails with
+ *              STACK_ALLOC_ERROR_OUT_OF_MEMORY beyond RLIMIT_MEMLOCK, and locked arenas
+ *              accept neither a release policy nor the scavenger
+ */
+TStack_alloc_error StackAlloc_InitVirtualEx(TStack_alloc* sa, TStack_alloc_size reserve_size,
+                                            TStack_alloc_size commit_step, TStack_alloc_vm_flags flags);
+
+/**
+ * @brief       Gets the kind of pages backing a virtual-memory arena
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @return      STACK_ALLOC_PAGES_DEFAULT, STACK_ALLOC_PAGES_HUGETLB or STACK_ALLOC_PAGES_THP
+ * @note        Arenas over caller-provided or chunked memory report STACK_ALLOC_PAGES_DEFAULT
+ */
+TStack_alloc_page_kind StackAlloc_GetPageKind(const TStack_alloc* sa);
+
+/**
+ * @brief       Gets the number of bytes currently backed by memory
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @return      Committed bytes, or 0 if sa is NULL_PTR
+ * @note        For a virtual arena StackAlloc_GetCapacity() reports the reserved size
+ *              and this function the committed part of it; for other modes both match
+ */
+TStack_alloc_size StackAlloc_GetCommitted(const TStack_alloc* sa);
+
+/**
+ * @brief       Faults in every page of the active region of an arena
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @return      STACK_ALLOC_OK on success, STACK_ALLOC_ERROR_INVALID_PARAM if sa is NULL
+ *              or empty, STACK_ALLOC_ERROR_OUT_OF_MEMORY if the pages could not be populated
+ * @note        Contents are preserved. For a virtual arena only the committed part is
+ *              populated; use STACK_ALLOC_VM_PREFAULT to cover the whole reservation.
+ *              Uses MADV_POPULATE_WRITE where available, otherwise writes each page
+ */
+TStack_alloc_error StackAlloc_Prefault(TStack_alloc* sa);
+
+/**
+ * @brief       Sets the policy for returning unused pages to the OS when rewinding
+ * @param[in]   sa         Pointer to a virtual stack allocator instance
+ * @param[in]   mode       STACK_ALLOC_RELEASE_NONE, _DONTNEED or _FREE
+ * @param[in]   keep_size  Bytes at the start of the range that always stay resident
+ * @return      STACK_ALLOC_OK on success, STACK_ALLOC_ERROR_INVALID_PARAM if sa is not
+ *              an unlocked virtual arena or mode is unknown
+ * @note        StackAlloc_Reset() and StackAlloc_FreeToMarker() then release the whole
+ *              pages between max(new top, keep_size) and the high-water mark, if that
+ *              span is at least STACK_ALLOC_RELEASE_MIN_SIZE. Pages stay committed, so
+ *              growing again only costs page faults. After MADV_DONTNEED the released
+ *              pages read as zero and the known-zero watermark moves down with them;
+ *              MADV_FREE is cheaper but leaves their contents undefined
+ */
+TStack_alloc_error StackAlloc_SetReleasePolicy(TStack_alloc* sa, TStack_alloc_release_mode mode,
+                                               TStack_alloc_size keep_size);
+
+/**
+ * @brief       Gets the number of bytes of an arena that are resident in RAM
+ * @param[in]   sa  Pointer to the stack allocator instance
+ * @return      Resident bytes of the active region, or 0 if sa is NULL_PTR
+ * @note        Counted with mincore() on Linux; elsewhere the committed size is reported
+ */
+TStack_alloc_size StackAlloc_GetResident(const TStack_alloc* sa);
+
+/**
+ * @brief       Gets the system page size
+ * @return      Page size in bytes
+ */
+TStack_alloc_size StackAlloc_GetPageSize(void);
+
+#endif /* STACK_ALLOC_VM_H */